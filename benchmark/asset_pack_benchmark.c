@@ -0,0 +1,107 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define DATA_DIR  "../../example/data/"
+#define PACK_PATH Str8Lit("./asset_pack_benchmark.pack")
+
+// NOTE: Compares loading a handful of assets from their source formats against reading them back from a pack
+// baked once at startup (i.e. the offline step).
+static String8 image_paths[] = {
+  Str8Static(DATA_DIR "leia.png"),
+  Str8Static(DATA_DIR "TEST_BMP.bmp"),
+};
+static String8 model_paths[] = {
+  Str8Static(DATA_DIR "computer.glb"),
+  Str8Static(DATA_DIR "sphere.glb"),
+  Str8Static(DATA_DIR "cube.obj"),
+};
+static String8 font_path = Str8Static(DATA_DIR "firacode.ttf");
+static Arena* arena;
+
+static void Bake(void) {
+  PackWriter writer;
+  DEBUG_ASSERT(PackWriterOpen(&writer, PACK_PATH));
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(image_paths); i++) {
+    Image image;
+    DEBUG_ASSERT(ImageLoadFile(arena, &image, ImageFormat_RGBA, image_paths[i]));
+    DEBUG_ASSERT(ImagePackAdd(&writer, image_paths[i], &image));
+  }
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(model_paths); i++) {
+    Model model;
+    DEBUG_ASSERT(ModelLoadFile(arena, &model, model_paths[i]));
+    DEBUG_ASSERT(ModelPackAdd(&writer, model_paths[i], &model));
+  }
+  FontAtlas atlas;
+  Image bitmap;
+  DEBUG_ASSERT(FontAtlasBakeSdfFromFile(arena, arena, &atlas, &bitmap, 0, 0, 0, FontCharSetLatin(), font_path));
+  DEBUG_ASSERT(FontAtlasPackAdd(&writer, font_path, &atlas, &bitmap));
+  DEBUG_ASSERT(PackWriterClose(&writer));
+  ArenaClear(arena);
+}
+
+BENCH(SourceLoad) {
+  while (BenchLoop(bench)) {
+    for (U32 i = 0; i < STATIC_ARRAY_SIZE(image_paths); i++) {
+      Image image;
+      DEBUG_ASSERT(ImageLoadFile(arena, &image, ImageFormat_RGBA, image_paths[i]));
+      BENCH_DO_NOT_OPTIMIZE(image.data);
+    }
+    for (U32 i = 0; i < STATIC_ARRAY_SIZE(model_paths); i++) {
+      Model model;
+      DEBUG_ASSERT(ModelLoadFile(arena, &model, model_paths[i]));
+      BENCH_DO_NOT_OPTIMIZE(model.meshes);
+    }
+    FontAtlas atlas;
+    Image bitmap;
+    DEBUG_ASSERT(FontAtlasBakeSdfFromFile(arena, arena, &atlas, &bitmap, 0, 0, 0, FontCharSetLatin(), font_path));
+    BENCH_DO_NOT_OPTIMIZE(bitmap.data);
+    ArenaClear(arena);
+  }
+}
+
+static void RunPackLoad(Bench* bench, B32 verify) {
+  while (BenchLoop(bench)) {
+    Pack pack;
+    DEBUG_ASSERT(PackOpen(&pack, PACK_PATH, FileMapHint_None));
+    for (U32 i = 0; i < STATIC_ARRAY_SIZE(image_paths); i++) {
+      Image image;
+      DEBUG_ASSERT(ImagePackGet(&pack, image_paths[i], &image));
+      BENCH_DO_NOT_OPTIMIZE(image.data);
+    }
+    for (U32 i = 0; i < STATIC_ARRAY_SIZE(model_paths); i++) {
+      Model model;
+      DEBUG_ASSERT(ModelPackGet(arena, &pack, model_paths[i], &model));
+      BENCH_DO_NOT_OPTIMIZE(model.meshes);
+    }
+    FontAtlas atlas;
+    Image bitmap;
+    DEBUG_ASSERT(FontAtlasPackGet(arena, &pack, font_path, &atlas, &bitmap));
+    BENCH_DO_NOT_OPTIMIZE(bitmap.data);
+    // NOTE: verifying touches every byte, comparable to e.g. uploading everything to the GPU.
+    if (verify) {
+      for (U32 i = 0; i < pack.header->entries_size; i++) { DEBUG_ASSERT(PackEntryVerify(&pack, &pack.entries[i])); }
+    }
+    DEBUG_ASSERT(PackClose(&pack));
+    ArenaClear(arena);
+  }
+}
+
+BENCH(PackLoad)         { RunPackLoad(bench, false); }
+BENCH(PackLoadVerified) { RunPackLoad(bench, true); }
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  DirSetCurrentToExeDir();
+  arena = _ArenaAllocate(GB(1), MB(1));
+  Bake();
+
+  RUN_BENCH(SourceLoad);
+  RUN_BENCH(PackLoad);
+  RUN_BENCH(PackLoadVerified);
+  S32 exit_code = BenchMain(argc, argv);
+
+  ArenaRelease(arena);
+  return exit_code;
+}
@@ -13,6 +13,38 @@ set FLAGS=%FLAGS% %RELEASE%
 
 echo Compiling benchmarks:
 cl %FLAGS% json_benchmark.c /Fobuild/json_benchmark.obj /Febin/json_benchmark.exe /link %LIBS%
+cl %FLAGS% string_split_benchmark.c /Fobuild/string_split_benchmark.obj /Febin/string_split_benchmark.exe /link %LIBS%
+cl %FLAGS% heap_benchmark.c /Fobuild/heap_benchmark.obj /Febin/heap_benchmark.exe /link %LIBS%
+cl %FLAGS% vring_buffer_benchmark.c /Fobuild/vring_buffer_benchmark.obj /Febin/vring_buffer_benchmark.exe /link %LIBS%
+cl %FLAGS% fiber_benchmark.c /Fobuild/fiber_benchmark.obj /Febin/fiber_benchmark.exe /link %LIBS%
+cl %FLAGS% thread_affinity_benchmark.c /Fobuild/thread_affinity_benchmark.obj /Febin/thread_affinity_benchmark.exe /link %LIBS%
+cl %FLAGS% profile_benchmark.c /Fobuild/profile_benchmark.obj /Febin/profile_benchmark.exe /link %LIBS%
+cl %FLAGS% profile_trace_benchmark.c /Fobuild/profile_trace_benchmark.obj /Febin/profile_trace_benchmark.exe /link %LIBS%
+cl %FLAGS% file_map_benchmark.c /Fobuild/file_map_benchmark.obj /Febin/file_map_benchmark.exe /link %LIBS%
+cl %FLAGS% file_read_queue_benchmark.c /Fobuild/file_read_queue_benchmark.obj /Febin/file_read_queue_benchmark.exe /link %LIBS%
+cl %FLAGS% file_stream_benchmark.c /Fobuild/file_stream_benchmark.obj /Febin/file_stream_benchmark.exe /link %LIBS%
+cl %FLAGS% log_benchmark.c /Fobuild/log_benchmark.obj /Febin/log_benchmark.exe /link %LIBS%
+cl %FLAGS% asset_pack_benchmark.c /Fobuild/asset_pack_benchmark.obj /Febin/asset_pack_benchmark.exe /link %LIBS%
+cl %FLAGS% compress_benchmark.c /Fobuild/compress_benchmark.obj /Febin/compress_benchmark.exe /link %LIBS%
+cl %FLAGS% checksum_benchmark.c /Fobuild/checksum_benchmark.obj /Febin/checksum_benchmark.exe /link %LIBS%
+cl %FLAGS% dir_walk_benchmark.c /Fobuild/dir_walk_benchmark.obj /Febin/dir_walk_benchmark.exe /link %LIBS%
+cl %FLAGS% file_watch_benchmark.c /Fobuild/file_watch_benchmark.obj /Febin/file_watch_benchmark.exe /link %LIBS%
 
 echo Running benchmarks:
 bin\json_benchmark.exe
+bin\string_split_benchmark.exe
+bin\heap_benchmark.exe
+bin\vring_buffer_benchmark.exe
+bin\fiber_benchmark.exe
+bin\thread_affinity_benchmark.exe
+bin\profile_benchmark.exe
+bin\profile_trace_benchmark.exe
+bin\file_map_benchmark.exe
+bin\file_read_queue_benchmark.exe
+bin\file_stream_benchmark.exe
+bin\log_benchmark.exe
+bin\asset_pack_benchmark.exe
+bin\compress_benchmark.exe
+bin\checksum_benchmark.exe
+bin\dir_walk_benchmark.exe
+bin\file_watch_benchmark.exe
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+set -e
+cd "$(dirname "$0")"
+
+mkdir -p ./bin/
+
+# NOTE: audio needs pulseaudio and render is windows only, neither is benchmarked.
+FLAGS="-O2 -DNDEBUG -DPROFILE -DCDEFAULT_NO_AUDIO -DCDEFAULT_NO_RENDER"
+LIBS="-lm -lpthread"
+
+echo "Compiling benchmarks:"
+for src in *_benchmark.c; do
+  gcc $FLAGS $src -o ./bin/${src%.c} $LIBS
+done
+
+echo "Running benchmarks:"
+for src in *_benchmark.c; do
+  ./bin/${src%.c}
+done
@@ -0,0 +1,64 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+// NOTE: L2 resident, so that the kernels rather than memory bandwidth are measured.
+#ifndef DATA_SIZE
+#define DATA_SIZE KB(256)
+#endif
+
+typedef U32 Checksum_Fn(U8* data, U64 size);
+static U8* data;
+
+static void RunMemcpy(Bench* bench) {
+  static U8 scratch[DATA_SIZE];
+  bench->bytes_per_iteration = DATA_SIZE;
+  while (BenchLoop(bench)) {
+    MEMORY_COPY_SIZE(scratch, data, DATA_SIZE);
+    BENCH_CLOBBER();
+  }
+}
+
+// NOTE: Each kernel variant is selected by capping the ISA level, see CpuIsaLevelForceMax.
+static void RunChecksum(Bench* bench, Checksum_Fn* checksum, CpuIsaLevel level) {
+  CpuIsaLevelForceMax(level);
+  bench->bytes_per_iteration = DATA_SIZE;
+  while (BenchLoop(bench)) {
+    U32 result = checksum(data, DATA_SIZE);
+    BENCH_DO_NOT_OPTIMIZE(result);
+  }
+  CpuIsaLevelForceMax(CpuIsaLevel_Count);
+}
+
+BENCH(Memcpy)        { RunMemcpy(bench); }
+BENCH(Crc32Scalar)   { RunChecksum(bench, Crc32, CpuIsaLevel_Scalar); }
+BENCH(Crc32Sse42)    { RunChecksum(bench, Crc32, CpuIsaLevel_SSE42); }
+BENCH(Crc32cScalar)  { RunChecksum(bench, Crc32c, CpuIsaLevel_Scalar); }
+BENCH(Crc32cSse42)   { RunChecksum(bench, Crc32c, CpuIsaLevel_SSE42); }
+BENCH(Adler32Scalar) { RunChecksum(bench, Adler32, CpuIsaLevel_Scalar); }
+BENCH(Adler32Sse2)   { RunChecksum(bench, Adler32, CpuIsaLevel_SSE2); }
+BENCH(Adler32Avx2)   { RunChecksum(bench, Adler32, CpuIsaLevel_AVX2); }
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  Arena* arena = ArenaAllocate();
+  data = ARENA_PUSH_ARRAY(arena, U8, DATA_SIZE);
+  RandSeed(NULL, 12345);
+  for (U32 i = 0; i < DATA_SIZE; i++) { data[i] = (U8) RandU32(NULL, 0, 256); }
+
+  // NOTE: variants above the machine's ISA level would silently measure a lower one, so are skipped.
+  CpuIsaLevel level = CpuIsaLevelGet();
+  RUN_BENCH(Memcpy);
+  RUN_BENCH(Crc32Scalar);
+  if (level >= CpuIsaLevel_SSE42 && CpuHasFeature(CpuFeature_PCLMUL)) { RUN_BENCH(Crc32Sse42); }
+  RUN_BENCH(Crc32cScalar);
+  if (level >= CpuIsaLevel_SSE42) { RUN_BENCH(Crc32cSse42); }
+  RUN_BENCH(Adler32Scalar);
+  if (level >= CpuIsaLevel_SSE2)  { RUN_BENCH(Adler32Sse2); }
+  if (level >= CpuIsaLevel_AVX2)  { RUN_BENCH(Adler32Avx2); }
+  S32 exit_code = BenchMain(argc, argv);
+
+  ArenaRelease(arena);
+  return exit_code;
+}
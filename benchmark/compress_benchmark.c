@@ -0,0 +1,137 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#ifndef CORPUS_SIZE
+#define CORPUS_SIZE MB(8)
+#endif
+
+// NOTE: Generated stand ins for the usual mix of a general purpose corpus (e.g. Silesia): prose, structured binary
+// records, incompressible data (e.g. already compressed textures) and sparse data (e.g. mostly empty tiles).
+typedef enum Corpus Corpus;
+enum Corpus {
+  Corpus_Text,
+  Corpus_Records,
+  Corpus_Random,
+  Corpus_Sparse,
+  Corpus_Count,
+};
+static char* corpus_names[Corpus_Count] = { "Text", "Records", "Random", "Sparse" };
+static U8* corpora[Corpus_Count];
+static U8* compressed[Corpus_Count]; // NOTE: With DeflateLevel_Default, the input to the inflate benchmarks.
+static U64 compressed_sizes[Corpus_Count];
+static U64 level_sizes[Corpus_Count][3];
+static U8* scratch;
+static Arena* arena;
+
+static void Generate(Corpus corpus, U8* data) {
+  static char* words[] = { "the", "of", "and", "compression", "window", "arena", "huffman", "a", "stream", "block", "match", "to", "in" };
+  RandSeed(NULL, 12345 + corpus);
+  U32 i = 0;
+  while (i < CORPUS_SIZE) {
+    switch (corpus) {
+      case Corpus_Text: {
+        char* word = words[RandU32(NULL, 0, STATIC_ARRAY_SIZE(words))];
+        for (U32 j = 0; word[j] != '\0' && i < CORPUS_SIZE; j++) { data[i++] = (U8) word[j]; }
+        if (i < CORPUS_SIZE) { data[i++] = (RandU32(NULL, 0, 12) == 0) ? '\n' : ' '; }
+      } break;
+      case Corpus_Records: {
+        U32 record[4] = { i / 16, RandU32(NULL, 0, 100), 7, RandU32(NULL, 0, 1 << 20) };
+        for (U32 j = 0; j < sizeof(record) && i < CORPUS_SIZE; j++) { data[i++] = ((U8*) record)[j]; }
+      } break;
+      case Corpus_Random: { data[i++] = (U8) RandU32(NULL, 0, 256); } break;
+      case Corpus_Sparse: { data[i++] = (RandU32(NULL, 0, 50) == 0) ? (U8) RandU32(NULL, 0, 256) : 0; } break;
+      default: UNREACHABLE();
+    }
+  }
+}
+
+static void RunMemcpy(Bench* bench) {
+  bench->bytes_per_iteration = CORPUS_SIZE;
+  while (BenchLoop(bench)) {
+    MEMORY_COPY_SIZE(scratch, corpora[Corpus_Text], CORPUS_SIZE);
+    BENCH_CLOBBER();
+  }
+}
+
+static void RunDeflate(Bench* bench, Corpus corpus, DeflateLevel level) {
+  bench->bytes_per_iteration = CORPUS_SIZE;
+  while (BenchLoop(bench)) {
+    U8* out;
+    U64 out_size;
+    DEBUG_ASSERT(DeflateAll(arena, CompressFormat_Zlib, level, corpora[corpus], CORPUS_SIZE, &out, &out_size));
+    level_sizes[corpus][level] = out_size;
+    BENCH_DO_NOT_OPTIMIZE(out);
+    ArenaClear(arena);
+  }
+}
+
+// NOTE: Throughput is measured in decompressed bytes, as for deflate.
+static void RunInflate(Bench* bench, Corpus corpus) {
+  bench->bytes_per_iteration = CORPUS_SIZE;
+  while (BenchLoop(bench)) {
+    Inflate* inflate;
+    DEBUG_ASSERT(InflateCreate(&inflate, CompressFormat_Zlib));
+    U64 in_read, out_written;
+    DEBUG_ASSERT(InflateRun(inflate, compressed[corpus], compressed_sizes[corpus], &in_read, scratch, CORPUS_SIZE, &out_written) == CompressStatus_Done);
+    DEBUG_ASSERT(out_written == CORPUS_SIZE);
+    InflateDestroy(inflate);
+    BENCH_CLOBBER();
+  }
+}
+
+#define COMPRESS_BENCH(corpus)                                                             \
+  BENCH(DeflateFast##corpus)    { RunDeflate(bench, Corpus_##corpus, DeflateLevel_Fast); }    \
+  BENCH(DeflateDefault##corpus) { RunDeflate(bench, Corpus_##corpus, DeflateLevel_Default); } \
+  BENCH(DeflateBest##corpus)    { RunDeflate(bench, Corpus_##corpus, DeflateLevel_Best); }    \
+  BENCH(Inflate##corpus)        { RunInflate(bench, Corpus_##corpus); }
+
+BENCH(Memcpy) { RunMemcpy(bench); }
+COMPRESS_BENCH(Text)
+COMPRESS_BENCH(Records)
+COMPRESS_BENCH(Random)
+COMPRESS_BENCH(Sparse)
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  Arena* data_arena = _ArenaAllocate(GB(1), MB(1));
+  arena = _ArenaAllocate(GB(1), MB(1));
+  scratch = ARENA_PUSH_ARRAY(data_arena, U8, CORPUS_SIZE);
+  for (U32 i = 0; i < Corpus_Count; i++) {
+    corpora[i] = ARENA_PUSH_ARRAY(data_arena, U8, CORPUS_SIZE);
+    Generate((Corpus) i, corpora[i]);
+    DEBUG_ASSERT(DeflateAll(data_arena, CompressFormat_Zlib, DeflateLevel_Default, corpora[i], CORPUS_SIZE, &compressed[i], &compressed_sizes[i]));
+  }
+
+  RUN_BENCH(Memcpy);
+  RUN_BENCH(DeflateFastText);
+  RUN_BENCH(DeflateDefaultText);
+  RUN_BENCH(DeflateBestText);
+  RUN_BENCH(InflateText);
+  RUN_BENCH(DeflateFastRecords);
+  RUN_BENCH(DeflateDefaultRecords);
+  RUN_BENCH(DeflateBestRecords);
+  RUN_BENCH(InflateRecords);
+  RUN_BENCH(DeflateFastRandom);
+  RUN_BENCH(DeflateDefaultRandom);
+  RUN_BENCH(DeflateBestRandom);
+  RUN_BENCH(InflateRandom);
+  RUN_BENCH(DeflateFastSparse);
+  RUN_BENCH(DeflateDefaultSparse);
+  RUN_BENCH(DeflateBestSparse);
+  RUN_BENCH(InflateSparse);
+  S32 exit_code = BenchMain(argc, argv);
+
+  // NOTE: sizes are only recorded for the benchmarks that ran, e.g. with a filter.
+  LOG_NO_PREFIX("%-24s %10s %10s %10s", "corpus (ratio)", "fast", "default", "best");
+  for (U32 i = 0; i < Corpus_Count; i++) {
+    F64 ratios[3];
+    for (U32 j = 0; j < 3; j++) { ratios[j] = (level_sizes[i][j] > 0) ? (F64) CORPUS_SIZE / level_sizes[i][j] : 0; }
+    LOG_NO_PREFIX("%-24s %10.3f %10.3f %10.3f", corpus_names[i], ratios[0], ratios[1], ratios[2]);
+  }
+
+  ArenaRelease(arena);
+  ArenaRelease(data_arena);
+  return exit_code;
+}
@@ -0,0 +1,113 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+// NOTE: A generated asset tree of TREE_DIRS x TREE_SUBDIRS directories, with TREE_FILES files each (100K total).
+#define TREE_ROOT    "./dir_walk_benchmark.tmp"
+#define TREE_DIRS    100
+#define TREE_SUBDIRS 10
+#define TREE_FILES   100
+
+static char* extensions[] = { ".png", ".json", ".glsl", ".txt", ".glb" };
+static Arena* arena;
+
+static String8 SubdirPath(Arena* arena, U32 dir, U32 subdir) {
+  return Str8Format(arena, TREE_ROOT "/dir_%u/sub_%u", dir, subdir);
+}
+
+static void Generate(void) {
+  DirEntry* entries;
+  U64 entries_size;
+  if (DirWalk(arena, Str8Lit(TREE_ROOT), DirWalkFlags_Recursive, NULL, NULL, &entries, &entries_size) &&
+      entries_size == TREE_DIRS * TREE_SUBDIRS * TREE_FILES) {
+    ArenaClear(arena);
+    return;
+  }
+  U8 data[16] = { 0 };
+  for (U32 i = 0; i < TREE_DIRS; i++) {
+    for (U32 j = 0; j < TREE_SUBDIRS; j++) {
+      String8 dir = SubdirPath(arena, i, j);
+      DEBUG_ASSERT(DirCreate(dir));
+      for (U32 k = 0; k < TREE_FILES; k++) {
+        String8 path = Str8Format(arena, "%S/file_%u%s", dir, k, extensions[k % STATIC_ARRAY_SIZE(extensions)]);
+        DEBUG_ASSERT(FileDump(path, data, k % sizeof(data)));
+      }
+      ArenaClear(arena);
+    }
+  }
+}
+
+// NOTE: What scanning the tree looked like before DirWalk: list each (known) directory, then stat each file by path.
+BENCH(DirListFilesAndStat) {
+  while (BenchLoop(bench)) {
+    U64 total_size = 0;
+    for (U32 i = 0; i < TREE_DIRS; i++) {
+      for (U32 j = 0; j < TREE_SUBDIRS; j++) {
+        String8List files;
+        MEMORY_ZERO_STRUCT(&files);
+        DEBUG_ASSERT(DirListFiles(arena, SubdirPath(arena, i, j), &files));
+        for (String8ListNode* node = files.head; node != NULL; node = node->next) {
+          FileStats stats;
+          DEBUG_ASSERT(FileStat(node->string, &stats));
+          total_size += stats.size;
+        }
+      }
+    }
+    BENCH_DO_NOT_OPTIMIZE(total_size);
+    ArenaClear(arena);
+  }
+}
+
+static void RunDirWalk(Bench* bench, DirWalkFlags flags, DirWalkFilter_Fn* filter, void* filter_data) {
+  while (BenchLoop(bench)) {
+    DirEntry* entries;
+    U64 entries_size;
+    DEBUG_ASSERT(DirWalk(arena, Str8Lit(TREE_ROOT), DirWalkFlags_Recursive | flags, filter, filter_data, &entries, &entries_size));
+    BENCH_DO_NOT_OPTIMIZE(entries);
+    ArenaClear(arena);
+  }
+}
+
+BENCH(DirWalkNames)        { RunDirWalk(bench, DirWalkFlags_None, NULL, NULL); }
+BENCH(DirWalkStat)         { RunDirWalk(bench, DirWalkFlags_Stat, NULL, NULL); }
+BENCH(DirWalkStatParallel) { RunDirWalk(bench, DirWalkFlags_Stat | DirWalkFlags_Parallel, NULL, NULL); }
+
+// NOTE: Only 1 in 5 files match, and the rest are never stat'd.
+BENCH(DirWalkStatExtension) {
+  String8List png;
+  MEMORY_ZERO_STRUCT(&png);
+  Str8ListAppend(arena, &png, Str8Lit(".png"));
+  U64 arena_pos = ArenaPos(arena);
+  while (BenchLoop(bench)) {
+    DirEntry* entries;
+    U64 entries_size;
+    DEBUG_ASSERT(DirWalk(arena, Str8Lit(TREE_ROOT), DirWalkFlags_Recursive | DirWalkFlags_Stat, DirWalkFilterExtensions, &png, &entries, &entries_size));
+    BENCH_DO_NOT_OPTIMIZE(entries);
+    ArenaPopTo(arena, arena_pos);
+  }
+  ArenaClear(arena);
+}
+
+BENCH(DirWalkGlob) {
+  String8 pattern = Str8Lit("file_1?.*");
+  RunDirWalk(bench, DirWalkFlags_None, DirWalkFilterGlob, &pattern);
+}
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  DirSetCurrentToExeDir();
+  arena = _ArenaAllocate(GB(1), MB(1));
+  Generate();
+
+  RUN_BENCH(DirListFilesAndStat);
+  RUN_BENCH(DirWalkNames);
+  RUN_BENCH(DirWalkStat);
+  RUN_BENCH(DirWalkStatParallel);
+  RUN_BENCH(DirWalkStatExtension);
+  RUN_BENCH(DirWalkGlob);
+  S32 exit_code = BenchMain(argc, argv);
+
+  ArenaRelease(arena);
+  return exit_code;
+}
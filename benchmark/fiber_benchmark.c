@@ -0,0 +1,70 @@
+#define PROFILE_REGISTRY(PROFILE_METRIC) \
+  PROFILE_METRIC(FIBER_SWITCH)           \
+  PROFILE_METRIC(THREAD_SWITCH)
+
+// NOTE: #define CDEFAULT_FIBER_UCONTEXT here to measure the ucontext fallback instead.
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define FIBER_SWITCHES  10000000
+#define THREAD_SWITCHES 200000
+
+static void PingPong(Fiber* fiber, void* UNUSED(arg)) {
+  while (true) { FiberYield(fiber); }
+}
+
+// NOTE: the kernel-scheduled equivalent: 2 threads handing control back and forth.
+typedef struct ThreadPingPong ThreadPingPong;
+struct ThreadPingPong {
+  Sem ping;
+  Sem pong;
+};
+
+static S32 ThreadPong(void* arg) {
+  ThreadPingPong* ping_pong = (ThreadPingPong*) arg;
+  for (S32 i = 0; i < THREAD_SWITCHES / 2; i++) {
+    SemWait(&ping_pong->ping);
+    SemSignal(&ping_pong->pong);
+  }
+  return 0;
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  TimeInit();
+
+  Fiber fiber;
+  DEBUG_ASSERT(FiberCreate(&fiber, PingPong, NULL, KB(64)));
+  FiberResume(&fiber);
+  Stopwatch stopwatch;
+  StopwatchInit(&stopwatch);
+  PROFILE_START(FIBER_SWITCH);
+  // NOTE: each resume is 2 switches, into the fiber and back out.
+  for (S32 i = 0; i < FIBER_SWITCHES / 2; i++) { FiberResume(&fiber); }
+  PROFILE_END(FIBER_SWITCH);
+  F32 fiber_seconds = StopwatchReadSeconds(&stopwatch);
+  FiberDestroy(&fiber);
+
+  ThreadPingPong ping_pong;
+  SemInit(&ping_pong.ping, 0);
+  SemInit(&ping_pong.pong, 0);
+  Thread thread;
+  ThreadCreate(&thread, ThreadPong, &ping_pong);
+  StopwatchInit(&stopwatch);
+  PROFILE_START(THREAD_SWITCH);
+  for (S32 i = 0; i < THREAD_SWITCHES / 2; i++) {
+    SemSignal(&ping_pong.ping);
+    SemWait(&ping_pong.pong);
+  }
+  PROFILE_END(THREAD_SWITCH);
+  F32 thread_seconds = StopwatchReadSeconds(&stopwatch);
+  ThreadJoin(&thread);
+  SemDeinit(&ping_pong.ping);
+  SemDeinit(&ping_pong.pong);
+
+  LOG_INFO("Fiber:  %.1f M switches/s, %.1f cycles/switch",
+           FIBER_SWITCHES / fiber_seconds / 1e6f, (F32) ProfileGetAnchor(FIBER_SWITCH).elapsed_inclusive / FIBER_SWITCHES);
+  LOG_INFO("Thread: %.3f M switches/s, %.1f cycles/switch",
+           THREAD_SWITCHES / thread_seconds / 1e6f, (F32) ProfileGetAnchor(THREAD_SWITCH).elapsed_inclusive / THREAD_SWITCHES);
+  return 0;
+}
@@ -0,0 +1,106 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#ifndef FILE_SIZE
+#define FILE_SIZE GB(1)
+#endif
+#define FILE_PATH Str8Lit("./file_map_benchmark.bin")
+
+static Arena* read_arena;
+
+// NOTE: Evicts the file from the OS file cache, so the next load has to go to disk.
+static void DropFileCache(String8 file_path) {
+  U8 file_path_cstr[256];
+  MEMORY_COPY_SIZE(file_path_cstr, file_path.str, file_path.size);
+  file_path_cstr[file_path.size] = '\0';
+#if defined(OS_WINDOWS)
+  // NOTE: opening a file unbuffered invalidates its cached pages.
+  HANDLE handle = CreateFileA((LPCSTR) file_path_cstr, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, NULL);
+  if (handle != INVALID_HANDLE_VALUE) { CloseHandle(handle); }
+#elif defined(OS_LINUX)
+  S32 fd = open((char*) file_path_cstr, O_RDONLY);
+  if (fd != -1) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#endif
+}
+
+static U64 Checksum(U8* data, U64 size) {
+  U64 result = 0;
+  U64* words = (U64*) data;
+  for (U64 i = 0; i < size / sizeof(U64); i++) { result += words[i]; }
+  return result;
+}
+
+static void ReadAll(Bench* bench, B32 cold) {
+  bench->bytes_per_iteration = FILE_SIZE;
+  while (BenchLoop(bench)) {
+    if (cold) {
+      BenchPause(bench);
+      DropFileCache(FILE_PATH);
+      BenchResume(bench);
+    }
+    String8 data;
+    DEBUG_ASSERT(FileReadAll(read_arena, FILE_PATH, &data.str, &data.size));
+    U64 checksum = Checksum(data.str, data.size);
+    BENCH_DO_NOT_OPTIMIZE(checksum);
+    ArenaClear(read_arena);
+  }
+}
+
+static void Map(Bench* bench, B32 cold, FileMapHint hints) {
+  bench->bytes_per_iteration = FILE_SIZE;
+  while (BenchLoop(bench)) {
+    if (cold) {
+      BenchPause(bench);
+      DropFileCache(FILE_PATH);
+      BenchResume(bench);
+    }
+    FileMap map;
+    DEBUG_ASSERT(FileMapOpen(FILE_PATH, &map, hints));
+    U64 checksum = Checksum(map.data, map.size);
+    BENCH_DO_NOT_OPTIMIZE(checksum);
+    DEBUG_ASSERT(FileMapClose(&map));
+  }
+}
+
+BENCH(ReadAllCold)           { ReadAll(bench, true); }
+BENCH(MapCold)               { Map(bench, true, FileMapHint_None); }
+BENCH(MapColdSequential)     { Map(bench, true, FileMapHint_Sequential); }
+BENCH(MapColdWillNeed)       { Map(bench, true, FileMapHint_Sequential | FileMapHint_WillNeed); }
+BENCH(ReadAllWarm)           { ReadAll(bench, false); }
+BENCH(MapWarm)               { Map(bench, false, FileMapHint_None); }
+BENCH(MapWarmHugePages)      { Map(bench, false, FileMapHint_HugePages); }
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  DirSetCurrentToExeDir();
+  read_arena = _ArenaAllocate(FILE_SIZE + MB(1), MB(1));
+
+  FileStats stats;
+  if (!FileStat(FILE_PATH, &stats) || stats.size != FILE_SIZE) {
+    LOG_INFO("Generating %llu MB test file...", FILE_SIZE / MB(1));
+    FileHandle* file;
+    DEBUG_ASSERT(FileHandleOpen(&file, FILE_PATH, FileMode_Write | FileMode_Create | FileMode_Truncate));
+    U8* chunk = ARENA_PUSH_ARRAY(read_arena, U8, MB(64));
+    RandSeed(NULL, 12345);
+    for (U64 i = 0; i < MB(64); i++) { chunk[i] = (U8) RandU32(NULL, 0, 256); }
+    for (U64 written = 0; written < FILE_SIZE; written += MB(64)) {
+      DEBUG_ASSERT(FileHandleWrite(file, chunk, (U32) MIN(MB(64), FILE_SIZE - written)));
+    }
+    DEBUG_ASSERT(FileHandleClose(file));
+    ArenaClear(read_arena);
+  }
+
+  RUN_BENCH(ReadAllCold);
+  RUN_BENCH(MapCold);
+  RUN_BENCH(MapColdSequential);
+  RUN_BENCH(MapColdWillNeed);
+  RUN_BENCH(ReadAllWarm);
+  RUN_BENCH(MapWarm);
+  RUN_BENCH(MapWarmHugePages);
+  return BenchMain(argc, argv);
+}
@@ -0,0 +1,144 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#ifndef FILES_SIZE
+#define FILES_SIZE 1000
+#endif
+#ifndef FILE_SIZE
+#define FILE_SIZE KB(64)
+#endif
+
+// NOTE: Handles are opened up front, only the reads are timed.
+static String8 file_paths[FILES_SIZE];
+static FileHandle* files[FILES_SIZE];
+static FileReadRequest requests[FILES_SIZE];
+static U8* buffers;
+
+// NOTE: Evicts the file from the OS file cache, so the next load has to go to disk.
+static void DropFileCache(String8 file_path) {
+  U8 file_path_cstr[256];
+  MEMORY_COPY_SIZE(file_path_cstr, file_path.str, file_path.size);
+  file_path_cstr[file_path.size] = '\0';
+#if defined(OS_WINDOWS)
+  // NOTE: opening a file unbuffered invalidates its cached pages.
+  HANDLE handle = CreateFileA((LPCSTR) file_path_cstr, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, NULL);
+  if (handle != INVALID_HANDLE_VALUE) { CloseHandle(handle); }
+#elif defined(OS_LINUX)
+  S32 fd = open((char*) file_path_cstr, O_RDONLY);
+  if (fd != -1) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#endif
+}
+
+static void DropAllFileCaches(Bench* bench) {
+  BenchPause(bench);
+  for (U32 i = 0; i < FILES_SIZE; i++) { DropFileCache(file_paths[i]); }
+  BenchResume(bench);
+}
+
+static void Sync(Bench* bench, B32 cold) {
+  bench->bytes_per_iteration = FILES_SIZE * FILE_SIZE;
+  while (BenchLoop(bench)) {
+    if (cold) { DropAllFileCaches(bench); }
+    for (U32 i = 0; i < FILES_SIZE; i++) {
+      U32 bytes_read;
+      DEBUG_ASSERT(FileHandleSeek(files[i], 0, FileSeekPos_Begin));
+      DEBUG_ASSERT(FileHandleRead(files[i], buffers + i * FILE_SIZE, FILE_SIZE, &bytes_read));
+      DEBUG_ASSERT(bytes_read == FILE_SIZE);
+    }
+    BENCH_CLOBBER();
+  }
+}
+
+static void Queue(Bench* bench, B32 cold, FileReadQueueBackend backend, U32 depth) {
+  FileReadQueue* queue;
+  DEBUG_ASSERT(FileReadQueueCreate(&queue, depth, backend));
+  if (FileReadQueueGetBackend(queue) != backend) { LOG_WARN("Native async reads unavailable, measuring the thread fallback."); }
+  for (U32 i = 0; i < FILES_SIZE; i++) {
+    MEMORY_ZERO_STRUCT(&requests[i]);
+    requests[i].file   = files[i];
+    requests[i].buffer = buffers + i * FILE_SIZE;
+    requests[i].size   = FILE_SIZE;
+  }
+
+  bench->bytes_per_iteration = FILES_SIZE * FILE_SIZE;
+  while (BenchLoop(bench)) {
+    if (cold) { DropAllFileCaches(bench); }
+    FileReadQueueSubmit(queue, requests, FILES_SIZE);
+    FileReadRequest* completed[FILE_READ_QUEUE_MAX_DEPTH];
+    U32 completed_size;
+    while ((completed_size = FileReadQueueWait(queue, completed, STATIC_ARRAY_SIZE(completed))) > 0) {
+      for (U32 i = 0; i < completed_size; i++) { DEBUG_ASSERT(completed[i]->bytes_read == FILE_SIZE); }
+    }
+    BENCH_CLOBBER();
+  }
+  FileReadQueueDestroy(queue);
+}
+
+#define QUEUE_BENCH(backend, depth)                                                        \
+  BENCH(backend##Cold##depth) { Queue(bench, true, FileReadQueueBackend_##backend, depth); }
+
+BENCH(SyncCold) { Sync(bench, true); }
+QUEUE_BENCH(Native, 1)
+QUEUE_BENCH(Native, 2)
+QUEUE_BENCH(Native, 4)
+QUEUE_BENCH(Native, 8)
+QUEUE_BENCH(Native, 16)
+QUEUE_BENCH(Native, 32)
+QUEUE_BENCH(Native, 64)
+QUEUE_BENCH(Threads, 1)
+QUEUE_BENCH(Threads, 2)
+QUEUE_BENCH(Threads, 4)
+QUEUE_BENCH(Threads, 8)
+QUEUE_BENCH(Threads, 16)
+QUEUE_BENCH(Threads, 32)
+QUEUE_BENCH(Threads, 64)
+BENCH(SyncWarm)      { Sync(bench, false); }
+BENCH(NativeWarm64)  { Queue(bench, false, FileReadQueueBackend_Native, 64); }
+BENCH(ThreadsWarm64) { Queue(bench, false, FileReadQueueBackend_Threads, 64); }
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  DirSetCurrentToExeDir();
+  Arena* arena = _ArenaAllocate(FILES_SIZE * FILE_SIZE + MB(1), MB(1));
+  buffers = ARENA_PUSH_ARRAY(arena, U8, FILES_SIZE * FILE_SIZE);
+
+  RandSeed(NULL, 12345);
+  for (U32 i = 0; i < FILES_SIZE * FILE_SIZE; i++) { buffers[i] = (U8) RandU32(NULL, 0, 256); }
+  for (U32 i = 0; i < FILES_SIZE; i++) {
+    file_paths[i] = Str8Format(arena, "./file_read_queue_benchmark_%u.bin", i);
+    FileStats stats;
+    if (!FileStat(file_paths[i], &stats) || stats.size != FILE_SIZE) {
+      DEBUG_ASSERT(FileDump(file_paths[i], buffers + i * FILE_SIZE, FILE_SIZE));
+    }
+    DEBUG_ASSERT(FileHandleOpen(&files[i], file_paths[i], FileMode_Read));
+  }
+
+  RUN_BENCH(SyncCold);
+  RUN_BENCH(NativeCold1);
+  RUN_BENCH(NativeCold2);
+  RUN_BENCH(NativeCold4);
+  RUN_BENCH(NativeCold8);
+  RUN_BENCH(NativeCold16);
+  RUN_BENCH(NativeCold32);
+  RUN_BENCH(NativeCold64);
+  RUN_BENCH(ThreadsCold1);
+  RUN_BENCH(ThreadsCold2);
+  RUN_BENCH(ThreadsCold4);
+  RUN_BENCH(ThreadsCold8);
+  RUN_BENCH(ThreadsCold16);
+  RUN_BENCH(ThreadsCold32);
+  RUN_BENCH(ThreadsCold64);
+  RUN_BENCH(SyncWarm);
+  RUN_BENCH(NativeWarm64);
+  RUN_BENCH(ThreadsWarm64);
+  S32 exit_code = BenchMain(argc, argv);
+
+  for (U32 i = 0; i < FILES_SIZE; i++) { DEBUG_ASSERT(FileHandleClose(files[i])); }
+  ArenaRelease(arena);
+  return exit_code;
+}
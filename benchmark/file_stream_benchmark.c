@@ -0,0 +1,145 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#ifndef RECORDS_SIZE
+#define RECORDS_SIZE 1000000
+#endif
+#define FILE_PATH Str8Lit("./file_stream_benchmark.csv")
+
+// NOTE: Small CSV records, e.g. exporting a point cloud.
+static String8 records;
+static U32* record_ends;
+static Arena* line_arena;
+
+// NOTE: Benchmarks run many times, so OS call counts are reported once, after the timing table.
+typedef struct OsCalls OsCalls;
+struct OsCalls {
+  String8 name;
+  U64 num;
+};
+static OsCalls os_calls[16];
+static U32 os_calls_size;
+
+static void RecordOsCalls(String8 name, U64 num) {
+  for (U32 i = 0; i < os_calls_size; i++) {
+    if (Str8Eq(os_calls[i].name, name)) { os_calls[i].num = num; return; }
+  }
+  DEBUG_ASSERT(os_calls_size < STATIC_ARRAY_SIZE(os_calls));
+  os_calls[os_calls_size].name = name;
+  os_calls[os_calls_size].num  = num;
+  os_calls_size++;
+}
+
+static String8 Record(U32 i) {
+  U32 start = (i == 0) ? 0 : record_ends[i - 1];
+  return Str8Substring(records, start, record_ends[i]);
+}
+
+static void RunHandleWrite(Bench* bench) {
+  bench->bytes_per_iteration = records.size;
+  while (BenchLoop(bench)) {
+    FileHandle* file;
+    DEBUG_ASSERT(FileHandleOpen(&file, FILE_PATH, FileMode_Write | FileMode_Create | FileMode_Truncate));
+    for (U32 i = 0; i < RECORDS_SIZE; i++) {
+      String8 record = Record(i);
+      DEBUG_ASSERT(FileHandleWrite(file, record.str, record.size));
+    }
+    DEBUG_ASSERT(FileHandleClose(file));
+  }
+  RecordOsCalls(Str8Lit("WriteHandle"), RECORDS_SIZE);
+}
+
+static void RunWrite(Bench* bench, String8 name, FileMode mode, U64 buffer_size) {
+  bench->bytes_per_iteration = records.size;
+  U64 num_os_calls = 0;
+  while (BenchLoop(bench)) {
+    FileWriter writer;
+    DEBUG_ASSERT(FileWriterOpen(&writer, FILE_PATH, mode | FileMode_Create | FileMode_Truncate, buffer_size));
+    for (U32 i = 0; i < RECORDS_SIZE; i++) { DEBUG_ASSERT(FileWriterWriteStr8(&writer, Record(i))); }
+    num_os_calls = writer.num_os_calls + ((writer.buffer_size > 0) ? 1 : 0); // NOTE: + the final flush in close.
+    DEBUG_ASSERT(FileWriterClose(&writer));
+  }
+  RecordOsCalls(name, num_os_calls);
+}
+
+static void RunReadLine(Bench* bench, String8 name, FileMode mode, U64 buffer_size) {
+  bench->bytes_per_iteration = records.size;
+  U64 num_os_calls = 0;
+  while (BenchLoop(bench)) {
+    FileReader reader;
+    DEBUG_ASSERT(FileReaderOpen(&reader, FILE_PATH, mode, buffer_size));
+    String8 line;
+    U32 lines_size = 0;
+    while (FileReaderReadLine(&reader, line_arena, &line)) {
+      lines_size++;
+      ArenaClear(line_arena);
+    }
+    DEBUG_ASSERT(lines_size == RECORDS_SIZE);
+    num_os_calls = reader.num_os_calls;
+    DEBUG_ASSERT(FileReaderClose(&reader));
+  }
+  RecordOsCalls(name, num_os_calls);
+}
+
+static void RunReadAll(Bench* bench) {
+  bench->bytes_per_iteration = records.size;
+  while (BenchLoop(bench)) {
+    String8 data;
+    DEBUG_ASSERT(FileReadAll(line_arena, FILE_PATH, &data.str, &data.size));
+    U32 lines_size = 0;
+    String8LineIter it;
+    String8 line;
+    for (Str8LineIterInit(&it, data); Str8LineIterNext(&it, &line);) { lines_size++; }
+    BENCH_DO_NOT_OPTIMIZE(lines_size);
+    ArenaClear(line_arena);
+  }
+}
+
+BENCH(WriteHandle)           { RunHandleWrite(bench); }
+BENCH(Write64K)              { RunWrite(bench, Str8Lit("Write64K"), 0, KB(64)); }
+BENCH(Write1M)               { RunWrite(bench, Str8Lit("Write1M"), 0, MB(1)); }
+BENCH(Write4M)               { RunWrite(bench, Str8Lit("Write4M"), 0, MB(4)); }
+BENCH(Write4MUnbuffered)     { RunWrite(bench, Str8Lit("Write4MUnbuffered"), FileMode_Unbuffered, MB(4)); }
+BENCH(ReadAllLines)          { RunReadAll(bench); }
+BENCH(ReadLine64K)           { RunReadLine(bench, Str8Lit("ReadLine64K"), 0, KB(64)); }
+BENCH(ReadLine1M)            { RunReadLine(bench, Str8Lit("ReadLine1M"), 0, MB(1)); }
+BENCH(ReadLine4M)            { RunReadLine(bench, Str8Lit("ReadLine4M"), 0, MB(4)); }
+BENCH(ReadLine4MUnbuffered)  { RunReadLine(bench, Str8Lit("ReadLine4MUnbuffered"), FileMode_Unbuffered, MB(4)); }
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  DirSetCurrentToExeDir();
+  Arena* arena = _ArenaAllocate(GB(1), MB(1));
+  line_arena = ArenaAllocate();
+
+  RandSeed(NULL, 12345);
+  record_ends = ARENA_PUSH_ARRAY(arena, U32, RECORDS_SIZE);
+  String8List record_list;
+  MEMORY_ZERO_STRUCT(&record_list);
+  U32 size = 0;
+  for (U32 i = 0; i < RECORDS_SIZE; i++) {
+    String8 record = Str8Format(arena, "%u,%u,%u\n", i, RandU32(NULL, 0, 100000), RandU32(NULL, 0, 100000));
+    Str8ListAppend(arena, &record_list, record);
+    size += record.size;
+    record_ends[i] = size;
+  }
+  records = Str8ListJoin(arena, &record_list);
+
+  RUN_BENCH(WriteHandle);
+  RUN_BENCH(Write64K);
+  RUN_BENCH(Write1M);
+  RUN_BENCH(Write4M);
+  RUN_BENCH(Write4MUnbuffered);
+  RUN_BENCH(ReadAllLines);
+  RUN_BENCH(ReadLine64K);
+  RUN_BENCH(ReadLine1M);
+  RUN_BENCH(ReadLine4M);
+  RUN_BENCH(ReadLine4MUnbuffered);
+  S32 exit_code = BenchMain(argc, argv);
+
+  LOG_NO_PREFIX("%-24s %16s", "benchmark", "OS calls");
+  for (U32 i = 0; i < os_calls_size; i++) { LOG_NO_PREFIX("%-24S %16llu", os_calls[i].name, os_calls[i].num); }
+  return exit_code;
+}
@@ -0,0 +1,89 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+// NOTE: A hot reload loop over an asset directory of TREE_DIRS x TREE_FILES files, per frame.
+#define TREE_ROOT  "./file_watch_benchmark.tmp"
+#define TREE_DIRS  10
+#define TREE_FILES 1000
+
+static String8* paths;
+static U64* last_write_times;
+static FileWatcher* watcher;
+static Arena* arena;
+
+static void Generate(void) {
+  U8 data[16] = { 0 };
+  paths = ARENA_PUSH_ARRAY(arena, String8, TREE_DIRS * TREE_FILES);
+  last_write_times = ARENA_PUSH_ARRAY(arena, U64, TREE_DIRS * TREE_FILES);
+  for (U32 i = 0; i < TREE_DIRS; i++) {
+    String8 dir = Str8Format(arena, TREE_ROOT "/dir_%u", i);
+    DEBUG_ASSERT(DirCreate(dir));
+    for (U32 j = 0; j < TREE_FILES; j++) {
+      U32 idx = i * TREE_FILES + j;
+      paths[idx] = Str8Format(arena, "%S/file_%u.json", dir, j);
+      DEBUG_ASSERT(FileDump(paths[idx], data, sizeof(data)));
+      last_write_times[idx] = 0;
+    }
+  }
+}
+
+// NOTE: What hot reloading looked like before FileWatcher: stat every file, every frame.
+BENCH(FileStatAll) {
+  while (BenchLoop(bench)) {
+    U32 changed = 0;
+    for (U32 i = 0; i < TREE_DIRS * TREE_FILES; i++) {
+      FileStats stats;
+      DEBUG_ASSERT(FileStat(paths[i], &stats));
+      if (stats.last_write_time != last_write_times[i]) {
+        last_write_times[i] = stats.last_write_time;
+        changed++;
+      }
+    }
+    BENCH_DO_NOT_OPTIMIZE(changed);
+  }
+}
+
+BENCH(FileWatcherPollIdle) {
+  U64 arena_pos = ArenaPos(arena);
+  while (BenchLoop(bench)) {
+    FileWatchEvent* events;
+    U64 events_size;
+    DEBUG_ASSERT(FileWatcherPoll(watcher, arena, &events, &events_size));
+    BENCH_DO_NOT_OPTIMIZE(events);
+    ArenaPopTo(arena, arena_pos);
+  }
+}
+
+// NOTE: Includes the cost of the write being watched.
+BENCH(FileWatcherPollOneChange) {
+  U8 data[16] = { 1 };
+  U64 arena_pos = ArenaPos(arena);
+  U32 i = 0;
+  while (BenchLoop(bench)) {
+    DEBUG_ASSERT(FileDump(paths[i++ % (TREE_DIRS * TREE_FILES)], data, sizeof(data)));
+    FileWatchEvent* events;
+    U64 events_size;
+    DEBUG_ASSERT(FileWatcherPoll(watcher, arena, &events, &events_size));
+    BENCH_DO_NOT_OPTIMIZE(events);
+    ArenaPopTo(arena, arena_pos);
+  }
+}
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  DirSetCurrentToExeDir();
+  arena = _ArenaAllocate(GB(1), MB(1));
+  Generate();
+  DEBUG_ASSERT(FileWatcherCreate(&watcher, Str8Lit(TREE_ROOT), true));
+
+  RUN_BENCH(FileStatAll);
+  RUN_BENCH(FileWatcherPollIdle);
+  RUN_BENCH(FileWatcherPollOneChange);
+  S32 exit_code = BenchMain(argc, argv);
+
+  FileWatcherDestroy(watcher);
+  ArenaRelease(arena);
+  return exit_code;
+}
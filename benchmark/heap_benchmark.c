@@ -0,0 +1,86 @@
+#define PROFILE_REGISTRY(PROFILE_METRIC) \
+  PROFILE_METRIC(HEAP)                   \
+  PROFILE_METRIC(LINEAR_SCAN)
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define OPS_PER_SIZE KB(256)
+
+#define F32Compare(a, b) (((a) > (b)) - ((a) < (b)))
+HEAP_DEFINE(F32Heap, F32, F32Compare)
+
+typedef struct F32List F32List;
+struct F32List {
+  F32* data;
+  U32 size;
+  U32 capacity;
+};
+
+// NOTE: EPA-like workload: repeatedly take the closest item, replace it with a slightly further one.
+static F32 RunHeap(Arena* arena, F32* items, U32 size, F32* deltas, U32 num_ops) {
+  F32 result = 0;
+  F32Heap heap;
+  F32HeapInit(&heap, arena);
+  F32HeapHeapify(&heap, items, size);
+  for (U32 i = 0; i < num_ops; i++) {
+    F32 min = F32HeapPop(&heap);
+    result += min;
+    F32HeapPush(&heap, min + deltas[i]);
+  }
+  return result;
+}
+
+static F32 RunLinearScan(Arena* arena, F32* items, U32 size, F32* deltas, U32 num_ops) {
+  F32 result = 0;
+  F32List list;
+  MEMORY_ZERO_STRUCT(&list);
+  for (U32 i = 0; i < size; i++) { DA_PUSH_BACK(arena, &list, items[i]); }
+  for (U32 i = 0; i < num_ops; i++) {
+    U32 min_idx = 0;
+    for (U32 j = 1; j < list.size; j++) {
+      if (list.data[j] < list.data[min_idx]) { min_idx = j; }
+    }
+    F32 min = list.data[min_idx];
+    result += min;
+    DA_SWAP_REMOVE(&list, min_idx);
+    DA_PUSH_BACK(arena, &list, min + deltas[i]);
+  }
+  return result;
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  Arena* arena = ArenaAllocate();
+  U32 sizes[] = { 8, 16, 32, 64, 128, 256, 1024, 4096 };
+
+  F32* deltas = ARENA_PUSH_ARRAY(arena, F32, OPS_PER_SIZE);
+  F32* items  = ARENA_PUSH_ARRAY(arena, F32, sizes[STATIC_ARRAY_SIZE(sizes) - 1]);
+  RandSeed(NULL, 12345);
+  for (U32 i = 0; i < OPS_PER_SIZE; i++) { deltas[i] = RandU32(NULL, 1, 1000) / 100.0f; }
+
+  for (U32 s = 0; s < STATIC_ARRAY_SIZE(sizes); s++) {
+    U32 size = sizes[s];
+    for (U32 i = 0; i < size; i++) { items[i] = RandU32(NULL, 0, 100000) / 100.0f; }
+    U64 arena_pos = ArenaPos(arena);
+
+    PROFILE_START(HEAP);
+    F32 heap_result = RunHeap(arena, items, size, deltas, OPS_PER_SIZE);
+    PROFILE_END(HEAP);
+    ArenaPopTo(arena, arena_pos);
+
+    PROFILE_START(LINEAR_SCAN);
+    F32 scan_result = RunLinearScan(arena, items, size, deltas, OPS_PER_SIZE);
+    PROFILE_END(LINEAR_SCAN);
+    ArenaPopTo(arena, arena_pos);
+    DEBUG_ASSERT(heap_result == scan_result);
+
+    U64 heap_cycles = ProfileGetAnchor(HEAP).elapsed_inclusive;
+    U64 scan_cycles = ProfileGetAnchor(LINEAR_SCAN).elapsed_inclusive;
+    LOG_INFO("size %4u: heap %6.1f cycles/op, linear scan %7.1f cycles/op",
+             size, (F32) heap_cycles / OPS_PER_SIZE, (F32) scan_cycles / OPS_PER_SIZE);
+    ProfileReset();
+  }
+
+  return 0;
+}
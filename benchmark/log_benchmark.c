@@ -0,0 +1,77 @@
+#define BENCH_MAX_SECONDS 3.0
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#ifndef MESSAGES_SIZE
+#define MESSAGES_SIZE 65536 // NOTE: Per iteration, split across all threads.
+#endif
+#define LOG_FILE Str8Lit("./log_benchmark.log")
+
+static AtomicS32 start_flag;
+
+static S32 LogThread(void* arg) {
+  U32 messages_size = (U32) (U64) arg;
+  while (!AtomicS32Load(&start_flag)) {}
+  for (U32 i = 0; i < messages_size; i++) { LOG_INFO("message %u, value %.3f", i, i * 0.5f); }
+  return 0;
+}
+
+static void Run(Bench* bench, U32 threads_size, B32 is_async) {
+  LogDeinit();
+  DEBUG_ASSERT(LogInitFile(LOG_FILE));
+  if (is_async) { DEBUG_ASSERT(LogEnableAsync(KB(16), LogAsyncPolicy_Block)); }
+
+  Thread threads[32];
+  DEBUG_ASSERT(threads_size <= STATIC_ARRAY_SIZE(threads));
+  while (BenchLoop(bench)) {
+    BenchPause(bench);
+    AtomicS32Store(&start_flag, false);
+    for (U32 i = 0; i < threads_size; i++) { ThreadCreate(&threads[i], LogThread, (void*) (U64) (MESSAGES_SIZE / threads_size)); }
+    BenchResume(bench);
+    AtomicS32Store(&start_flag, true);
+    for (U32 i = 0; i < threads_size; i++) { ThreadJoin(&threads[i]); }
+    LogFlush();
+  }
+
+  LogDeinit();
+  DEBUG_ASSERT(LogInitStdOut());
+}
+
+#define LOG_BENCH(threads_size)                                    \
+  BENCH(Sync##threads_size)  { Run(bench, threads_size, false); } \
+  BENCH(Async##threads_size) { Run(bench, threads_size, true);  }
+
+LOG_BENCH(1)
+LOG_BENCH(2)
+LOG_BENCH(4)
+LOG_BENCH(8)
+LOG_BENCH(16)
+LOG_BENCH(32)
+
+int main(int argc, char** argv) {
+  DEBUG_ASSERT(LogInitStdOut());
+  DirSetCurrentToExeDir();
+  AtomicS32Init(&start_flag, false);
+
+  RUN_BENCH(Sync1);
+  RUN_BENCH(Async1);
+  RUN_BENCH(Sync2);
+  RUN_BENCH(Async2);
+  RUN_BENCH(Sync4);
+  RUN_BENCH(Async4);
+  RUN_BENCH(Sync8);
+  RUN_BENCH(Async8);
+  RUN_BENCH(Sync16);
+  RUN_BENCH(Async16);
+  RUN_BENCH(Sync32);
+  RUN_BENCH(Async32);
+  S32 exit_code = BenchMain(argc, argv);
+
+  LOG_NO_PREFIX("%-24s %16s", "benchmark", "messages / s");
+  for (BenchResult* result = BenchGetResults(); result != NULL; result = result->next) {
+    U64 messages_per_second = (U64) (MESSAGES_SIZE / (result->stats.median_ns / 1000000000.0));
+    LOG_NO_PREFIX("%-24S %16llu", result->name, messages_per_second);
+  }
+  return exit_code;
+}
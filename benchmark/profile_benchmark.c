@@ -0,0 +1,27 @@
+#define PROFILE_REGISTRY(PROFILE_METRIC) \
+  PROFILE_METRIC(LOOP)                   \
+  PROFILE_METRIC(EMPTY_BLOCK)
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define NUM_BLOCKS     10000000
+#define BENCHMARK_RUNS 5
+
+// NOTE: Measures the overhead of an empty PROFILE_START / PROFILE_END pair, as seen by an enclosing block.
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  U64 total_cycles = 0;
+  for (S32 run = 0; run < BENCHMARK_RUNS; run++) {
+    PROFILE_START(LOOP);
+    for (S32 i = 0; i < NUM_BLOCKS; i++) {
+      PROFILE_START(EMPTY_BLOCK);
+      PROFILE_END(EMPTY_BLOCK);
+    }
+    PROFILE_END(LOOP);
+    total_cycles += ProfileGetAnchor(LOOP).elapsed_inclusive;
+    ProfileReset();
+  }
+  LOG_INFO("Profile block overhead: %.1f cycles / block", (F64) total_cycles / ((F64) NUM_BLOCKS * BENCHMARK_RUNS));
+  return 0;
+}
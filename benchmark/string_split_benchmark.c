@@ -0,0 +1,116 @@
+#define PROFILE_REGISTRY(PROFILE_METRIC) \
+  PROFILE_METRIC(STR8_SPLIT_LIST)        \
+  PROFILE_METRIC(STR8_SPLIT_ITER)
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define TEXT_SIZE      MB(256)
+#define WARMUP_RUNS    1
+#define BENCHMARK_RUNS 5
+
+static U8* WriteU32(U8* dest, U32 x) {
+  U8 digits[10];
+  U32 digits_size = 0;
+  do { digits[digits_size++] = '0' + (x % 10); x /= 10; } while (x > 0);
+  while (digits_size > 0) { *dest++ = digits[--digits_size]; }
+  return dest;
+}
+
+// NOTE: OBJ-like text, e.g. "v 123 456 789" and "f 1/2/3 4/5/6 7/8/9" lines.
+static String8 GenerateText(Arena* arena, U32 size) {
+  String8 result;
+  result.str = ARENA_PUSH_ARRAY(arena, U8, size);
+  U8* curr = result.str;
+  U8* end  = result.str + size - 64;
+  RandSeed(NULL, 12345);
+  while (curr < end) {
+    if (RandB32(NULL)) {
+      *curr++ = 'v';
+      for (U32 i = 0; i < 3; i++) { *curr++ = ' '; curr = WriteU32(curr, RandU32(NULL, 0, 100000)); }
+    } else {
+      *curr++ = 'f';
+      for (U32 i = 0; i < 3; i++) {
+        *curr++ = ' ';
+        curr = WriteU32(curr, RandU32(NULL, 1, 10000));
+        *curr++ = '/';
+        curr = WriteU32(curr, RandU32(NULL, 1, 10000));
+        *curr++ = '/';
+        curr = WriteU32(curr, RandU32(NULL, 1, 10000));
+      }
+    }
+    *curr++ = '\n';
+  }
+  result.size = curr - result.str;
+  return result;
+}
+
+static U64 SplitList(Arena* arena, String8 text) {
+  U64 result = 0;
+  String8List lines = Str8Split(arena, text, '\n');
+  for (String8ListNode* line = lines.head; line != NULL; line = line->next) {
+    String8List tokens = Str8Split(arena, line->string, ' ');
+    for (String8ListNode* token = tokens.head; token != NULL; token = token->next) { result += token->string.size; }
+  }
+  return result;
+}
+
+static U64 SplitIter(String8 text) {
+  U64 result = 0;
+  String8LineIter lines;
+  String8TokenIter tokens;
+  String8 line, token;
+  Str8LineIterInit(&lines, text);
+  Str8TokenIterInit(&tokens, Str8Lit(""), STR8_WHITESPACE);
+  while (Str8LineIterNext(&lines, &line)) {
+    Str8TokenIterReset(&tokens, line);
+    while (Str8TokenIterNext(&tokens, &token)) { result += token.size; }
+  }
+  return result;
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  TimeInit();
+  Arena* text_arena = _ArenaAllocate(TEXT_SIZE + MB(1), MB(1));
+  Arena* list_arena = _ArenaAllocate(GB(4), MB(1));
+  String8 text = GenerateText(text_arena, TEXT_SIZE);
+  LOG_INFO("Generated %u bytes of text.", text.size);
+
+  for (S32 i = 0; i < WARMUP_RUNS; i++) {
+    DEBUG_ASSERT(SplitList(list_arena, text) == SplitIter(text));
+    ArenaClear(list_arena);
+  }
+
+  F32 list_seconds = 0;
+  F32 iter_seconds = 0;
+  U64 list_cycles  = 0;
+  U64 iter_cycles  = 0;
+  U64 list_bytes   = 0;
+  for (S32 i = 0; i < BENCHMARK_RUNS; i++) {
+    Stopwatch stopwatch;
+
+    StopwatchInit(&stopwatch);
+    PROFILE_START(STR8_SPLIT_LIST);
+    SplitList(list_arena, text);
+    PROFILE_END(STR8_SPLIT_LIST);
+    list_seconds += StopwatchReadSeconds(&stopwatch);
+    list_bytes = ArenaPos(list_arena) - sizeof(Arena);
+    ArenaClear(list_arena);
+
+    StopwatchInit(&stopwatch);
+    PROFILE_START(STR8_SPLIT_ITER);
+    SplitIter(text);
+    PROFILE_END(STR8_SPLIT_ITER);
+    iter_seconds += StopwatchReadSeconds(&stopwatch);
+
+    list_cycles += ProfileGetAnchor(STR8_SPLIT_LIST).elapsed_inclusive;
+    iter_cycles += ProfileGetAnchor(STR8_SPLIT_ITER).elapsed_inclusive;
+    ProfileReset();
+  }
+  F32 gb = (F32) text.size / (F32) GB(1);
+  LOG_INFO("Str8Split: AVG %lu cycles, %.3f GB/s, %lu MB of list nodes", list_cycles / BENCHMARK_RUNS, gb * BENCHMARK_RUNS / list_seconds, list_bytes / MB(1));
+  LOG_INFO("Str8*Iter: AVG %lu cycles, %.3f GB/s, 0 MB of list nodes", iter_cycles / BENCHMARK_RUNS, gb * BENCHMARK_RUNS / iter_seconds);
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+// NOTE: STREAM-style triad (a = b + s * c) over per-thread arrays, much larger than cache.
+#define ARRAY_SIZE  MB(16)
+#define PASSES      10
+#define MAX_THREADS 256
+
+typedef struct Worker Worker;
+struct Worker {
+  Thread thread;
+  S32 cpu; // NOTE: -1 for unpinned.
+  AtomicS32* ready;
+  AtomicB32* go;
+  F32 checksum;
+};
+
+static S32 WorkerEntry(void* arg) {
+  Worker* worker = (Worker*) arg;
+  if (worker->cpu >= 0) {
+    U32 cpu = (U32) worker->cpu;
+    DEBUG_ASSERT(ThreadSetAffinity(&cpu, 1));
+  }
+  // NOTE: allocate and first-touch after pinning, so pages land on the local NUMA node.
+  Arena* arena = _ArenaAllocate(3 * ARRAY_SIZE * sizeof(F32) + MB(1), MB(1));
+  F32* a = ARENA_PUSH_ARRAY(arena, F32, ARRAY_SIZE);
+  F32* b = ARENA_PUSH_ARRAY(arena, F32, ARRAY_SIZE);
+  F32* c = ARENA_PUSH_ARRAY(arena, F32, ARRAY_SIZE);
+  for (U32 i = 0; i < ARRAY_SIZE; i++) { a[i] = 0; b[i] = 1; c[i] = 2; }
+
+  AtomicS32FetchAdd(worker->ready, 1);
+  while (!AtomicB32Load(worker->go)) {}
+  for (U32 pass = 0; pass < PASSES; pass++) {
+    for (U32 i = 0; i < ARRAY_SIZE; i++) { a[i] = b[i] + 3.0f * c[i]; }
+    b[pass] += 1.0f;
+  }
+  worker->checksum = a[0] + a[ARRAY_SIZE - 1];
+  ArenaRelease(arena);
+  return 0;
+}
+
+// NOTE: Returns GB/s over all threads. cpus == NULL runs unpinned.
+static F32 RunTriad(U32 num_threads, U32* cpus) {
+  Worker workers[MAX_THREADS];
+  AtomicS32 ready;
+  AtomicB32 go;
+  AtomicS32Init(&ready, 0);
+  AtomicB32Init(&go, false);
+  for (U32 i = 0; i < num_threads; i++) {
+    workers[i].cpu = (cpus == NULL) ? -1 : (S32) cpus[i];
+    workers[i].ready = &ready;
+    workers[i].go = &go;
+    ThreadCreate(&workers[i].thread, WorkerEntry, &workers[i]);
+  }
+  while (AtomicS32Load(&ready) != (S32) num_threads) { SleepMs(1); }
+  Stopwatch stopwatch;
+  StopwatchInit(&stopwatch);
+  AtomicB32Store(&go, true);
+  for (U32 i = 0; i < num_threads; i++) { ThreadJoin(&workers[i].thread); }
+  F32 seconds = StopwatchReadSeconds(&stopwatch);
+  // NOTE: 2 reads, 1 write per element.
+  F32 bytes = (F32) num_threads * PASSES * ARRAY_SIZE * 3 * sizeof(F32);
+  return bytes / (F32) GB(1) / seconds;
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  TimeInit();
+  Arena* arena = ArenaAllocate();
+  CpuTopology topology;
+  DEBUG_ASSERT(CpuTopologyGet(arena, &topology));
+  LOG_INFO("%u logical cores, %u physical cores, %u NUMA nodes, L3 %u KB",
+           topology.logical_cores, topology.physical_cores, topology.numa_nodes, topology.l3_cache_size / KB(1));
+
+  U32 num_threads = MIN(topology.physical_cores, MAX_THREADS);
+  U32* spread = ARENA_PUSH_ARRAY(arena, U32, topology.physical_cores);
+  CpuTopologyOnePerPhysicalCore(&topology, spread);
+
+  // NOTE: the worst case for a memory bound pool: pairs of threads sharing SMT siblings.
+  U32* packed = ARENA_PUSH_ARRAY(arena, U32, num_threads);
+  U32 packed_size = 0;
+  for (U32 core = 0; core < topology.physical_cores && packed_size < num_threads; core++) {
+    for (U32 cpu = 0; cpu < topology.logical_cores && packed_size < num_threads; cpu++) {
+      if (topology.physical_core_ids[cpu] == core) { packed[packed_size++] = cpu; }
+    }
+  }
+
+  LOG_INFO("Unpinned,                 %u threads: %.2f GB/s", num_threads, RunTriad(num_threads, NULL));
+  LOG_INFO("Pinned 1 / physical core, %u threads: %.2f GB/s", num_threads, RunTriad(num_threads, spread));
+  if (topology.logical_cores > topology.physical_cores) {
+    LOG_INFO("Pinned to SMT siblings,   %u threads: %.2f GB/s", num_threads, RunTriad(num_threads, packed));
+  }
+  return 0;
+}
@@ -0,0 +1,152 @@
+#define PROFILE_REGISTRY(PROFILE_METRIC) \
+  PROFILE_METRIC(SPLIT_RING)             \
+  PROFILE_METRIC(VRING)
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define RING_SIZE      KB(64)
+#define MAX_RECORD     KB(4)
+#define TOTAL_BYTES    GB(1)
+#define BENCHMARK_RUNS 5
+
+// NOTE: Plain ring buffer, where every read / write that wraps is split into 2 copies.
+typedef struct SplitRing SplitRing;
+struct SplitRing {
+  U8* data;
+  U64 capacity;
+  U64 write_pos;
+  U64 read_pos;
+};
+
+static B32 SplitRingWrite(SplitRing* ring, void* src, U64 size) {
+  if (ring->capacity - (ring->write_pos - ring->read_pos) < size) { return false; }
+  U64 offset = ring->write_pos & (ring->capacity - 1);
+  U64 first  = MIN(size, ring->capacity - offset);
+  MEMORY_COPY_SIZE(ring->data + offset, src, first);
+  MEMORY_COPY_SIZE(ring->data, (U8*) src + first, size - first);
+  ring->write_pos += size;
+  return true;
+}
+
+static B32 SplitRingRead(SplitRing* ring, void* dest, U64 size) {
+  if (ring->write_pos - ring->read_pos < size) { return false; }
+  U64 offset = ring->read_pos & (ring->capacity - 1);
+  U64 first  = MIN(size, ring->capacity - offset);
+  MEMORY_COPY_SIZE(dest, ring->data + offset, first);
+  MEMORY_COPY_SIZE((U8*) dest + first, ring->data, size - first);
+  ring->read_pos += size;
+  return true;
+}
+
+static U64 Checksum(U8* data, U32 size) {
+  U64 result = 0;
+  for (U32 i = 0; i < size; i++) { result += data[i]; }
+  return result;
+}
+
+// NOTE: Producer writes [U32 size][payload] records, consumer checksums each payload.
+// The split ring has to copy each record out to be able to look at it contiguously, the
+// vring can be read in place.
+static U64 RunSplitRing(SplitRing* ring, U8* payload, U32* sizes, U32 sizes_count, U8* scratch) {
+  U64 result = 0;
+  U64 moved  = 0;
+  U32 next   = 0;
+  while (moved < TOTAL_BYTES) {
+    while (true) {
+      U32 size = sizes[next % sizes_count];
+      if (ring->capacity - (ring->write_pos - ring->read_pos) < sizeof(U32) + size) { break; }
+      SplitRingWrite(ring, &size, sizeof(size));
+      SplitRingWrite(ring, payload, size);
+      next++;
+    }
+    U32 size;
+    while (SplitRingRead(ring, &size, sizeof(size))) {
+      SplitRingRead(ring, scratch, size);
+      result += Checksum(scratch, size);
+      moved  += size;
+    }
+  }
+  return result;
+}
+
+static U64 RunVRing(VRingBuffer* ring, U8* payload, U32* sizes, U32 sizes_count) {
+  U64 result = 0;
+  U64 moved  = 0;
+  U32 next   = 0;
+  while (moved < TOTAL_BYTES) {
+    while (true) {
+      U32 size = sizes[next % sizes_count];
+      U64 available;
+      U8* dest = VRingBufferWriteBegin(ring, &available);
+      if (available < sizeof(U32) + size) { break; }
+      MEMORY_COPY_SIZE(dest, &size, sizeof(size));
+      MEMORY_COPY_SIZE(dest + sizeof(size), payload, size);
+      VRingBufferWriteCommit(ring, sizeof(size) + size);
+      next++;
+    }
+    U64 available;
+    U8* src = VRingBufferReadBegin(ring, &available);
+    U64 consumed = 0;
+    while (consumed < available) {
+      U32 size = *(U32*) (src + consumed);
+      result   += Checksum(src + consumed + sizeof(U32), size);
+      consumed += sizeof(U32) + size;
+      moved    += size;
+    }
+    VRingBufferReadCommit(ring, consumed);
+  }
+  return result;
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  TimeInit();
+  Arena* arena = ArenaAllocate();
+
+  U8* payload = ARENA_PUSH_ARRAY(arena, U8, MAX_RECORD);
+  U8* scratch = ARENA_PUSH_ARRAY(arena, U8, MAX_RECORD);
+  U32 sizes[1024];
+  RandSeed(NULL, 12345);
+  for (U32 i = 0; i < MAX_RECORD; i++) { payload[i] = (U8) RandU32(NULL, 0, 255); }
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(sizes); i++) { sizes[i] = RandU32(NULL, 1, MAX_RECORD); }
+
+  SplitRing split_ring;
+  MEMORY_ZERO_STRUCT(&split_ring);
+  split_ring.capacity = RING_SIZE;
+  split_ring.data = ARENA_PUSH_ARRAY(arena, U8, RING_SIZE);
+  VRingBuffer vring;
+  DEBUG_ASSERT(VRingBufferInit(&vring, RING_SIZE));
+  DEBUG_ASSERT(vring.capacity == RING_SIZE);
+
+  F32 split_seconds = 0;
+  F32 vring_seconds = 0;
+  U64 split_cycles  = 0;
+  U64 vring_cycles  = 0;
+  for (S32 i = 0; i < BENCHMARK_RUNS; i++) {
+    Stopwatch stopwatch;
+
+    StopwatchInit(&stopwatch);
+    PROFILE_START(SPLIT_RING);
+    U64 split_result = RunSplitRing(&split_ring, payload, sizes, STATIC_ARRAY_SIZE(sizes), scratch);
+    PROFILE_END(SPLIT_RING);
+    split_seconds += StopwatchReadSeconds(&stopwatch);
+
+    StopwatchInit(&stopwatch);
+    PROFILE_START(VRING);
+    U64 vring_result = RunVRing(&vring, payload, sizes, STATIC_ARRAY_SIZE(sizes));
+    PROFILE_END(VRING);
+    vring_seconds += StopwatchReadSeconds(&stopwatch);
+    DEBUG_ASSERT(split_result == vring_result);
+
+    split_cycles += ProfileGetAnchor(SPLIT_RING).elapsed_inclusive;
+    vring_cycles += ProfileGetAnchor(VRING).elapsed_inclusive;
+    ProfileReset();
+  }
+  F32 gb = (F32) TOTAL_BYTES / (F32) GB(1);
+  LOG_INFO("Split-copy ring: AVG %lu cycles, %.3f GB/s", split_cycles / BENCHMARK_RUNS, gb * BENCHMARK_RUNS / split_seconds);
+  LOG_INFO("VRingBuffer:     AVG %lu cycles, %.3f GB/s", vring_cycles / BENCHMARK_RUNS, gb * BENCHMARK_RUNS / vring_seconds);
+
+  VRingBufferDeinit(&vring);
+  return 0;
+}
@@ -2,8 +2,13 @@
 #define CDEFAULT_H_
 
 // NOTE: this just provides a convenient shorthand to #include all cdefault modules.
+// Modules that need platform libraries can be left out by #defining CDEFAULT_NO_AUDIO (pulseaudio on linux) or
+// CDEFAULT_NO_RENDER (windows only), e.g. for headless tools. No other module depends on them.
 
+#ifndef CDEFAULT_NO_AUDIO
 #include "cdefault_audio.h"
+#endif
+#include "cdefault_bench.h"
 #include "cdefault_font.h"
 #include "cdefault_geometry.h"
 #include "cdefault_image.h"
@@ -14,7 +19,9 @@
 #include "cdefault_physics_2d.h"
 #include "cdefault_physics_3d.h"
 #include "cdefault_profile.h"
+#ifndef CDEFAULT_NO_RENDER
 #include "cdefault_render.h"
+#endif
 #include "cdefault_sound.h"
 #include "cdefault_std.h"
 #include "cdefault_test.h"
@@ -25,8 +32,12 @@
 #ifdef CDEFAULT_IMPLEMENTATION
 #undef CDEFAULT_IMPLEMENTATION
 
+#ifndef CDEFAULT_NO_AUDIO
 #define CDEFAULT_AUDIO_IMPLEMENTATION
 #include "cdefault_audio.h"
+#endif
+#define CDEFAULT_BENCH_IMPLEMENTATION
+#include "cdefault_bench.h"
 #define CDEFAULT_FONT_IMPLEMENTATION
 #include "cdefault_font.h"
 #define CDEFAULT_GEOMETRY_IMPLEMENTATION
@@ -47,8 +58,10 @@
 #include "cdefault_physics_3d.h"
 #define CDEFAULT_PROFILE_IMPLEMENTATION
 #include "cdefault_profile.h"
+#ifndef CDEFAULT_NO_RENDER
 #define CDEFAULT_RENDER_IMPLEMENTATION
 #include "cdefault_render.h"
+#endif
 #define CDEFAULT_SOUND_IMPLEMENTATION
 #include "cdefault_sound.h"
 #define CDEFAULT_STD_IMPLEMENTATION
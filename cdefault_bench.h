@@ -0,0 +1,428 @@
+#ifndef CDEFAULT_BENCH_H_
+#define CDEFAULT_BENCH_H_
+
+#include "cdefault_std.h"
+#include "cdefault_io.h"
+#include "cdefault_math.h"
+#include "cdefault_json.h"
+
+// NOTE: this implements a framework for statistical micro / macro benchmarks, in the spirit of cdefault_test.h.
+// Each benchmark is run in samples of a calibrated number of iterations (so that a sample takes at least
+// BENCH_SAMPLE_SECONDS), after BENCH_WARMUP_SECONDS of warmup. Per-iteration times are reported as the median,
+// median absolute deviation (MAD) and percentiles over samples, which are far less sensitive to outliers than
+// min / max / average.
+//
+// e.g.
+//
+// BENCH(MyBench) {
+//   MyData* data = MySetup();                  // NOTE: Anything outside of the BenchLoop is not timed.
+//   bench->bytes_per_iteration = MY_DATA_SIZE; // NOTE: Optional, enables throughput reporting.
+//   while (BenchLoop(bench)) {
+//     U64 result = MyFunction(data);
+//     BENCH_DO_NOT_OPTIMIZE(result);
+//   }
+// }
+//
+// int main(int argc, char** argv) {
+//   RUN_BENCH(MyBench);
+//   return BenchMain(argc, argv);
+// }
+//
+// BenchMain logs the report and understands the following arguments:
+//   --json <path>      Writes results as JSON, e.g. to be used as a baseline later.
+//   --csv <path>       Writes results as CSV.
+//   --baseline <path>  Compares results against a previous --json dump, returns non-zero on regressions.
+//   --threshold <x>    Relative slowdown (of the median) that counts as a regression, defaults to BENCH_REGRESSION_THRESHOLD.
+
+#ifndef BENCH_WARMUP_SECONDS
+#define BENCH_WARMUP_SECONDS 0.1
+#endif
+#ifndef BENCH_SAMPLE_SECONDS
+#define BENCH_SAMPLE_SECONDS 0.01
+#endif
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 50
+#endif
+// NOTE: Slow benchmarks stop sampling after BENCH_MAX_SECONDS, but always collect at least BENCH_MIN_SAMPLES.
+#ifndef BENCH_MAX_SECONDS
+#define BENCH_MAX_SECONDS 5.0
+#endif
+#ifndef BENCH_MIN_SAMPLES
+#define BENCH_MIN_SAMPLES 5
+#endif
+#ifndef BENCH_REGRESSION_THRESHOLD
+#define BENCH_REGRESSION_THRESHOLD 0.05
+#endif
+
+typedef struct Bench Bench;
+struct Bench {
+  U64 iterations;          // NOTE: Iterations per sample, chosen by the harness.
+  U64 bytes_per_iteration; // NOTE: Optionally set by the benchmark to report throughput.
+  U64 _iteration;
+  U64 _start;
+  U64 _paused_at;
+  U64 _elapsed;
+};
+
+// NOTE: All benchmark functions must have this signature, prefer declaring them with BENCH(name).
+typedef void Bench_Fn(Bench* bench);
+
+#define BENCH(name) void name(Bench* bench)
+#define RUN_BENCH(name) _RunBench(Str8Lit(#name), name) // NOTE: Each benchmark must be invoked in main via RUN_BENCH(name).
+
+B32  BenchLoop(Bench* bench);   // NOTE: Drives the timed loop, i.e. while (BenchLoop(bench)) { ... }. Must be run to completion.
+void BenchPause(Bench* bench);  // NOTE: Excludes work inside of the loop from timing, e.g. per-iteration resets.
+void BenchResume(Bench* bench);
+
+// NOTE: BENCH_DO_NOT_OPTIMIZE forces the value of x (an lvalue) to be computed and stored, so the work producing it
+// can't be eliminated. BENCH_CLOBBER forces all pending memory writes to be performed.
+#if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
+#  define BENCH_DO_NOT_OPTIMIZE(x) __asm__ volatile("" : : "g"(&(x)) : "memory")
+#  define BENCH_CLOBBER()          __asm__ volatile("" : : : "memory")
+#elif defined(COMPILER_MSVC)
+#  define BENCH_DO_NOT_OPTIMIZE(x) _BenchEscape((void*) &(x))
+#  define BENCH_CLOBBER()          _ReadWriteBarrier()
+#endif
+void _BenchEscape(void* ptr);
+
+// NOTE: All times are in nanoseconds per iteration.
+typedef struct BenchStats BenchStats;
+struct BenchStats {
+  U32 samples_size;
+  U64 iterations; // NOTE: Per sample.
+  F64 min_ns;
+  F64 max_ns;
+  F64 mean_ns;
+  F64 median_ns;
+  F64 mad_ns;
+  F64 p90_ns;
+  F64 p99_ns;
+  F64 gb_per_second; // NOTE: At the median, 0 if bytes_per_iteration isn't set.
+};
+BenchStats BenchStatsCompute(F64* samples_ns, U32 samples_size); // NOTE: Clobbers samples_ns.
+
+typedef struct BenchResult BenchResult;
+struct BenchResult {
+  String8 name;
+  U64 bytes_per_iteration;
+  BenchStats stats;
+  BenchResult* next;
+};
+BenchResult* BenchGetResults(); // NOTE: In the order benchmarks were run.
+
+void    LogBenchReport(); // NOTE: Prints a table of all results to stdout.
+String8 BenchReportToJson(Arena* arena); // NOTE: { "benchmarks": [ { "name", "median_ns", ... }, ... ] }
+String8 BenchReportToCsv(Arena* arena);  // NOTE: One header row, then one row per benchmark.
+U32     BenchCompareBaseline(String8 baseline_json, F64 threshold); // NOTE: Logs and returns the number of regressions.
+S32     BenchMain(int argc, char** argv); // NOTE: See above. Returns the process exit code.
+
+void _RunBench(String8 name, Bench_Fn* bench_fn);
+
+#endif // CDEFAULT_BENCH_H_
+
+#ifdef CDEFAULT_BENCH_IMPLEMENTATION
+#undef CDEFAULT_BENCH_IMPLEMENTATION
+
+typedef struct BenchContext BenchContext;
+struct BenchContext {
+  Arena* arena;
+  B32 is_initialized;
+  BenchResult* results_head;
+  BenchResult* results_tail;
+};
+static BenchContext _cdef_bench_context;
+static void* volatile _cdef_bench_escape;
+
+#if defined(OS_WINDOWS)
+
+static U64 _BenchReadTimerNs() {
+  static LARGE_INTEGER freq;
+  if (freq.QuadPart == 0) { QueryPerformanceFrequency(&freq); }
+  LARGE_INTEGER value;
+  QueryPerformanceCounter(&value);
+  return (U64) ((F64) value.QuadPart * (1000000000.0 / (F64) freq.QuadPart));
+}
+
+#else
+
+static U64 _BenchReadTimerNs() {
+  struct timespec value;
+  clock_gettime(CLOCK_MONOTONIC, &value);
+  return (U64) value.tv_sec * 1000000000 + value.tv_nsec;
+}
+
+#endif
+
+void _BenchEscape(void* ptr) {
+  _cdef_bench_escape = ptr;
+#if defined(COMPILER_MSVC)
+  _ReadWriteBarrier();
+#endif
+}
+
+B32 BenchLoop(Bench* bench) {
+  if (bench->_iteration == 0) { bench->_start = _BenchReadTimerNs(); }
+  if (bench->_iteration < bench->iterations) {
+    bench->_iteration++;
+    return true;
+  }
+  bench->_elapsed = _BenchReadTimerNs() - bench->_start;
+  return false;
+}
+
+void BenchPause(Bench* bench) {
+  bench->_paused_at = _BenchReadTimerNs();
+}
+
+void BenchResume(Bench* bench) {
+  bench->_start += _BenchReadTimerNs() - bench->_paused_at;
+}
+
+// NOTE: SortCompareF64Asc truncates the difference to an S32, which is too coarse for sub-ns deltas.
+static S32 _BenchCompareF64(void* a, void* b) {
+  F64 x = *(F64*) a;
+  F64 y = *(F64*) b;
+  return (x > y) - (x < y);
+}
+
+static F64 _BenchPercentile(F64* sorted, U32 size, F64 percentile) {
+  S32 idx = (S32) F64Ceil(percentile * size) - 1;
+  return sorted[CLAMP(0, idx, (S32) size - 1)];
+}
+
+static F64 _BenchMedian(F64* sorted, U32 size) {
+  if (size % 2 == 1) { return sorted[size / 2]; }
+  return (sorted[size / 2 - 1] + sorted[size / 2]) / 2.0;
+}
+
+BenchStats BenchStatsCompute(F64* samples_ns, U32 samples_size) {
+  BenchStats stats;
+  MEMORY_ZERO_STRUCT(&stats);
+  if (samples_size == 0) { return stats; }
+
+  F64 temp;
+  _Sort(samples_ns, samples_size, sizeof(F64), _BenchCompareF64, &temp);
+  F64 sum = 0;
+  for (U32 i = 0; i < samples_size; i++) { sum += samples_ns[i]; }
+  stats.samples_size = samples_size;
+  stats.min_ns    = samples_ns[0];
+  stats.max_ns    = samples_ns[samples_size - 1];
+  stats.mean_ns   = sum / samples_size;
+  stats.median_ns = _BenchMedian(samples_ns, samples_size);
+  stats.p90_ns    = _BenchPercentile(samples_ns, samples_size, 0.90);
+  stats.p99_ns    = _BenchPercentile(samples_ns, samples_size, 0.99);
+
+  for (U32 i = 0; i < samples_size; i++) { samples_ns[i] = F64Abs(samples_ns[i] - stats.median_ns); }
+  _Sort(samples_ns, samples_size, sizeof(F64), _BenchCompareF64, &temp);
+  stats.mad_ns = _BenchMedian(samples_ns, samples_size);
+  return stats;
+}
+
+static U64 _BenchRunSample(Bench* bench, Bench_Fn* bench_fn, U64 iterations) {
+  bench->iterations = iterations;
+  bench->_iteration = 0;
+  bench->_elapsed   = 0;
+  bench_fn(bench);
+  DEBUG_ASSERT(bench->_iteration == iterations);
+  return bench->_elapsed;
+}
+
+void _RunBench(String8 name, Bench_Fn* bench_fn) {
+  BenchContext* c = &_cdef_bench_context;
+  if (!c->is_initialized) {
+    MEMORY_ZERO_STRUCT(c);
+    c->arena = ArenaAllocate();
+    c->is_initialized = true;
+  }
+
+  Bench bench;
+  MEMORY_ZERO_STRUCT(&bench);
+  U64 start_ns  = _BenchReadTimerNs();
+  U64 sample_ns = (U64) (BENCH_SAMPLE_SECONDS * 1000000000.0);
+
+  // NOTE: Grow the iteration count until a sample takes at least BENCH_SAMPLE_SECONDS, this doubles as warmup.
+  U64 iterations = 1;
+  U64 elapsed_ns = _BenchRunSample(&bench, bench_fn, iterations);
+  while (elapsed_ns < sample_ns) {
+    F64 scale = (elapsed_ns == 0) ? 10.0 : (1.2 * sample_ns / elapsed_ns);
+    iterations = MAX(iterations + 1, (U64) (iterations * CLAMP(1.0, scale, 10.0)));
+    elapsed_ns = _BenchRunSample(&bench, bench_fn, iterations);
+  }
+  while (_BenchReadTimerNs() - start_ns < (U64) (BENCH_WARMUP_SECONDS * 1000000000.0)) {
+    _BenchRunSample(&bench, bench_fn, iterations);
+  }
+
+  U64 arena_pos = ArenaPos(c->arena);
+  F64* samples = ARENA_PUSH_ARRAY(c->arena, F64, BENCH_SAMPLES);
+  U32 samples_size = 0;
+  U64 sampling_start_ns = _BenchReadTimerNs();
+  while (samples_size < BENCH_SAMPLES) {
+    samples[samples_size++] = (F64) _BenchRunSample(&bench, bench_fn, iterations) / (F64) iterations;
+    if (samples_size >= BENCH_MIN_SAMPLES &&
+        _BenchReadTimerNs() - sampling_start_ns > (U64) (BENCH_MAX_SECONDS * 1000000000.0)) {
+      break;
+    }
+  }
+  BenchStats stats = BenchStatsCompute(samples, samples_size);
+  stats.iterations = iterations;
+  if (bench.bytes_per_iteration > 0 && stats.median_ns > 0) {
+    stats.gb_per_second = ((F64) bench.bytes_per_iteration / (F64) GB(1)) / (stats.median_ns / 1000000000.0);
+  }
+  ArenaPopTo(c->arena, arena_pos);
+
+  BenchResult* result = ARENA_PUSH_STRUCT(c->arena, BenchResult);
+  MEMORY_ZERO_STRUCT(result);
+  result->name = name;
+  result->bytes_per_iteration = bench.bytes_per_iteration;
+  result->stats = stats;
+  SLL_QUEUE_PUSH_BACK(c->results_head, c->results_tail, result, next);
+}
+
+BenchResult* BenchGetResults() {
+  return _cdef_bench_context.results_head;
+}
+
+void LogBenchReport() {
+  Arena* arena = ArenaAllocate();
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  Str8ListAppend(arena, &list, Str8Format(arena, "%-32s %12s %8s %14s %10s %14s %14s %14s %10s\n",
+                                          "benchmark", "iterations", "samples", "median (ns)", "mad (%)",
+                                          "p90 (ns)", "p99 (ns)", "min (ns)", "GB/s"));
+  for (BenchResult* result = BenchGetResults(); result != NULL; result = result->next) {
+    BenchStats* s = &result->stats;
+    F64 mad_percent = (s->median_ns > 0) ? (100.0 * s->mad_ns / s->median_ns) : 0;
+    Str8ListAppend(arena, &list, Str8Format(arena, "%-32S %12llu %8u %14.2f %10.2f %14.2f %14.2f %14.2f %10.3f\n",
+                                            result->name, s->iterations, s->samples_size, s->median_ns, mad_percent,
+                                            s->p90_ns, s->p99_ns, s->min_ns, s->gb_per_second));
+  }
+  String8 report = Str8ListJoin(arena, &list);
+  LOG_NO_PREFIX("%.*s", report.size, report.str);
+  ArenaRelease(arena);
+}
+
+String8 BenchReportToJson(Arena* arena) {
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  Str8ListAppend(arena, &list, Str8Lit("{\"benchmarks\":["));
+  for (BenchResult* result = BenchGetResults(); result != NULL; result = result->next) {
+    BenchStats* s = &result->stats;
+    Str8ListAppend(arena, &list, Str8Format(arena, "%S{\"name\":\"%S\",\"iterations\":%llu,\"samples\":%u,"
+                                            "\"median_ns\":%.3f,\"mad_ns\":%.3f,\"mean_ns\":%.3f,"
+                                            "\"min_ns\":%.3f,\"max_ns\":%.3f,\"p90_ns\":%.3f,\"p99_ns\":%.3f,"
+                                            "\"bytes_per_iteration\":%llu,\"gb_per_second\":%.6f}",
+                                            result == BenchGetResults() ? Str8Lit("") : Str8Lit(","),
+                                            result->name, s->iterations, s->samples_size,
+                                            s->median_ns, s->mad_ns, s->mean_ns, s->min_ns, s->max_ns, s->p90_ns, s->p99_ns,
+                                            result->bytes_per_iteration, s->gb_per_second));
+  }
+  Str8ListAppend(arena, &list, Str8Lit("]}"));
+  return Str8ListJoin(arena, &list);
+}
+
+String8 BenchReportToCsv(Arena* arena) {
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  Str8ListAppend(arena, &list, Str8Lit("name,iterations,samples,median_ns,mad_ns,mean_ns,min_ns,max_ns,p90_ns,p99_ns,bytes_per_iteration,gb_per_second\n"));
+  for (BenchResult* result = BenchGetResults(); result != NULL; result = result->next) {
+    BenchStats* s = &result->stats;
+    Str8ListAppend(arena, &list, Str8Format(arena, "%S,%llu,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu,%.6f\n",
+                                            result->name, s->iterations, s->samples_size,
+                                            s->median_ns, s->mad_ns, s->mean_ns, s->min_ns, s->max_ns, s->p90_ns, s->p99_ns,
+                                            result->bytes_per_iteration, s->gb_per_second));
+  }
+  return Str8ListJoin(arena, &list);
+}
+
+// NOTE: A benchmark regresses if its median slowed down by more than threshold, and by more than its own MAD (so
+// noisy benchmarks don't get flagged for jitter).
+U32 BenchCompareBaseline(String8 baseline_json, F64 threshold) {
+  U32 regressions = 0;
+  Arena* arena = ArenaAllocate();
+  JsonObject baseline;
+  JsonArray benchmarks;
+  if (!JsonParse(arena, &baseline, baseline_json) ||
+      !JsonObjectGetArray(baseline, Str8Lit("benchmarks"), &benchmarks)) {
+    LOG_ERROR("[BENCH] Failed to parse benchmark baseline.");
+    goto bench_compare_baseline_exit;
+  }
+
+  for (BenchResult* result = BenchGetResults(); result != NULL; result = result->next) {
+    B32 found = false;
+    for (JsonArrayNode* node = benchmarks.head; node != NULL; node = node->next) {
+      JsonObject entry;
+      String8 name;
+      F32 base_median_ns;
+      if (!JsonValueGetObject(&node->value, &entry)) { continue; }
+      if (!JsonObjectGetString(entry, Str8Lit("name"), &name) || !Str8Eq(name, result->name)) { continue; }
+      if (!JsonObjectGetNumber(entry, Str8Lit("median_ns"), &base_median_ns) || base_median_ns <= 0) { continue; }
+      found = true;
+
+      BenchStats* s = &result->stats;
+      F64 delta = s->median_ns - base_median_ns;
+      F64 change = delta / base_median_ns;
+      if (change > threshold && delta > s->mad_ns) {
+        regressions++;
+        LOG_NO_PREFIX("[" ANSI_COLOR_RED "REGRESSION" ANSI_COLOR_RESET "] %S: %.2f ns -> %.2f ns (+%.2f%%)",
+                      result->name, (F64) base_median_ns, s->median_ns, change * 100.0);
+      } else if (change < -threshold && -delta > s->mad_ns) {
+        LOG_NO_PREFIX("[" ANSI_COLOR_GREEN "IMPROVEMENT" ANSI_COLOR_RESET "] %S: %.2f ns -> %.2f ns (-%.2f%%)",
+                      result->name, (F64) base_median_ns, s->median_ns, -change * 100.0);
+      }
+      break;
+    }
+    if (!found) { LOG_NO_PREFIX("[" ANSI_COLOR_YELLOW "NEW" ANSI_COLOR_RESET "] %S: no baseline", result->name); }
+  }
+
+bench_compare_baseline_exit:
+  ArenaRelease(arena);
+  return regressions;
+}
+
+S32 BenchMain(int argc, char** argv) {
+  S32 exit_code = 0;
+  Arena* arena = ArenaAllocate();
+  String8 json_path     = Str8Lit("");
+  String8 csv_path      = Str8Lit("");
+  String8 baseline_path = Str8Lit("");
+  F64 threshold = BENCH_REGRESSION_THRESHOLD;
+  for (S32 i = 1; i + 1 < argc; i += 2) {
+    String8 arg   = Str8CStr(argv[i]);
+    String8 value = Str8CStr(argv[i + 1]);
+    if      (Str8Eq(arg, Str8Lit("--json")))     { json_path = value; }
+    else if (Str8Eq(arg, Str8Lit("--csv")))      { csv_path = value; }
+    else if (Str8Eq(arg, Str8Lit("--baseline"))) { baseline_path = value; }
+    else if (Str8Eq(arg, Str8Lit("--threshold"))) {
+      F32 parsed;
+      if (Str8ToF32(value, &parsed) > 0) { threshold = parsed; }
+      else { LOG_ERROR("[BENCH] Invalid threshold: %S", value); exit_code = 1; }
+    } else {
+      LOG_ERROR("[BENCH] Unknown argument: %S", arg);
+      exit_code = 1;
+    }
+  }
+
+  LogBenchReport();
+  if (json_path.size > 0) {
+    String8 json = BenchReportToJson(arena);
+    if (!FileDump(json_path, json.str, json.size)) { LOG_ERROR("[BENCH] Failed to write %S", json_path); exit_code = 1; }
+  }
+  if (csv_path.size > 0) {
+    String8 csv = BenchReportToCsv(arena);
+    if (!FileDump(csv_path, csv.str, csv.size)) { LOG_ERROR("[BENCH] Failed to write %S", csv_path); exit_code = 1; }
+  }
+  if (baseline_path.size > 0) {
+    String8 baseline;
+    if (!FileReadAll(arena, baseline_path, &baseline.str, &baseline.size)) {
+      LOG_ERROR("[BENCH] Failed to read baseline %S", baseline_path);
+      exit_code = 1;
+    } else if (BenchCompareBaseline(baseline, threshold) > 0) {
+      exit_code = 1;
+    }
+  }
+
+  ArenaRelease(arena);
+  return exit_code;
+}
+
+#endif // CDEFAULT_BENCH_IMPLEMENTATION
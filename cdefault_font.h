@@ -5,6 +5,7 @@
 #include "cdefault_io.h"
 #include "cdefault_math.h"
 #include "cdefault_image.h"
+#include "cdefault_profile.h"
 
 // TODO: better atlas fitting / packing
 // TODO: separate? arenas for image and atlas, since the texture can be released after gpu upload.
@@ -144,6 +145,11 @@ B32 FontAtlasPlace(FontAtlas* atlas, U32 codepoint, U32 codepoint_next, F32 pixe
 void FontAtlasGetAttributes(FontAtlas* atlas, F32 pixel_height, F32* ascent, F32* descent);
 B32 FontAtlasMeasureString(FontAtlas* atlas, F32 pixel_height, String8 str, V2* size);
 
+// NOTE: Bakes the atlas (metrics, glyph rects and kerning) and its bitmap into an asset pack, see cdefault_io.h.
+B32 FontAtlasPackAdd(PackWriter* writer, String8 name, FontAtlas* atlas, Image* bitmap);
+// NOTE: The atlas's chars and kerns are pushed on arena, bitmap->data points into the (read-only) pack.
+B32 FontAtlasPackGet(Arena* arena, Pack* pack, String8 name, FontAtlas* atlas, Image* bitmap);
+
 FontCharSet* FontCharSetLatin();
 FontCharSet* FontCharSetConcat(FontCharSet* set, FontCharSet* to_concat);
 
@@ -345,31 +351,32 @@ static B32 FontAtlasBuildKernTable(Arena* arena, Font* font, FontAtlas* atlas, F
 }
 #undef BIN_CATCH
 
+// NOTE: the font file is only needed while baking, so map it rather than copying it into an arena.
 B32 FontAtlasBakeBitmapFromFile(Arena* atlas_arena, Arena* bitmap_arena, FontAtlas* atlas, Image* bitmap, F32 pixel_height, FontCharSet* char_set, String8 file_path) {
   B32 success = false;
-  Arena* file_arena = ArenaAllocate();
-  String8 ttf_data;
-  if (!FileReadAll(file_arena, file_path, &ttf_data.str, &ttf_data.size)) { goto font_atlas_bake_bitmap_from_file_exit; }
+  FileMap ttf_map;
+  if (!FileMapOpen(file_path, &ttf_map, FileMapHint_None)) { return false; }
+  if (ttf_map.size > U32_MAX) { goto font_atlas_bake_bitmap_from_file_exit; }
   Font font;
-  if (!FontInit(&font, ttf_data.str, ttf_data.size)) { goto font_atlas_bake_bitmap_from_file_exit; }
+  if (!FontInit(&font, ttf_map.data, ttf_map.size)) { goto font_atlas_bake_bitmap_from_file_exit; }
   if (!FontAtlasBakeBitmap(atlas_arena, bitmap_arena, &font, atlas, bitmap, pixel_height, char_set)) { goto font_atlas_bake_bitmap_from_file_exit; }
   success = true;
 font_atlas_bake_bitmap_from_file_exit:
-  ArenaRelease(file_arena);
+  DEBUG_ASSERT(FileMapClose(&ttf_map));
   return success;
 }
 
 B32 FontAtlasBakeSdfFromFile(Arena* atlas_arena, Arena* bitmap_arena, FontAtlas* atlas, Image* bitmap, F32 bmp_pixel_height, F32 sdf_pixel_height, F32 spread_factor, FontCharSet* char_set, String8 file_path) {
   B32 success = false;
-  Arena* file_arena = ArenaAllocate();
-  String8 ttf_data;
-  if (!FileReadAll(file_arena, file_path, &ttf_data.str, &ttf_data.size)) { goto font_atlas_bake_sdf_from_file_exit; }
+  FileMap ttf_map;
+  if (!FileMapOpen(file_path, &ttf_map, FileMapHint_None)) { return false; }
+  if (ttf_map.size > U32_MAX) { goto font_atlas_bake_sdf_from_file_exit; }
   Font font;
-  if (!FontInit(&font, ttf_data.str, ttf_data.size)) { goto font_atlas_bake_sdf_from_file_exit; }
+  if (!FontInit(&font, ttf_map.data, ttf_map.size)) { goto font_atlas_bake_sdf_from_file_exit; }
   if (!FontAtlasBakeSdf(atlas_arena, bitmap_arena, &font, atlas, bitmap, bmp_pixel_height, sdf_pixel_height, spread_factor, char_set)) { goto font_atlas_bake_sdf_from_file_exit; }
   success = true;
 font_atlas_bake_sdf_from_file_exit:
-  ArenaRelease(file_arena);
+  DEBUG_ASSERT(FileMapClose(&ttf_map));
   return success;
 }
 
@@ -1122,6 +1129,7 @@ B32 FontGlyphShapeRasterize(GlyphShape* glyph_shape, U8** bmp, U32 bmp_width, U3
 }
 
 B32 FontAtlasBakeBitmap(Arena* atlas_arena, Arena* bitmap_arena, Font* font, FontAtlas* atlas, Image* bitmap, F32 pixel_height, FontCharSet* char_set) {
+  CDEFAULT_PROFILE_START(FONT_ATLAS_BAKE_BITMAP);
   B32 success  = false;
   U64 atlas_arena_base_pos = ArenaPos(atlas_arena);
   U64 image_arena_base_pos = ArenaPos(bitmap_arena);
@@ -1229,11 +1237,13 @@ font_atlas_bake_bitmap_end:
     ArenaPopTo(atlas_arena, atlas_arena_base_pos);
     ArenaPopTo(bitmap_arena, image_arena_base_pos);
   }
+  CDEFAULT_PROFILE_END(FONT_ATLAS_BAKE_BITMAP);
   return success;
 }
 
 // https://steamcdn-a.akamaihd.net/apps/valve/2007/SIGGRAPH2007_AlphaTestedMagnification.pdf
 B32 FontAtlasBakeSdf(Arena* atlas_arena, Arena* bitmap_arena, Font* font, FontAtlas* atlas, Image* bitmap, F32 bmp_pixel_height, F32 sdf_pixel_height, F32 spread_factor, FontCharSet* char_set) {
+  CDEFAULT_PROFILE_START(FONT_ATLAS_BAKE_SDF);
   B32 success = false;
   Arena* temp_arena = ArenaAllocate();
   U64 atlas_arena_base_pos = ArenaPos(atlas_arena);
@@ -1402,6 +1412,7 @@ font_atlas_bake_sdf_end:
     ArenaPopTo(bitmap_arena, image_arena_base_pos);
   }
   ArenaRelease(temp_arena);
+  CDEFAULT_PROFILE_END(FONT_ATLAS_BAKE_SDF);
   return success;
 }
 
@@ -1491,6 +1502,155 @@ void FontAtlasGetAttributes(FontAtlas* atlas, F32 pixel_height, F32* ascent, F32
   if (descent != NULL) { *descent  = atlas->descent * scale; }
 }
 
+// NOTE: a baked atlas is a FontAtlasPackHeader, then its chars, then its kerns, then the bitmap's pixels.
+// Every section starts on a FONT_ATLAS_PACK_ALIGNMENT boundary.
+#define FONT_ATLAS_PACK_ALIGNMENT 16
+
+typedef struct FontAtlasPackHeader FontAtlasPackHeader;
+struct FontAtlasPackHeader {
+  F32 scale_coeff;
+  F32 ascent;
+  F32 descent;
+  U32 chars_size;
+  U32 kerns_size;
+  U32 bitmap_format;
+  U32 bitmap_width;
+  U32 bitmap_height;
+};
+
+typedef struct FontAtlasPackChar FontAtlasPackChar;
+struct FontAtlasPackChar {
+  U32 codepoint;
+  F32 advance;
+  V2  offset;
+  V2  size;
+  V2  uv_min;
+  V2  uv_max;
+};
+
+typedef struct FontAtlasPackKern FontAtlasPackKern;
+struct FontAtlasPackKern {
+  U32 codepoint_left;
+  U32 codepoint_right;
+  F32 advance;
+};
+
+static B32 FontAtlasPackPad(PackWriter* writer, U64 section_size) {
+  static U8 zeros[FONT_ATLAS_PACK_ALIGNMENT];
+  return PackWriterAppend(writer, zeros, ALIGN_POW_2(section_size, FONT_ATLAS_PACK_ALIGNMENT) - section_size);
+}
+
+B32 FontAtlasPackAdd(PackWriter* writer, String8 name, FontAtlas* atlas, Image* bitmap) {
+  FontAtlasPackHeader header;
+  MEMORY_ZERO_STRUCT(&header);
+  header.scale_coeff   = atlas->scale_coeff;
+  header.ascent        = atlas->ascent;
+  header.descent       = atlas->descent;
+  header.bitmap_format = bitmap->format;
+  header.bitmap_width  = bitmap->width;
+  header.bitmap_height = bitmap->height;
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(atlas->char_map); i++) {
+    for (AtlasChar* c = atlas->char_map[i]; c != NULL; c = c->next) { header.chars_size++; }
+  }
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(atlas->kern_map); i++) {
+    for (GlyphKernInfo* k = atlas->kern_map[i]; k != NULL; k = k->next) { header.kerns_size++; }
+  }
+
+  if (!PackWriterBegin(writer, name)) { return false; }
+  if (!PackWriterAppend(writer, (U8*) &header, sizeof(header))) { return false; }
+  if (!FontAtlasPackPad(writer, sizeof(header))) { return false; }
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(atlas->char_map); i++) {
+    for (AtlasChar* c = atlas->char_map[i]; c != NULL; c = c->next) {
+      FontAtlasPackChar packed;
+      packed.codepoint = c->codepoint;
+      packed.advance   = c->advance;
+      packed.offset    = c->offset;
+      packed.size      = c->size;
+      packed.uv_min    = c->uv_min;
+      packed.uv_max    = c->uv_max;
+      if (!PackWriterAppend(writer, (U8*) &packed, sizeof(packed))) { return false; }
+    }
+  }
+  if (!FontAtlasPackPad(writer, sizeof(FontAtlasPackChar) * header.chars_size)) { return false; }
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(atlas->kern_map); i++) {
+    for (GlyphKernInfo* k = atlas->kern_map[i]; k != NULL; k = k->next) {
+      FontAtlasPackKern packed;
+      packed.codepoint_left  = k->codepoint_left;
+      packed.codepoint_right = k->codepoint_right;
+      packed.advance         = k->advance;
+      if (!PackWriterAppend(writer, (U8*) &packed, sizeof(packed))) { return false; }
+    }
+  }
+  if (!FontAtlasPackPad(writer, sizeof(FontAtlasPackKern) * header.kerns_size)) { return false; }
+  U64 bitmap_size = (U64) bitmap->width * bitmap->height * ImageBytesPerPixel(bitmap->format);
+  return PackWriterAppend(writer, bitmap->data, bitmap_size) && PackWriterEnd(writer);
+}
+
+// NOTE: returns NULL if the section would run past the end of the entry.
+static void* FontAtlasPackTake(U8* data, U64 data_size, U64* pos, U64 size) {
+  if (*pos > data_size || size > data_size - *pos) { return NULL; }
+  void* result = data + *pos;
+  *pos = ALIGN_POW_2(*pos + size, FONT_ATLAS_PACK_ALIGNMENT);
+  return result;
+}
+
+B32 FontAtlasPackGet(Arena* arena, Pack* pack, String8 name, FontAtlas* atlas, Image* bitmap) {
+  U8* data;
+  U64 data_size;
+  if (!PackGet(pack, name, &data, &data_size)) { return false; }
+  U64 arena_base = ArenaPos(arena);
+  B32 success    = false;
+  MEMORY_ZERO_STRUCT(atlas);
+  MEMORY_ZERO_STRUCT(bitmap);
+
+  U64 pos = 0;
+  FontAtlasPackHeader* header = (FontAtlasPackHeader*) FontAtlasPackTake(data, data_size, &pos, sizeof(FontAtlasPackHeader));
+  if (header == NULL || header->bitmap_format > ImageFormat_R) { goto font_atlas_pack_get_exit; }
+  FontAtlasPackChar* chars = (FontAtlasPackChar*) FontAtlasPackTake(data, data_size, &pos, sizeof(FontAtlasPackChar) * header->chars_size);
+  if (chars == NULL) { goto font_atlas_pack_get_exit; }
+  FontAtlasPackKern* kerns = (FontAtlasPackKern*) FontAtlasPackTake(data, data_size, &pos, sizeof(FontAtlasPackKern) * header->kerns_size);
+  if (kerns == NULL) { goto font_atlas_pack_get_exit; }
+  U64 bitmap_size = (U64) header->bitmap_width * header->bitmap_height * ImageBytesPerPixel((ImageFormat) header->bitmap_format);
+  if (pos > data_size || data_size - pos != bitmap_size) { goto font_atlas_pack_get_exit; }
+
+  atlas->scale_coeff = header->scale_coeff;
+  atlas->ascent      = header->ascent;
+  atlas->descent     = header->descent;
+  for (U32 i = 0; i < header->chars_size; i++) {
+    AtlasChar* c = ARENA_PUSH_STRUCT(arena, AtlasChar);
+    MEMORY_ZERO_STRUCT(c);
+    c->codepoint = chars[i].codepoint;
+    c->advance   = chars[i].advance;
+    c->offset    = chars[i].offset;
+    c->size      = chars[i].size;
+    c->uv_min    = chars[i].uv_min;
+    c->uv_max    = chars[i].uv_max;
+    if (!FontAtlasInsertChar(atlas, c->codepoint, c)) { goto font_atlas_pack_get_exit; }
+  }
+  for (U32 i = 0; i < header->kerns_size; i++) {
+    GlyphKernInfo* k = ARENA_PUSH_STRUCT(arena, GlyphKernInfo);
+    MEMORY_ZERO_STRUCT(k);
+    k->codepoint_left  = kerns[i].codepoint_left;
+    k->codepoint_right = kerns[i].codepoint_right;
+    k->advance         = kerns[i].advance;
+    if (!FontAtlasInsertKern(atlas, k->codepoint_left, k->codepoint_right, k)) { goto font_atlas_pack_get_exit; }
+  }
+  bitmap->format = (ImageFormat) header->bitmap_format;
+  bitmap->width  = header->bitmap_width;
+  bitmap->height = header->bitmap_height;
+  bitmap->data   = data + pos;
+  success = true;
+
+font_atlas_pack_get_exit:
+  if (!success) {
+    LOG_ERROR("[FONT] Asset pack entry is not a baked font atlas: %S", name);
+    ArenaPopTo(arena, arena_base);
+    MEMORY_ZERO_STRUCT(atlas);
+    MEMORY_ZERO_STRUCT(bitmap);
+  }
+  return success;
+}
+
 FontCharSet* FontCharSetConcat(FontCharSet* set, FontCharSet* to_concat) {
   FontCharSet* curr = set;
   while (curr->next != NULL) { curr = curr->next; }
@@ -1523,5 +1683,6 @@ FontCharSet* FontCharSetLatin() {
 #undef COMPOUND_FLAG_MORE
 #undef COMPOUND_FLAG_SEP_SCALES
 #undef COMPOUND_FLAG_2X2MAT
+#undef FONT_ATLAS_PACK_ALIGNMENT
 
 #endif // CDEFAULT_FONT_IMPLEMENTATION
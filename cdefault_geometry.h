@@ -4,6 +4,7 @@
 #include "cdefault_math.h"
 #include "cdefault_std.h"
 #include "cdefault_io.h"
+#include "cdefault_profile.h"
 
 // TODO: harden routines against e.g. division by 0
 // TODO: finish rounding out 3d
@@ -2649,6 +2650,7 @@ static V3 GjkSupport(GjkSupportContext* a, GjkSupportContext* b, V3 search_dir)
 #define EPA_MAX_ITERATIONS 64
 B32 GjkIntersection3(GjkSupportContext* a, GjkSupportContext* b, IntersectManifold3* manifold) {
   // NOTE: determine intersection using GJK
+  CDEFAULT_PROFILE_START(GJK3);
   B32 gjk_success = false;
   V3  simplex_points[4];
   MEMORY_ZERO_STATIC_ARRAY(simplex_points);
@@ -2686,11 +2688,13 @@ B32 GjkIntersection3(GjkSupportContext* a, GjkSupportContext* b, IntersectManifo
   }
 
 gjk_exit:
+  CDEFAULT_PROFILE_END(GJK3);
   if (!gjk_success)     { return false; }
   if (manifold == NULL) { return true;  }
   DEBUG_ASSERT(simplex_points_size == 4);
 
   // NOTE: determine manifold penetration and normal using EPA
+  CDEFAULT_PROFILE_START(EPA3);
   Arena* horizon_arena = ArenaAllocate();
   EpaHorizon horizon;
   MEMORY_ZERO_STRUCT(&horizon);
@@ -2767,6 +2771,7 @@ epa_exit:
   manifold->normal = V3Negate(search_dir);
   manifold->penetration = min_distance;
 
+  CDEFAULT_PROFILE_END(EPA3);
   return true;
 }
 
@@ -2,6 +2,7 @@
 #define CDEFAULT_IMAGE_H_
 
 #include "cdefault_io.h"
+#include "cdefault_profile.h"
 #include "cdefault_std.h"
 
 // API for loading image files, e.g. off of disk.
@@ -25,6 +26,12 @@ ArenaRelease(arena);
 // TODO: SIMD
 // TODO: wider PNG support
 
+// NOTE: Verifies each PNG chunk's CRC-32 on load. Hardware accelerated, so costs little next to
+// decoding, but may be set to 0 to skip it, e.g. for trusted / baked assets.
+#ifndef IMAGE_PNG_VERIFY_CRC
+#define IMAGE_PNG_VERIFY_CRC 1
+#endif
+
 // NOTE: Uncompressed image data format.
 typedef enum ImageFormat ImageFormat;
 enum ImageFormat {
@@ -47,6 +54,8 @@ B32  ImageLoadFile(Arena* arena, Image* image, ImageFormat format, String8 file_
 B32  ImageLoad(Arena* arena, Image* image, ImageFormat format, U8* file_data, U32 file_data_size);
 void ImageConvert(Arena* arena, Image* to, Image* from, ImageFormat to_format);
 B32  ImageDumpBmp(Image* image, String8 file_path); // NOTE: Preserves alpha channel, if present.
+B32  ImagePackAdd(PackWriter* writer, String8 name, Image* image); // NOTE: Bakes the decoded pixels into an asset pack, see cdefault_io.h.
+B32  ImagePackGet(Pack* pack, String8 name, Image* image);         // NOTE: Zero-copy, image->data points into the pack, is read-only, and is valid until PackClose.
 
 U32  ImageBytesPerPixel(ImageFormat format);
 void ImageFlipY(Image* image);
@@ -74,6 +83,8 @@ enum BmpVersion {
 // https://www.fileformat.info/format/bmp/egff.htm
 #define BIN_CATCH IMAGE_LOG_OUT_OF_CHARS(); goto image_load_bmp_exit;
 B32 ImageLoadBmp(Arena* arena, Image* image, ImageFormat format, U8* file_data, U32 file_data_size) {
+  CDEFAULT_PROFILE_START(IMAGE_LOAD_BMP);
+  PROFILE_ADD_BYTES(file_data_size);
   B32 success = false;
   Arena* temp_arena = ArenaAllocate();
 
@@ -364,127 +375,17 @@ B32 ImageLoadBmp(Arena* arena, Image* image, ImageFormat format, U8* file_data,
   success = true;
 image_load_bmp_exit:
   ArenaRelease(temp_arena);
+  CDEFAULT_PROFILE_END(IMAGE_LOAD_BMP);
   return success;
 }
 #undef BIN_CATCH
 
-#define PNG_HUFFMAN_MAX_BIT_COUNT 16
-static U32 _cdef_png_hclen_swizzle[]         = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
-// NOTE: { last value, num bits }
-static U32 _cdef_png_fixed_hclens[][2]       = { {143, 8}, {255, 9}, {279, 7}, {287, 8}, {319, 5} };
-// NOTE: { length, extra bits }
-static U32 _cdef_png_extra_length_codes[][2] = { {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}, {8, 0}, {9, 0}, {10, 0}, {11, 1}, {13, 1}, {15, 1}, {17, 1}, {19, 2}, {23, 2}, {27, 2}, {31, 2}, {35, 3}, {43, 3}, {51, 3}, {59, 3}, {67, 4}, {83, 4}, {99, 4}, {115, 4}, {131, 5}, {163, 5}, {195, 5}, {227, 5}, {258, 0} };
-// NOTE: { dist, extra bits }
-static U32 _cdef_png_extra_dist_codes[][2]   = { {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 1}, {7, 1}, {9, 2}, {13, 2}, {17, 3}, {25, 3}, {33, 4}, {49, 4}, {65, 5}, {97, 5}, {129, 6}, {193, 6}, {257, 7}, {385, 7}, {513, 8}, {769, 8}, {1025, 9}, {1537, 9}, {2049, 10}, {3073, 10}, {4097, 11}, {6145, 11}, {8193, 12}, {12289, 12}, {16385, 13}, {24577, 13} };
-
 typedef struct PngChunk PngChunk;
 struct PngChunk {
   BinStream s;
   PngChunk* next;
 };
 
-typedef struct PngIdatStream PngIdatStream;
-struct PngIdatStream {
-  PngChunk* chunks;
-  U64 buffer;
-  U8  buffer_size;
-};
-
-typedef struct PngHuffmanNode PngHuffmanNode;
-struct PngHuffmanNode {
-  S32 symbol;
-  PngHuffmanNode* left;
-  PngHuffmanNode* right;
-};
-
-static B32 PngIdatStreamPullBits(PngIdatStream* s, U32 num_bits, U32* result) {
-  DEBUG_ASSERT(num_bits <= 32);
-  while (s->buffer_size < num_bits) {
-    U8 byte;
-    while (!BinStreamPullU8(&s->chunks->s, &byte)) {
-      if (s->chunks->next == NULL) { return false; }
-      s->chunks = s->chunks->next;
-    }
-    s->buffer |= ((U64) byte) << s->buffer_size;
-    s->buffer_size += 8;
-  }
-  *result = s->buffer & ((1 << num_bits) - 1);
-  s->buffer >>= num_bits;
-  s->buffer_size -= num_bits;
-  return true;
-}
-
-static void PngIdatStreamFlushByte(PngIdatStream* s) {
-  U32 x = s->buffer_size % 8;
-  s->buffer >>= x;
-  s->buffer_size -= x;
-}
-
-static PngHuffmanNode* PngHuffmanNodeCreate(Arena* arena) {
-  PngHuffmanNode* result = ARENA_PUSH_STRUCT(arena, PngHuffmanNode);
-  MEMORY_ZERO_STRUCT(result);
-  result->symbol = -1;
-  return result;
-}
-
-static PngHuffmanNode* PngHuffmanBuild(Arena* arena, U32* code_lengths, U32 num_symbols) {
-  // NOTE: count number of codes
-  S32 code_length_histogram[PNG_HUFFMAN_MAX_BIT_COUNT];
-  MEMORY_ZERO_STATIC_ARRAY(code_length_histogram);
-  for (U32 i = 0; i < num_symbols; i++) {
-    U32 code_length = code_lengths[i];
-    if (code_length == 0) { continue; }
-    DEBUG_ASSERT(code_length < STATIC_ARRAY_SIZE(code_length_histogram));
-    code_length_histogram[code_length] += 1;
-  }
-
-  // NOTE: assign starting codes
-  S32 next_code[PNG_HUFFMAN_MAX_BIT_COUNT];
-  MEMORY_ZERO_STATIC_ARRAY(next_code);
-  for (U32 i = 1; i < STATIC_ARRAY_SIZE(next_code); i++) {
-    next_code[i] = (next_code[i - 1] + code_length_histogram[i - 1]) << 1;
-  }
-
-  // NOTE: build the tree
-  PngHuffmanNode* root = PngHuffmanNodeCreate(arena);
-  for (S32 symbol = 0; symbol < (S32) num_symbols; symbol++) {
-    U32 code_length = code_lengths[symbol];
-    if (code_length == 0) { continue; }
-    S32 curr_code = next_code[code_length]++;
-    PngHuffmanNode* node = root;
-    for (S32 i = code_length - 1; i >= 0; i--) {
-      S32 bit = (curr_code >> i) & 1;
-      if (bit == 0) {
-        if (node->left == NULL)  { node->left = PngHuffmanNodeCreate(arena);  }
-        node = node->left;
-      } else {
-        if (node->right == NULL) { node->right = PngHuffmanNodeCreate(arena); }
-        node = node->right;
-      }
-    }
-    node->symbol = symbol;
-  }
-  return root;
-}
-
-#define BIN_CATCH IMAGE_LOG_OUT_OF_CHARS(); return false;
-static B32 PngHuffmanDecode(PngHuffmanNode* root, PngIdatStream* s, U32* result) {
-  PngHuffmanNode* curr = root;
-  while (curr->symbol < 0) {
-    U32 bit;
-    BIN_TRY(PngIdatStreamPullBits(s, 1, &bit));
-    if (bit == 0) { curr = curr->left;  }
-    else          { curr = curr->right; }
-    if (curr == NULL) {
-      LOG_ERROR("[IMAGE] PNG huffman tree unable to decode symbol.");
-      return false;
-    }
-  }
-  *result = (U32) curr->symbol;
-  return true;
-}
-#undef BIN_CATCH
-
 static U8 PngFilterSum(U8* a, U8* b, U32 channel) {
   return (U8)a[channel] + (U8)b[channel];
 }
@@ -519,6 +420,8 @@ static U8 PngFilterPaeth(U8* x, U8* a_arr, U8* b_arr, U8* c_arr, U32 channel) {
 // https://github.com/nothings/stb/blob/master/stb_image.h
 #define BIN_CATCH IMAGE_LOG_OUT_OF_CHARS(); goto image_load_png_exit;
 B32 ImageLoadPng(Arena* arena, Image* image, ImageFormat format, U8* file_data, U32 file_data_size) {
+  CDEFAULT_PROFILE_START(IMAGE_LOAD_PNG);
+  PROFILE_ADD_BYTES(file_data_size);
   MEMORY_ZERO_STRUCT(image);
   B32 success = false;
   U64 arena_base = ArenaPos(arena);
@@ -527,12 +430,11 @@ B32 ImageLoadPng(Arena* arena, Image* image, ImageFormat format, U8* file_data,
 
   U64 magic_number;
   BIN_TRY(BinStreamPullU64BE(&s, &magic_number));
-  if (magic_number != 0x89504E470D0A1A0A) { return false; }
+  if (magic_number != 0x89504E470D0A1A0A) { goto image_load_png_exit; }
 
   // NOTE: pull out interesting chunks
-  PngIdatStream idat;
-  MEMORY_ZERO_STRUCT(&idat);
   BinStream* ihdr            = NULL;
+  PngChunk* idat_chunks      = NULL;
   PngChunk* idat_chunks_tail = NULL;
   while (BinStreamRemaining(&s) > 0) {
     U32 chunk_length, chunk_crc;
@@ -543,6 +445,11 @@ B32 ImageLoadPng(Arena* arena, Image* image, ImageFormat format, U8* file_data,
     BinStream chunk_stream = BinStreamAssign(BinStreamDecay(&s), chunk_length);
     BinStreamSkip(&s, chunk_length, sizeof(U8));
     BIN_TRY(BinStreamPullU32BE(&s, &chunk_crc));
+    // NOTE: the crc covers the chunk type and data, which are contiguous in the file.
+    if (IMAGE_PNG_VERIFY_CRC && Crc32(chunk_type.str, 4 + chunk_length) != chunk_crc) {
+      LOG_ERROR("[IMAGE] PNG chunk '%.*s' failed its CRC check.", chunk_type.size, chunk_type.str);
+      goto image_load_png_exit;
+    }
     // LOG_INFO("Identified chunk: %.*s", chunk_type.size, chunk_type.str);
     if (Str8Eq(chunk_type, Str8Lit("IHDR"))) {
       if (ihdr != NULL) {
@@ -556,14 +463,14 @@ B32 ImageLoadPng(Arena* arena, Image* image, ImageFormat format, U8* file_data,
       PngChunk* chunk = ARENA_PUSH_STRUCT(temp_arena, PngChunk);
       MEMORY_ZERO_STRUCT(chunk);
       chunk->s = chunk_stream;
-      SLL_QUEUE_PUSH_BACK(idat.chunks, idat_chunks_tail, chunk, next);
+      SLL_QUEUE_PUSH_BACK(idat_chunks, idat_chunks_tail, chunk, next);
     }
   }
   if (ihdr == NULL) {
     LOG_ERROR("[IMAGE] PNG missing required chunk 'IHDR'!");
     goto image_load_png_exit;
   }
-  if (idat.chunks == NULL) {
+  if (idat_chunks == NULL) {
     LOG_ERROR("[IMAGE] PNG missing required chunk 'IDAT'!");
     goto image_load_png_exit;
   }
@@ -601,170 +508,25 @@ B32 ImageLoadPng(Arena* arena, Image* image, ImageFormat format, U8* file_data,
     goto image_load_png_exit;
   }
 
-  // NOTE: investigate zlib chunks
-  U32 zlib_compression_method, flags;
-  BIN_TRY(PngIdatStreamPullBits(&idat, 8, &zlib_compression_method));
-  BIN_TRY(PngIdatStreamPullBits(&idat, 8, &flags));
-  U8 zlib_cm    = (zlib_compression_method >> 0) & 0xF;
-  U8 zlib_fdict = (flags >> 5) & 0x1;
-  if (zlib_cm != 8) {
-    LOG_ERROR("[IMAGE] PNG invalid zlib compression method detected: %d", zlib_cm);
-    goto image_load_png_exit;
-  }
-  if (zlib_fdict != 0) {
-    LOG_ERROR("[IMAGE] PNG invalid zlib preset dictionary method detected: %d", zlib_fdict);
-    goto image_load_png_exit;
-  }
-
-  // NOTE: decompress
+  // NOTE: decompress, feeding the IDAT chunks to the inflater in order.
   // NOTE: addl. height for png filtering information (+1 byte per-row)
   U32 decompressed_pixels_size = ((width * height * 4) + height) * sizeof(U8);
   U8* decompressed_pixels = ARENA_PUSH_ARRAY(temp_arena, U8, decompressed_pixels_size);
-  MEMORY_ZERO_SIZE(decompressed_pixels, decompressed_pixels_size);
-  U8* dest = decompressed_pixels;
-  U32 bfinal = 0;
-  while (bfinal != 1) {
-    U32 btype;
-    BIN_TRY(PngIdatStreamPullBits(&idat, 1, &bfinal));
-    BIN_TRY(PngIdatStreamPullBits(&idat, 2, &btype));
-
-      // NOTE: no compression
-    if (btype == 0) {
-      PngIdatStreamFlushByte(&idat);
-      U32 len = 0, nlen = 0;
-      BIN_TRY(PngIdatStreamPullBits(&idat, 16, &len));
-      BIN_TRY(PngIdatStreamPullBits(&idat, 16, &nlen));
-      if ((U16)len != (U16)~nlen) {
-        LOG_ERROR("[IMAGE] PNG zlib chunk len / nlen mismatch");
-        goto image_load_png_exit;
-      }
-      for (U32 i = 0; i < len; i++) {
-        U32 byte;
-        BIN_TRY(PngIdatStreamPullBits(&idat, 8, &byte));
-        *dest++ = (U8) byte;
-      }
-    } else {
-      U32 hlit;
-      U32 hdist;
-      U32 lit_len_dist_table[512];
-
-      if (btype == 1) {
-        // NOTE: fixed huffman codes
-        hlit = 288;
-        hdist = 32;
-        U32 bit_count_idx = 0;
-        for (U32 i = 0; i < STATIC_ARRAY_SIZE(_cdef_png_fixed_hclens); i++) {
-          U32 last_value = _cdef_png_fixed_hclens[i][0];
-          U32 bit_count  = _cdef_png_fixed_hclens[i][1];
-          while (bit_count_idx <= last_value) {
-            lit_len_dist_table[bit_count_idx++] = bit_count;
-          }
-        }
-      } else if (btype == 2) {
-        // NOTE: dynamic huffman codes
-        U32 hclen;
-        BIN_TRY(PngIdatStreamPullBits(&idat, 5, &hlit));
-        BIN_TRY(PngIdatStreamPullBits(&idat, 5, &hdist));
-        BIN_TRY(PngIdatStreamPullBits(&idat, 4, &hclen));
-        hlit  += 257;
-        hdist += 1;
-        hclen += 4;
-
-        DEBUG_ASSERT(hclen <= STATIC_ARRAY_SIZE(_cdef_png_hclen_swizzle));
-        U32 hclen_table[STATIC_ARRAY_SIZE(_cdef_png_hclen_swizzle)];
-        MEMORY_ZERO_STATIC_ARRAY(hclen_table);
-        for (U32 i = 0; i < hclen; i++) {
-          BIN_TRY(PngIdatStreamPullBits(&idat, 3, &hclen_table[_cdef_png_hclen_swizzle[i]]));
-        }
-        PngHuffmanNode* dict_huffman = PngHuffmanBuild(temp_arena, hclen_table, STATIC_ARRAY_SIZE(hclen_table));
-
-        U32 lit_len_count = 0;
-        U32 len_count = hlit + hdist;
-        while (lit_len_count < len_count) {
-          U32 encoded_len;
-          if (!PngHuffmanDecode(dict_huffman, &idat, &encoded_len)) { goto image_load_png_exit; }
-
-          U32 rep_count;
-          U32 rep_val;
-          if (encoded_len <= 15) {
-            rep_val = encoded_len;
-            rep_count = 1;
-          } else if (encoded_len == 16) {
-            DEBUG_ASSERT(lit_len_count > 0);
-            rep_val = lit_len_dist_table[lit_len_count - 1];
-            BIN_TRY(PngIdatStreamPullBits(&idat, 2, &rep_count));
-            rep_count += 3;
-          } else if (encoded_len == 17) {
-            rep_val = 0;
-            BIN_TRY(PngIdatStreamPullBits(&idat, 3, &rep_count));
-            rep_count += 3;
-          } else if (encoded_len == 18) {
-            rep_val = 0;
-            BIN_TRY(PngIdatStreamPullBits(&idat, 7, &rep_count));
-            rep_count += 11;
-          } else {
-            LOG_ERROR("[IMAGE] PNG unrecognized encoded length: %d", encoded_len);
-            goto image_load_png_exit;
-          }
-          while (rep_count > 0) {
-            rep_count--;
-            lit_len_dist_table[lit_len_count++] = rep_val;
-          }
-        }
-        DEBUG_ASSERT(lit_len_count == len_count);
-
-      } else {
-        // NOTE: btype is reserved or invalid
-        LOG_ERROR("[IMAGE] PNG invalid zlib compression btype provided: %d", btype);
-        goto image_load_png_exit;
-      }
-
-      PngHuffmanNode* lit_len_huffman = PngHuffmanBuild(temp_arena, lit_len_dist_table, hlit);
-      PngHuffmanNode* dist_huffman    = PngHuffmanBuild(temp_arena, lit_len_dist_table + hlit, hdist);
-      while (true) {
-        // NOTE: LZ compression
-        U32 lit_len;
-        if (!PngHuffmanDecode(lit_len_huffman, &idat, &lit_len)) { goto image_load_png_exit; }
-        if (lit_len < 256) {
-          *dest++ = (U8) (lit_len & 0xFF);
-        } else if (lit_len > 256) {
-          U32 len_idx = lit_len - 257;
-          DEBUG_ASSERT(len_idx < STATIC_ARRAY_SIZE(_cdef_png_extra_length_codes));
-          U32 length = _cdef_png_extra_length_codes[len_idx][0];
-          U32 extra_length_bits_used  = _cdef_png_extra_length_codes[len_idx][1];
-          if (extra_length_bits_used > 0) {
-            U32 extra_bits;
-            BIN_TRY(PngIdatStreamPullBits(&idat, extra_length_bits_used, &extra_bits));
-            length += extra_bits;
-          }
-
-          U32 dist_idx;
-          if (!PngHuffmanDecode(dist_huffman, &idat, &dist_idx)) { goto image_load_png_exit; }
-          DEBUG_ASSERT(dist_idx < STATIC_ARRAY_SIZE(_cdef_png_extra_dist_codes));
-          U32 distance = _cdef_png_extra_dist_codes[dist_idx][0];
-          U32 extra_distance_bits_used = _cdef_png_extra_dist_codes[dist_idx][1];
-          if (extra_distance_bits_used > 0) {
-            U32 extra_bits;
-            BIN_TRY(PngIdatStreamPullBits(&idat, extra_distance_bits_used, &extra_bits));
-            distance += extra_bits;
-          }
-
-          U8* src = dest - distance;
-          DEBUG_ASSERT(src + length <= decompressed_pixels + decompressed_pixels_size);
-          DEBUG_ASSERT(dest + length <= decompressed_pixels + decompressed_pixels_size);
-          DEBUG_ASSERT(src >= decompressed_pixels);
-          while (length > 0) {
-            *dest++ = *src++;
-            length -= 1;
-          }
-        } else {
-          DEBUG_ASSERT(lit_len == 256);
-          break;
-        }
-      }
-    }
+  Inflate* inflate;
+  if (!InflateCreate(&inflate, CompressFormat_Zlib)) { goto image_load_png_exit; }
+  U64 decompressed_size = 0;
+  CompressStatus status = CompressStatus_NeedsInput;
+  for (PngChunk* chunk = idat_chunks; chunk != NULL && status == CompressStatus_NeedsInput; chunk = chunk->next) {
+    U64 in_read, out_written;
+    status = InflateRun(inflate, BinStreamDecay(&chunk->s), BinStreamRemaining(&chunk->s), &in_read,
+                        decompressed_pixels + decompressed_size, decompressed_pixels_size - decompressed_size, &out_written);
+    decompressed_size += out_written;
+  }
+  InflateDestroy(inflate);
+  if (status != CompressStatus_Done || decompressed_size != decompressed_pixels_size) {
+    LOG_ERROR("[IMAGE] PNG image data is corrupt, decompressed %llu of %u expected bytes.", decompressed_size, decompressed_pixels_size);
+    goto image_load_png_exit;
   }
-  DEBUG_ASSERT(dest == decompressed_pixels + decompressed_pixels_size);
 
   // NOTE: render to temp image first and convert to final format separately
   Image temp_image;
@@ -778,8 +540,8 @@ B32 ImageLoadPng(Arena* arena, Image* image, ImageFormat format, U8* file_data,
   U32 zeroes = 0;
   U8* prior_row = (U8*) &zeroes;
   U32 prior_row_advance = 0;
-  U8* src = decompressed_pixels;
-  dest    = temp_image.data;
+  U8* src  = decompressed_pixels;
+  U8* dest = temp_image.data;
   for (U32 y = 0; y < height; y++) {
     U8 filter = *src++;
     U8* current_row = dest;
@@ -876,18 +638,23 @@ B32 ImageLoadPng(Arena* arena, Image* image, ImageFormat format, U8* file_data,
 image_load_png_exit:
   ArenaRelease(temp_arena);
   if (!success) { ArenaPopTo(arena, arena_base); }
+  CDEFAULT_PROFILE_END(IMAGE_LOAD_PNG);
   return success;
 }
 #undef BIN_CATCH
 
+// NOTE: the file is only needed while decoding, so map it rather than copying it into an arena.
 B32 ImageLoadFile(Arena* arena, Image* image, ImageFormat format, String8 file_path) {
   B32 success = false;
-  String8 file_data;
-  Arena* file_arena = ArenaAllocate();
-  if (!FileReadAll(file_arena, file_path, &file_data.str, &file_data.size)) { goto image_load_file_exit; }
-  success = ImageLoad(arena, image, format, file_data.str, file_data.size);
+  FileMap file_map;
+  if (!FileMapOpen(file_path, &file_map, FileMapHint_Sequential)) { return false; }
+  if (file_map.size > U32_MAX) {
+    LOG_ERROR("[IMAGE] File is too large to load: %S", file_path);
+    goto image_load_file_exit;
+  }
+  success = ImageLoad(arena, image, format, file_map.data, file_map.size);
 image_load_file_exit:
-  ArenaRelease(file_arena);
+  DEBUG_ASSERT(FileMapClose(&file_map));
   return success;
 }
 
@@ -1025,6 +792,45 @@ B32 ImageDumpBmp(Image* image, String8 file_path) {
   return success;
 }
 
+// NOTE: the pixels follow the header directly, 16 byte aligned.
+typedef struct ImagePackHeader ImagePackHeader;
+struct ImagePackHeader {
+  U32 format;
+  U32 width;
+  U32 height;
+  U32 _pad;
+};
+
+B32 ImagePackAdd(PackWriter* writer, String8 name, Image* image) {
+  ImagePackHeader header;
+  MEMORY_ZERO_STRUCT(&header);
+  header.format = image->format;
+  header.width  = image->width;
+  header.height = image->height;
+  U64 data_size = (U64) image->width * image->height * ImageBytesPerPixel(image->format);
+  return PackWriterBegin(writer, name) &&
+         PackWriterAppend(writer, (U8*) &header, sizeof(header)) &&
+         PackWriterAppend(writer, image->data, data_size) &&
+         PackWriterEnd(writer);
+}
+
+B32 ImagePackGet(Pack* pack, String8 name, Image* image) {
+  U8* data;
+  U64 data_size;
+  if (!PackGet(pack, name, &data, &data_size)) { return false; }
+  ImagePackHeader* header = (ImagePackHeader*) data;
+  if (data_size < sizeof(ImagePackHeader) || header->format > ImageFormat_R ||
+      data_size - sizeof(ImagePackHeader) != (U64) header->width * header->height * ImageBytesPerPixel((ImageFormat) header->format)) {
+    LOG_ERROR("[IMAGE] Asset pack entry is not a baked image: %S", name);
+    return false;
+  }
+  image->format = (ImageFormat) header->format;
+  image->width  = header->width;
+  image->height = header->height;
+  image->data   = (U8*) (header + 1);
+  return true;
+}
+
 U32 ImageBytesPerPixel(ImageFormat format) {
   switch (format) {
     case ImageFormat_RGBA:  return 4;
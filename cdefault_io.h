@@ -2,15 +2,16 @@
 #define CDEFAULT_IO_H_
 
 #include "cdefault_std.h"
+#include "cdefault_profile.h"
 
-// API for handling OS files, with some generic convenience funcs. All routines are synchronous.
+// API for handling OS files, with some generic convenience funcs. All routines are synchronous, except
+// for the FileReadQueue.
 // Also contains routines for logging (either to stdout or a file, based on initialization).
 //
 // NOTE: This API simplifies file access semantics. If opening a file to write, it places an exclusive
 // (read & write) lock on that file. If opening a file in read-only mode, it places a shared (read)
 // lock on that file. Any written data is flushed when the file handle is closed.
 
-// TODO: file search / better directory navigation
 // TODO: more extensive testing
 // TODO: support in-memory files
 // TODO: support stdout / stderr
@@ -18,14 +19,23 @@
 
 typedef struct FileHandle FileHandle;
 
+// NOTE: Large reads / writes are split into OS calls of at most FILE_IO_CHUNK_SIZE bytes, since e.g. read / write
+// transfer at most ~2GB per call on Linux, and ReadFile / WriteFile take a 32-bit size on Windows.
+#ifndef FILE_IO_CHUNK_SIZE
+#define FILE_IO_CHUNK_SIZE GB(1)
+#endif
+
 typedef enum FileMode FileMode;
 enum FileMode {
-  FileMode_Read     = BIT(0), // NOTE: Allow reading of file data.
-  FileMode_Write    = BIT(1), // NOTE: Allow writing of file data.
-  FileMode_Create   = BIT(2), // NOTE: Allow creation of the file if it does not exist.
-  FileMode_Truncate = BIT(3), // NOTE: Truncate the file on successful open.
+  FileMode_Read       = BIT(0), // NOTE: Allow reading of file data.
+  FileMode_Write      = BIT(1), // NOTE: Allow writing of file data.
+  FileMode_Create     = BIT(2), // NOTE: Allow creation of the file if it does not exist.
+  FileMode_Truncate   = BIT(3), // NOTE: Truncate the file on successful open.
+  FileMode_Unbuffered = BIT(4), // NOTE: Bypass the OS file cache (O_DIRECT / FILE_FLAG_NO_BUFFERING). Offsets, sizes and buffers must then be aligned to FILE_DIRECT_ALIGNMENT.
 };
 
+#define FILE_DIRECT_ALIGNMENT KB(4)
+
 typedef enum FileSeekPos FileSeekPos;
 enum FileSeekPos {
   FileSeekPos_Begin,
@@ -35,16 +45,38 @@ enum FileSeekPos {
 
 typedef struct FileStats FileStats;
 struct FileStats {
-  U32 size;
+  U64 size;
   U64 last_write_time;
   U64 last_access_time;
 };
 
 B32 FileStat(String8 file_path, FileStats* stats); // NOTE: Retrieves stats / info on the file with the given path.
-B32 FileReadAll(Arena* arena, String8 file_path, U8** buffer, U32* buffer_size); // NOTE: Places the data in file_path in *buffer.
-B32 FileDump(String8 file_path, U8* buffer, U32 buffer_size);   // NOTE: Replaces data in file_path with buffer (removes any \0 suffix).
-B32 FileAppend(String8 file_path, U8* buffer, U32 buffer_size); // NOTE: Appends the data with buffer (removes any \0 suffix). If you will append many times, prefer opening a FileHandle manually.
+B32 FileReadAll(Arena* arena, String8 file_path, U8** buffer, U32* buffer_size);   // NOTE: Places the data in file_path in *buffer. Fails on files of 4GB or more.
+B32 FileReadAll64(Arena* arena, String8 file_path, U8** buffer, U64* buffer_size); // NOTE: Like FileReadAll, for files of any size.
+B32 FileDump(String8 file_path, U8* buffer, U64 buffer_size);   // NOTE: Replaces data in file_path with buffer (removes any \0 suffix).
+B32 FileAppend(String8 file_path, U8* buffer, U64 buffer_size); // NOTE: Appends the data with buffer (removes any \0 suffix). If you will append many times, prefer a FileWriter.
 B32 FileCopy(String8 src_path, String8 dest_path); // NOTE: Replaces all data in dest_path with the data in src_path.
+B32 FileDelete(String8 file_path); // NOTE: Removes the file. Fails if it does not exist.
+
+// NOTE: Maps a whole file read-only into memory, instead of copying it into an arena like FileReadAll. Pages are
+// loaded lazily on first access (unless FileMapHint_WillNeed), and are shared with the OS's file cache. No lock is
+// held on the file, and truncating it while mapped is undefined behavior (e.g. SIGBUS), so only map files you own.
+typedef enum FileMapHint FileMapHint;
+enum FileMapHint {
+  FileMapHint_None       = 0,
+  FileMapHint_Sequential = BIT(0), // NOTE: Data will be read front to back, read ahead aggressively (MADV_SEQUENTIAL).
+  FileMapHint_WillNeed   = BIT(1), // NOTE: Start paging the whole file in immediately (MADV_WILLNEED / PrefetchVirtualMemory).
+  FileMapHint_HugePages  = BIT(2), // NOTE: Back the mapping with huge pages where supported to reduce TLB misses (MADV_HUGEPAGE, Linux only).
+};
+
+typedef struct FileMap FileMap;
+struct FileMap {
+  U8* data; // NOTE: Read-only. NULL for empty files.
+  U64 size;
+};
+
+B32 FileMapOpen(String8 file_path, FileMap* map, FileMapHint hints); // NOTE: Maps file_path into map->data.
+B32 FileMapClose(FileMap* map);                                      // NOTE: Unmaps the file, map->data is invalid afterwards.
 
 B32 DirSetCurrentToExeDir();      // NOTE: Sets the current working directory to wherever the executable is.
 B32 DirSetCurrent(String8 file_path); // NOTE: Sets the current working directory to the provided location.
@@ -52,20 +84,412 @@ B32 DirGetCurrent(Arena* arena, String8* file_path); // NOTE: Gets the current w
 B32 DirGetExe(Arena* arena, String8* file_path);     // NOTE: Gets the path to the currently running executable.
 B32 DirGetExeDir(Arena* arena, String8* file_path);  // NOTE: Gets the directory to the currently running executable.
 B32 DirListFiles(Arena* arena, String8 dir_path, String8List* file_paths); // NOTE: Given a path to a directory, returns the files in that directory.
+B32 DirCreate(String8 dir_path); // NOTE: Creates the directory and any missing parents. Succeeds if it already exists.
+B32 DirDelete(String8 dir_path); // NOTE: Removes the directory. Fails if it does not exist or is not empty.
+
+// NOTE: Lists a directory tree in one call, e.g. to scan an asset directory. Entries come straight from the
+// directory listings (batched getdents64 on linux, FindFirstFileEx with FIND_FIRST_EX_LARGE_FETCH on windows),
+// rather than looking up each file by path. Symlinks are returned as such, and never followed.
+//
+// E.g.
+#if 0
+String8List extensions = { 0 };
+Str8ListAppend(arena, &extensions, Str8Lit(".png"));
+Str8ListAppend(arena, &extensions, Str8Lit(".bmp"));
+DirEntry* entries;
+U64 entries_size;
+DirWalk(arena, Str8Lit("data"), DirWalkFlags_Recursive | DirWalkFlags_Stat, DirWalkFilterExtensions, &extensions, &entries, &entries_size);
+for (U64 i = 0; i < entries_size; i++) { LOG_INFO("%S: %llu bytes", entries[i].path, entries[i].size); }
+#endif
+
+#ifndef DIR_WALK_MAX_THREADS
+#define DIR_WALK_MAX_THREADS 8
+#endif
+
+typedef enum DirEntryType DirEntryType;
+enum DirEntryType {
+  DirEntryType_File,
+  DirEntryType_Dir,
+  DirEntryType_Symlink,
+  DirEntryType_Other, // NOTE: e.g. devices, pipes, sockets.
+};
+
+typedef struct DirEntry DirEntry;
+struct DirEntry {
+  String8 path; // NOTE: The root path joined with the entry's path under it, '/' separated.
+  String8 name; // NOTE: The last part of path.
+  DirEntryType type;
+  U32 depth;    // NOTE: 0 for entries directly in the root directory.
+  U64 size;            // NOTE: With DirWalkFlags_Stat (or always on windows, where it's free), 0 otherwise.
+  U64 last_write_time; // NOTE: As for size. Seconds since the epoch, as in FileStats.
+};
+
+typedef enum DirWalkFlags DirWalkFlags;
+enum DirWalkFlags {
+  DirWalkFlags_None        = 0,
+  DirWalkFlags_Recursive   = BIT(0), // NOTE: Descend into subdirectories.
+  DirWalkFlags_IncludeDirs = BIT(1), // NOTE: Return directories too, not just files / symlinks / etc.
+  DirWalkFlags_SkipHidden  = BIT(2), // NOTE: Skip entries whose name starts with '.', and the contents of such directories.
+  DirWalkFlags_Stat        = BIT(3), // NOTE: Fill in size / last_write_time. One fstatat (relative to the open directory) per returned entry on linux.
+  DirWalkFlags_Parallel    = BIT(4), // NOTE: List subdirectories on up to DIR_WALK_MAX_THREADS threads.
+};
+
+// NOTE: Decides whether an entry is returned. Called before size / last_write_time are filled in, so that rejected
+// entries are never stat'd. Directories are descended into regardless. Must be thread safe with DirWalkFlags_Parallel.
+typedef B32 DirWalkFilter_Fn(DirEntry* entry, void* user_data);
+B32 DirWalkFilterGlob(DirEntry* entry, void* pattern);          // NOTE: pattern is a String8*, matched against the entry's name with PathMatchGlob.
+B32 DirWalkFilterExtensions(DirEntry* entry, void* extensions); // NOTE: extensions is a String8List* of e.g. ".png", compared case insensitively.
+
+// NOTE: Places all entries under root into *entries, in no particular order. filter may be NULL. Subdirectories that
+// can't be read (e.g. permissions) are logged and skipped, only failing to read root fails the walk.
+B32 DirWalk(Arena* arena, String8 root, DirWalkFlags flags, DirWalkFilter_Fn* filter, void* filter_data, DirEntry** entries, U64* entries_size);
 
 B32     PathPop(String8 path, String8* dir_part, String8* file_part); // NOTE: Pops the right most part of the path off. E.g. /a/b/c -> /a/b
 String8 PathJoin(Arena* arena, String8List path_parts);
+B32     PathMatchGlob(String8 name, String8 pattern); // NOTE: * matches any run of characters, ? any one character. E.g. "*.png", "tex_??_*".
 
 B32 FileHandleOpenStdOut(FileHandle** file);                              // NOTE: Opens a file to stdout / the console.
 B32 FileHandleOpen(FileHandle** file, String8 file_path, FileMode mode);  // NOTE: Opens a file. Mode must include read and / or write. Implicitly places a shared or exclusive lock depending on the mode.
 B32 FileHandleClose(FileHandle* file);                               // NOTE: Closes a file, releases any locks held on that file.
 B32 FileHandleStat(FileHandle* file, FileStats* stats);              // NOTE: Like FileStat, but on a FileHandle instead of a path.
-B32 FileHandleSeek(FileHandle* file, S32 distance, FileSeekPos pos); // NOTE: Seeks to a given position in the file.
-B32 FileHandleRead(FileHandle* file, U8* buffer, U32 buffer_size, U32* bytes_read); // NOTE: Reads / places buffer_size bytes into buffer, stopping if EOF is observed. Num bytes read is placed into bytes_read.
-B32 FileHandleWrite(FileHandle* file, U8* buffer, U32 buffer_size);  // NOTE: Writes / places buffer_size bytes from buffer into the file.
+B32 FileHandleSeek(FileHandle* file, S64 distance, FileSeekPos pos); // NOTE: Seeks to a given position in the file. Seeking past the end and writing leaves a (sparse, where supported) zero-filled gap.
+B32 FileHandleRead(FileHandle* file, U8* buffer, U32 buffer_size, U32* bytes_read);   // NOTE: Reads / places buffer_size bytes into buffer, stopping if EOF is observed. Num bytes read is placed into bytes_read.
+B32 FileHandleRead64(FileHandle* file, U8* buffer, U64 buffer_size, U64* bytes_read); // NOTE: Like FileHandleRead, for reads of any size.
+B32 FileHandleWrite(FileHandle* file, U8* buffer, U64 buffer_size);  // NOTE: Writes / places buffer_size bytes from buffer into the file.
+B32 FileHandleSetSize(FileHandle* file, U64 size);                   // NOTE: Truncates or zero-extends the file to size bytes. Does not move the seek position.
+
+// NOTE: Buffered, sequential streams over a file, for many small reads / writes (e.g. parsing or exporting text
+// formats) without paying for a syscall each. buffer_size of 0 uses FILE_STREAM_DEFAULT_BUFFER_SIZE.
+//
+// With FileMode_Unbuffered, the stream handles the alignment requirements and moves whole blocks directly between
+// its buffer and the disk, which is useful for streaming huge files through without evicting everything else from
+// the OS file cache. The buffer size is rounded up to FILE_DIRECT_ALIGNMENT. An unbuffered writer pads its last
+// block and trims the file back down on close, so the file ends wherever the writer stopped.
+#define FILE_STREAM_DEFAULT_BUFFER_SIZE KB(256)
+#define FILE_STREAM_MIN_BUFFER_SIZE     KB(4)
+#define FILE_STREAM_MAX_BUFFER_SIZE     MB(16)
+
+typedef struct FileReader FileReader;
+struct FileReader {
+  FileHandle* file;
+  U8* buffer;
+  U64 buffer_cap;
+  U64 buffer_pos;
+  U64 buffer_size;
+  B32 is_eof;
+  B32 is_unbuffered;
+  U64 num_os_calls; // NOTE: Num of reads issued to the OS, for diagnostics.
+};
+
+B32 FileReaderOpen(FileReader* reader, String8 file_path, FileMode mode, U64 buffer_size); // NOTE: mode is implicitly FileMode_Read, may add FileMode_Unbuffered.
+B32 FileReaderClose(FileReader* reader);
+B32 FileReaderRead(FileReader* reader, U8* buffer, U64 buffer_size, U64* bytes_read); // NOTE: Like FileHandleRead64.
+B32 FileReaderReadExact(FileReader* reader, U8* buffer, U64 buffer_size);             // NOTE: Fails if EOF is observed before buffer_size bytes are read.
+B32 FileReaderReadLine(FileReader* reader, Arena* arena, String8* line);              // NOTE: Places the next line, without its \n or \r\n, in arena. Fails at EOF.
+
+typedef struct FileWriter FileWriter;
+struct FileWriter {
+  FileHandle* file;
+  U8* buffer;
+  U64 buffer_cap;
+  U64 buffer_size;
+  U64 file_pos;
+  B32 is_unbuffered;
+  U64 num_os_calls; // NOTE: Num of writes issued to the OS, for diagnostics.
+};
+
+B32 FileWriterOpen(FileWriter* writer, String8 file_path, FileMode mode, U64 buffer_size); // NOTE: mode is implicitly FileMode_Write, e.g. add FileMode_Create | FileMode_Truncate. Writes start at the beginning of the file.
+B32 FileWriterClose(FileWriter* writer); // NOTE: Flushes any buffered data first.
+B32 FileWriterWrite(FileWriter* writer, U8* buffer, U64 buffer_size);
+B32 FileWriterWriteStr8(FileWriter* writer, String8 str);
+B32 FileWriterFlush(FileWriter* writer); // NOTE: Hands buffered data to the OS. When unbuffered, a trailing partial block is held until more data arrives or close.
+
+// NOTE: DEFLATE (RFC 1951) compression, optionally framed as zlib (RFC 1950) or gzip (RFC 1952). Both directions are
+// incremental: input may be fed in chunks of any size, and output drained into buffers of any size, e.g. to / from a
+// FileReader / FileWriter. Call Run until it returns Done, adding input on NeedsInput and / or draining the output on
+// NeedsOutput. For whole buffers already in memory, InflateAll / DeflateAll are simpler.
+//
+// E.g.
+#if 0
+Inflate* inflate;
+InflateCreate(&inflate, CompressFormat_Gzip);
+U8 in[KB(64)], out[KB(64)];
+U64 in_size = 0, in_pos = 0;
+CompressStatus status = CompressStatus_NeedsInput;
+while (status == CompressStatus_NeedsInput || status == CompressStatus_NeedsOutput) {
+  if (in_pos == in_size) {
+    FileReaderRead(&reader, in, sizeof(in), &in_size);
+    in_pos = 0;
+    if (in_size == 0) { break; } // NOTE: truncated.
+  }
+  U64 in_read, out_written;
+  status = InflateRun(inflate, in + in_pos, in_size - in_pos, &in_read, out, sizeof(out), &out_written);
+  in_pos += in_read;
+  Process(out, out_written);
+}
+InflateDestroy(inflate);
+#endif
+
+typedef enum CompressFormat CompressFormat;
+enum CompressFormat {
+  CompressFormat_Raw,  // NOTE: Bare DEFLATE blocks.
+  CompressFormat_Zlib, // NOTE: 2 byte header, Adler-32 trailer. E.g. PNG image data.
+  CompressFormat_Gzip, // NOTE: .gz files, CRC-32 trailer. Only the first member is read.
+};
+
+typedef enum CompressStatus CompressStatus;
+enum CompressStatus {
+  CompressStatus_Error,
+  CompressStatus_NeedsInput,  // NOTE: All input was consumed, call again with more.
+  CompressStatus_NeedsOutput, // NOTE: The output buffer is full, call again with more room.
+  CompressStatus_Done,        // NOTE: The stream ended, and its checksum (if any) matched.
+};
+
+typedef enum DeflateLevel DeflateLevel;
+enum DeflateLevel {
+  DeflateLevel_Fast,    // NOTE: Greedy matching over short hash chains.
+  DeflateLevel_Default, // NOTE: Lazy matching.
+  DeflateLevel_Best,    // NOTE: Lazy matching over long hash chains, for e.g. offline baking.
+};
+
+typedef struct Inflate Inflate;
+B32  InflateCreate(Inflate** inflate, CompressFormat format);
+void InflateDestroy(Inflate* inflate);
+// NOTE: Consumes up to in_size bytes of in, and writes up to out_size bytes to out. Once Done, in_read excludes any
+// data following the stream.
+CompressStatus InflateRun(Inflate* inflate, U8* in, U64 in_size, U64* in_read, U8* out, U64 out_size, U64* out_written);
+B32  InflateAll(Arena* arena, CompressFormat format, U8* in, U64 in_size, U8** out, U64* out_size);
+
+typedef struct Deflate Deflate;
+B32  DeflateCreate(Deflate** deflate, CompressFormat format, DeflateLevel level);
+void DeflateDestroy(Deflate* deflate);
+// NOTE: Like InflateRun. Pass finish once all input has been provided, then call until Done.
+CompressStatus DeflateRun(Deflate* deflate, U8* in, U64 in_size, U64* in_read, U8* out, U64 out_size, U64* out_written, B32 finish);
+B32  DeflateAll(Arena* arena, CompressFormat format, DeflateLevel level, U8* in, U64 in_size, U8** out, U64* out_size);
+
+// NOTE: Asset packs bake many named blobs (e.g. decoded image pixels or mesh arrays) into a single file offline, so
+// at runtime they can be found with a hash lookup after one FileMapOpen, with no parsing or copying. Each entry's
+// data starts on a PACK_DATA_ALIGNMENT boundary, so it can be reinterpreted directly as arrays of e.g. V3 or U32.
+// Data pointers handed out by the reader point into the (read-only) mapping, and are valid until PackClose.
+//
+// Layout: [PackHeader][entry data, aligned]...[PackEntry * entries_size][U32 table * table_size][names]
+// table is an open addressed hash table (linear probing) of indices + 1 into the entries, 0 means empty.
+//
+// E.g.
+#if 0
+PackWriter writer;
+PackWriterOpen(&writer, Str8Lit("assets.pack"));
+PackWriterAdd(&writer, Str8Lit("shaders/basic.frag"), frag_src.str, frag_src.size, PackCompression_None);
+PackWriterClose(&writer);
+
+Pack pack;
+PackOpen(&pack, Str8Lit("assets.pack"), FileMapHint_None);
+U8* frag_src; U64 frag_src_size;
+PackGet(&pack, Str8Lit("shaders/basic.frag"), &frag_src, &frag_src_size);
+PackClose(&pack);
+#endif
+
+#define PACK_MAGIC          0x4B434150 // NOTE: "PACK"
+#define PACK_VERSION        2
+#define PACK_DATA_ALIGNMENT 64
+
+typedef enum PackCompression PackCompression;
+enum PackCompression {
+  PackCompression_None    = 0, // NOTE: Stored as is, may be read zero-copy with PackGet.
+  PackCompression_Deflate = 1, // NOTE: Raw DEFLATE, must be read with PackRead. Stored as is if it doesn't shrink.
+};
+
+typedef struct PackHeader PackHeader;
+struct PackHeader {
+  U32 magic;
+  U32 version;
+  U32 entries_size;
+  U32 table_size; // NOTE: Always a power of 2.
+  U64 toc_offset;
+  U64 file_size;  // NOTE: For detecting truncated packs.
+};
+
+typedef struct PackEntry PackEntry;
+struct PackEntry {
+  U64 name_hash;
+  U64 offset;   // NOTE: From the start of the file.
+  U64 size;     // NOTE: Stored size.
+  U64 raw_size; // NOTE: Size once decompressed, equal to size if uncompressed.
+  U64 checksum; // NOTE: Crc32c of the stored bytes.
+  U32 name_offset;
+  U32 name_size;
+  U32 compression;
+  U32 _pad;
+};
+
+typedef struct PackWriterEntry PackWriterEntry;
+struct PackWriterEntry {
+  PackEntry entry;
+  String8 name;
+  PackWriterEntry* next;
+};
+
+typedef struct PackWriter PackWriter;
+struct PackWriter {
+  FileWriter file;
+  Arena* arena;
+  PackWriterEntry* entries_head;
+  PackWriterEntry* entries_tail;
+  U32 entries_size;
+  PackWriterEntry* entry; // NOTE: The entry between PackWriterBegin and PackWriterEnd, if any.
+  U64 names_size;
+  B32 is_failed;
+};
+
+typedef struct Pack Pack;
+struct Pack {
+  FileMap map;
+  PackHeader* header;
+  PackEntry* entries;
+  U32* table;
+  U8* names;
+};
+
+B32 PackWriterOpen(PackWriter* writer, String8 file_path);
+B32 PackWriterAdd(PackWriter* writer, String8 name, U8* data, U64 data_size, PackCompression compression); // NOTE: data is written immediately, and need not outlive the call.
+// NOTE: Streams a single uncompressed entry in pieces, e.g. a header then a payload, without gathering them in memory first.
+B32 PackWriterBegin(PackWriter* writer, String8 name);
+B32 PackWriterAppend(PackWriter* writer, U8* data, U64 data_size); // NOTE: Appended right after the previous piece, so pad sections manually.
+B32 PackWriterEnd(PackWriter* writer);
+B32 PackWriterClose(PackWriter* writer); // NOTE: Writes the table of contents. Fails on duplicate names, or if any prior add failed.
+
+B32        PackOpen(Pack* pack, String8 file_path, FileMapHint hints); // NOTE: Validates the header and table of contents, but not the entry data, see PackEntryVerify.
+B32        PackClose(Pack* pack);
+PackEntry* PackFind(Pack* pack, String8 name); // NOTE: Returns NULL if not present.
+String8    PackEntryName(Pack* pack, PackEntry* entry);
+U8*        PackEntryData(Pack* pack, PackEntry* entry); // NOTE: The stored (possibly compressed) bytes.
+B32        PackEntryVerify(Pack* pack, PackEntry* entry); // NOTE: Checks the entry's checksum. Touches all of its data, so e.g. do this in the bake step or a debug build.
+B32        PackGet(Pack* pack, String8 name, U8** data, U64* data_size); // NOTE: Zero-copy. Fails if the entry is missing or compressed.
+B32        PackRead(Arena* arena, Pack* pack, String8 name, U8** data, U64* data_size); // NOTE: Copies (and decompresses) the entry into arena, verifying its checksum.
+
+// NOTE: Asynchronous, positional reads. Submit a batch of requests, then Poll or Wait for them to
+// complete (in any order). Backed by io_uring on linux and overlapped IO on windows, or a pool of
+// worker threads issuing blocking reads where those are unavailable.
+//
+// Requests and their buffers are owned by the caller (e.g. pushed on an arena), and must stay valid
+// until they are returned by Poll / Wait. Async reads leave the handle's seek position unspecified.
+//
+// E.g.
+#if 0
+FileReadRequest* requests = ARENA_PUSH_ARRAY(arena, FileReadRequest, files_size);
+for (U32 i = 0; i < files_size; i++) {
+  MEMORY_ZERO_STRUCT(&requests[i]);
+  requests[i].file   = files[i];
+  requests[i].buffer = ARENA_PUSH_ARRAY(arena, U8, sizes[i]);
+  requests[i].size   = sizes[i];
+}
+FileReadQueue* queue;
+FileReadQueueCreate(&queue, 32, FileReadQueueBackend_Native);
+FileReadQueueSubmit(queue, requests, files_size);
+FileReadRequest* completed[32];
+U32 completed_size;
+while ((completed_size = FileReadQueueWait(queue, completed, STATIC_ARRAY_SIZE(completed))) > 0) {
+  for (U32 i = 0; i < completed_size; i++) { Process(completed[i]); }
+}
+FileReadQueueDestroy(queue);
+#endif
+
+#define FILE_READ_QUEUE_MAX_DEPTH 64
+
+typedef enum FileReadQueueBackend FileReadQueueBackend;
+enum FileReadQueueBackend {
+  FileReadQueueBackend_Native,  // NOTE: io_uring / overlapped IO. Falls back to Threads if unavailable.
+  FileReadQueueBackend_Threads, // NOTE: one worker thread per slot in the queue.
+};
+
+typedef struct FileReadRequest FileReadRequest;
+struct FileReadRequest {
+  FileHandle* file;
+  U64 offset;
+  U8* buffer;
+  U32 size;
+  void* user_data;
+  // NOTE: Populated on completion.
+  B32 success;
+  U32 bytes_read; // NOTE: May be less than size if EOF was observed.
+  FileReadRequest* next;
+};
+
+typedef struct FileReadQueue FileReadQueue;
+B32  FileReadQueueCreate(FileReadQueue** queue, U32 depth, FileReadQueueBackend backend); // NOTE: depth is the max num of reads in flight at once, up to FILE_READ_QUEUE_MAX_DEPTH.
+void FileReadQueueDestroy(FileReadQueue* queue); // NOTE: Waits for any outstanding reads to complete first.
+FileReadQueueBackend FileReadQueueGetBackend(FileReadQueue* queue); // NOTE: The backend actually in use, after any fallback.
+void FileReadQueueSubmit(FileReadQueue* queue, FileReadRequest* requests, U32 requests_size); // NOTE: Requests past depth are held, and issued as earlier ones complete.
+U32  FileReadQueuePoll(FileReadQueue* queue, FileReadRequest** completed, U32 completed_cap); // NOTE: Non-blocking. Places up to completed_cap finished requests into completed, returns the num placed.
+U32  FileReadQueueWait(FileReadQueue* queue, FileReadRequest** completed, U32 completed_cap); // NOTE: Like Poll, but blocks until at least one request completes. Returns 0 only if nothing is outstanding.
+U32  FileReadQueueOutstanding(FileReadQueue* queue); // NOTE: Num of submitted requests not yet returned by Poll / Wait.
+
+// NOTE: Reports changes to the files under a directory, e.g. to hot reload shaders or configs, instead of calling
+// FileStat on every file every frame. Backed by inotify on linux and ReadDirectoryChangesW on windows. The OS queues
+// changes in the background, and Poll never blocks: it drains everything queued so far, and coalesces repeated
+// changes to the same path (e.g. the many writes an editor makes while saving) into a single event.
+//
+// Events are reported for directories as well as files. Renames are reported as a Deleted old path and a Created
+// new path. Poll soon after a change may observe it mid-write, so readers should tolerate e.g. a truncated file, and
+// expect another Modified event once the write finishes.
+//
+// E.g.
+#if 0
+FileWatcher* watcher;
+FileWatcherCreate(&watcher, Str8Lit("shaders"), true);
+while (running) {
+  FileWatchEvent* events;
+  U64 events_size;
+  FileWatcherPoll(watcher, frame_arena, &events, &events_size);
+  for (U64 i = 0; i < events_size; i++) {
+    if (events[i].flags & FileWatchEventFlags_Overflow) { ReloadAll(); }
+    else if (events[i].flags & (FileWatchEventFlags_Created | FileWatchEventFlags_Modified)) { Reload(events[i].path); }
+  }
+}
+FileWatcherDestroy(watcher);
+#endif
+
+typedef enum FileWatchEventFlags FileWatchEventFlags;
+enum FileWatchEventFlags {
+  FileWatchEventFlags_Created  = BIT(0),
+  FileWatchEventFlags_Modified = BIT(1), // NOTE: Contents or size changed.
+  FileWatchEventFlags_Deleted  = BIT(2),
+  FileWatchEventFlags_Overflow = BIT(3), // NOTE: The OS dropped changes. path is the watched directory, and anything under it may have changed.
+};
+
+typedef struct FileWatchEvent FileWatchEvent;
+struct FileWatchEvent {
+  String8 path; // NOTE: The watched directory joined with the changed path, separated by '/'.
+  FileWatchEventFlags flags; // NOTE: Every kind of change observed since the last poll, e.g. Created | Deleted for a temp file.
+};
+
+typedef struct FileWatcher FileWatcher;
+B32  FileWatcherCreate(FileWatcher** watcher, String8 dir_path, B32 recursive); // NOTE: Watches dir_path, and all directories under it if recursive (including ones created later).
+void FileWatcherDestroy(FileWatcher* watcher);
+B32  FileWatcherPoll(FileWatcher* watcher, Arena* arena, FileWatchEvent** events, U64* events_size); // NOTE: Non-blocking. Places the changes since the last poll into *events, in the order each path first changed.
+
+B32  LogInitStdOut();
+B32  LogInitFile(String8 file_path);
+void LogDeinit(); // NOTE: Flushes, and closes the log file if any. Logging may be re-initialized afterwards.
+
+// NOTE: By default, each log call formats its record and writes it to the OS under a lock. In async mode, records
+// are instead copied into a lock-free ring, and a background thread writes them out in batches (writev on linux).
+// Records that don't fit in a ring slot are written synchronously. LogLevel_Error records, LogDeinit and process
+// exit flush the ring before returning, so errors logged ahead of a crash are not lost.
+#ifndef LOG_ASYNC_RECORD_SIZE
+#define LOG_ASYNC_RECORD_SIZE 512 // NOTE: Bytes per ring slot, including a small header.
+#endif
+
+typedef enum LogAsyncPolicy LogAsyncPolicy;
+enum LogAsyncPolicy {
+  LogAsyncPolicy_Block, // NOTE: When the ring is full, loggers wait for the writer to catch up.
+  LogAsyncPolicy_Drop,  // NOTE: When the ring is full, records are discarded. See LogGetDroppedCount.
+};
+
+B32  LogEnableAsync(U32 ring_size, LogAsyncPolicy policy); // NOTE: Call after LogInit*. ring_size is the num of records, must be a power of 2.
+void LogFlush();          // NOTE: Blocks until everything logged so far is written. A no-op if not in async mode.
+U64  LogGetDroppedCount(); // NOTE: Num of records discarded by LogAsyncPolicy_Drop.
 
-B32 LogInitStdOut();
-B32 LogInitFile(String8 file_path);
 #define LOG_NO_PREFIX(fmt, ...)  Log(LogLevel_NoPrefix, Str8Lit(__FILE__), __LINE__, Str8Lit(fmt), ##__VA_ARGS__)
 #define LOG_INFO(fmt, ...)       Log(LogLevel_Info,     Str8Lit(__FILE__), __LINE__, Str8Lit(fmt), ##__VA_ARGS__)
 #define LOG_WARN(fmt, ...)       Log(LogLevel_Warning,  Str8Lit(__FILE__), __LINE__, Str8Lit(fmt), ##__VA_ARGS__)
@@ -91,6 +515,9 @@ void Log(LogLevel level, String8 filename, U32 loc, String8 fmt, ...);
 #ifdef CDEFAULT_IO_IMPLEMENTATION
 #undef CDEFAULT_IO_IMPLEMENTATION
 
+// NOTE: Records one change for the next FileWatcherPoll. Called by the backends, defined below.
+static void _FileWatcherPush(FileWatcher* watcher, String8 dir_path, String8 name, FileWatchEventFlags flags);
+
 #if defined(OS_WINDOWS)
 #define CDEFAULT_IO_BACKEND_NAMESPACE WIN_
 
@@ -99,6 +526,7 @@ void Log(LogLevel level, String8 filename, U32 loc, String8 fmt, ...);
 struct FileHandle {
   Arena* arena;
   HANDLE handle;
+  HANDLE overlapped_handle; // NOTE: Lazily reopened with FILE_FLAG_OVERLAPPED for FileReadQueue.
   String8 file_path;
   B8 is_writing;
 };
@@ -131,7 +559,7 @@ B32 WIN_FileStat(String8 file_path, FileStats* stats) {
     WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to stat file: %S", file_path);
     return false;
   }
-  stats->size = (((U32) attributes.nFileSizeHigh) << 16) | attributes.nFileSizeLow;
+  stats->size = (((U64) attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
   stats->last_write_time = WIN_FileTimeToEpochSeconds(&attributes.ftLastWriteTime);
   stats->last_access_time = WIN_FileTimeToEpochSeconds(&attributes.ftLastAccessTime);
   return true;
@@ -143,7 +571,7 @@ B32 WIN_FileHandleStat(FileHandle* file, FileStats* stats) {
     WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to stat file: %S", file->file_path);
     return false;
   }
-  stats->size = (((U32) attributes.nFileSizeHigh) << 16) | attributes.nFileSizeLow;
+  stats->size = (((U64) attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
   stats->last_write_time = WIN_FileTimeToEpochSeconds(&attributes.ftLastWriteTime);
   stats->last_access_time = WIN_FileTimeToEpochSeconds(&attributes.ftLastAccessTime);
   return true;
@@ -231,6 +659,91 @@ win_dir_list_files_exit:
   return success;
 }
 
+B32 WIN_FileDelete(String8 file_path) {
+  Arena* temp_arena = ArenaAllocate();
+  U8* file_path_cstr = CStrFromStr8(temp_arena, file_path);
+  CStrReplaceAllChar(file_path_cstr, '/', '\\');
+  B32 success = DeleteFileA((LPCSTR) file_path_cstr);
+  if (!success) { WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to delete file: %S", file_path); }
+  ArenaRelease(temp_arena);
+  return success;
+}
+
+B32 WIN_DirCreate(String8 dir_path) {
+  Arena* temp_arena = ArenaAllocate();
+  U8* dir_path_cstr = CStrFromStr8(temp_arena, dir_path);
+  CStrReplaceAllChar(dir_path_cstr, '/', '\\');
+  B32 success = true;
+  // NOTE: creates each missing parent in turn, e.g. a, a\b, a\b\c. Drive letters are skipped.
+  for (U32 i = 1; i <= dir_path.size && success; i++) {
+    if (i < dir_path.size && dir_path_cstr[i] != '\\') { continue; }
+    if (dir_path_cstr[i - 1] == ':' || dir_path_cstr[i - 1] == '\\') { continue; }
+    U8 c = dir_path_cstr[i];
+    dir_path_cstr[i] = 0;
+    if (!CreateDirectoryA((LPCSTR) dir_path_cstr, NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+      WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to create directory: %S", dir_path);
+      success = false;
+    }
+    dir_path_cstr[i] = c;
+  }
+  ArenaRelease(temp_arena);
+  return success;
+}
+
+B32 WIN_DirDelete(String8 dir_path) {
+  Arena* temp_arena = ArenaAllocate();
+  U8* dir_path_cstr = CStrFromStr8(temp_arena, dir_path);
+  CStrReplaceAllChar(dir_path_cstr, '/', '\\');
+  B32 success = RemoveDirectoryA((LPCSTR) dir_path_cstr);
+  if (!success) { WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to delete directory: %S", dir_path); }
+  ArenaRelease(temp_arena);
+  return success;
+}
+
+typedef struct WIN_DirWalkIter WIN_DirWalkIter;
+struct WIN_DirWalkIter {
+  HANDLE handle;
+  B32 is_first;
+  WIN32_FIND_DATAA find_data;
+};
+
+B32 WIN_DirWalkIterOpen(WIN_DirWalkIter* iter, Arena* arena, String8 dir_path) {
+  U64 arena_pos = ArenaPos(arena);
+  U8* query_cstr = CStrFromStr8(arena, Str8Concat(arena, dir_path, Str8Lit("/*")));
+  CStrReplaceAllChar(query_cstr, '/', '\\');
+  // NOTE: FindExInfoBasic skips looking up 8.3 names, LARGE_FETCH asks for bigger batches per call.
+  iter->handle   = FindFirstFileExA((char*) query_cstr, FindExInfoBasic, &iter->find_data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+  iter->is_first = true;
+  ArenaPopTo(arena, arena_pos);
+  if (iter->handle == INVALID_HANDLE_VALUE) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to read contents of directory: %S", dir_path);
+    return false;
+  }
+  return true;
+}
+
+// NOTE: entry->name points into iter, and is null terminated. The listing includes sizes and times,
+// so those are filled in here.
+B32 WIN_DirWalkIterNext(WIN_DirWalkIter* iter, DirEntry* entry) {
+  if (!iter->is_first && !FindNextFileA(iter->handle, &iter->find_data)) { return false; }
+  iter->is_first = false;
+  WIN32_FIND_DATAA* data = &iter->find_data;
+  entry->name = Str8CStr(data->cFileName);
+  if      (data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) { entry->type = DirEntryType_Symlink; }
+  else if (data->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)     { entry->type = DirEntryType_Dir;     }
+  else if (data->dwFileAttributes & FILE_ATTRIBUTE_DEVICE)        { entry->type = DirEntryType_Other;   }
+  else                                                             { entry->type = DirEntryType_File;    }
+  entry->size            = (((U64) data->nFileSizeHigh) << 32) | data->nFileSizeLow;
+  entry->last_write_time = WIN_FileTimeToEpochSeconds(&data->ftLastWriteTime);
+  return true;
+}
+
+void WIN_DirWalkIterStat(WIN_DirWalkIter* UNUSED(iter), String8 UNUSED(name), DirEntry* UNUSED(entry)) {}
+
+void WIN_DirWalkIterClose(WIN_DirWalkIter* iter) {
+  FindClose(iter->handle);
+}
+
 B32 WIN_FileHandleOpenStdOut(FileHandle** file) {
   HANDLE handle = CreateFileA("CON", GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
   if (handle == INVALID_HANDLE_VALUE) {
@@ -271,8 +784,11 @@ B32 WIN_FileHandleOpen(FileHandle** file, String8 file_path, FileMode mode) {
   DWORD share_mode = 0;
   if (!write && read) { share_mode |= FILE_SHARE_READ; }
 
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+  if (mode & FileMode_Unbuffered) { flags |= FILE_FLAG_NO_BUFFERING; }
+
   U8* file_path_cstr = CStrFromStr8(arena, file_path);
-  HANDLE handle = CreateFileA((const char*) file_path_cstr, desired_access, FILE_SHARE_READ, NULL, disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+  HANDLE handle = CreateFileA((const char*) file_path_cstr, desired_access, FILE_SHARE_READ, NULL, disposition, flags, NULL);
   ArenaClear(arena);
   if (handle == INVALID_HANDLE_VALUE) {
     WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to open file: %S", file_path);
@@ -296,6 +812,10 @@ B32 WIN_FileHandleClose(FileHandle* file) {
     WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to flush file: %S", file->file_path);
     return false;
   }
+  if (file->overlapped_handle != NULL && !CloseHandle(file->overlapped_handle)) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to close overlapped file: %S", file->file_path);
+    return false;
+  }
   if (!CloseHandle(file->handle)) {
     WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to close file: %S", file->file_path);
     return false;
@@ -304,7 +824,7 @@ B32 WIN_FileHandleClose(FileHandle* file) {
   return true;
 }
 
-B32 WIN_FileHandleSeek(FileHandle* file, S32 distance, FileSeekPos pos) {
+B32 WIN_FileHandleSeek(FileHandle* file, S64 distance, FileSeekPos pos) {
   DWORD move_method = 0;
   switch (pos) {
     case FileSeekPos_Begin:   { move_method = FILE_BEGIN;   } break;
@@ -312,7 +832,9 @@ B32 WIN_FileHandleSeek(FileHandle* file, S32 distance, FileSeekPos pos) {
     case FileSeekPos_End:     { move_method = FILE_END;     } break;
     default: UNIMPLEMENTED(); break;
   }
-  if (SetFilePointer(file->handle, distance, NULL, move_method) == INVALID_SET_FILE_POINTER) {
+  LARGE_INTEGER move;
+  move.QuadPart = distance;
+  if (!SetFilePointerEx(file->handle, move, NULL, move_method)) {
     WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to seek: %S", file->file_path);
     return false;
   }
@@ -348,6 +870,333 @@ B32 WIN_FileHandleWrite(FileHandle* file, U8* buffer, U32 buffer_size) {
   return true;
 }
 
+// NOTE: windows only supports gather writes for unbuffered, overlapped handles, so coalesce the buffers instead.
+B32 WIN_FileHandleWriteGather(FileHandle* file, String8* buffers, U32 buffers_size) {
+  U64 arena_base = ArenaPos(file->arena);
+  U64 total = 0;
+  for (U32 i = 0; i < buffers_size; i++) { total += buffers[i].size; }
+  U8* data = ARENA_PUSH_ARRAY(file->arena, U8, total);
+  U64 pos = 0;
+  for (U32 i = 0; i < buffers_size; i++) {
+    MEMORY_COPY_SIZE(data + pos, buffers[i].str, buffers[i].size);
+    pos += buffers[i].size;
+  }
+  B32 success = WIN_FileHandleWrite(file, data, (U32) total);
+  ArenaPopTo(file->arena, arena_base);
+  return success;
+}
+
+B32 WIN_FileHandleSetSize(FileHandle* file, U64 size) {
+  FILE_END_OF_FILE_INFO info;
+  info.EndOfFile.QuadPart = size;
+  if (!SetFileInformationByHandle(file->handle, FileEndOfFileInfo, &info, sizeof(info))) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to set file size: %S", file->file_path);
+    return false;
+  }
+  return true;
+}
+
+B32 WIN_FileHandleReadAt(FileHandle* file, U64 offset, U8* buffer, U32 buffer_size, U32* bytes_read) {
+  OVERLAPPED overlapped;
+  MEMORY_ZERO_STRUCT(&overlapped);
+  overlapped.Offset     = (DWORD) offset;
+  overlapped.OffsetHigh = (DWORD) (offset >> 32);
+  DWORD read = 0;
+  if (!ReadFile(file->handle, (LPVOID) buffer, buffer_size, &read, &overlapped)) {
+    DWORD error = GetLastError();
+    // NOTE: reads starting past the end of the file fail, rather than reading 0 bytes.
+    if (error != ERROR_HANDLE_EOF) {
+      WIN_IO_LOG_ERROR_EX(error, "[IO] Failed to read file: %S", file->file_path);
+      return false;
+    }
+  }
+  *bytes_read = read;
+  return true;
+}
+
+#define CDEFAULT_IO_NATIVE_READ_QUEUE
+
+typedef struct WIN_FileReadQueueSlot WIN_FileReadQueueSlot;
+struct WIN_FileReadQueueSlot {
+  OVERLAPPED overlapped;
+  FileReadRequest* request; // NOTE: NULL if the slot is free.
+};
+
+// NOTE: Completions are detected via per-slot events, rather than an IO completion port, since a
+// handle can only ever be associated with a single port. This caps the depth at MAXIMUM_WAIT_OBJECTS.
+typedef struct WIN_FileReadQueueNative WIN_FileReadQueueNative;
+struct WIN_FileReadQueueNative {
+  WIN_FileReadQueueSlot slots[FILE_READ_QUEUE_MAX_DEPTH];
+  U32 slots_size;
+};
+STATIC_ASSERT(FILE_READ_QUEUE_MAX_DEPTH <= MAXIMUM_WAIT_OBJECTS, "FileReadQueue slots must be waitable at once.");
+
+B32 WIN_FileReadQueueNativeInit(WIN_FileReadQueueNative* native, U32 depth) {
+  MEMORY_ZERO_STRUCT(native);
+  for (U32 i = 0; i < depth; i++) {
+    HANDLE event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (event == NULL) {
+      WIN_IO_LOG_ERROR(GetLastError(), "[IO] Failed to create read queue event.");
+      for (U32 j = 0; j < native->slots_size; j++) { CloseHandle(native->slots[j].overlapped.hEvent); }
+      return false;
+    }
+    native->slots[native->slots_size++].overlapped.hEvent = event;
+  }
+  return true;
+}
+
+void WIN_FileReadQueueNativeDeinit(WIN_FileReadQueueNative* native) {
+  for (U32 i = 0; i < native->slots_size; i++) {
+    DEBUG_ASSERT(native->slots[i].request == NULL);
+    CloseHandle(native->slots[i].overlapped.hEvent);
+  }
+}
+
+// NOTE: Returns false if the read completed (or failed) immediately instead of being put in flight.
+B32 WIN_FileReadQueueNativeIssue(WIN_FileReadQueueNative* native, FileReadRequest* request) {
+  WIN_FileReadQueueSlot* slot = NULL;
+  for (U32 i = 0; i < native->slots_size; i++) {
+    if (native->slots[i].request == NULL) { slot = &native->slots[i]; break; }
+  }
+  DEBUG_ASSERT(slot != NULL);
+  request->success    = false;
+  request->bytes_read = 0;
+
+  FileHandle* file = request->file;
+  if (file->overlapped_handle == NULL) {
+    HANDLE handle = ReOpenFile(file->handle, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, FILE_FLAG_OVERLAPPED);
+    if (handle == INVALID_HANDLE_VALUE) {
+      WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to reopen file for overlapped reads: %S", file->file_path);
+      return false;
+    }
+    file->overlapped_handle = handle;
+  }
+
+  HANDLE event = slot->overlapped.hEvent;
+  MEMORY_ZERO_STRUCT(&slot->overlapped);
+  slot->overlapped.hEvent     = event;
+  slot->overlapped.Offset     = (DWORD) request->offset;
+  slot->overlapped.OffsetHigh = (DWORD) (request->offset >> 32);
+  if (!ReadFile(file->overlapped_handle, (LPVOID) request->buffer, request->size, NULL, &slot->overlapped)) {
+    DWORD error = GetLastError();
+    if (error == ERROR_HANDLE_EOF) {
+      request->success = true;
+      return false;
+    } else if (error != ERROR_IO_PENDING) {
+      WIN_IO_LOG_ERROR_EX(error, "[IO] Failed to read file: %S", file->file_path);
+      return false;
+    }
+  }
+  // NOTE: reads that complete synchronously still signal the event, so they're reaped like any other.
+  slot->request = request;
+  return true;
+}
+
+// NOTE: reads are issued to the OS immediately, so there's nothing to flush.
+void WIN_FileReadQueueNativeFlush(WIN_FileReadQueueNative* UNUSED(native)) {}
+
+U32 WIN_FileReadQueueNativeReap(WIN_FileReadQueueNative* native, FileReadRequest** completed, U32 completed_cap, B32 wait) {
+  U32 completed_size = 0;
+  while (true) {
+    HANDLE events[FILE_READ_QUEUE_MAX_DEPTH];
+    U32 events_size = 0;
+    for (U32 i = 0; i < native->slots_size && completed_size < completed_cap; i++) {
+      WIN_FileReadQueueSlot* slot = &native->slots[i];
+      if (slot->request == NULL) { continue; }
+      if (!HasOverlappedIoCompleted(&slot->overlapped)) {
+        events[events_size++] = slot->overlapped.hEvent;
+        continue;
+      }
+      FileReadRequest* request = slot->request;
+      DWORD read = 0;
+      request->success = true;
+      if (!GetOverlappedResult(request->file->overlapped_handle, &slot->overlapped, &read, FALSE)) {
+        DWORD error = GetLastError();
+        if (error != ERROR_HANDLE_EOF) {
+          WIN_IO_LOG_ERROR_EX(error, "[IO] Failed to read file: %S", request->file->file_path);
+          request->success = false;
+        }
+      }
+      request->bytes_read = read;
+      slot->request = NULL;
+      completed[completed_size++] = request;
+    }
+    if (completed_size > 0 || !wait || events_size == 0) { break; }
+    DWORD result = WaitForMultipleObjects(events_size, events, FALSE, INFINITE);
+    DEBUG_ASSERT(result < WAIT_OBJECT_0 + events_size);
+  }
+  return completed_size;
+}
+
+B32 WIN_FileMapOpen(String8 file_path, FileMap* map, FileMapHint hints) {
+  B32 success    = false;
+  HANDLE file    = INVALID_HANDLE_VALUE;
+  HANDLE mapping = NULL;
+  MEMORY_ZERO_STRUCT(map);
+  Arena* temp_arena = ArenaAllocate();
+
+  U8* file_path_cstr = CStrFromStr8(temp_arena, file_path);
+  CStrReplaceAllChar(file_path_cstr, '/', '\\');
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+  if (hints & FileMapHint_Sequential) { flags |= FILE_FLAG_SEQUENTIAL_SCAN; }
+  file = CreateFileA((LPCSTR) file_path_cstr, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to open file: %S", file_path);
+    goto win_file_map_open_exit;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to stat file: %S", file_path);
+    goto win_file_map_open_exit;
+  }
+  map->size = size.QuadPart;
+  // NOTE: empty files can't be mapped.
+  if (map->size == 0) {
+    success = true;
+    goto win_file_map_open_exit;
+  }
+
+  mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to create file mapping: %S", file_path);
+    goto win_file_map_open_exit;
+  }
+  map->data = (U8*) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (map->data == NULL) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to map view of file: %S", file_path);
+    goto win_file_map_open_exit;
+  }
+  if (hints & FileMapHint_WillNeed) {
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = map->data;
+    range.NumberOfBytes  = map->size;
+    if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0)) {
+      LOG_DEBUG("[IO] Failed to prefetch mapped file, ignoring: %S", file_path);
+    }
+  }
+  // NOTE: windows only supports large pages for pagefile-backed sections, so FileMapHint_HugePages is ignored.
+  success = true;
+
+win_file_map_open_exit:
+  // NOTE: the view keeps the file and mapping objects alive, so their handles can be closed immediately.
+  if (mapping != NULL)              { CloseHandle(mapping); }
+  if (file != INVALID_HANDLE_VALUE) { CloseHandle(file); }
+  if (!success) { MEMORY_ZERO_STRUCT(map); }
+  ArenaRelease(temp_arena);
+  return success;
+}
+
+B32 WIN_FileMapClose(FileMap* map) {
+  if (map->data != NULL && !UnmapViewOfFile(map->data)) {
+    WIN_IO_LOG_ERROR(GetLastError(), "[IO] Failed to unmap file.");
+    return false;
+  }
+  MEMORY_ZERO_STRUCT(map);
+  return true;
+}
+
+// NOTE: One overlapped ReadDirectoryChangesW is kept in flight. Between polls, the OS queues further changes
+// internally (since the first call), and reports an empty result if that queue overflows.
+typedef struct WIN_FileWatcherNative WIN_FileWatcherNative;
+struct WIN_FileWatcherNative {
+  HANDLE handle;
+  OVERLAPPED overlapped;
+  B32 recursive;
+  String8 dir_path;
+  DWORD buffer[KB(16)]; // NOTE: Must be DWORD aligned. Kept to 64KB, the limit for watching network shares.
+};
+
+static B32 WIN_FileWatcherNativeIssue(WIN_FileWatcherNative* native) {
+  DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE |
+                 FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION;
+  if (!ReadDirectoryChangesW(native->handle, native->buffer, sizeof(native->buffer), native->recursive, filter, NULL, &native->overlapped, NULL)) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to watch directory: %S", native->dir_path);
+    return false;
+  }
+  return true;
+}
+
+B32 WIN_FileWatcherNativeInit(WIN_FileWatcherNative* native, Arena* arena, String8 dir_path, B32 recursive) {
+  MEMORY_ZERO_STRUCT(native);
+  native->recursive = recursive;
+  native->dir_path  = dir_path;
+  U64 arena_pos = ArenaPos(arena);
+  U8* dir_path_cstr = CStrFromStr8(arena, dir_path);
+  CStrReplaceAllChar(dir_path_cstr, '/', '\\');
+  native->handle = CreateFileA(
+      (LPCSTR) dir_path_cstr, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+      OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+  ArenaPopTo(arena, arena_pos);
+  if (native->handle == INVALID_HANDLE_VALUE) {
+    WIN_IO_LOG_ERROR_EX(GetLastError(), "[IO] Failed to open directory to watch: %S", dir_path);
+    return false;
+  }
+  native->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+  if (native->overlapped.hEvent == NULL) {
+    WIN_IO_LOG_ERROR(GetLastError(), "[IO] Failed to create directory watch event.");
+    CloseHandle(native->handle);
+    return false;
+  }
+  if (!WIN_FileWatcherNativeIssue(native)) {
+    CloseHandle(native->overlapped.hEvent);
+    CloseHandle(native->handle);
+    return false;
+  }
+  return true;
+}
+
+void WIN_FileWatcherNativeDeinit(WIN_FileWatcherNative* native) {
+  DWORD bytes;
+  CancelIoEx(native->handle, &native->overlapped);
+  GetOverlappedResult(native->handle, &native->overlapped, &bytes, TRUE);
+  CloseHandle(native->overlapped.hEvent);
+  CloseHandle(native->handle);
+}
+
+B32 WIN_FileWatcherNativePoll(WIN_FileWatcherNative* native, FileWatcher* watcher, Arena* arena) {
+  while (true) {
+    DWORD bytes;
+    if (!GetOverlappedResult(native->handle, &native->overlapped, &bytes, FALSE)) {
+      DWORD result = GetLastError();
+      if (result == ERROR_IO_INCOMPLETE) { return true; }
+      if (result != ERROR_NOTIFY_ENUM_DIR) {
+        WIN_IO_LOG_ERROR_EX(result, "[IO] Failed to read changes to directory: %S", native->dir_path);
+        return false;
+      }
+      bytes = 0;
+    }
+
+    if (bytes == 0) {
+      _FileWatcherPush(watcher, native->dir_path, Str8Lit(""), FileWatchEventFlags_Overflow);
+    } else {
+      U8* record = (U8*) native->buffer;
+      while (true) {
+        FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*) record;
+        FileWatchEventFlags flags = 0;
+        switch (info->Action) {
+          case FILE_ACTION_ADDED:
+          case FILE_ACTION_RENAMED_NEW_NAME: { flags = FileWatchEventFlags_Created;  } break;
+          case FILE_ACTION_REMOVED:
+          case FILE_ACTION_RENAMED_OLD_NAME: { flags = FileWatchEventFlags_Deleted;  } break;
+          case FILE_ACTION_MODIFIED:         { flags = FileWatchEventFlags_Modified; } break;
+        }
+        if (flags != 0) {
+          S32 name_wide_size = info->FileNameLength / sizeof(WCHAR);
+          S32 name_size = WideCharToMultiByte(CP_UTF8, 0, info->FileName, name_wide_size, NULL, 0, NULL, NULL);
+          String8 name;
+          name.str  = ARENA_PUSH_ARRAY(arena, U8, name_size);
+          name.size = WideCharToMultiByte(CP_UTF8, 0, info->FileName, name_wide_size, (LPSTR) name.str, name_size, NULL, NULL);
+          Str8ReplaceAllChar(&name, '\\', '/');
+          _FileWatcherPush(watcher, native->dir_path, name, flags);
+        }
+        if (info->NextEntryOffset == 0) { break; }
+        record += info->NextEntryOffset;
+      }
+    }
+    if (!WIN_FileWatcherNativeIssue(native)) { return false; }
+  }
+}
+
 #elif defined(OS_LINUX)
 #define CDEFAULT_IO_BACKEND_NAMESPACE LINUX_
 
@@ -355,9 +1204,16 @@ B32 WIN_FileHandleWrite(FileHandle* file, U8* buffer, U32 buffer_size) {
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/inotify.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#ifndef CDEFAULT_IO_NO_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#endif
 
 struct FileHandle {
   Arena* arena;
@@ -482,23 +1338,139 @@ linux_dir_list_files_exit:
   return success;
 }
 
-B32 LINUX_FileHandleOpenStdOut(FileHandle** file) {
-  MEMORY_ZERO_STRUCT(file);
-  Arena* arena = ArenaAllocate();
-  *file = ARENA_PUSH_STRUCT(arena, FileHandle);
-  (*file)->arena      = arena;
-  (*file)->fd         = dup(STDOUT_FILENO);
-  (*file)->file_path  = Str8Lit("stdout");
-  (*file)->is_writing = true;
-  return true;
+B32 LINUX_FileDelete(String8 file_path) {
+  Arena* temp_arena = ArenaAllocate();
+  U8* file_path_cstr = CStrFromStr8(temp_arena, file_path);
+  B32 success = unlink((char*) file_path_cstr) == 0;
+  if (!success) { LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to delete file: %S", file_path); }
+  ArenaRelease(temp_arena);
+  return success;
 }
 
-B32 LINUX_FileHandleOpen(FileHandle** file, String8 file_path, FileMode mode) {
-  B32 success  = false;
-  Arena* arena = ArenaAllocate();
-
-  S32 flags = 0;
-  B32 read  = mode & FileMode_Read;
+B32 LINUX_DirCreate(String8 dir_path) {
+  Arena* temp_arena = ArenaAllocate();
+  U8* dir_path_cstr = CStrFromStr8(temp_arena, dir_path);
+  CStrReplaceAllChar(dir_path_cstr, '\\', '/');
+  B32 success = true;
+  // NOTE: creates each missing parent in turn, e.g. a, a/b, a/b/c.
+  for (U32 i = 1; i <= dir_path.size && success; i++) {
+    if (i < dir_path.size && dir_path_cstr[i] != '/') { continue; }
+    if (dir_path_cstr[i - 1] == '/') { continue; }
+    U8 c = dir_path_cstr[i];
+    dir_path_cstr[i] = 0;
+    if (mkdir(dir_path_cstr, 0755) == -1 && errno != EEXIST) {
+      LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to create directory: %S", dir_path);
+      success = false;
+    }
+    dir_path_cstr[i] = c;
+  }
+  ArenaRelease(temp_arena);
+  return success;
+}
+
+B32 LINUX_DirDelete(String8 dir_path) {
+  Arena* temp_arena = ArenaAllocate();
+  U8* dir_path_cstr = CStrFromStr8(temp_arena, dir_path);
+  B32 success = rmdir((char*) dir_path_cstr) == 0;
+  if (!success) { LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to delete directory: %S", dir_path); }
+  ArenaRelease(temp_arena);
+  return success;
+}
+
+// NOTE: The record layout returned by getdents64, which glibc only wraps with _GNU_SOURCE.
+typedef struct LINUX_Dirent64 LINUX_Dirent64;
+struct LINUX_Dirent64 {
+  U64 d_ino;
+  S64 d_off;
+  U16 d_reclen;
+  U8  d_type;
+  char d_name[];
+};
+
+typedef struct LINUX_DirWalkIter LINUX_DirWalkIter;
+struct LINUX_DirWalkIter {
+  S32 fd;
+  S64 buffer_size;
+  S64 buffer_pos;
+  U8 buffer[KB(32)];
+};
+
+static DirEntryType LINUX_DirEntryTypeFromMode(mode_t mode) {
+  if (S_ISREG(mode)) { return DirEntryType_File;    }
+  if (S_ISDIR(mode)) { return DirEntryType_Dir;     }
+  if (S_ISLNK(mode)) { return DirEntryType_Symlink; }
+  return DirEntryType_Other;
+}
+
+B32 LINUX_DirWalkIterOpen(LINUX_DirWalkIter* iter, Arena* arena, String8 dir_path) {
+  U64 arena_pos = ArenaPos(arena);
+  iter->fd          = open(CStrFromStr8(arena, dir_path), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  iter->buffer_size = 0;
+  iter->buffer_pos  = 0;
+  ArenaPopTo(arena, arena_pos);
+  if (iter->fd == -1) {
+    LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to read contents of directory: %S", dir_path);
+    return false;
+  }
+  return true;
+}
+
+// NOTE: entry->name points into iter, and is null terminated. Entries are read in batches of up to
+// sizeof(iter->buffer) bytes per syscall.
+B32 LINUX_DirWalkIterNext(LINUX_DirWalkIter* iter, DirEntry* entry) {
+  if (iter->buffer_pos >= iter->buffer_size) {
+    S64 result = syscall(SYS_getdents64, iter->fd, iter->buffer, sizeof(iter->buffer));
+    if (result < 0) { LINUX_IO_LOG_ERROR(errno, "[IO] Failed to read directory entries."); }
+    if (result <= 0) { return false; }
+    iter->buffer_size = result;
+    iter->buffer_pos  = 0;
+  }
+  LINUX_Dirent64* dirent = (LINUX_Dirent64*) (iter->buffer + iter->buffer_pos);
+  iter->buffer_pos += dirent->d_reclen;
+  entry->name = Str8CStr(dirent->d_name);
+  switch (dirent->d_type) {
+    case DT_REG: { entry->type = DirEntryType_File;    } break;
+    case DT_DIR: { entry->type = DirEntryType_Dir;     } break;
+    case DT_LNK: { entry->type = DirEntryType_Symlink; } break;
+    case DT_UNKNOWN: {
+      // NOTE: some filesystems don't report types in the listing.
+      struct stat st;
+      entry->type = (fstatat(iter->fd, dirent->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0) ? LINUX_DirEntryTypeFromMode(st.st_mode) : DirEntryType_Other;
+    } break;
+    default: { entry->type = DirEntryType_Other; } break;
+  }
+  return true;
+}
+
+// NOTE: name is as returned by Next. Relative to the open directory, so no path lookup is needed.
+void LINUX_DirWalkIterStat(LINUX_DirWalkIter* iter, String8 name, DirEntry* entry) {
+  struct stat st;
+  if (fstatat(iter->fd, (char*) name.str, &st, AT_SYMLINK_NOFOLLOW) != 0) { return; }
+  entry->size            = st.st_size;
+  entry->last_write_time = st.st_mtime;
+}
+
+void LINUX_DirWalkIterClose(LINUX_DirWalkIter* iter) {
+  close(iter->fd);
+}
+
+B32 LINUX_FileHandleOpenStdOut(FileHandle** file) {
+  MEMORY_ZERO_STRUCT(file);
+  Arena* arena = ArenaAllocate();
+  *file = ARENA_PUSH_STRUCT(arena, FileHandle);
+  (*file)->arena      = arena;
+  (*file)->fd         = dup(STDOUT_FILENO);
+  (*file)->file_path  = Str8Lit("stdout");
+  (*file)->is_writing = true;
+  return true;
+}
+
+B32 LINUX_FileHandleOpen(FileHandle** file, String8 file_path, FileMode mode) {
+  B32 success  = false;
+  Arena* arena = ArenaAllocate();
+
+  S32 flags = 0;
+  B32 read  = mode & FileMode_Read;
   B32 write = mode & FileMode_Write;
   DEBUG_ASSERT(read || write);
   if      (read && write) { flags |= O_RDWR;   }
@@ -507,6 +1479,12 @@ B32 LINUX_FileHandleOpen(FileHandle** file, String8 file_path, FileMode mode) {
 
   if (mode & FileMode_Truncate) { flags |= O_TRUNC; }
   if (mode & FileMode_Create)   { flags |= O_CREAT; }
+  // NOTE: O_DIRECT is only exposed with _GNU_SOURCE.
+#if defined(O_DIRECT)
+  if (mode & FileMode_Unbuffered) { flags |= O_DIRECT; }
+#else
+  if (mode & FileMode_Unbuffered) { flags |= __O_DIRECT; }
+#endif
   U8* file_path_cstr = CStrFromStr8(arena, file_path);
   S32 fd = open(file_path_cstr, flags, 0770);
   ArenaClear(arena);
@@ -558,7 +1536,7 @@ B32 LINUX_FileHandleClose(FileHandle* file) {
   return true;
 }
 
-B32 LINUX_FileHandleSeek(FileHandle* file, S32 distance, FileSeekPos pos) {
+B32 LINUX_FileHandleSeek(FileHandle* file, S64 distance, FileSeekPos pos) {
   S32 whence;
   switch (pos) {
     case FileSeekPos_Begin:   { whence = SEEK_SET; } break;
@@ -566,7 +1544,7 @@ B32 LINUX_FileHandleSeek(FileHandle* file, S32 distance, FileSeekPos pos) {
     case FileSeekPos_End:     { whence = SEEK_END; } break;
     default: UNIMPLEMENTED(); break;
   }
-  if (lseek(file->fd, distance, whence) == -1) {
+  if (lseek(file->fd, (off_t) distance, whence) == -1) {
     LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to seek for file: %S", file->file_path);
     return false;
   }
@@ -574,7 +1552,7 @@ B32 LINUX_FileHandleSeek(FileHandle* file, S32 distance, FileSeekPos pos) {
 }
 
 B32 LINUX_FileHandleRead(FileHandle* file, U8* buffer, U32 buffer_size, U32* bytes_read) {
-  S32 r = read(file->fd, buffer, buffer_size);
+  ssize_t r = read(file->fd, buffer, buffer_size);
   if (r == -1) {
     LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to read file: %S", file->file_path);
     return false;
@@ -586,7 +1564,7 @@ B32 LINUX_FileHandleRead(FileHandle* file, U8* buffer, U32 buffer_size, U32* byt
 B32 LINUX_FileHandleWrite(FileHandle* file, U8* buffer, U32 buffer_size) {
   U32 total = 0;
   while (total < buffer_size) {
-    U32 w = write(file->fd, buffer + total, buffer_size - total);
+    ssize_t w = write(file->fd, buffer + total, buffer_size - total);
     if (w == -1) {
       LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to write file: %S", file->file_path);
       return false;
@@ -600,6 +1578,480 @@ B32 LINUX_FileHandleWrite(FileHandle* file, U8* buffer, U32 buffer_size) {
   return true;
 }
 
+B32 LINUX_FileHandleWriteGather(FileHandle* file, String8* buffers, U32 buffers_size) {
+  struct iovec iovs[64];
+  U32 i = 0;
+  U64 offset = 0; // NOTE: bytes of buffers[i] already written.
+  while (true) {
+    while (i < buffers_size && offset == buffers[i].size) {
+      i++;
+      offset = 0;
+    }
+    if (i == buffers_size) { break; }
+
+    U32 iovs_size = 0;
+    for (U32 j = i; j < buffers_size && iovs_size < STATIC_ARRAY_SIZE(iovs); j++) {
+      U64 skip = (j == i) ? offset : 0;
+      iovs[iovs_size].iov_base = buffers[j].str + skip;
+      iovs[iovs_size].iov_len  = buffers[j].size - skip;
+      iovs_size++;
+    }
+    ssize_t w = writev(file->fd, iovs, iovs_size);
+    if (w == -1) {
+      if (errno == EINTR) { continue; }
+      LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to write file: %S", file->file_path);
+      return false;
+    }
+    if (w == 0) {
+      LOG_ERROR("[IO] Attempt to write returned 0 bytes: %S", file->file_path);
+      return false;
+    }
+    for (U64 remaining = w; remaining > 0;) {
+      U64 left = buffers[i].size - offset;
+      if (remaining < left) {
+        offset += remaining;
+        break;
+      }
+      remaining -= left;
+      i++;
+      offset = 0;
+    }
+  }
+  return true;
+}
+
+B32 LINUX_FileHandleSetSize(FileHandle* file, U64 size) {
+  if (ftruncate(file->fd, (off_t) size) == -1) {
+    LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to set file size: %S", file->file_path);
+    return false;
+  }
+  return true;
+}
+
+B32 LINUX_FileHandleReadAt(FileHandle* file, U64 offset, U8* buffer, U32 buffer_size, U32* bytes_read) {
+  U32 total = 0;
+  while (total < buffer_size) {
+    ssize_t r = pread(file->fd, buffer + total, buffer_size - total, (off_t) (offset + total));
+    if (r == -1) {
+      if (errno == EINTR) { continue; }
+      LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to read file: %S", file->file_path);
+      return false;
+    }
+    if (r == 0) { break; } // NOTE: EOF
+    total += r;
+  }
+  *bytes_read = total;
+  return true;
+}
+
+// NOTE: io_uring is driven through the raw syscalls, rather than liburing. #define CDEFAULT_IO_NO_IO_URING
+// to always use the thread pool, e.g. when building against kernel headers older than 5.6.
+#ifndef CDEFAULT_IO_NO_IO_URING
+#define CDEFAULT_IO_NATIVE_READ_QUEUE
+
+// NOTE: Requests are tracked in slots while in flight, so they can all be failed if the ring breaks (io_uring_enter
+// fails for good). The slot index is the submission's user_data.
+typedef struct LINUX_FileReadQueueNative LINUX_FileReadQueueNative;
+struct LINUX_FileReadQueueNative {
+  S32 ring_fd;
+  U8* ring;
+  U64 ring_size;
+  struct io_uring_sqe* sqes;
+  U64 sqes_size;
+  U32* sq_tail;
+  U32* sq_mask;
+  U32* sq_array;
+  U32* cq_head;
+  U32* cq_tail;
+  U32* cq_mask;
+  struct io_uring_cqe* cqes;
+  U32 to_submit;
+  B32 is_broken;
+  FileReadRequest* slots[FILE_READ_QUEUE_MAX_DEPTH];
+};
+
+B32 LINUX_FileReadQueueNativeInit(LINUX_FileReadQueueNative* native, U32 depth) {
+  MEMORY_ZERO_STRUCT(native);
+  struct io_uring_params params;
+  MEMORY_ZERO_STRUCT(&params);
+  native->ring_fd = syscall(__NR_io_uring_setup, depth, &params);
+  if (native->ring_fd < 0) {
+    LOG_DEBUG("[IO] io_uring is unavailable - %s", strerror(errno));
+    return false;
+  }
+  // NOTE: IORING_OP_READ landed in 5.6, alongside IORING_FEAT_RW_CUR_POS. SINGLE_MMAP is 5.4.
+  if (!(params.features & IORING_FEAT_RW_CUR_POS) || !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+    LOG_DEBUG("[IO] io_uring is too old, requires linux 5.6+");
+    goto linux_file_read_queue_native_init_fail;
+  }
+
+  U64 sq_ring_size  = params.sq_off.array + params.sq_entries * sizeof(U32);
+  U64 cq_ring_size  = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  native->ring_size = MAX(sq_ring_size, cq_ring_size);
+  native->ring = (U8*) mmap(NULL, native->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, native->ring_fd, IORING_OFF_SQ_RING);
+  if (native->ring == MAP_FAILED) {
+    LINUX_IO_LOG_ERROR(errno, "[IO] Failed to map io_uring.");
+    native->ring = NULL;
+    goto linux_file_read_queue_native_init_fail;
+  }
+  native->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  native->sqes = (struct io_uring_sqe*) mmap(NULL, native->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, native->ring_fd, IORING_OFF_SQES);
+  if (native->sqes == MAP_FAILED) {
+    LINUX_IO_LOG_ERROR(errno, "[IO] Failed to map io_uring submission entries.");
+    native->sqes = NULL;
+    goto linux_file_read_queue_native_init_fail;
+  }
+  native->sq_tail  = (U32*) (native->ring + params.sq_off.tail);
+  native->sq_mask  = (U32*) (native->ring + params.sq_off.ring_mask);
+  native->sq_array = (U32*) (native->ring + params.sq_off.array);
+  native->cq_head  = (U32*) (native->ring + params.cq_off.head);
+  native->cq_tail  = (U32*) (native->ring + params.cq_off.tail);
+  native->cq_mask  = (U32*) (native->ring + params.cq_off.ring_mask);
+  native->cqes     = (struct io_uring_cqe*) (native->ring + params.cq_off.cqes);
+  return true;
+
+linux_file_read_queue_native_init_fail:
+  if (native->ring != NULL) { munmap(native->ring, native->ring_size); }
+  close(native->ring_fd);
+  return false;
+}
+
+void LINUX_FileReadQueueNativeDeinit(LINUX_FileReadQueueNative* native) {
+  munmap(native->sqes, native->sqes_size);
+  munmap(native->ring, native->ring_size);
+  close(native->ring_fd);
+}
+
+// NOTE: Only queues the submission entry, the kernel sees it on the next flush / reap.
+B32 LINUX_FileReadQueueNativeIssue(LINUX_FileReadQueueNative* native, FileReadRequest* request) {
+  if (native->is_broken) { return false; }
+  U32 slot = 0;
+  while (native->slots[slot] != NULL) { slot++; }
+  DEBUG_ASSERT(slot < FILE_READ_QUEUE_MAX_DEPTH);
+  native->slots[slot] = request;
+  // NOTE: this is the only producer, so the tail can be read without synchronization.
+  U32 tail  = *native->sq_tail;
+  U32 index = tail & *native->sq_mask;
+  struct io_uring_sqe* sqe = &native->sqes[index];
+  MEMORY_ZERO_STRUCT(sqe);
+  sqe->opcode    = IORING_OP_READ;
+  sqe->fd        = request->file->fd;
+  sqe->off       = request->offset;
+  sqe->addr      = (U64) request->buffer;
+  sqe->len       = request->size;
+  sqe->user_data = slot;
+  native->sq_array[index] = index;
+  __atomic_store_n(native->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  native->to_submit++;
+  return true;
+}
+
+// NOTE: Returns false, and breaks the ring, on any failure other than a transient one. See
+// LINUX_FileReadQueueNativeReap.
+static B32 LINUX_FileReadQueueNativeEnter(LINUX_FileReadQueueNative* native, U32 min_complete) {
+  if (native->is_broken) { return false; }
+  while (native->to_submit > 0 || min_complete > 0) {
+    U32 flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+    S32 result = syscall(__NR_io_uring_enter, native->ring_fd, native->to_submit, min_complete, flags, NULL, 0);
+    if (result < 0) {
+      if (errno == EINTR) { continue; }
+      // NOTE: the kernel is short on resources, or the completion queue is full. Unsubmitted entries stay queued for
+      // the next enter, and the caller retries any wait.
+      if (errno == EAGAIN || errno == EBUSY) { return true; }
+      LINUX_IO_LOG_ERROR(errno, "[IO] Failed to enter io_uring.");
+      native->is_broken = true;
+      return false;
+    }
+    native->to_submit -= result;
+    // NOTE: if the kernel consumed everything, any requested wait has also been satisfied.
+    if (native->to_submit == 0) { break; }
+  }
+  return true;
+}
+
+void LINUX_FileReadQueueNativeFlush(LINUX_FileReadQueueNative* native) {
+  LINUX_FileReadQueueNativeEnter(native, 0);
+}
+
+// NOTE: Once the ring is broken, its completions can't be waited on anymore, so the requests still in flight are
+// returned as failed.
+U32 LINUX_FileReadQueueNativeReap(LINUX_FileReadQueueNative* native, FileReadRequest** completed, U32 completed_cap, B32 wait) {
+  U32 head = *native->cq_head;
+  if (wait && head == __atomic_load_n(native->cq_tail, __ATOMIC_ACQUIRE)) { LINUX_FileReadQueueNativeEnter(native, 1); }
+  U32 completed_size = 0;
+  if (native->is_broken) {
+    for (U32 i = 0; i < FILE_READ_QUEUE_MAX_DEPTH && completed_size < completed_cap; i++) {
+      FileReadRequest* request = native->slots[i];
+      if (request == NULL) { continue; }
+      request->success    = false;
+      request->bytes_read = 0;
+      native->slots[i] = NULL;
+      completed[completed_size++] = request;
+    }
+    return completed_size;
+  }
+  U32 tail = __atomic_load_n(native->cq_tail, __ATOMIC_ACQUIRE);
+  for (; head != tail && completed_size < completed_cap; head++) {
+    struct io_uring_cqe* cqe = &native->cqes[head & *native->cq_mask];
+    FileReadRequest* request = native->slots[cqe->user_data];
+    native->slots[cqe->user_data] = NULL;
+    if (cqe->res < 0) {
+      LINUX_IO_LOG_ERROR_EX(-cqe->res, "[IO] Failed to read file: %S", request->file->file_path);
+      request->success    = false;
+      request->bytes_read = 0;
+    } else {
+      request->success    = true;
+      request->bytes_read = (U32) cqe->res;
+    }
+    completed[completed_size++] = request;
+  }
+  __atomic_store_n(native->cq_head, head, __ATOMIC_RELEASE);
+  return completed_size;
+}
+
+#endif // CDEFAULT_IO_NO_IO_URING
+
+B32 LINUX_FileMapOpen(String8 file_path, FileMap* map, FileMapHint hints) {
+  B32 success = false;
+  S32 fd      = -1;
+  MEMORY_ZERO_STRUCT(map);
+  Arena* temp_arena = ArenaAllocate();
+
+  U8* file_path_cstr = CStrFromStr8(temp_arena, file_path);
+  CStrReplaceAllChar(file_path_cstr, '\\', '/');
+  fd = open(file_path_cstr, O_RDONLY);
+  if (fd == -1) {
+    LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to open file: %S", file_path);
+    goto linux_file_map_open_exit;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to stat file: %S", file_path);
+    goto linux_file_map_open_exit;
+  }
+  map->size = st.st_size;
+  // NOTE: empty files can't be mapped.
+  if (map->size == 0) {
+    success = true;
+    goto linux_file_map_open_exit;
+  }
+
+  void* data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to map file: %S", file_path);
+    goto linux_file_map_open_exit;
+  }
+  map->data = (U8*) data;
+
+  // NOTE: hints are advisory, e.g. file-backed huge pages depend on kernel config, so failures are not errors.
+  if ((hints & FileMapHint_Sequential) && madvise(data, map->size, MADV_SEQUENTIAL) == -1) {
+    LOG_DEBUG("[IO] MADV_SEQUENTIAL failed, ignoring: %S - %s", file_path, strerror(errno));
+  }
+  if ((hints & FileMapHint_WillNeed) && madvise(data, map->size, MADV_WILLNEED) == -1) {
+    LOG_DEBUG("[IO] MADV_WILLNEED failed, ignoring: %S - %s", file_path, strerror(errno));
+  }
+#ifdef MADV_HUGEPAGE
+  if ((hints & FileMapHint_HugePages) && madvise(data, map->size, MADV_HUGEPAGE) == -1) {
+    LOG_DEBUG("[IO] MADV_HUGEPAGE failed, ignoring: %S - %s", file_path, strerror(errno));
+  }
+#endif
+  success = true;
+
+linux_file_map_open_exit:
+  // NOTE: the mapping holds its own reference to the file, so the fd can be closed immediately.
+  if (fd != -1) { close(fd); }
+  if (!success) { MEMORY_ZERO_STRUCT(map); }
+  ArenaRelease(temp_arena);
+  return success;
+}
+
+B32 LINUX_FileMapClose(FileMap* map) {
+  if (map->data != NULL && munmap(map->data, map->size) == -1) {
+    LINUX_IO_LOG_ERROR(errno, "[IO] Failed to unmap file.");
+    return false;
+  }
+  MEMORY_ZERO_STRUCT(map);
+  return true;
+}
+
+// NOTE: inotify watches single directories, so a recursive watch adds one per directory under the root, and adds /
+// drops watches as directories are created or moved. Watches are found by descriptor in a small hash table.
+#define LINUX_FILE_WATCH_BUCKETS 256
+#define LINUX_FILE_WATCH_MASK                                                                      \
+  (IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | \
+   IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK)
+
+typedef struct LINUX_FileWatch LINUX_FileWatch;
+struct LINUX_FileWatch {
+  S32 wd;
+  String8 path;
+  LINUX_FileWatch* next;
+};
+
+typedef struct LINUX_FileWatcherNative LINUX_FileWatcherNative;
+struct LINUX_FileWatcherNative {
+  Arena* arena; // NOTE: Watches and their paths.
+  S32 fd;
+  S32 root_wd;
+  B32 recursive;
+  String8 dir_path;
+  LINUX_FileWatch* buckets[LINUX_FILE_WATCH_BUCKETS];
+  LINUX_FileWatch* free_watches;
+  U32 buffer[KB(16)]; // NOTE: 64KB, aligned for struct inotify_event.
+};
+
+static LINUX_FileWatch** LINUX_FileWatchFind(LINUX_FileWatcherNative* native, S32 wd) {
+  LINUX_FileWatch** watch = &native->buckets[wd % LINUX_FILE_WATCH_BUCKETS];
+  while (*watch != NULL && (*watch)->wd != wd) { watch = &(*watch)->next; }
+  return watch;
+}
+
+static void LINUX_FileWatchRemove(LINUX_FileWatcherNative* native, LINUX_FileWatch** watch) {
+  LINUX_FileWatch* removed = *watch;
+  *watch = removed->next;
+  SLL_STACK_PUSH(native->free_watches, removed, next);
+}
+
+// NOTE: Returns the watch descriptor, or -1 if path could not be watched (e.g. it was deleted again already).
+static S32 LINUX_FileWatcherAdd(LINUX_FileWatcherNative* native, String8 path) {
+  U64 arena_pos = ArenaPos(native->arena);
+  U8* path_cstr = CStrFromStr8(native->arena, path);
+  S32 wd = inotify_add_watch(native->fd, (char*) path_cstr, LINUX_FILE_WATCH_MASK);
+  ArenaPopTo(native->arena, arena_pos);
+  if (wd == -1) {
+    // NOTE: ENOSPC is the fs.inotify.max_user_watches limit.
+    if (errno != ENOENT && errno != ENOTDIR) { LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to watch directory: %S", path); }
+    return -1;
+  }
+  LINUX_FileWatch** watch = LINUX_FileWatchFind(native, wd);
+  if (*watch == NULL) {
+    LINUX_FileWatch* added = native->free_watches;
+    if (added != NULL) { SLL_STACK_POP(native->free_watches, next); }
+    else               { added = ARENA_PUSH_STRUCT(native->arena, LINUX_FileWatch); }
+    added->wd   = wd;
+    added->next = NULL;
+    *watch = added;
+  }
+  // NOTE: re-adding a directory returns its existing descriptor, e.g. after it was moved.
+  (*watch)->path = Str8Copy(native->arena, path);
+  return wd;
+}
+
+static B32 LINUX_FileWatcherIsDir(DirEntry* entry, void* UNUSED(user_data)) {
+  return entry->type == DirEntryType_Dir;
+}
+
+// NOTE: Watches path and every directory under it. If report, everything under path is reported as created, since
+// it may have been created before path was watched.
+static void LINUX_FileWatcherAddTree(LINUX_FileWatcherNative* native, FileWatcher* watcher, Arena* arena, String8 path, B32 report) {
+  if (LINUX_FileWatcherAdd(native, path) == -1) { return; }
+  DirEntry* entries;
+  U64 entries_size;
+  DirWalkFilter_Fn* filter = report ? NULL : LINUX_FileWatcherIsDir;
+  if (!DirWalk(arena, path, DirWalkFlags_Recursive | DirWalkFlags_IncludeDirs, filter, NULL, &entries, &entries_size)) { return; }
+  for (U64 i = 0; i < entries_size; i++) {
+    if (entries[i].type == DirEntryType_Dir) { LINUX_FileWatcherAdd(native, entries[i].path); }
+    if (report) { _FileWatcherPush(watcher, entries[i].path, Str8Lit(""), FileWatchEventFlags_Created); }
+  }
+}
+
+// NOTE: Drops the watches on path and every directory under it, e.g. when it's moved out of the watched tree.
+static void LINUX_FileWatcherRemoveTree(LINUX_FileWatcherNative* native, String8 path) {
+  for (U32 i = 0; i < LINUX_FILE_WATCH_BUCKETS; i++) {
+    LINUX_FileWatch** watch = &native->buckets[i];
+    while (*watch != NULL) {
+      String8 watch_path = (*watch)->path;
+      if (Str8StartsWith(watch_path, path) && (watch_path.size == path.size || watch_path.str[path.size] == '/')) {
+        inotify_rm_watch(native->fd, (*watch)->wd);
+        LINUX_FileWatchRemove(native, watch);
+      } else {
+        watch = &(*watch)->next;
+      }
+    }
+  }
+}
+
+B32 LINUX_FileWatcherNativeInit(LINUX_FileWatcherNative* native, Arena* arena, String8 dir_path, B32 recursive) {
+  MEMORY_ZERO_STRUCT(native);
+  native->arena     = arena;
+  native->recursive = recursive;
+  native->dir_path  = dir_path;
+  native->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (native->fd == -1) {
+    LINUX_IO_LOG_ERROR(errno, "[IO] Failed to initialize inotify.");
+    return false;
+  }
+  native->root_wd = LINUX_FileWatcherAdd(native, dir_path);
+  if (native->root_wd == -1) {
+    if (errno == ENOENT || errno == ENOTDIR) { LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to watch directory: %S", dir_path); }
+    close(native->fd);
+    return false;
+  }
+  if (recursive) {
+    Arena* temp_arena = ArenaAllocate();
+    LINUX_FileWatcherAddTree(native, NULL, temp_arena, dir_path, false);
+    ArenaRelease(temp_arena);
+  }
+  return true;
+}
+
+void LINUX_FileWatcherNativeDeinit(LINUX_FileWatcherNative* native) {
+  close(native->fd);
+}
+
+static void LINUX_FileWatcherNativeHandle(LINUX_FileWatcherNative* native, FileWatcher* watcher, Arena* arena, struct inotify_event* event) {
+  if (event->mask & IN_Q_OVERFLOW) {
+    _FileWatcherPush(watcher, native->dir_path, Str8Lit(""), FileWatchEventFlags_Overflow);
+    // NOTE: directories created while events were dropped aren't watched yet.
+    if (native->recursive) { LINUX_FileWatcherAddTree(native, NULL, arena, native->dir_path, false); }
+    return;
+  }
+  // NOTE: events may still be queued for a watch that was already dropped.
+  LINUX_FileWatch** watch = LINUX_FileWatchFind(native, event->wd);
+  if (*watch == NULL) { return; }
+  if (event->mask & IN_IGNORED) {
+    LINUX_FileWatchRemove(native, watch);
+    return;
+  }
+  String8 dir_path = (*watch)->path;
+  if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+    // NOTE: otherwise, reported by the parent directory's watch.
+    if (event->wd == native->root_wd) { _FileWatcherPush(watcher, dir_path, Str8Lit(""), FileWatchEventFlags_Deleted); }
+    return;
+  }
+
+  String8 name = (event->len > 0) ? Str8CStr(event->name) : Str8Lit("");
+  FileWatchEventFlags flags = 0;
+  if (event->mask & (IN_CREATE | IN_MOVED_TO))     { flags |= FileWatchEventFlags_Created;  }
+  if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE))  { flags |= FileWatchEventFlags_Modified; }
+  if (event->mask & (IN_DELETE | IN_MOVED_FROM))   { flags |= FileWatchEventFlags_Deleted;  }
+  if (flags == 0) { return; }
+  _FileWatcherPush(watcher, dir_path, name, flags);
+
+  if (native->recursive && (event->mask & IN_ISDIR)) {
+    String8 path = Str8Format(arena, "%S/%S", dir_path, name);
+    if (event->mask & IN_MOVED_FROM)             { LINUX_FileWatcherRemoveTree(native, path); }
+    if (event->mask & (IN_CREATE | IN_MOVED_TO)) { LINUX_FileWatcherAddTree(native, watcher, arena, path, true); }
+  }
+}
+
+B32 LINUX_FileWatcherNativePoll(LINUX_FileWatcherNative* native, FileWatcher* watcher, Arena* arena) {
+  while (true) {
+    S64 bytes = read(native->fd, native->buffer, sizeof(native->buffer));
+    if (bytes == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) { return true; }
+      if (errno == EINTR) { continue; }
+      LINUX_IO_LOG_ERROR_EX(errno, "[IO] Failed to read changes to directory: %S", native->dir_path);
+      return false;
+    }
+    for (S64 pos = 0; pos < bytes;) {
+      struct inotify_event* event = (struct inotify_event*) ((U8*) native->buffer + pos);
+      pos += sizeof(struct inotify_event) + event->len;
+      LINUX_FileWatcherNativeHandle(native, watcher, arena, event);
+    }
+  }
+}
+
 #else
 
 // TODO: mac support.
@@ -614,26 +2066,42 @@ B32 FileStat(String8 file_path, FileStats* stats) {
   return CDEFAULT_IO_BACKEND_FN(FileStat(file_path, stats));
 }
 
-B32 FileReadAll(Arena* arena, String8 file_path, U8** buffer, U32* buffer_size) {
+static B32 _FileReadAll(Arena* arena, String8 file_path, U8** buffer, U64* buffer_size, U64 max_size) {
   B32 success = false;
   FileHandle* handle;
   if (!FileHandleOpen(&handle, file_path, FileMode_Read)) { return false; }
   FileStats stats;
   if (!FileHandleStat(handle, &stats)) { goto file_read_all_exit; }
+  if (stats.size > max_size) {
+    LOG_ERROR("[IO] File is too large (%llu bytes) to read: %S", stats.size, file_path);
+    goto file_read_all_exit;
+  }
   *buffer = ARENA_PUSH_ARRAY(arena, U8, stats.size);
-  U32 bytes_read;
-  if (!FileHandleRead(handle, *buffer, stats.size, &bytes_read)) {
+  U64 bytes_read;
+  if (!FileHandleRead64(handle, *buffer, stats.size, &bytes_read)) {
     ARENA_POP_ARRAY(arena, U8, stats.size);
     goto file_read_all_exit;
   }
   if (buffer_size != NULL) { *buffer_size = bytes_read; }
+  PROFILE_ADD_BYTES(bytes_read);
   success = true;
 file_read_all_exit:
   DEBUG_ASSERT(FileHandleClose(handle));
   return success;
 }
 
-B32 FileDump(String8 file_path, U8* buffer, U32 buffer_size) {
+B32 FileReadAll(Arena* arena, String8 file_path, U8** buffer, U32* buffer_size) {
+  U64 size;
+  if (!_FileReadAll(arena, file_path, buffer, &size, U32_MAX)) { return false; }
+  if (buffer_size != NULL) { *buffer_size = (U32) size; }
+  return true;
+}
+
+B32 FileReadAll64(Arena* arena, String8 file_path, U8** buffer, U64* buffer_size) {
+  return _FileReadAll(arena, file_path, buffer, buffer_size, U64_MAX);
+}
+
+B32 FileDump(String8 file_path, U8* buffer, U64 buffer_size) {
   B32 success = false;
   FileHandle* handle;
   if (!FileHandleOpen(&handle, file_path, FileMode_Write | FileMode_Create | FileMode_Truncate)) { return false; }
@@ -644,7 +2112,7 @@ file_dump_exit:
   return success;
 }
 
-B32 FileAppend(String8 file_path, U8* buffer, U32 buffer_size) {
+B32 FileAppend(String8 file_path, U8* buffer, U64 buffer_size) {
   B32 success = false;
   FileHandle* handle;
   if (!FileHandleOpen(&handle, file_path, FileMode_Write | FileMode_Create)) { return false; }
@@ -668,6 +2136,18 @@ file_copy_exit:
   return success;
 }
 
+B32 FileDelete(String8 file_path) {
+  return CDEFAULT_IO_BACKEND_FN(FileDelete(file_path));
+}
+
+B32 FileMapOpen(String8 file_path, FileMap* map, FileMapHint hints) {
+  return CDEFAULT_IO_BACKEND_FN(FileMapOpen(file_path, map, hints));
+}
+
+B32 FileMapClose(FileMap* map) {
+  return CDEFAULT_IO_BACKEND_FN(FileMapClose(map));
+}
+
 B32 DirGetExe(Arena* arena, String8* file_path) {
   return CDEFAULT_IO_BACKEND_FN(DirGetExe(arena, file_path));
 }
@@ -702,98 +2182,2559 @@ B32 DirListFiles(Arena* arena, String8 dir_path, String8List* file_paths) {
   return CDEFAULT_IO_BACKEND_FN(DirListFiles(arena, dir_path, file_paths));
 }
 
-B32 PathPop(String8 path, String8* dir_part, String8* file_part) {
-  S32 result;
-  result = Str8FindReverse(path, 0, Str8Lit("/"));
-  if (result >= 0) {
-    if (dir_part != NULL)  { *dir_part  = Str8Substring(path, 0, result);             }
-    if (file_part != NULL) { *file_part = Str8Substring(path, result + 1, path.size); }
-    return true;
-  }
-  result = Str8FindReverse(path, 0, Str8Lit("\\"));
-  if (result >= 0) {
-    if (dir_part != NULL)  { *dir_part  = Str8Substring(path, 0, result);             }
-    if (file_part != NULL) { *file_part = Str8Substring(path, result + 1, path.size); }
-    return true;
-  }
-  return false;
+B32 DirCreate(String8 dir_path) {
+  return CDEFAULT_IO_BACKEND_FN(DirCreate(dir_path));
 }
 
-String8 PathJoin(Arena* arena, String8List path_parts) {
-  for (String8ListNode* node = path_parts.head; node != NULL; node = node->next) {
-    node->string = Str8Trim(node->string);
-    Str8ReplaceAllChar(&node->string, '\\', '/');
-    if (node->string.size == 0) { continue; }
+B32 DirDelete(String8 dir_path) {
+  return CDEFAULT_IO_BACKEND_FN(DirDelete(dir_path));
+}
 
-    if (node != path_parts.head) {
-      if (node->string.str[0] == '/') {
-        node->string = Str8Substring(node->string, 1, node->string.size);
-      }
-    }
-    if (node != path_parts.tail) {
-      if (node->string.str[node->string.size - 1] == '/') {
-        node->string = Str8Substring(node->string, 0, node->string.size - 1);
-      }
+typedef CDEFAULT_IO_BACKEND_FN(DirWalkIter) DirWalkIter;
 
-      String8ListNode* delim = ARENA_PUSH_STRUCT(arena, String8ListNode);
-      delim->string = Str8Lit("/");
-      delim->next = node->next;
-      node->next = delim;
+#define DIR_WALK_BLOCK_SIZE 256
 
-      node = node->next;
-    }
-  }
-  return Str8ListJoin(arena, &path_parts);
-}
+typedef struct DirWalkDir DirWalkDir;
+struct DirWalkDir {
+  String8 path;
+  U32 depth;
+  DirWalkDir* next;
+};
 
-B32 FileHandleStat(FileHandle* file, FileStats* stats) {
-  return CDEFAULT_IO_BACKEND_FN(FileHandleStat(file, stats));
-}
+typedef struct DirWalkBlock DirWalkBlock;
+struct DirWalkBlock {
+  DirEntry entries[DIR_WALK_BLOCK_SIZE];
+  U32 entries_size;
+  DirWalkBlock* next;
+};
+
+typedef struct DirWalkState DirWalkState;
+
+typedef struct DirWalkWorker DirWalkWorker;
+struct DirWalkWorker {
+  DirWalkState* walk;
+  Arena* arena; // NOTE: Holds this worker's entries, paths and discovered directories until they're merged.
+  DirWalkBlock* blocks_head;
+  DirWalkBlock* blocks_tail;
+  U64 entries_size;
+  Thread thread;
+};
+
+struct DirWalkState {
+  DirWalkFlags flags;
+  DirWalkFilter_Fn* filter;
+  void* filter_data;
+  Mutex mutex;
+  CV cv;
+  DirWalkDir* pending; // NOTE: Directories waiting to be listed.
+  U32 active;          // NOTE: Workers currently listing a directory, which may add to pending.
+  B32 is_root_readable;
+};
+
+static void _DirWalkPushEntry(DirWalkWorker* worker, DirEntry* entry) {
+  DirWalkBlock* block = worker->blocks_tail;
+  if (block == NULL || block->entries_size == DIR_WALK_BLOCK_SIZE) {
+    block = ARENA_PUSH_STRUCT(worker->arena, DirWalkBlock);
+    block->entries_size = 0;
+    block->next = NULL;
+    SLL_QUEUE_PUSH_BACK(worker->blocks_head, worker->blocks_tail, block, next);
+  }
+  block->entries[block->entries_size++] = *entry;
+  worker->entries_size++;
+}
+
+// NOTE: Lists one directory, returning its subdirectories to be walked.
+static DirWalkDir* _DirWalkList(DirWalkWorker* worker, DirWalkDir* dir) {
+  DirWalkState* walk = worker->walk;
+  DirWalkDir* subdirs = NULL;
+  DirWalkIter iter;
+  if (!CDEFAULT_IO_BACKEND_FN(DirWalkIterOpen(&iter, worker->arena, dir->path))) { return NULL; }
+  if (dir->depth == 0) { walk->is_root_readable = true; }
+
+  B32 is_recursive = walk->flags & DirWalkFlags_Recursive;
+  DirEntry raw;
+  MEMORY_ZERO_STRUCT(&raw);
+  while (CDEFAULT_IO_BACKEND_FN(DirWalkIterNext(&iter, &raw))) {
+    String8 name = raw.name;
+    if (Str8Eq(name, Str8Lit(".")) || Str8Eq(name, Str8Lit(".."))) { continue; }
+    if ((walk->flags & DirWalkFlags_SkipHidden) && name.str[0] == '.') { continue; }
+    B32 is_dir = raw.type == DirEntryType_Dir;
+    if (is_dir && !is_recursive && !(walk->flags & DirWalkFlags_IncludeDirs)) { continue; }
+
+    // NOTE: dir->path never ends in a separator, unless it is the file system root.
+    U64 arena_pos = ArenaPos(worker->arena);
+    B32 needs_separator = dir->path.str[dir->path.size - 1] != '/';
+    DirEntry entry = raw;
+    entry.path.size = dir->path.size + needs_separator + name.size;
+    entry.path.str  = ARENA_PUSH_ARRAY(worker->arena, U8, entry.path.size);
+    MEMORY_COPY_SIZE(entry.path.str, dir->path.str, dir->path.size);
+    if (needs_separator) { entry.path.str[dir->path.size] = '/'; }
+    MEMORY_COPY_SIZE(entry.path.str + entry.path.size - name.size, name.str, name.size);
+    entry.name  = Str8Substring(entry.path, entry.path.size - name.size, entry.path.size);
+    entry.depth = dir->depth;
+
+    B32 is_returned = !is_dir || (walk->flags & DirWalkFlags_IncludeDirs);
+    if (is_returned && walk->filter != NULL) { is_returned = walk->filter(&entry, walk->filter_data); }
+    if (is_returned) {
+      if (walk->flags & DirWalkFlags_Stat) { CDEFAULT_IO_BACKEND_FN(DirWalkIterStat(&iter, name, &entry)); }
+      _DirWalkPushEntry(worker, &entry);
+    }
+    if (is_dir && is_recursive) {
+      DirWalkDir* subdir = ARENA_PUSH_STRUCT(worker->arena, DirWalkDir);
+      subdir->path  = entry.path;
+      subdir->depth = dir->depth + 1;
+      SLL_STACK_PUSH(subdirs, subdir, next);
+    } else if (!is_returned) {
+      ArenaPopTo(worker->arena, arena_pos);
+    }
+    MEMORY_ZERO_STRUCT(&raw);
+  }
+  CDEFAULT_IO_BACKEND_FN(DirWalkIterClose(&iter));
+  return subdirs;
+}
+
+static S32 _DirWalkWorker(void* arg) {
+  DirWalkWorker* worker = (DirWalkWorker*) arg;
+  DirWalkState* walk = worker->walk;
+  MutexLock(&walk->mutex);
+  while (true) {
+    while (walk->pending == NULL && walk->active > 0) { CVWait(&walk->cv, &walk->mutex); }
+    if (walk->pending == NULL) { break; }
+    DirWalkDir* dir = walk->pending;
+    SLL_STACK_POP(walk->pending, next);
+    walk->active++;
+    MutexUnlock(&walk->mutex);
+
+    DirWalkDir* subdirs = _DirWalkList(worker, dir);
+
+    MutexLock(&walk->mutex);
+    while (subdirs != NULL) {
+      DirWalkDir* subdir = subdirs;
+      SLL_STACK_POP(subdirs, next);
+      SLL_STACK_PUSH(walk->pending, subdir, next);
+    }
+    walk->active--;
+    CVBroadcast(&walk->cv);
+  }
+  MutexUnlock(&walk->mutex);
+  return 0;
+}
+
+B32 DirWalk(Arena* arena, String8 root, DirWalkFlags flags, DirWalkFilter_Fn* filter, void* filter_data, DirEntry** entries, U64* entries_size) {
+  *entries = NULL;
+  *entries_size = 0;
+  DirWalkState walk;
+  MEMORY_ZERO_STRUCT(&walk);
+  walk.flags       = flags;
+  walk.filter      = filter;
+  walk.filter_data = filter_data;
+  MutexInit(&walk.mutex);
+  CVInit(&walk.cv);
+
+  U32 workers_size = 1;
+  if (flags & DirWalkFlags_Parallel) {
+    Arena* temp_arena = ArenaAllocate();
+    CpuTopology topology;
+    if (CpuTopologyGet(temp_arena, &topology)) { workers_size = CLAMP(1, topology.logical_cores, DIR_WALK_MAX_THREADS); }
+    ArenaRelease(temp_arena);
+  }
+  DirWalkWorker workers[DIR_WALK_MAX_THREADS];
+  for (U32 i = 0; i < workers_size; i++) {
+    MEMORY_ZERO_STRUCT(&workers[i]);
+    workers[i].walk  = &walk;
+    workers[i].arena = _ArenaAllocate(GB(1), MB(1));
+  }
+
+  DirWalkDir* root_dir = ARENA_PUSH_STRUCT(workers[0].arena, DirWalkDir);
+  MEMORY_ZERO_STRUCT(root_dir);
+  root_dir->path = Str8Copy(workers[0].arena, Str8Trim(root));
+  Str8ReplaceAllChar(&root_dir->path, '\\', '/');
+  while (root_dir->path.size > 1 && root_dir->path.str[root_dir->path.size - 1] == '/') { root_dir->path.size--; }
+  if (root_dir->path.size == 0) { root_dir->path = Str8Lit("."); }
+  walk.pending = root_dir;
+
+  // NOTE: the calling thread is worker 0. If a worker fails to start, the walk carries on with the ones that did,
+  // at worst just the calling thread, since any worker can list any pending directory.
+  U32 threads_size = 1;
+  for (; threads_size < workers_size; threads_size++) {
+    if (!ThreadCreate(&workers[threads_size].thread, _DirWalkWorker, &workers[threads_size])) {
+      LOG_WARN("[IO] Failed to start a DirWalk worker thread, continuing on %u threads.", threads_size);
+      break;
+    }
+  }
+  _DirWalkWorker(&workers[0]);
+  for (U32 i = 1; i < threads_size; i++) { ThreadJoin(&workers[i].thread); }
+
+  if (walk.is_root_readable) {
+    U64 total = 0;
+    for (U32 i = 0; i < workers_size; i++) { total += workers[i].entries_size; }
+    DirEntry* result = ARENA_PUSH_ARRAY(arena, DirEntry, total);
+    U64 result_size = 0;
+    for (U32 i = 0; i < workers_size; i++) {
+      for (DirWalkBlock* block = workers[i].blocks_head; block != NULL; block = block->next) {
+        for (U32 j = 0; j < block->entries_size; j++) {
+          DirEntry* entry = &result[result_size++];
+          *entry = block->entries[j];
+          entry->path = Str8Copy(arena, entry->path);
+          entry->name = Str8Substring(entry->path, entry->path.size - entry->name.size, entry->path.size);
+        }
+      }
+    }
+    *entries = result;
+    *entries_size = result_size;
+  }
+
+  for (U32 i = 0; i < workers_size; i++) { ArenaRelease(workers[i].arena); }
+  CVDeinit(&walk.cv);
+  MutexDeinit(&walk.mutex);
+  return walk.is_root_readable;
+}
+
+B32 DirWalkFilterGlob(DirEntry* entry, void* pattern) {
+  return PathMatchGlob(entry->name, *(String8*) pattern);
+}
+
+B32 DirWalkFilterExtensions(DirEntry* entry, void* extensions) {
+  String8List* list = (String8List*) extensions;
+  for (String8ListNode* node = list->head; node != NULL; node = node->next) {
+    String8 extension = node->string;
+    if (entry->name.size < extension.size) { continue; }
+    B32 is_match = true;
+    U8* suffix = entry->name.str + entry->name.size - extension.size;
+    for (U32 i = 0; i < extension.size && is_match; i++) { is_match = CharToLower(suffix[i]) == CharToLower(extension.str[i]); }
+    if (is_match) { return true; }
+  }
+  return false;
+}
+
+B32 PathPop(String8 path, String8* dir_part, String8* file_part) {
+  S32 result;
+  result = Str8FindReverse(path, 0, Str8Lit("/"));
+  if (result >= 0) {
+    if (dir_part != NULL)  { *dir_part  = Str8Substring(path, 0, result);             }
+    if (file_part != NULL) { *file_part = Str8Substring(path, result + 1, path.size); }
+    return true;
+  }
+  result = Str8FindReverse(path, 0, Str8Lit("\\"));
+  if (result >= 0) {
+    if (dir_part != NULL)  { *dir_part  = Str8Substring(path, 0, result);             }
+    if (file_part != NULL) { *file_part = Str8Substring(path, result + 1, path.size); }
+    return true;
+  }
+  return false;
+}
+
+String8 PathJoin(Arena* arena, String8List path_parts) {
+  for (String8ListNode* node = path_parts.head; node != NULL; node = node->next) {
+    node->string = Str8Trim(node->string);
+    Str8ReplaceAllChar(&node->string, '\\', '/');
+    if (node->string.size == 0) { continue; }
+
+    if (node != path_parts.head) {
+      if (node->string.str[0] == '/') {
+        node->string = Str8Substring(node->string, 1, node->string.size);
+      }
+    }
+    if (node != path_parts.tail) {
+      if (node->string.str[node->string.size - 1] == '/') {
+        node->string = Str8Substring(node->string, 0, node->string.size - 1);
+      }
+
+      String8ListNode* delim = ARENA_PUSH_STRUCT(arena, String8ListNode);
+      delim->string = Str8Lit("/");
+      delim->next = node->next;
+      node->next = delim;
+
+      node = node->next;
+    }
+  }
+  return Str8ListJoin(arena, &path_parts);
+}
+
+B32 PathMatchGlob(String8 name, String8 pattern) {
+  U32 n = 0, p = 0;
+  // NOTE: on a mismatch, backtrack to the last * and have it consume one more character.
+  U32 star_p = U32_MAX, star_n = 0;
+  while (n < name.size) {
+    if (p < pattern.size && (pattern.str[p] == '?' || pattern.str[p] == name.str[n])) {
+      n++;
+      p++;
+    } else if (p < pattern.size && pattern.str[p] == '*') {
+      star_p = p++;
+      star_n = n;
+    } else if (star_p != U32_MAX) {
+      p = star_p + 1;
+      n = ++star_n;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size && pattern.str[p] == '*') { p++; }
+  return p == pattern.size;
+}
+
+B32 FileHandleStat(FileHandle* file, FileStats* stats) {
+  return CDEFAULT_IO_BACKEND_FN(FileHandleStat(file, stats));
+}
+
+B32 FileHandleOpenStdOut(FileHandle** file) {
+  return CDEFAULT_IO_BACKEND_FN(FileHandleOpenStdOut(file));
+}
+
+B32 FileHandleOpen(FileHandle** file, String8 file_path, FileMode mode) {
+  return CDEFAULT_IO_BACKEND_FN(FileHandleOpen(file, file_path, mode));
+}
+
+B32 FileHandleClose(FileHandle* file) {
+  return CDEFAULT_IO_BACKEND_FN(FileHandleClose(file));
+}
+
+B32 FileHandleSeek(FileHandle* file, S64 distance, FileSeekPos pos) {
+  return CDEFAULT_IO_BACKEND_FN(FileHandleSeek(file, distance, pos));
+}
+
+STATIC_ASSERT(FILE_IO_CHUNK_SIZE > 0 && FILE_IO_CHUNK_SIZE <= GB(1), "FILE_IO_CHUNK_SIZE must fit in a single OS read / write call.");
+
+B32 FileHandleRead64(FileHandle* file, U8* buffer, U64 buffer_size, U64* bytes_read) {
+  B32 success = true;
+  U64 total   = 0;
+  while (total < buffer_size) {
+    U32 chunk_size = (U32) MIN(buffer_size - total, FILE_IO_CHUNK_SIZE);
+    U32 chunk_read = 0;
+    if (!CDEFAULT_IO_BACKEND_FN(FileHandleRead(file, buffer + total, chunk_size, &chunk_read))) {
+      success = false;
+      break;
+    }
+    total += chunk_read;
+    if (chunk_read < chunk_size) { break; } // NOTE: EOF
+  }
+  if (bytes_read != NULL) { *bytes_read = total; }
+  return success;
+}
+
+B32 FileHandleRead(FileHandle* file, U8* buffer, U32 buffer_size, U32* bytes_read) {
+  U64 total;
+  B32 success = FileHandleRead64(file, buffer, buffer_size, &total);
+  if (bytes_read != NULL) { *bytes_read = (U32) total; }
+  return success;
+}
+
+B32 FileHandleWrite(FileHandle* file, U8* buffer, U64 buffer_size) {
+  for (U64 total = 0; total < buffer_size;) {
+    U32 chunk_size = (U32) MIN(buffer_size - total, FILE_IO_CHUNK_SIZE);
+    if (!CDEFAULT_IO_BACKEND_FN(FileHandleWrite(file, buffer + total, chunk_size))) { return false; }
+    total += chunk_size;
+  }
+  return true;
+}
+
+B32 FileHandleSetSize(FileHandle* file, U64 size) {
+  return CDEFAULT_IO_BACKEND_FN(FileHandleSetSize(file, size));
+}
+
+static B32 _FileStreamBufferInit(FileHandle* file, FileMode mode, U64 buffer_size, U8** buffer, U64* buffer_cap) {
+  if (buffer_size == 0) { buffer_size = FILE_STREAM_DEFAULT_BUFFER_SIZE; }
+  if (buffer_size < FILE_STREAM_MIN_BUFFER_SIZE || buffer_size > FILE_STREAM_MAX_BUFFER_SIZE) {
+    LOG_ERROR("[IO] Invalid stream buffer size %llu, must be in [%llu, %llu].", buffer_size, (U64) FILE_STREAM_MIN_BUFFER_SIZE, (U64) FILE_STREAM_MAX_BUFFER_SIZE);
+    return false;
+  }
+  U64 align = 8;
+  if (mode & FileMode_Unbuffered) {
+    align       = FILE_DIRECT_ALIGNMENT;
+    buffer_size = ALIGN_POW_2(buffer_size, FILE_DIRECT_ALIGNMENT);
+  }
+  // NOTE: the buffer lives with the handle, so it's released on close.
+  *buffer     = (U8*) _ArenaPush(file->arena, buffer_size, align);
+  *buffer_cap = buffer_size;
+  return true;
+}
+
+B32 FileReaderOpen(FileReader* reader, String8 file_path, FileMode mode, U64 buffer_size) {
+  MEMORY_ZERO_STRUCT(reader);
+  mode = (mode & FileMode_Unbuffered) | FileMode_Read;
+  if (!FileHandleOpen(&reader->file, file_path, mode)) { return false; }
+  if (!_FileStreamBufferInit(reader->file, mode, buffer_size, &reader->buffer, &reader->buffer_cap)) {
+    DEBUG_ASSERT(FileHandleClose(reader->file));
+    return false;
+  }
+  reader->is_unbuffered = (mode & FileMode_Unbuffered) != 0;
+  return true;
+}
+
+B32 FileReaderClose(FileReader* reader) {
+  B32 success = FileHandleClose(reader->file);
+  MEMORY_ZERO_STRUCT(reader);
+  return success;
+}
+
+static B32 _FileReaderFill(FileReader* reader) {
+  DEBUG_ASSERT(reader->buffer_pos == reader->buffer_size);
+  reader->buffer_pos  = 0;
+  reader->buffer_size = 0;
+  if (reader->is_eof) { return true; }
+  reader->num_os_calls++;
+  if (!FileHandleRead64(reader->file, reader->buffer, reader->buffer_cap, &reader->buffer_size)) { return false; }
+  // NOTE: a short read means EOF. This also keeps unbuffered reads from ever starting at an unaligned offset.
+  if (reader->buffer_size < reader->buffer_cap) { reader->is_eof = true; }
+  return true;
+}
+
+B32 FileReaderRead(FileReader* reader, U8* buffer, U64 buffer_size, U64* bytes_read) {
+  B32 success = true;
+  U64 total   = 0;
+  while (total < buffer_size) {
+    if (reader->buffer_pos == reader->buffer_size) {
+      if (reader->is_eof) { break; }
+      // NOTE: large reads skip the buffer and go directly into the destination.
+      U64 remaining = buffer_size - total;
+      if (!reader->is_unbuffered && remaining >= reader->buffer_cap) {
+        U64 direct_read;
+        reader->num_os_calls++;
+        if (!FileHandleRead64(reader->file, buffer + total, remaining, &direct_read)) { success = false; break; }
+        total += direct_read;
+        if (direct_read < remaining) { reader->is_eof = true; }
+        continue;
+      }
+      if (!_FileReaderFill(reader)) { success = false; break; }
+      if (reader->buffer_size == 0) { break; }
+    }
+    U64 copy_size = MIN(buffer_size - total, reader->buffer_size - reader->buffer_pos);
+    MEMORY_COPY_SIZE(buffer + total, reader->buffer + reader->buffer_pos, copy_size);
+    reader->buffer_pos += copy_size;
+    total += copy_size;
+  }
+  if (bytes_read != NULL) { *bytes_read = total; }
+  return success;
+}
+
+B32 FileReaderReadExact(FileReader* reader, U8* buffer, U64 buffer_size) {
+  U64 bytes_read;
+  if (!FileReaderRead(reader, buffer, buffer_size, &bytes_read)) { return false; }
+  return bytes_read == buffer_size;
+}
+
+B32 FileReaderReadLine(FileReader* reader, Arena* arena, String8* line) {
+  line->str  = NULL;
+  line->size = 0;
+  B32 found_newline = false;
+  while (!found_newline) {
+    if (reader->buffer_pos == reader->buffer_size) {
+      if (!_FileReaderFill(reader)) { return false; }
+      if (reader->buffer_size == 0) { break; }
+    }
+    U8* start = reader->buffer + reader->buffer_pos;
+    U64 available = reader->buffer_size - reader->buffer_pos;
+    S32 newline_pos = Str8FindChar(Str8(start, (U32) available), 0, '\n');
+    U64 take = available;
+    if (newline_pos >= 0) {
+      take = newline_pos;
+      found_newline = true;
+    }
+    // NOTE: lines spanning multiple fills are pushed piecewise, nothing else is pushed in between so they're contiguous.
+    U8* dest = (U8*) _ArenaPush(arena, take, 1);
+    if (line->str == NULL) { line->str = dest; }
+    DEBUG_ASSERT(line->str + line->size == dest);
+    MEMORY_COPY_SIZE(dest, start, take);
+    line->size += take;
+    reader->buffer_pos += take + (found_newline ? 1 : 0);
+  }
+  if (!found_newline && line->size == 0) { return false; }
+  if (line->size > 0 && line->str[line->size - 1] == '\r') { line->size--; }
+  return true;
+}
+
+B32 FileWriterOpen(FileWriter* writer, String8 file_path, FileMode mode, U64 buffer_size) {
+  MEMORY_ZERO_STRUCT(writer);
+  mode = (mode & ~FileMode_Read) | FileMode_Write;
+  if (!FileHandleOpen(&writer->file, file_path, mode)) { return false; }
+  if (!_FileStreamBufferInit(writer->file, mode, buffer_size, &writer->buffer, &writer->buffer_cap)) {
+    DEBUG_ASSERT(FileHandleClose(writer->file));
+    return false;
+  }
+  writer->is_unbuffered = (mode & FileMode_Unbuffered) != 0;
+  return true;
+}
+
+static B32 _FileWriterWriteBuffer(FileWriter* writer, U64 size) {
+  writer->num_os_calls++;
+  if (!FileHandleWrite(writer->file, writer->buffer, size)) { return false; }
+  MEMORY_MOVE_SIZE(writer->buffer, writer->buffer + size, writer->buffer_size - size);
+  writer->buffer_size -= size;
+  writer->file_pos    += size;
+  return true;
+}
+
+B32 FileWriterFlush(FileWriter* writer) {
+  U64 size = writer->buffer_size;
+  if (writer->is_unbuffered) { size -= size % FILE_DIRECT_ALIGNMENT; }
+  if (size == 0) { return true; }
+  return _FileWriterWriteBuffer(writer, size);
+}
+
+B32 FileWriterWrite(FileWriter* writer, U8* buffer, U64 buffer_size) {
+  while (buffer_size > 0) {
+    if (writer->buffer_size == writer->buffer_cap) {
+      if (!_FileWriterWriteBuffer(writer, writer->buffer_size)) { return false; }
+    }
+    // NOTE: large writes skip the buffer and go directly to the OS.
+    if (!writer->is_unbuffered && writer->buffer_size == 0 && buffer_size >= writer->buffer_cap) {
+      writer->num_os_calls++;
+      if (!FileHandleWrite(writer->file, buffer, buffer_size)) { return false; }
+      writer->file_pos += buffer_size;
+      return true;
+    }
+    U64 copy_size = MIN(buffer_size, writer->buffer_cap - writer->buffer_size);
+    MEMORY_COPY_SIZE(writer->buffer + writer->buffer_size, buffer, copy_size);
+    writer->buffer_size += copy_size;
+    buffer      += copy_size;
+    buffer_size -= copy_size;
+  }
+  return true;
+}
+
+B32 FileWriterWriteStr8(FileWriter* writer, String8 str) {
+  return FileWriterWrite(writer, str.str, str.size);
+}
+
+B32 FileWriterClose(FileWriter* writer) {
+  B32 success = true;
+  if (writer->is_unbuffered && writer->buffer_size > 0) {
+    // NOTE: pad out the last block, then trim the padding back off.
+    U64 file_size   = writer->file_pos + writer->buffer_size;
+    U64 padded_size = ALIGN_POW_2(writer->buffer_size, FILE_DIRECT_ALIGNMENT);
+    MEMORY_ZERO_SIZE(writer->buffer + writer->buffer_size, padded_size - writer->buffer_size);
+    writer->buffer_size = padded_size;
+    success = _FileWriterWriteBuffer(writer, padded_size) && FileHandleSetSize(writer->file, file_size);
+  } else if (writer->buffer_size > 0) {
+    success = _FileWriterWriteBuffer(writer, writer->buffer_size);
+  }
+  success = FileHandleClose(writer->file) && success;
+  MEMORY_ZERO_STRUCT(writer);
+  return success;
+}
+
+#define DEFLATE_WINDOW_SIZE   32768
+#define DEFLATE_MIN_MATCH     3
+#define DEFLATE_MAX_MATCH     258
+#define DEFLATE_MAX_BITS      15
+#define DEFLATE_LIT_SYMBOLS   288
+#define DEFLATE_DIST_SYMBOLS  32
+#define DEFLATE_HASH_BITS     15
+#define DEFLATE_MIN_LOOKAHEAD (DEFLATE_MAX_MATCH + DEFLATE_MIN_MATCH + 1)
+#define DEFLATE_MAX_DIST      (DEFLATE_WINDOW_SIZE - DEFLATE_MIN_LOOKAHEAD)
+#define DEFLATE_SYMBOLS_CAP   16384   // NOTE: Num of symbols buffered per block.
+#define DEFLATE_PENDING_CAP   KB(128) // NOTE: Fits any one block, since a block is never larger than its dynamic huffman encoding.
+#define INFLATE_FAST_BITS     10
+
+static const U16 _cdef_deflate_length_base[29]       = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const U8  _cdef_deflate_length_extra[29]      = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const U16 _cdef_deflate_dist_base[30]         = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const U8  _cdef_deflate_dist_extra[30]        = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const U8  _cdef_deflate_code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+static U32 _DeflateChecksum(CompressFormat format, U32 checksum, U8* data, U64 data_size) {
+  switch (format) {
+    case CompressFormat_Zlib: return Adler32Update(checksum, data, data_size);
+    case CompressFormat_Gzip: return Crc32Update(checksum, data, data_size);
+    default:                  return checksum;
+  }
+}
+
+static U32 _DeflateReverse16(U32 x) {
+  x = ((x & 0xAAAA) >> 1) | ((x & 0x5555) << 1);
+  x = ((x & 0xCCCC) >> 2) | ((x & 0x3333) << 2);
+  x = ((x & 0xF0F0) >> 4) | ((x & 0x0F0F) << 4);
+  x = ((x & 0xFF00) >> 8) | ((x & 0x00FF) << 8);
+  return x;
+}
+
+static inline U32 _DeflateLsb64(U64 x) {
+  DEBUG_ASSERT(x != 0);
+#if defined(COMPILER_MSVC)
+  unsigned long result;
+  _BitScanForward64(&result, x);
+  return (U32) result;
+#else
+  return (U32) __builtin_ctzll(x);
+#endif
+}
+
+static inline U32 _DeflateMsb32(U32 x) {
+  DEBUG_ASSERT(x != 0);
+#if defined(COMPILER_MSVC)
+  unsigned long result;
+  _BitScanReverse(&result, x);
+  return (U32) result;
+#else
+  return 31 - (U32) __builtin_clz(x);
+#endif
+}
+
+static void _DeflateFixedLengths(U8* lit_lengths, U8* dist_lengths) {
+  for (U32 i = 0; i < DEFLATE_LIT_SYMBOLS; i++) {
+    if      (i < 144) { lit_lengths[i] = 8; }
+    else if (i < 256) { lit_lengths[i] = 9; }
+    else if (i < 280) { lit_lengths[i] = 7; }
+    else              { lit_lengths[i] = 8; }
+  }
+  MEMORY_SET_SIZE(dist_lengths, 5, DEFLATE_DIST_SYMBOLS);
+}
+
+typedef enum InflateState InflateState;
+enum InflateState {
+  InflateState_ZlibHeader,
+  InflateState_GzipHeader,
+  InflateState_GzipTime,
+  InflateState_GzipOs,
+  InflateState_GzipExtraSize,
+  InflateState_GzipExtra,
+  InflateState_GzipName,
+  InflateState_GzipComment,
+  InflateState_GzipHeaderCrc,
+  InflateState_BlockHeader,
+  InflateState_StoredHeader,
+  InflateState_Stored,
+  InflateState_TableSizes,
+  InflateState_TableCodeLengths,
+  InflateState_TableLengths,
+  InflateState_Block,
+  InflateState_Match,
+  InflateState_Trailer,
+  InflateState_GzipSize,
+  InflateState_Done,
+  InflateState_Error,
+};
+
+// NOTE: Canonical huffman decoding table. Codes of up to INFLATE_FAST_BITS bits are resolved with a single lookup,
+// longer ones by comparing against the first code of each length.
+typedef struct InflateHuffman InflateHuffman;
+struct InflateHuffman {
+  U16 fast[1 << INFLATE_FAST_BITS]; // NOTE: (code length << 9) | symbol, indexed by the next bits. 0 for longer codes.
+  U32 max_code[DEFLATE_MAX_BITS + 1]; // NOTE: Per length, the first code (left aligned to 16 bits) past that length.
+  U16 first_code[DEFLATE_MAX_BITS + 1];
+  U16 first_symbol[DEFLATE_MAX_BITS + 1];
+  U16 symbols[DEFLATE_LIT_SYMBOLS]; // NOTE: In code order.
+  U32 symbols_size;
+};
+
+struct Inflate {
+  Arena* arena;
+  CompressFormat format;
+  InflateState state;
+  U8* in;
+  U8* in_end;
+  U8* out_start;
+  U8* out;
+  U8* out_end;
+  U8* out_checked; // NOTE: Output before this has been added to the checksum.
+  U64 bitbuf;
+  U32 bitcount;
+  U32 checksum;
+  U64 total_out;
+  B32 is_final_block;
+  U32 gzip_flags;
+  U32 counter; // NOTE: Bytes left in a stored block or gzip field, or lengths read so far while reading a table.
+  U32 lit_size;
+  U32 dist_size;
+  U32 code_lengths_size;
+  U8  lengths[DEFLATE_LIT_SYMBOLS + DEFLATE_DIST_SYMBOLS];
+  U32 match_length;
+  U32 match_dist;
+  InflateHuffman lit;
+  InflateHuffman dist;
+  InflateHuffman code_lengths;
+  // NOTE: The last DEFLATE_WINDOW_SIZE bytes output by previous calls, which matches may still refer to.
+  U32 window_pos;
+  U32 window_size;
+  U8  window[DEFLATE_WINDOW_SIZE];
+};
+
+static B32 _InflateHuffmanBuild(InflateHuffman* h, U8* lengths, U32 lengths_size) {
+  U32 counts[DEFLATE_MAX_BITS + 1];
+  MEMORY_ZERO_STATIC_ARRAY(counts);
+  for (U32 i = 0; i < lengths_size; i++) { counts[lengths[i]]++; }
+  counts[0] = 0;
+  S32 left = 1;
+  for (U32 len = 1; len <= DEFLATE_MAX_BITS; len++) {
+    left = (left << 1) - (S32) counts[len];
+    if (left < 0) { return false; } // NOTE: over-subscribed. Incomplete codes are allowed.
+  }
+
+  U32 offsets[DEFLATE_MAX_BITS + 1];
+  U32 code = 0, symbols_size = 0;
+  for (U32 len = 1; len <= DEFLATE_MAX_BITS; len++) {
+    h->first_code[len]   = (U16) code;
+    h->first_symbol[len] = (U16) symbols_size;
+    offsets[len]         = symbols_size;
+    code         += counts[len];
+    symbols_size += counts[len];
+    h->max_code[len] = code << (16 - len);
+    code <<= 1;
+  }
+  h->symbols_size = symbols_size;
+
+  MEMORY_ZERO_STATIC_ARRAY(h->fast);
+  for (U32 symbol = 0; symbol < lengths_size; symbol++) {
+    U32 len = lengths[symbol];
+    if (len == 0) { continue; }
+    U32 idx = offsets[len]++;
+    h->symbols[idx] = (U16) symbol;
+    if (len <= INFLATE_FAST_BITS) {
+      // NOTE: codes are read least significant bit first, so every index ending in the reversed code maps to it.
+      U32 reversed = _DeflateReverse16(h->first_code[len] + (idx - h->first_symbol[len])) >> (16 - len);
+      for (U32 i = reversed; i < (1 << INFLATE_FAST_BITS); i += (1 << len)) { h->fast[i] = (U16) ((len << 9) | symbol); }
+    }
+  }
+  return true;
+}
+
+// NOTE: Returns 1 and places the symbol and its code length, 0 if more bits are needed, or -1 on an invalid code.
+// Does not consume the bits.
+static inline S32 _InflateDecode(InflateHuffman* h, U64 bits, U32 bitcount, U32* symbol, U32* length) {
+  U32 entry = h->fast[bits & ((1 << INFLATE_FAST_BITS) - 1)];
+  if (entry != 0) {
+    *symbol = entry & 0x1FF;
+    *length = entry >> 9;
+    return (*length <= bitcount) ? 1 : 0;
+  }
+  U32 code = _DeflateReverse16((U32) bits & 0xFFFF);
+  U32 len  = INFLATE_FAST_BITS + 1;
+  while (len <= DEFLATE_MAX_BITS && code >= h->max_code[len]) { len++; }
+  if (len > DEFLATE_MAX_BITS) { return (bitcount < DEFLATE_MAX_BITS) ? 0 : -1; }
+  if (len > bitcount) { return 0; }
+  U32 idx = h->first_symbol[len] + ((code >> (16 - len)) - h->first_code[len]);
+  if (idx >= h->symbols_size) { return -1; }
+  *symbol = h->symbols[idx];
+  *length = len;
+  return 1;
+}
+
+// NOTE: Tops the bit buffer up to at least 56 bits, if enough input remains. The fast path may leave bits of the next
+// unread byte above bitcount, which is harmless since they are the same bits the next refill places there.
+static inline void _InflateRefill(Inflate* f) {
+  if (f->in_end - f->in >= 8) {
+    U64 bits;
+    MEMORY_COPY_SIZE(&bits, f->in, sizeof(bits)); // NOTE: assumes a little endian host.
+    f->bitbuf   |= bits << f->bitcount;
+    f->in       += (63 - f->bitcount) >> 3;
+    f->bitcount |= 56;
+  } else {
+    while (f->bitcount <= 56 && f->in < f->in_end) {
+      f->bitbuf   |= (U64) *f->in++ << f->bitcount;
+      f->bitcount += 8;
+    }
+  }
+}
+
+static inline void _InflateConsume(Inflate* f, U32 num_bits) {
+  f->bitbuf   >>= num_bits;
+  f->bitcount  -= num_bits;
+}
+
+// NOTE: Returns false if fewer than num_bits are available, without consuming any.
+static inline B32 _InflatePullBits(Inflate* f, U32 num_bits, U32* result) {
+  DEBUG_ASSERT(num_bits <= 32);
+  if (f->bitcount < num_bits) {
+    _InflateRefill(f);
+    if (f->bitcount < num_bits) { return false; }
+  }
+  *result = (U32) (f->bitbuf & ((1ULL << num_bits) - 1));
+  _InflateConsume(f, num_bits);
+  return true;
+}
+
+static inline void _InflateAlignToByte(Inflate* f) {
+  _InflateConsume(f, f->bitcount % 8);
+}
+
+static void _InflateUpdateChecksum(Inflate* f) {
+  f->checksum    = _DeflateChecksum(f->format, f->checksum, f->out_checked, f->out - f->out_checked);
+  f->out_checked = f->out;
+}
+
+static void _InflateUpdateWindow(Inflate* f) {
+  U8* data = f->out_start;
+  U64 size = f->out - f->out_start;
+  if (size >= DEFLATE_WINDOW_SIZE) {
+    data += size - DEFLATE_WINDOW_SIZE;
+    size  = DEFLATE_WINDOW_SIZE;
+  }
+  U32 first_size = MIN((U32) size, DEFLATE_WINDOW_SIZE - f->window_pos);
+  MEMORY_COPY_SIZE(f->window + f->window_pos, data, first_size);
+  MEMORY_COPY_SIZE(f->window, data + first_size, size - first_size);
+  f->window_pos  = (f->window_pos + (U32) size) & (DEFLATE_WINDOW_SIZE - 1);
+  f->window_size = MIN(f->window_size + (U32) size, DEFLATE_WINDOW_SIZE);
+}
+
+// NOTE: Returns false if the output filled up first.
+static B32 _InflateCopyMatch(Inflate* f) {
+  while (f->match_length > 0) {
+    U64 out_left = f->out_end - f->out;
+    if (out_left == 0) { return false; }
+    U64 produced = f->out - f->out_start;
+    U8* dest = f->out;
+    U64 size;
+    if (f->match_dist > produced) {
+      // NOTE: the match starts in output from a previous call.
+      U32 back = f->match_dist - (U32) produced;
+      U32 idx  = (f->window_pos - back) & (DEFLATE_WINDOW_SIZE - 1);
+      size = MIN(MIN(f->match_length, back), DEFLATE_WINDOW_SIZE - idx);
+      size = MIN(size, out_left);
+      MEMORY_COPY_SIZE(dest, f->window + idx, size);
+    } else {
+      U8* src = f->out - f->match_dist;
+      size = MIN(f->match_length, out_left);
+      if (f->match_dist >= size) {
+        MEMORY_COPY_SIZE(dest, src, size);
+      } else if (f->match_dist >= 8) {
+        // NOTE: overlapping, but each 8 byte chunk only reads bytes that have already been written.
+        U64 i = 0;
+        for (; i + 8 <= size; i += 8) { MEMORY_COPY_SIZE(dest + i, src + i, 8); }
+        for (; i < size; i++) { dest[i] = src[i]; }
+      } else {
+        for (U64 i = 0; i < size; i++) { dest[i] = src[i]; }
+      }
+    }
+    f->out          += size;
+    f->match_length -= (U32) size;
+  }
+  return true;
+}
+
+B32 InflateCreate(Inflate** inflate, CompressFormat format) {
+  Arena* arena = _ArenaAllocate(KB(256), KB(64));
+  Inflate* f = ARENA_PUSH_STRUCT(arena, Inflate);
+  MEMORY_ZERO_STRUCT(f);
+  f->arena  = arena;
+  f->format = format;
+  switch (format) {
+    case CompressFormat_Raw:  { f->state = InflateState_BlockHeader; } break;
+    case CompressFormat_Zlib: { f->state = InflateState_ZlibHeader; f->checksum = ADLER32_INIT; } break;
+    case CompressFormat_Gzip: { f->state = InflateState_GzipHeader; } break;
+    default: {
+      LOG_ERROR("[IO] Invalid compression format: %d", format);
+      ArenaRelease(arena);
+      return false;
+    }
+  }
+  *inflate = f;
+  return true;
+}
+
+void InflateDestroy(Inflate* inflate) {
+  ArenaRelease(inflate->arena);
+}
+
+#define INFLATE_PULL_BITS(num_bits, result) if (!_InflatePullBits(f, num_bits, result)) { goto inflate_run_needs_input; }
+CompressStatus InflateRun(Inflate* f, U8* in, U64 in_size, U64* in_read, U8* out, U64 out_size, U64* out_written) {
+  f->in          = in;
+  f->in_end      = in + in_size;
+  f->out_start   = out;
+  f->out         = out;
+  f->out_end     = out + out_size;
+  f->out_checked = out;
+  CompressStatus status = CompressStatus_Error;
+  U32 x;
+
+  while (true) {
+    switch (f->state) {
+      case InflateState_ZlibHeader: {
+        INFLATE_PULL_BITS(16, &x);
+        U32 cmf = x & 0xFF;
+        U32 flg = x >> 8;
+        if ((cmf & 0xF) != 8 || (cmf >> 4) > 7) {
+          LOG_ERROR("[IO] Inflate: unsupported zlib compression method: %u", cmf);
+          goto inflate_run_fail;
+        }
+        if (((cmf << 8) | flg) % 31 != 0) {
+          LOG_ERROR("[IO] Inflate: zlib header check failed.");
+          goto inflate_run_fail;
+        }
+        if (flg & BIT(5)) {
+          LOG_ERROR("[IO] Inflate: zlib preset dictionaries are not supported.");
+          goto inflate_run_fail;
+        }
+        f->state = InflateState_BlockHeader;
+      } break;
+
+      case InflateState_GzipHeader: {
+        INFLATE_PULL_BITS(32, &x);
+        if ((x & 0xFFFF) != 0x8B1F) {
+          LOG_ERROR("[IO] Inflate: not a gzip stream.");
+          goto inflate_run_fail;
+        }
+        if (((x >> 16) & 0xFF) != 8) {
+          LOG_ERROR("[IO] Inflate: unsupported gzip compression method: %u", (x >> 16) & 0xFF);
+          goto inflate_run_fail;
+        }
+        f->gzip_flags = x >> 24;
+        if (f->gzip_flags & 0xE0) {
+          LOG_ERROR("[IO] Inflate: reserved gzip flags are set.");
+          goto inflate_run_fail;
+        }
+        f->state = InflateState_GzipTime;
+      } break;
+      case InflateState_GzipTime: {
+        INFLATE_PULL_BITS(32, &x);
+        f->state = InflateState_GzipOs;
+      } break;
+      case InflateState_GzipOs: {
+        INFLATE_PULL_BITS(16, &x); // NOTE: extra flags and OS.
+        f->state = InflateState_GzipExtraSize;
+      } break;
+      case InflateState_GzipExtraSize: {
+        if (f->gzip_flags & BIT(2)) {
+          INFLATE_PULL_BITS(16, &x);
+          f->counter = x;
+        }
+        f->state = InflateState_GzipExtra;
+      } break;
+      case InflateState_GzipExtra: {
+        for (; f->counter > 0; f->counter--) { INFLATE_PULL_BITS(8, &x); }
+        f->state = InflateState_GzipName;
+      } break;
+      case InflateState_GzipName: {
+        if (f->gzip_flags & BIT(3)) {
+          do { INFLATE_PULL_BITS(8, &x); } while (x != 0);
+        }
+        f->state = InflateState_GzipComment;
+      } break;
+      case InflateState_GzipComment: {
+        if (f->gzip_flags & BIT(4)) {
+          do { INFLATE_PULL_BITS(8, &x); } while (x != 0);
+        }
+        f->state = InflateState_GzipHeaderCrc;
+      } break;
+      case InflateState_GzipHeaderCrc: {
+        if (f->gzip_flags & BIT(1)) { INFLATE_PULL_BITS(16, &x); }
+        f->state = InflateState_BlockHeader;
+      } break;
+
+      case InflateState_BlockHeader: {
+        INFLATE_PULL_BITS(3, &x);
+        f->is_final_block = x & 1;
+        switch (x >> 1) {
+          case 0: { f->state = InflateState_StoredHeader; } break;
+          case 1: {
+            _DeflateFixedLengths(f->lengths, f->lengths + DEFLATE_LIT_SYMBOLS);
+            DEBUG_ASSERT(_InflateHuffmanBuild(&f->lit, f->lengths, DEFLATE_LIT_SYMBOLS));
+            DEBUG_ASSERT(_InflateHuffmanBuild(&f->dist, f->lengths + DEFLATE_LIT_SYMBOLS, DEFLATE_DIST_SYMBOLS));
+            f->state = InflateState_Block;
+          } break;
+          case 2: { f->state = InflateState_TableSizes; } break;
+          default: {
+            LOG_ERROR("[IO] Inflate: invalid block type.");
+            goto inflate_run_fail;
+          }
+        }
+      } break;
+
+      case InflateState_StoredHeader: {
+        _InflateAlignToByte(f);
+        INFLATE_PULL_BITS(32, &x);
+        if ((x & 0xFFFF) != ((~x) >> 16)) {
+          LOG_ERROR("[IO] Inflate: stored block length check failed.");
+          goto inflate_run_fail;
+        }
+        f->counter = x & 0xFFFF;
+        f->state   = InflateState_Stored;
+      } break;
+      case InflateState_Stored: {
+        while (f->counter > 0) {
+          if (f->out == f->out_end) { goto inflate_run_needs_output; }
+          if (f->bitcount >= 8) {
+            *f->out++ = (U8) f->bitbuf;
+            _InflateConsume(f, 8);
+            f->counter--;
+            continue;
+          }
+          if (f->in == f->in_end) { goto inflate_run_needs_input; }
+          U64 size = MIN(MIN((U64) f->counter, (U64) (f->in_end - f->in)), (U64) (f->out_end - f->out));
+          MEMORY_COPY_SIZE(f->out, f->in, size);
+          f->bitbuf   = 0; // NOTE: drop any bits a fast refill left behind, that input was just consumed directly.
+          f->in      += size;
+          f->out     += size;
+          f->counter -= (U32) size;
+        }
+        f->state = f->is_final_block ? InflateState_Trailer : InflateState_BlockHeader;
+      } break;
+
+      case InflateState_TableSizes: {
+        INFLATE_PULL_BITS(14, &x);
+        f->lit_size          = (x & 0x1F) + 257;
+        f->dist_size         = ((x >> 5) & 0x1F) + 1;
+        f->code_lengths_size = (x >> 10) + 4;
+        if (f->lit_size > 286 || f->dist_size > 30) {
+          LOG_ERROR("[IO] Inflate: invalid huffman table sizes.");
+          goto inflate_run_fail;
+        }
+        MEMORY_ZERO_SIZE(f->lengths, STATIC_ARRAY_SIZE(_cdef_deflate_code_length_order));
+        f->counter = 0;
+        f->state   = InflateState_TableCodeLengths;
+      } break;
+      case InflateState_TableCodeLengths: {
+        for (; f->counter < f->code_lengths_size; f->counter++) {
+          INFLATE_PULL_BITS(3, &x);
+          f->lengths[_cdef_deflate_code_length_order[f->counter]] = (U8) x;
+        }
+        if (!_InflateHuffmanBuild(&f->code_lengths, f->lengths, STATIC_ARRAY_SIZE(_cdef_deflate_code_length_order))) {
+          LOG_ERROR("[IO] Inflate: invalid code length code.");
+          goto inflate_run_fail;
+        }
+        f->counter = 0;
+        f->state   = InflateState_TableLengths;
+      } break;
+      case InflateState_TableLengths: {
+        U32 lengths_size = f->lit_size + f->dist_size;
+        while (f->counter < lengths_size) {
+          if (f->bitcount < 14) { _InflateRefill(f); }
+          U32 symbol, length;
+          S32 decoded = _InflateDecode(&f->code_lengths, f->bitbuf, f->bitcount, &symbol, &length);
+          if (decoded == 0) { goto inflate_run_needs_input; }
+          if (decoded < 0) {
+            LOG_ERROR("[IO] Inflate: invalid code length symbol.");
+            goto inflate_run_fail;
+          }
+          if (symbol < 16) {
+            _InflateConsume(f, length);
+            f->lengths[f->counter++] = (U8) symbol;
+            continue;
+          }
+          U32 extra = (symbol == 16) ? 2 : (symbol == 17) ? 3 : 7;
+          if (length + extra > f->bitcount) { goto inflate_run_needs_input; }
+          U32 repeat = (U32) ((f->bitbuf >> length) & ((1 << extra) - 1));
+          U8  value  = 0;
+          if (symbol == 16) {
+            if (f->counter == 0) {
+              LOG_ERROR("[IO] Inflate: code length repeat with no previous length.");
+              goto inflate_run_fail;
+            }
+            value   = f->lengths[f->counter - 1];
+            repeat += 3;
+          } else if (symbol == 17) {
+            repeat += 3;
+          } else {
+            repeat += 11;
+          }
+          if (f->counter + repeat > lengths_size) {
+            LOG_ERROR("[IO] Inflate: code lengths overflow the table.");
+            goto inflate_run_fail;
+          }
+          _InflateConsume(f, length + extra);
+          MEMORY_SET_SIZE(f->lengths + f->counter, value, repeat);
+          f->counter += repeat;
+        }
+        if (f->lengths[256] == 0) {
+          LOG_ERROR("[IO] Inflate: block is missing an end of block code.");
+          goto inflate_run_fail;
+        }
+        if (!_InflateHuffmanBuild(&f->lit, f->lengths, f->lit_size) ||
+            !_InflateHuffmanBuild(&f->dist, f->lengths + f->lit_size, f->dist_size)) {
+          LOG_ERROR("[IO] Inflate: invalid huffman table.");
+          goto inflate_run_fail;
+        }
+        f->state = InflateState_Block;
+      } break;
+
+      case InflateState_Block: {
+        // NOTE: each iteration decodes one whole symbol, or nothing. A length / distance pair needs at most 48 bits.
+        while (true) {
+          if (f->bitcount < 48) { _InflateRefill(f); }
+          U32 symbol, length;
+          S32 decoded = _InflateDecode(&f->lit, f->bitbuf, f->bitcount, &symbol, &length);
+          if (decoded == 0) { goto inflate_run_needs_input; }
+          if (decoded < 0) {
+            LOG_ERROR("[IO] Inflate: invalid literal / length code.");
+            goto inflate_run_fail;
+          }
+          if (symbol < 256) {
+            if (f->out == f->out_end) { goto inflate_run_needs_output; }
+            *f->out++ = (U8) symbol;
+            _InflateConsume(f, length);
+            continue;
+          }
+          if (symbol == 256) {
+            _InflateConsume(f, length);
+            f->state = f->is_final_block ? InflateState_Trailer : InflateState_BlockHeader;
+            break;
+          }
+
+          symbol -= 257;
+          if (symbol >= STATIC_ARRAY_SIZE(_cdef_deflate_length_base)) {
+            LOG_ERROR("[IO] Inflate: invalid length symbol.");
+            goto inflate_run_fail;
+          }
+          U32 used  = length;
+          U32 extra = _cdef_deflate_length_extra[symbol];
+          if (used + extra > f->bitcount) { goto inflate_run_needs_input; }
+          U32 match_length = _cdef_deflate_length_base[symbol] + (U32) ((f->bitbuf >> used) & ((1 << extra) - 1));
+          used += extra;
+
+          decoded = _InflateDecode(&f->dist, f->bitbuf >> used, f->bitcount - used, &symbol, &length);
+          if (decoded == 0) { goto inflate_run_needs_input; }
+          if (decoded < 0 || symbol >= STATIC_ARRAY_SIZE(_cdef_deflate_dist_base)) {
+            LOG_ERROR("[IO] Inflate: invalid distance code.");
+            goto inflate_run_fail;
+          }
+          used += length;
+          extra = _cdef_deflate_dist_extra[symbol];
+          if (used + extra > f->bitcount) { goto inflate_run_needs_input; }
+          U32 match_dist = _cdef_deflate_dist_base[symbol] + (U32) ((f->bitbuf >> used) & ((1 << extra) - 1));
+          used += extra;
+          if (match_dist > (U64) (f->out - f->out_start) + f->window_size) {
+            LOG_ERROR("[IO] Inflate: distance refers to before the start of the stream.");
+            goto inflate_run_fail;
+          }
+
+          _InflateConsume(f, used);
+          f->match_length = match_length;
+          f->match_dist   = match_dist;
+          if (!_InflateCopyMatch(f)) {
+            f->state = InflateState_Match;
+            goto inflate_run_needs_output;
+          }
+        }
+      } break;
+      case InflateState_Match: {
+        if (!_InflateCopyMatch(f)) { goto inflate_run_needs_output; }
+        f->state = InflateState_Block;
+      } break;
+
+      case InflateState_Trailer: {
+        _InflateAlignToByte(f);
+        _InflateUpdateChecksum(f);
+        if (f->format == CompressFormat_Zlib) {
+          INFLATE_PULL_BITS(32, &x);
+          U32 expected = ((x & 0xFF) << 24) | ((x & 0xFF00) << 8) | ((x >> 8) & 0xFF00) | (x >> 24);
+          if (expected != f->checksum) {
+            LOG_ERROR("[IO] Inflate: zlib checksum mismatch, data is corrupt.");
+            goto inflate_run_fail;
+          }
+          f->state = InflateState_Done;
+        } else if (f->format == CompressFormat_Gzip) {
+          INFLATE_PULL_BITS(32, &x);
+          if (x != f->checksum) {
+            LOG_ERROR("[IO] Inflate: gzip checksum mismatch, data is corrupt.");
+            goto inflate_run_fail;
+          }
+          f->state = InflateState_GzipSize;
+        } else {
+          f->state = InflateState_Done;
+        }
+        if (f->state == InflateState_Done) { goto inflate_run_done; }
+      } break;
+      case InflateState_GzipSize: {
+        INFLATE_PULL_BITS(32, &x);
+        if (x != (U32) (f->total_out + (f->out - f->out_start))) {
+          LOG_ERROR("[IO] Inflate: gzip size mismatch, data is corrupt.");
+          goto inflate_run_fail;
+        }
+        f->state = InflateState_Done;
+        goto inflate_run_done;
+      } break;
+
+      case InflateState_Done: {
+        status = CompressStatus_Done;
+        goto inflate_run_exit;
+      } break;
+      case InflateState_Error: {
+        status = CompressStatus_Error;
+        goto inflate_run_exit;
+      } break;
+    }
+  }
+
+inflate_run_done:
+  // NOTE: give back whole bytes read ahead into the bit buffer, they belong to whatever follows the stream.
+  {
+    U64 unused = MIN((U64) (f->bitcount / 8), (U64) (f->in - in));
+    f->in      -= unused;
+    f->bitbuf   = 0;
+    f->bitcount = 0;
+  }
+  status = CompressStatus_Done;
+  goto inflate_run_exit;
+inflate_run_needs_input:
+  status = CompressStatus_NeedsInput;
+  goto inflate_run_exit;
+inflate_run_needs_output:
+  status = CompressStatus_NeedsOutput;
+  goto inflate_run_exit;
+inflate_run_fail:
+  f->state = InflateState_Error;
+  status   = CompressStatus_Error;
+inflate_run_exit:
+  _InflateUpdateChecksum(f);
+  _InflateUpdateWindow(f);
+  f->total_out += f->out - f->out_start;
+  *in_read      = f->in - in;
+  *out_written  = f->out - out;
+  return status;
+}
+#undef INFLATE_PULL_BITS
+
+B32 InflateAll(Arena* arena, CompressFormat format, U8* in, U64 in_size, U8** out, U64* out_size) {
+  Inflate* inflate;
+  if (!InflateCreate(&inflate, format)) { return false; }
+  U64 arena_base = ArenaPos(arena);
+  B32 success    = false;
+
+  // NOTE: output chunks are pushed back to back, so they form one contiguous buffer.
+  U64 cap  = MAX(in_size * 4, KB(64));
+  U8* data = (U8*) _ArenaPush(arena, cap, 8);
+  U64 size = 0, in_pos = 0;
+  while (true) {
+    U64 in_read, out_written;
+    CompressStatus status = InflateRun(inflate, in + in_pos, in_size - in_pos, &in_read, data + size, cap - size, &out_written);
+    in_pos += in_read;
+    size   += out_written;
+    if (status == CompressStatus_Done) { break; }
+    if (status == CompressStatus_Error) { goto inflate_all_exit; }
+    if (status == CompressStatus_NeedsInput) {
+      LOG_ERROR("[IO] Inflate: compressed data is truncated.");
+      goto inflate_all_exit;
+    }
+    U8* next = (U8*) _ArenaPush(arena, cap, 1);
+    DEBUG_ASSERT(next == data + cap);
+    cap *= 2;
+  }
+  ArenaPop(arena, cap - size);
+  *out      = data;
+  *out_size = size;
+  success   = true;
+
+inflate_all_exit:
+  if (!success) { ArenaPopTo(arena, arena_base); }
+  InflateDestroy(inflate);
+  return success;
+}
+
+struct Deflate {
+  Arena* arena;
+  CompressFormat format;
+  U32 max_chain;   // NOTE: Most hash chain entries to check per position.
+  U32 good_length; // NOTE: Check only a quarter of the chain if the previous match is at least this long.
+  U32 lazy_length; // NOTE: Don't look for a better match if the previous match is at least this long.
+  U32 nice_length; // NOTE: Stop searching once a match is at least this long.
+  B32 is_lazy;
+  B32 is_done;
+  U32 checksum;
+  U64 total_in;
+
+  // NOTE: Input is appended to the window, and the window is slid down by DEFLATE_WINDOW_SIZE once full.
+  U8* window;
+  U32 window_size;
+  U32 pos;         // NOTE: Next byte to encode.
+  U32 block_start; // NOTE: First byte of the current block.
+  U32 block_size;  // NOTE: Num of bytes covered by the buffered symbols.
+  S32* head;       // NOTE: Per hash, the most recent position, or -1.
+  S32* prev;       // NOTE: Per position (mod DEFLATE_WINDOW_SIZE), the previous position with the same hash, or -1.
+  U32 prev_length; // NOTE: Lazy matching state, the match found at pos - 1.
+  U32 prev_dist;
+  B32 is_literal_pending; // NOTE: Lazy matching state, pos - 1 has not been encoded yet.
+
+  // NOTE: Symbols of the current block. dist is 0 for literals.
+  U16* sym_lengths;
+  U16* sym_dists;
+  U32 syms_size;
+  U32 lit_freqs[DEFLATE_LIT_SYMBOLS];
+  U32 dist_freqs[DEFLATE_DIST_SYMBOLS];
+  U8  fixed_lit_lengths[DEFLATE_LIT_SYMBOLS];
+  U8  fixed_dist_lengths[DEFLATE_DIST_SYMBOLS];
+  U16 fixed_lit_codes[DEFLATE_LIT_SYMBOLS];
+  U16 fixed_dist_codes[DEFLATE_DIST_SYMBOLS];
+
+  // NOTE: Encoded output not yet handed to the caller.
+  U8* pending;
+  U32 pending_size;
+  U32 pending_pos;
+  U64 bitbuf;
+  U32 bitcount;
+};
+
+static inline void _DeflatePutBits(Deflate* d, U32 bits, U32 num_bits) {
+  DEBUG_ASSERT(num_bits <= 32);
+  d->bitbuf   |= (U64) bits << d->bitcount;
+  d->bitcount += num_bits;
+  if (d->bitcount >= 32) {
+    U32 word = (U32) d->bitbuf;
+    MEMORY_COPY_SIZE(d->pending + d->pending_size, &word, sizeof(word)); // NOTE: assumes a little endian host.
+    d->pending_size += sizeof(word);
+    d->bitbuf      >>= 32;
+    d->bitcount     -= 32;
+  }
+}
+
+// NOTE: Pads to a byte boundary with 0s.
+static void _DeflateFlushBits(Deflate* d) {
+  while (d->bitcount > 0) {
+    d->pending[d->pending_size++] = (U8) d->bitbuf;
+    d->bitbuf   >>= 8;
+    d->bitcount   = (d->bitcount > 8) ? d->bitcount - 8 : 0;
+  }
+  d->bitbuf = 0;
+}
+
+static void _DeflatePutByte(Deflate* d, U8 byte) {
+  DEBUG_ASSERT(d->bitcount == 0);
+  d->pending[d->pending_size++] = byte;
+}
+
+static inline U32 _DeflateLengthSymbol(U32 length) {
+  if (length == DEFLATE_MAX_MATCH) { return 285; }
+  U32 x = length - DEFLATE_MIN_MATCH;
+  if (x < 8) { return 257 + x; }
+  U32 msb = _DeflateMsb32(x);
+  return 257 + 4 * (msb - 1) + ((x >> (msb - 2)) & 3);
+}
+
+static inline U32 _DeflateDistSymbol(U32 dist) {
+  U32 x = dist - 1;
+  if (x < 4) { return x; }
+  U32 msb = _DeflateMsb32(x);
+  return 2 * msb + ((x >> (msb - 1)) & 1);
+}
+
+// NOTE: Builds huffman code lengths of at most max_bits for the symbols with non-zero freqs.
+static void _DeflateBuildLengths(U32* freqs, U32 symbols_size, U32 max_bits, U8* lengths) {
+  U16 sorted[DEFLATE_LIT_SYMBOLS];
+  U32 weights[2 * DEFLATE_LIT_SYMBOLS];
+  U16 parents[2 * DEFLATE_LIT_SYMBOLS];
+  U16 depths[2 * DEFLATE_LIT_SYMBOLS];
+  MEMORY_ZERO_SIZE(lengths, symbols_size);
+  U32 leaves_size = 0;
+  for (U32 i = 0; i < symbols_size; i++) {
+    if (freqs[i] > 0) { sorted[leaves_size++] = (U16) i; }
+  }
+  if (leaves_size == 0) { return; }
+  if (leaves_size == 1) {
+    lengths[sorted[0]] = 1;
+    return;
+  }
+  // NOTE: insertion sort by frequency, there are at most a few hundred symbols.
+  for (U32 i = 1; i < leaves_size; i++) {
+    U16 symbol = sorted[i];
+    U32 j = i;
+    for (; j > 0 && freqs[sorted[j - 1]] > freqs[symbol]; j--) { sorted[j] = sorted[j - 1]; }
+    sorted[j] = symbol;
+  }
+
+  // NOTE: two queue huffman construction. Leaves are sorted, and internal nodes are created in sorted order, so the
+  // two lightest nodes are always at the front of one of the two queues.
+  for (U32 i = 0; i < leaves_size; i++) { weights[i] = freqs[sorted[i]]; }
+  U32 leaf = 0, node = leaves_size, nodes_size = leaves_size;
+  while (nodes_size < 2 * leaves_size - 1) {
+    U32 children[2];
+    for (U32 c = 0; c < 2; c++) {
+      if (leaf < leaves_size && (node >= nodes_size || weights[leaf] <= weights[node])) { children[c] = leaf++; }
+      else                                                                              { children[c] = node++; }
+    }
+    weights[nodes_size]  = weights[children[0]] + weights[children[1]];
+    parents[children[0]] = (U16) nodes_size;
+    parents[children[1]] = (U16) nodes_size;
+    nodes_size++;
+  }
+  U32 counts[64];
+  MEMORY_ZERO_STATIC_ARRAY(counts);
+  depths[nodes_size - 1] = 0;
+  for (S32 i = (S32) nodes_size - 2; i >= 0; i--) { depths[i] = depths[parents[i]] + 1; }
+  for (U32 i = 0; i < leaves_size; i++) { counts[MIN(depths[i], STATIC_ARRAY_SIZE(counts) - 1)]++; }
+
+  // NOTE: limit the code lengths by folding overlong codes into max_bits, then deepening shorter codes until the
+  // code is complete again (as in miniz).
+  for (U32 i = max_bits + 1; i < STATIC_ARRAY_SIZE(counts); i++) {
+    counts[max_bits] += counts[i];
+    counts[i] = 0;
+  }
+  U32 total = 0;
+  for (U32 i = max_bits; i > 0; i--) { total += counts[i] << (max_bits - i); }
+  while (total != (1U << max_bits)) {
+    counts[max_bits]--;
+    for (U32 i = max_bits - 1; i > 0; i--) {
+      if (counts[i] > 0) {
+        counts[i]--;
+        counts[i + 1] += 2;
+        break;
+      }
+    }
+    total--;
+  }
+
+  // NOTE: the least frequent symbols get the longest codes.
+  U32 idx = 0;
+  for (U32 len = max_bits; len > 0; len--) {
+    for (U32 i = 0; i < counts[len]; i++) { lengths[sorted[idx++]] = (U8) len; }
+  }
+}
+
+// NOTE: Canonical codes for the given lengths, bit reversed since they are written least significant bit first.
+static void _DeflateBuildCodes(U8* lengths, U32 symbols_size, U16* codes) {
+  U32 counts[DEFLATE_MAX_BITS + 1];
+  U32 next_code[DEFLATE_MAX_BITS + 1];
+  MEMORY_ZERO_STATIC_ARRAY(counts);
+  for (U32 i = 0; i < symbols_size; i++) { counts[lengths[i]]++; }
+  counts[0] = 0;
+  U32 code = 0;
+  for (U32 len = 1; len <= DEFLATE_MAX_BITS; len++) {
+    code = (code + counts[len - 1]) << 1;
+    next_code[len] = code;
+  }
+  for (U32 i = 0; i < symbols_size; i++) {
+    if (lengths[i] == 0) { continue; }
+    codes[i] = (U16) (_DeflateReverse16(next_code[lengths[i]]++) >> (16 - lengths[i]));
+  }
+}
+
+// NOTE: Some decoders reject codes with a single symbol, so make sure at least 2 are used.
+static void _DeflateEnsureTwoSymbols(U32* freqs, U32 symbols_size) {
+  U32 used = 0;
+  for (U32 i = 0; i < symbols_size; i++) { used += (freqs[i] > 0); }
+  for (U32 i = 0; i < symbols_size && used < 2; i++) {
+    if (freqs[i] == 0) {
+      freqs[i] = 1;
+      used++;
+    }
+  }
+}
+
+static void _DeflateWriteSymbols(Deflate* d, U8* lit_lengths, U16* lit_codes, U8* dist_lengths, U16* dist_codes) {
+  for (U32 i = 0; i < d->syms_size; i++) {
+    U32 length = d->sym_lengths[i];
+    U32 dist   = d->sym_dists[i];
+    if (dist == 0) {
+      _DeflatePutBits(d, lit_codes[length], lit_lengths[length]);
+      continue;
+    }
+    U32 symbol = _DeflateLengthSymbol(length);
+    _DeflatePutBits(d, lit_codes[symbol], lit_lengths[symbol]);
+    symbol -= 257;
+    _DeflatePutBits(d, length - _cdef_deflate_length_base[symbol], _cdef_deflate_length_extra[symbol]);
+    symbol = _DeflateDistSymbol(dist);
+    _DeflatePutBits(d, dist_codes[symbol], dist_lengths[symbol]);
+    _DeflatePutBits(d, dist - _cdef_deflate_dist_base[symbol], _cdef_deflate_dist_extra[symbol]);
+  }
+  _DeflatePutBits(d, lit_codes[256], lit_lengths[256]);
+}
+
+// NOTE: Encodes the buffered symbols into pending as whichever of a stored, fixed or dynamic block is smallest.
+static void _DeflateEmitBlock(Deflate* d, B32 is_final) {
+  DEBUG_ASSERT(d->pending_size == 0);
+  d->lit_freqs[256] = 1;
+  _DeflateEnsureTwoSymbols(d->lit_freqs, 286);
+  _DeflateEnsureTwoSymbols(d->dist_freqs, 30);
+  U8  lit_lengths[DEFLATE_LIT_SYMBOLS], dist_lengths[DEFLATE_DIST_SYMBOLS];
+  U16 lit_codes[DEFLATE_LIT_SYMBOLS], dist_codes[DEFLATE_DIST_SYMBOLS];
+  MEMORY_ZERO_STATIC_ARRAY(lit_lengths);
+  MEMORY_ZERO_STATIC_ARRAY(dist_lengths);
+  _DeflateBuildLengths(d->lit_freqs, 286, DEFLATE_MAX_BITS, lit_lengths);
+  _DeflateBuildLengths(d->dist_freqs, 30, DEFLATE_MAX_BITS, dist_lengths);
+  _DeflateBuildCodes(lit_lengths, 286, lit_codes);
+  _DeflateBuildCodes(dist_lengths, 30, dist_codes);
+  U32 lit_size = 286, dist_size = 30;
+  while (lit_size > 257 && lit_lengths[lit_size - 1] == 0) { lit_size--; }
+  while (dist_size > 1 && dist_lengths[dist_size - 1] == 0) { dist_size--; }
+
+  // NOTE: run length encode the code lengths, with symbol 16 repeating the previous length 3 - 6 times, and 17 / 18
+  // repeating zero 3 - 10 / 11 - 138 times.
+  U8  all_lengths[286 + 30];
+  U8  rle_symbols[286 + 30];
+  U8  rle_extras[286 + 30];
+  U32 rle_size = 0;
+  U32 code_length_freqs[19];
+  MEMORY_ZERO_STATIC_ARRAY(code_length_freqs);
+  U32 all_lengths_size = lit_size + dist_size;
+  MEMORY_COPY_SIZE(all_lengths, lit_lengths, lit_size);
+  MEMORY_COPY_SIZE(all_lengths + lit_size, dist_lengths, dist_size);
+  for (U32 i = 0; i < all_lengths_size;) {
+    U8  length = all_lengths[i];
+    U32 run    = 1;
+    while (i + run < all_lengths_size && all_lengths[i + run] == length && run < 138) { run++; }
+    U8 symbol, extra = 0;
+    if (length == 0 && run >= 11) {
+      symbol = 18;
+      extra  = (U8) (run - 11);
+    } else if (length == 0 && run >= 3) {
+      symbol = 17;
+      extra  = (U8) (run - 3);
+    } else if (i > 0 && all_lengths[i - 1] == length && run >= 3) {
+      run    = MIN(run, 6);
+      symbol = 16;
+      extra  = (U8) (run - 3);
+    } else {
+      run    = 1;
+      symbol = length;
+    }
+    rle_symbols[rle_size] = symbol;
+    rle_extras[rle_size]  = extra;
+    rle_size++;
+    code_length_freqs[symbol]++;
+    i += run;
+  }
+  U8  code_length_lengths[19];
+  U16 code_length_codes[19];
+  _DeflateEnsureTwoSymbols(code_length_freqs, 19);
+  _DeflateBuildLengths(code_length_freqs, 19, 7, code_length_lengths);
+  _DeflateBuildCodes(code_length_lengths, 19, code_length_codes);
+  U32 code_lengths_size = 19;
+  while (code_lengths_size > 4 && code_length_lengths[_cdef_deflate_code_length_order[code_lengths_size - 1]] == 0) { code_lengths_size--; }
+
+  // NOTE: size each block type.
+  U64 extra_bits = 0, dynamic_bits = 0, fixed_bits = 0;
+  for (U32 i = 0; i < 286; i++) {
+    dynamic_bits += (U64) d->lit_freqs[i] * lit_lengths[i];
+    fixed_bits   += (U64) d->lit_freqs[i] * d->fixed_lit_lengths[i];
+    if (i >= 257) { extra_bits += (U64) d->lit_freqs[i] * _cdef_deflate_length_extra[i - 257]; }
+  }
+  for (U32 i = 0; i < 30; i++) {
+    dynamic_bits += (U64) d->dist_freqs[i] * dist_lengths[i];
+    fixed_bits   += (U64) d->dist_freqs[i] * d->fixed_dist_lengths[i];
+    extra_bits   += (U64) d->dist_freqs[i] * _cdef_deflate_dist_extra[i];
+  }
+  dynamic_bits += 3 + 14 + 3 * code_lengths_size + extra_bits;
+  for (U32 i = 0; i < 19; i++) { dynamic_bits += (U64) code_length_freqs[i] * code_length_lengths[i]; }
+  dynamic_bits += 2 * code_length_freqs[16] + 3 * code_length_freqs[17] + 7 * code_length_freqs[18];
+  fixed_bits   += 3 + extra_bits;
+  U32 stored_blocks = MAX((d->block_size + 65534) / 65535, 1);
+  U64 stored_bits   = (U64) stored_blocks * (3 + 7 + 32) + (U64) d->block_size * 8;
+
+  if (stored_bits <= MIN(fixed_bits, dynamic_bits)) {
+    U8* data = d->window + d->block_start;
+    U32 remaining = d->block_size;
+    do {
+      U32 size = MIN(remaining, 65535);
+      remaining -= size;
+      _DeflatePutBits(d, (is_final && remaining == 0) ? 1 : 0, 1);
+      _DeflatePutBits(d, 0, 2);
+      _DeflateFlushBits(d);
+      _DeflatePutByte(d, (U8) size);
+      _DeflatePutByte(d, (U8) (size >> 8));
+      _DeflatePutByte(d, (U8) ~size);
+      _DeflatePutByte(d, (U8) (~size >> 8));
+      MEMORY_COPY_SIZE(d->pending + d->pending_size, data, size);
+      d->pending_size += size;
+      data += size;
+    } while (remaining > 0);
+  } else if (fixed_bits <= dynamic_bits) {
+    _DeflatePutBits(d, is_final ? 1 : 0, 1);
+    _DeflatePutBits(d, 1, 2);
+    _DeflateWriteSymbols(d, d->fixed_lit_lengths, d->fixed_lit_codes, d->fixed_dist_lengths, d->fixed_dist_codes);
+  } else {
+    _DeflatePutBits(d, is_final ? 1 : 0, 1);
+    _DeflatePutBits(d, 2, 2);
+    _DeflatePutBits(d, lit_size - 257, 5);
+    _DeflatePutBits(d, dist_size - 1, 5);
+    _DeflatePutBits(d, code_lengths_size - 4, 4);
+    for (U32 i = 0; i < code_lengths_size; i++) { _DeflatePutBits(d, code_length_lengths[_cdef_deflate_code_length_order[i]], 3); }
+    for (U32 i = 0; i < rle_size; i++) {
+      U8 symbol = rle_symbols[i];
+      _DeflatePutBits(d, code_length_codes[symbol], code_length_lengths[symbol]);
+      if      (symbol == 16) { _DeflatePutBits(d, rle_extras[i], 2); }
+      else if (symbol == 17) { _DeflatePutBits(d, rle_extras[i], 3); }
+      else if (symbol == 18) { _DeflatePutBits(d, rle_extras[i], 7); }
+    }
+    _DeflateWriteSymbols(d, lit_lengths, lit_codes, dist_lengths, dist_codes);
+  }
+  DEBUG_ASSERT(d->pending_size <= DEFLATE_PENDING_CAP - 64);
+
+  d->block_start += d->block_size;
+  d->block_size   = 0;
+  d->syms_size    = 0;
+  MEMORY_ZERO_STATIC_ARRAY(d->lit_freqs);
+  MEMORY_ZERO_STATIC_ARRAY(d->dist_freqs);
+}
+
+static inline void _DeflateTallyLiteral(Deflate* d, U8 literal) {
+  d->sym_lengths[d->syms_size] = literal;
+  d->sym_dists[d->syms_size]   = 0;
+  d->syms_size++;
+  d->lit_freqs[literal]++;
+  d->block_size++;
+}
+
+static inline void _DeflateTallyMatch(Deflate* d, U32 length, U32 dist) {
+  d->sym_lengths[d->syms_size] = (U16) length;
+  d->sym_dists[d->syms_size]   = (U16) dist;
+  d->syms_size++;
+  d->lit_freqs[_DeflateLengthSymbol(length)]++;
+  d->dist_freqs[_DeflateDistSymbol(dist)]++;
+  d->block_size += length;
+}
+
+// NOTE: Returns the previous position with the same hash (or -1), and makes pos the most recent. Needs
+// DEFLATE_MIN_MATCH bytes at pos.
+static inline S32 _DeflateInsert(Deflate* d, U32 pos) {
+  U8* p = d->window + pos;
+  U32 hash   = ((((U32) p[0]) | ((U32) p[1] << 8) | ((U32) p[2] << 16)) * 0x9E3779B1) >> (32 - DEFLATE_HASH_BITS);
+  S32 result = d->head[hash];
+  d->prev[pos & (DEFLATE_WINDOW_SIZE - 1)] = result;
+  d->head[hash] = (S32) pos;
+  return result;
+}
+
+static inline U32 _DeflateMatchLength(U8* a, U8* b, U32 max_length) {
+  U32 length = 0;
+  while (length + 8 <= max_length) {
+    U64 x, y;
+    MEMORY_COPY_SIZE(&x, a + length, sizeof(x));
+    MEMORY_COPY_SIZE(&y, b + length, sizeof(y));
+    if (x != y) { return length + (_DeflateLsb64(x ^ y) >> 3); } // NOTE: assumes a little endian host.
+    length += 8;
+  }
+  while (length < max_length && a[length] == b[length]) { length++; }
+  return length;
+}
+
+// NOTE: Walks the hash chain from candidate, returning the longest match longer than best_length, or best_length.
+static U32 _DeflateFindMatch(Deflate* d, U32 pos, S32 candidate, U32 best_length, U32 max_chain, U32* best_dist) {
+  U32 max_length = MIN(DEFLATE_MAX_MATCH, d->window_size - pos);
+  if (best_length >= max_length) { return best_length; }
+  S32 limit = (S32) pos - DEFLATE_MAX_DIST - 1;
+  U8* scan  = d->window + pos;
+  for (U32 chain = max_chain; candidate > limit && candidate >= 0 && chain > 0; chain--, candidate = d->prev[candidate & (DEFLATE_WINDOW_SIZE - 1)]) {
+    U8* match = d->window + candidate;
+    if (match[best_length] != scan[best_length] || match[0] != scan[0] || match[1] != scan[1]) { continue; }
+    U32 length = _DeflateMatchLength(scan, match, max_length);
+    if (length > best_length) {
+      best_length = length;
+      *best_dist  = pos - (U32) candidate;
+      if (length >= d->nice_length) { break; }
+    }
+  }
+  return best_length;
+}
+
+// NOTE: Inserts the positions in [start, end) that have enough bytes after them to hash.
+static inline void _DeflateInsertRange(Deflate* d, U32 start, U32 end) {
+  end = MIN(end, d->window_size - (DEFLATE_MIN_MATCH - 1));
+  for (U32 pos = start; pos < end; pos++) { _DeflateInsert(d, pos); }
+}
+
+// NOTE: Encodes bytes up to end, stopping early if the symbol buffer fills.
+static void _DeflateCompress(Deflate* d, U32 end) {
+  if (!d->is_lazy) {
+    while (d->pos < end && d->syms_size < DEFLATE_SYMBOLS_CAP) {
+      U32 length = 0, dist = 0;
+      if (d->window_size - d->pos >= DEFLATE_MIN_MATCH) {
+        S32 candidate = _DeflateInsert(d, d->pos);
+        length = _DeflateFindMatch(d, d->pos, candidate, DEFLATE_MIN_MATCH - 1, d->max_chain, &dist);
+      }
+      if (length >= DEFLATE_MIN_MATCH) {
+        _DeflateTallyMatch(d, length, dist);
+        _DeflateInsertRange(d, d->pos + 1, d->pos + length);
+        d->pos += length;
+      } else {
+        _DeflateTallyLiteral(d, d->window[d->pos]);
+        d->pos++;
+      }
+    }
+    return;
+  }
+
+  // NOTE: lazy matching, a match is only taken if the match starting at the next byte isn't longer.
+  while (d->pos < end && d->syms_size < DEFLATE_SYMBOLS_CAP - 1) {
+    U32 length = 0, dist = 0;
+    if (d->window_size - d->pos >= DEFLATE_MIN_MATCH) {
+      S32 candidate = _DeflateInsert(d, d->pos);
+      if (d->prev_length < d->lazy_length) {
+        // NOTE: only look briefly for something better than an already good match.
+        U32 max_chain = (d->prev_length >= d->good_length) ? MAX(d->max_chain / 4, 1) : d->max_chain;
+        length = _DeflateFindMatch(d, d->pos, candidate, MAX(d->prev_length, DEFLATE_MIN_MATCH - 1), max_chain, &dist);
+        if (length <= d->prev_length || length < DEFLATE_MIN_MATCH) { length = 0; }
+        // NOTE: a short, distant match costs about as much as the literals it replaces.
+        if (length == DEFLATE_MIN_MATCH && dist > KB(4)) { length = 0; }
+      }
+    }
+    if (d->prev_length >= DEFLATE_MIN_MATCH && length == 0) {
+      U32 match_end = d->pos - 1 + d->prev_length;
+      _DeflateTallyMatch(d, d->prev_length, d->prev_dist);
+      _DeflateInsertRange(d, d->pos + 1, match_end);
+      d->pos                = match_end;
+      d->prev_length        = 0;
+      d->is_literal_pending = false;
+    } else {
+      if (d->is_literal_pending) { _DeflateTallyLiteral(d, d->window[d->pos - 1]); }
+      d->is_literal_pending = true;
+      d->prev_length        = length;
+      d->prev_dist          = dist;
+      d->pos++;
+    }
+  }
+}
+
+static void _DeflateSlide(Deflate* d) {
+  DEBUG_ASSERT(d->window_size == 2 * DEFLATE_WINDOW_SIZE && d->pos > DEFLATE_WINDOW_SIZE && d->block_start >= DEFLATE_WINDOW_SIZE);
+  MEMORY_COPY_SIZE(d->window, d->window + DEFLATE_WINDOW_SIZE, DEFLATE_WINDOW_SIZE);
+  d->window_size -= DEFLATE_WINDOW_SIZE;
+  d->pos         -= DEFLATE_WINDOW_SIZE;
+  d->block_start -= DEFLATE_WINDOW_SIZE;
+  for (U32 i = 0; i < (1 << DEFLATE_HASH_BITS); i++) {
+    d->head[i] = (d->head[i] >= (S32) DEFLATE_WINDOW_SIZE) ? d->head[i] - (S32) DEFLATE_WINDOW_SIZE : -1;
+  }
+  for (U32 i = 0; i < DEFLATE_WINDOW_SIZE; i++) {
+    d->prev[i] = (d->prev[i] >= (S32) DEFLATE_WINDOW_SIZE) ? d->prev[i] - (S32) DEFLATE_WINDOW_SIZE : -1;
+  }
+}
+
+B32 DeflateCreate(Deflate** deflate, CompressFormat format, DeflateLevel level) {
+  if (format != CompressFormat_Raw && format != CompressFormat_Zlib && format != CompressFormat_Gzip) {
+    LOG_ERROR("[IO] Invalid compression format: %d", format);
+    return false;
+  }
+  Arena* arena = _ArenaAllocate(MB(1), KB(64));
+  Deflate* d = ARENA_PUSH_STRUCT(arena, Deflate);
+  MEMORY_ZERO_STRUCT(d);
+  d->arena       = arena;
+  d->format      = format;
+  d->checksum    = (format == CompressFormat_Zlib) ? ADLER32_INIT : CRC32_INIT;
+  d->window      = ARENA_PUSH_ARRAY(arena, U8, 2 * DEFLATE_WINDOW_SIZE);
+  d->head        = ARENA_PUSH_ARRAY(arena, S32, 1 << DEFLATE_HASH_BITS);
+  d->prev        = ARENA_PUSH_ARRAY(arena, S32, DEFLATE_WINDOW_SIZE);
+  d->sym_lengths = ARENA_PUSH_ARRAY(arena, U16, DEFLATE_SYMBOLS_CAP);
+  d->sym_dists   = ARENA_PUSH_ARRAY(arena, U16, DEFLATE_SYMBOLS_CAP);
+  d->pending     = ARENA_PUSH_ARRAY(arena, U8, DEFLATE_PENDING_CAP);
+  MEMORY_SET_SIZE(d->head, 0xFF, sizeof(S32) << DEFLATE_HASH_BITS);
+  MEMORY_SET_SIZE(d->prev, 0xFF, sizeof(S32) * DEFLATE_WINDOW_SIZE);
+  _DeflateFixedLengths(d->fixed_lit_lengths, d->fixed_dist_lengths);
+  _DeflateBuildCodes(d->fixed_lit_lengths, DEFLATE_LIT_SYMBOLS, d->fixed_lit_codes);
+  _DeflateBuildCodes(d->fixed_dist_lengths, DEFLATE_DIST_SYMBOLS, d->fixed_dist_codes);
+
+  U8 zlib_level = 2, gzip_level = 0;
+  switch (level) {
+    // NOTE: tuned like zlib's levels 1, 6 and 9.
+    case DeflateLevel_Fast:    { d->max_chain = 8;    d->good_length = 0;  d->lazy_length = 0;                 d->nice_length = 32;                d->is_lazy = false; zlib_level = 1; gzip_level = 4; } break;
+    case DeflateLevel_Default: { d->max_chain = 128;  d->good_length = 8;  d->lazy_length = 16;                d->nice_length = 128;               d->is_lazy = true;  zlib_level = 2; gzip_level = 0; } break;
+    case DeflateLevel_Best:    { d->max_chain = 4096; d->good_length = 32; d->lazy_length = DEFLATE_MAX_MATCH; d->nice_length = DEFLATE_MAX_MATCH; d->is_lazy = true;  zlib_level = 3; gzip_level = 2; } break;
+    default: {
+      LOG_ERROR("[IO] Invalid deflate level: %d", level);
+      ArenaRelease(arena);
+      return false;
+    }
+  }
+
+  if (format == CompressFormat_Zlib) {
+    // NOTE: 32KB window, FCHECK makes the header a multiple of 31.
+    U32 cmf = 0x78;
+    U32 flg = zlib_level << 6;
+    flg += 31 - (((cmf << 8) | flg) % 31);
+    _DeflatePutByte(d, (U8) cmf);
+    _DeflatePutByte(d, (U8) flg);
+  } else if (format == CompressFormat_Gzip) {
+    U8 header[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, gzip_level, 255 }; // NOTE: no name or time, unknown OS.
+    for (U32 i = 0; i < STATIC_ARRAY_SIZE(header); i++) { _DeflatePutByte(d, header[i]); }
+  }
+  *deflate = d;
+  return true;
+}
+
+void DeflateDestroy(Deflate* deflate) {
+  ArenaRelease(deflate->arena);
+}
+
+static void _DeflateWriteTrailer(Deflate* d) {
+  _DeflateFlushBits(d);
+  if (d->format == CompressFormat_Zlib) {
+    for (S32 i = 3; i >= 0; i--) { _DeflatePutByte(d, (U8) (d->checksum >> (i * 8))); }
+  } else if (d->format == CompressFormat_Gzip) {
+    for (U32 i = 0; i < 4; i++) { _DeflatePutByte(d, (U8) (d->checksum >> (i * 8))); }
+    for (U32 i = 0; i < 4; i++) { _DeflatePutByte(d, (U8) (d->total_in >> (i * 8))); }
+  }
+}
+
+CompressStatus DeflateRun(Deflate* d, U8* in, U64 in_size, U64* in_read, U8* out, U64 out_size, U64* out_written, B32 finish) {
+  U8* in_pos  = in;
+  U8* in_end  = in + in_size;
+  U8* out_pos = out;
+  U8* out_end = out + out_size;
+  CompressStatus status;
+  while (true) {
+    // NOTE: hand over anything already encoded first.
+    U64 size = MIN((U64) (d->pending_size - d->pending_pos), (U64) (out_end - out_pos));
+    MEMORY_COPY_SIZE(out_pos, d->pending + d->pending_pos, size);
+    out_pos        += size;
+    d->pending_pos += (U32) size;
+    if (d->pending_pos < d->pending_size) {
+      status = CompressStatus_NeedsOutput;
+      break;
+    }
+    d->pending_pos  = 0;
+    d->pending_size = 0;
+    if (d->is_done) {
+      status = CompressStatus_Done;
+      break;
+    }
+
+    if (d->window_size == 2 * DEFLATE_WINDOW_SIZE && d->pos > DEFLATE_WINDOW_SIZE) {
+      // NOTE: a stored block needs its data in the window, so finish the block before sliding it out.
+      if (d->block_start < DEFLATE_WINDOW_SIZE) {
+        _DeflateEmitBlock(d, false);
+        continue;
+      }
+      _DeflateSlide(d);
+    }
+    size = MIN((U64) (in_end - in_pos), (U64) (2 * DEFLATE_WINDOW_SIZE - d->window_size));
+    MEMORY_COPY_SIZE(d->window + d->window_size, in_pos, size);
+    d->checksum     = _DeflateChecksum(d->format, d->checksum, in_pos, size);
+    d->total_in    += size;
+    d->window_size += (U32) size;
+    in_pos         += size;
 
-B32 FileHandleOpenStdOut(FileHandle** file) {
-  return CDEFAULT_IO_BACKEND_FN(FileHandleOpenStdOut(file));
+    B32 is_last = finish && in_pos == in_end;
+    U32 end     = is_last ? d->window_size : (d->window_size > DEFLATE_MIN_LOOKAHEAD ? d->window_size - DEFLATE_MIN_LOOKAHEAD : 0);
+    _DeflateCompress(d, end);
+    if (d->pos < end) {
+      _DeflateEmitBlock(d, false); // NOTE: the symbol buffer is full.
+      continue;
+    }
+    if (is_last) {
+      if (d->is_literal_pending) {
+        _DeflateTallyLiteral(d, d->window[d->pos - 1]);
+        d->is_literal_pending = false;
+      }
+      _DeflateEmitBlock(d, true);
+      _DeflateWriteTrailer(d);
+      d->is_done = true;
+      continue;
+    }
+    if (in_pos == in_end) {
+      status = CompressStatus_NeedsInput;
+      break;
+    }
+  }
+  *in_read     = in_pos - in;
+  *out_written = out_pos - out;
+  return status;
 }
 
-B32 FileHandleOpen(FileHandle** file, String8 file_path, FileMode mode) {
-  return CDEFAULT_IO_BACKEND_FN(FileHandleOpen(file, file_path, mode));
+B32 DeflateAll(Arena* arena, CompressFormat format, DeflateLevel level, U8* in, U64 in_size, U8** out, U64* out_size) {
+  Deflate* deflate;
+  if (!DeflateCreate(&deflate, format, level)) { return false; }
+
+  // NOTE: output chunks are pushed back to back, so they form one contiguous buffer.
+  U64 cap  = MAX(in_size / 2, KB(64));
+  U8* data = (U8*) _ArenaPush(arena, cap, 8);
+  U64 size = 0, in_pos = 0;
+  while (true) {
+    U64 in_read, out_written;
+    CompressStatus status = DeflateRun(deflate, in + in_pos, in_size - in_pos, &in_read, data + size, cap - size, &out_written, true);
+    in_pos += in_read;
+    size   += out_written;
+    if (status == CompressStatus_Done) { break; }
+    DEBUG_ASSERT(status == CompressStatus_NeedsOutput);
+    U8* next = (U8*) _ArenaPush(arena, cap, 1);
+    DEBUG_ASSERT(next == data + cap);
+    cap *= 2;
+  }
+  ArenaPop(arena, cap - size);
+  *out      = data;
+  *out_size = size;
+  DeflateDestroy(deflate);
+  return true;
 }
 
-B32 FileHandleClose(FileHandle* file) {
-  return CDEFAULT_IO_BACKEND_FN(FileHandleClose(file));
+// NOTE: 64 bit FNV-1a, for names. Names are hashed at bake time, so this is part of the pack format.
+static U64 _PackHash(U8* data, U64 data_size) {
+  U64 hash = 0xCBF29CE484222325;
+  for (U64 i = 0; i < data_size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001B3;
+  }
+  return hash;
 }
 
-B32 FileHandleSeek(FileHandle* file, S32 distance, FileSeekPos pos) {
-  return CDEFAULT_IO_BACKEND_FN(FileHandleSeek(file, distance, pos));
+static B32 _PackWriterPad(PackWriter* writer) {
+  static U8 zeros[PACK_DATA_ALIGNMENT];
+  U64 pos = writer->file.file_pos + writer->file.buffer_size;
+  U64 pad = ALIGN_POW_2(pos, PACK_DATA_ALIGNMENT) - pos;
+  return FileWriterWrite(&writer->file, zeros, pad);
 }
 
-B32 FileHandleRead(FileHandle* file, U8* buffer, U32 buffer_size, U32* bytes_read) {
-  return CDEFAULT_IO_BACKEND_FN(FileHandleRead(file, buffer, buffer_size, bytes_read));
+B32 PackWriterOpen(PackWriter* writer, String8 file_path) {
+  MEMORY_ZERO_STRUCT(writer);
+  if (!FileWriterOpen(&writer->file, file_path, FileMode_Create | FileMode_Truncate, 0)) { return false; }
+  writer->arena = ArenaAllocate();
+  // NOTE: the header is filled in on close, leaving the magic zeroed until then marks the pack as incomplete.
+  PackHeader header;
+  MEMORY_ZERO_STRUCT(&header);
+  if (!FileWriterWrite(&writer->file, (U8*) &header, sizeof(header))) {
+    DEBUG_ASSERT(FileWriterClose(&writer->file));
+    ArenaRelease(writer->arena);
+    return false;
+  }
+  return true;
+}
+
+B32 PackWriterAdd(PackWriter* writer, String8 name, U8* data, U64 data_size, PackCompression compression) {
+  if (writer->is_failed) { return false; }
+  if (compression != PackCompression_None && compression != PackCompression_Deflate) {
+    LOG_ERROR("[IO] Unsupported pack compression %d for entry: %S", compression, name);
+    return false;
+  }
+
+  B32 success       = false;
+  Arena* temp_arena = NULL;
+  U8* stored        = data;
+  U64 stored_size   = data_size;
+  if (compression == PackCompression_Deflate) {
+    // NOTE: packs are baked offline, so spend the time on the best ratio.
+    temp_arena = _ArenaAllocate(ALIGN_POW_2(data_size * 2, MB(1)) + MB(1), MB(1));
+    U8* compressed;
+    U64 compressed_size;
+    if (!DeflateAll(temp_arena, CompressFormat_Raw, DeflateLevel_Best, data, data_size, &compressed, &compressed_size)) {
+      writer->is_failed = true;
+      goto pack_writer_add_exit;
+    }
+    if (compressed_size < data_size) {
+      stored      = compressed;
+      stored_size = compressed_size;
+    } else {
+      compression = PackCompression_None;
+    }
+  }
+  if (!PackWriterBegin(writer, name)) { goto pack_writer_add_exit; }
+  writer->entry->entry.compression = compression;
+  writer->entry->entry.raw_size    = data_size;
+  success = PackWriterAppend(writer, stored, stored_size) && PackWriterEnd(writer);
+
+pack_writer_add_exit:
+  if (temp_arena != NULL) { ArenaRelease(temp_arena); }
+  return success;
+}
+
+B32 PackWriterBegin(PackWriter* writer, String8 name) {
+  if (writer->is_failed) { return false; }
+  if (writer->entry != NULL) {
+    LOG_ERROR("[IO] Pack entry %S was begun before %S was ended.", name, writer->entry->name);
+    writer->is_failed = true;
+    return false;
+  }
+  if (!_PackWriterPad(writer)) {
+    writer->is_failed = true;
+    return false;
+  }
+  PackWriterEntry* node = ARENA_PUSH_STRUCT(writer->arena, PackWriterEntry);
+  MEMORY_ZERO_STRUCT(node);
+  node->name              = Str8Copy(writer->arena, name);
+  node->entry.name_hash   = _PackHash(name.str, name.size);
+  node->entry.offset      = writer->file.file_pos + writer->file.buffer_size;
+  node->entry.checksum    = CRC32C_INIT;
+  node->entry.name_offset = (U32) writer->names_size;
+  node->entry.name_size   = name.size;
+  node->entry.compression = PackCompression_None;
+  writer->entry = node;
+  return true;
+}
+
+B32 PackWriterAppend(PackWriter* writer, U8* data, U64 data_size) {
+  if (writer->is_failed) { return false; }
+  if (writer->entry == NULL) {
+    LOG_ERROR("[IO] PackWriterAppend called without an entry begun.");
+    writer->is_failed = true;
+    return false;
+  }
+  PackEntry* entry = &writer->entry->entry;
+  entry->checksum  = Crc32cUpdate((U32) entry->checksum, data, data_size);
+  entry->size     += data_size;
+  if (!FileWriterWrite(&writer->file, data, data_size)) {
+    writer->is_failed = true;
+    return false;
+  }
+  return true;
+}
+
+B32 PackWriterEnd(PackWriter* writer) {
+  if (writer->is_failed) { return false; }
+  if (writer->entry == NULL) {
+    LOG_ERROR("[IO] PackWriterEnd called without an entry begun.");
+    writer->is_failed = true;
+    return false;
+  }
+  PackWriterEntry* node = writer->entry;
+  // NOTE: PackWriterAdd fills in raw_size itself for compressed entries.
+  if (node->entry.compression == PackCompression_None) { node->entry.raw_size = node->entry.size; }
+  SLL_QUEUE_PUSH_BACK(writer->entries_head, writer->entries_tail, node, next);
+  writer->entries_size++;
+  writer->names_size += node->name.size;
+  writer->entry = NULL;
+  return true;
+}
+
+B32 PackWriterClose(PackWriter* writer) {
+  B32 success = false;
+  if (writer->is_failed) { goto pack_writer_close_exit; }
+  if (writer->entry != NULL) {
+    LOG_ERROR("[IO] Pack entry was never ended: %S", writer->entry->name);
+    goto pack_writer_close_exit;
+  }
+  if (writer->names_size > U32_MAX) {
+    LOG_ERROR("[IO] Pack entry names exceed 4GB.");
+    goto pack_writer_close_exit;
+  }
+
+  PackHeader header;
+  MEMORY_ZERO_STRUCT(&header);
+  header.magic        = PACK_MAGIC;
+  header.version      = PACK_VERSION;
+  header.entries_size = writer->entries_size;
+  // NOTE: keep the table at most half full, so probe sequences stay short.
+  header.table_size = 1;
+  while (header.table_size < writer->entries_size * 2) { header.table_size <<= 1; }
+
+  PackEntry* entries = ARENA_PUSH_ARRAY(writer->arena, PackEntry, MAX(writer->entries_size, 1));
+  String8* names     = ARENA_PUSH_ARRAY(writer->arena, String8, MAX(writer->entries_size, 1));
+  U32* table         = ARENA_PUSH_ARRAY(writer->arena, U32, header.table_size);
+  MEMORY_ZERO_ARRAY(table, header.table_size);
+  U32 i = 0;
+  for (PackWriterEntry* node = writer->entries_head; node != NULL; node = node->next, i++) {
+    entries[i] = node->entry;
+    names[i]   = node->name;
+    U32 slot   = node->entry.name_hash & (header.table_size - 1);
+    for (; table[slot] != 0; slot = (slot + 1) & (header.table_size - 1)) {
+      PackEntry* other = &entries[table[slot] - 1];
+      if (other->name_hash == node->entry.name_hash && Str8Eq(names[table[slot] - 1], node->name)) {
+        LOG_ERROR("[IO] Duplicate pack entry: %S", node->name);
+        goto pack_writer_close_exit;
+      }
+    }
+    table[slot] = i + 1;
+  }
+
+  if (!_PackWriterPad(writer)) { goto pack_writer_close_exit; }
+  header.toc_offset = writer->file.file_pos + writer->file.buffer_size;
+  if (!FileWriterWrite(&writer->file, (U8*) entries, sizeof(PackEntry) * writer->entries_size)) { goto pack_writer_close_exit; }
+  if (!FileWriterWrite(&writer->file, (U8*) table, sizeof(U32) * header.table_size)) { goto pack_writer_close_exit; }
+  for (i = 0; i < writer->entries_size; i++) {
+    if (!FileWriterWriteStr8(&writer->file, names[i])) { goto pack_writer_close_exit; }
+  }
+  header.file_size = writer->file.file_pos + writer->file.buffer_size;
+
+  if (!FileWriterFlush(&writer->file)) { goto pack_writer_close_exit; }
+  if (!FileHandleSeek(writer->file.file, 0, FileSeekPos_Begin)) { goto pack_writer_close_exit; }
+  if (!FileHandleWrite(writer->file.file, (U8*) &header, sizeof(header))) { goto pack_writer_close_exit; }
+  success = true;
+
+pack_writer_close_exit:
+  success = FileWriterClose(&writer->file) && success;
+  ArenaRelease(writer->arena);
+  MEMORY_ZERO_STRUCT(writer);
+  return success;
+}
+
+B32 PackOpen(Pack* pack, String8 file_path, FileMapHint hints) {
+  MEMORY_ZERO_STRUCT(pack);
+  if (!FileMapOpen(file_path, &pack->map, hints)) { return false; }
+  U8* data  = pack->map.data;
+  U64 size  = pack->map.size;
+  PackHeader* header = (PackHeader*) data;
+  if (size < sizeof(PackHeader) || header->magic != PACK_MAGIC) {
+    LOG_ERROR("[IO] Not an asset pack, or it was not finished: %S", file_path);
+    goto pack_open_fail;
+  }
+  if (header->version != PACK_VERSION) {
+    LOG_ERROR("[IO] Unsupported asset pack version %u (expected %u): %S", header->version, PACK_VERSION, file_path);
+    goto pack_open_fail;
+  }
+  if (header->file_size != size) {
+    LOG_ERROR("[IO] Asset pack size %llu does not match its header (%llu), it may be truncated: %S", size, header->file_size, file_path);
+    goto pack_open_fail;
+  }
+  if (header->table_size == 0 || (header->table_size & (header->table_size - 1)) != 0 ||
+      header->toc_offset % PACK_DATA_ALIGNMENT != 0 || header->toc_offset > size ||
+      (size - header->toc_offset) / sizeof(PackEntry) < header->entries_size ||
+      (size - header->toc_offset - header->entries_size * sizeof(PackEntry)) / sizeof(U32) < header->table_size) {
+    LOG_ERROR("[IO] Asset pack has a malformed table of contents: %S", file_path);
+    goto pack_open_fail;
+  }
+  pack->header  = header;
+  pack->entries = (PackEntry*) (data + header->toc_offset);
+  pack->table   = (U32*) (pack->entries + header->entries_size);
+  pack->names   = (U8*) (pack->table + header->table_size);
+
+  // NOTE: entry data is not touched here, so pages are only faulted in as entries are used.
+  U64 names_size = size - (pack->names - data);
+  for (U32 i = 0; i < header->entries_size; i++) {
+    PackEntry* entry = &pack->entries[i];
+    if (entry->offset > header->toc_offset || entry->size > header->toc_offset - entry->offset ||
+        entry->name_offset > names_size || entry->name_size > names_size - entry->name_offset) {
+      LOG_ERROR("[IO] Asset pack entry %u is out of bounds: %S", i, file_path);
+      goto pack_open_fail;
+    }
+  }
+  for (U32 i = 0; i < header->table_size; i++) {
+    if (pack->table[i] > header->entries_size) {
+      LOG_ERROR("[IO] Asset pack has a malformed table of contents: %S", file_path);
+      goto pack_open_fail;
+    }
+  }
+  return true;
+
+pack_open_fail:
+  DEBUG_ASSERT(FileMapClose(&pack->map));
+  MEMORY_ZERO_STRUCT(pack);
+  return false;
+}
+
+B32 PackClose(Pack* pack) {
+  B32 success = FileMapClose(&pack->map);
+  MEMORY_ZERO_STRUCT(pack);
+  return success;
+}
+
+PackEntry* PackFind(Pack* pack, String8 name) {
+  U64 hash  = _PackHash(name.str, name.size);
+  U32 mask  = pack->header->table_size - 1;
+  // NOTE: the table is never full, so this always reaches an empty slot.
+  for (U32 slot = hash & mask, i = 0; pack->table[slot] != 0 && i <= mask; slot = (slot + 1) & mask, i++) {
+    PackEntry* entry = &pack->entries[pack->table[slot] - 1];
+    if (entry->name_hash == hash && Str8Eq(PackEntryName(pack, entry), name)) { return entry; }
+  }
+  return NULL;
+}
+
+String8 PackEntryName(Pack* pack, PackEntry* entry) {
+  return Str8(pack->names + entry->name_offset, entry->name_size);
+}
+
+U8* PackEntryData(Pack* pack, PackEntry* entry) {
+  return pack->map.data + entry->offset;
+}
+
+B32 PackEntryVerify(Pack* pack, PackEntry* entry) {
+  if (Crc32c(PackEntryData(pack, entry), entry->size) != entry->checksum) {
+    LOG_ERROR("[IO] Asset pack entry failed its checksum: %S", PackEntryName(pack, entry));
+    return false;
+  }
+  return true;
+}
+
+B32 PackGet(Pack* pack, String8 name, U8** data, U64* data_size) {
+  PackEntry* entry = PackFind(pack, name);
+  if (entry == NULL) {
+    LOG_ERROR("[IO] Asset pack entry not found: %S", name);
+    return false;
+  }
+  if (entry->compression != PackCompression_None) {
+    LOG_ERROR("[IO] Asset pack entry is compressed, use PackRead instead: %S", name);
+    return false;
+  }
+  *data      = PackEntryData(pack, entry);
+  *data_size = entry->size;
+  return true;
+}
+
+B32 PackRead(Arena* arena, Pack* pack, String8 name, U8** data, U64* data_size) {
+  PackEntry* entry = PackFind(pack, name);
+  if (entry == NULL) {
+    LOG_ERROR("[IO] Asset pack entry not found: %S", name);
+    return false;
+  }
+  if (!PackEntryVerify(pack, entry)) { return false; }
+  switch (entry->compression) {
+    case PackCompression_None: {
+      *data      = ARENA_PUSH_ARRAY(arena, U8, entry->size);
+      *data_size = entry->size;
+      MEMORY_COPY_SIZE(*data, PackEntryData(pack, entry), entry->size);
+    } break;
+    case PackCompression_Deflate: {
+      // NOTE: the raw size is known, so inflate straight into an exactly sized buffer.
+      Inflate* inflate;
+      if (!InflateCreate(&inflate, CompressFormat_Raw)) { return false; }
+      U64 arena_pos = ArenaPos(arena);
+      U8* out       = ARENA_PUSH_ARRAY(arena, U8, entry->raw_size);
+      U64 in_read, out_written;
+      CompressStatus status = InflateRun(inflate, PackEntryData(pack, entry), entry->size, &in_read, out, entry->raw_size, &out_written);
+      InflateDestroy(inflate);
+      if (status != CompressStatus_Done || out_written != entry->raw_size) {
+        LOG_ERROR("[IO] Asset pack entry failed to decompress: %S", name);
+        ArenaPopTo(arena, arena_pos);
+        return false;
+      }
+      *data      = out;
+      *data_size = entry->raw_size;
+    } break;
+    default: {
+      LOG_ERROR("[IO] Unsupported pack compression %u for entry: %S", entry->compression, name);
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef CDEFAULT_IO_NATIVE_READ_QUEUE
+typedef CDEFAULT_IO_BACKEND_FN(FileReadQueueNative) FileReadQueueNative;
+#endif
+
+struct FileReadQueue {
+  Arena* arena;
+  FileReadQueueBackend backend;
+  U32 depth;
+  U32 in_flight;   // NOTE: Issued to the backend, not yet reaped.
+  U32 outstanding; // NOTE: Submitted, not yet returned to the caller.
+  FileReadRequest* pending_head; // NOTE: Submitted, waiting on a free slot.
+  FileReadRequest* pending_tail;
+  FileReadRequest* ready_head;   // NOTE: Completed without going through the backend, e.g. failed to issue.
+  FileReadRequest* ready_tail;
+
+#ifdef CDEFAULT_IO_NATIVE_READ_QUEUE
+  FileReadQueueNative native;
+#endif
+
+  // NOTE: FileReadQueueBackend_Threads.
+  Mutex mutex;
+  CV work_cv;
+  CV done_cv;
+  FileReadRequest* work_head;
+  FileReadRequest* work_tail;
+  FileReadRequest* done_head;
+  FileReadRequest* done_tail;
+  B32 is_stopping;
+  Thread threads[FILE_READ_QUEUE_MAX_DEPTH];
+};
+
+static S32 _FileReadQueueWorker(void* arg) {
+  FileReadQueue* queue = (FileReadQueue*) arg;
+  MutexLock(&queue->mutex);
+  while (true) {
+    while (!queue->is_stopping && queue->work_head == NULL) { CVWait(&queue->work_cv, &queue->mutex); }
+    if (queue->work_head == NULL) { break; }
+    FileReadRequest* request = queue->work_head;
+    SLL_QUEUE_POP(queue->work_head, queue->work_tail, next);
+    MutexUnlock(&queue->mutex);
+
+    request->bytes_read = 0;
+    request->success = CDEFAULT_IO_BACKEND_FN(FileHandleReadAt(request->file, request->offset, request->buffer, request->size, &request->bytes_read));
+
+    MutexLock(&queue->mutex);
+    SLL_QUEUE_PUSH_BACK(queue->done_head, queue->done_tail, request, next);
+    CVSignal(&queue->done_cv);
+  }
+  MutexUnlock(&queue->mutex);
+  return 0;
+}
+
+static void _FileReadQueueIssue(FileReadQueue* queue) {
+  if (queue->pending_head == NULL || queue->in_flight == queue->depth) { return; }
+  if (queue->backend == FileReadQueueBackend_Threads) { MutexLock(&queue->mutex); }
+  while (queue->pending_head != NULL && queue->in_flight < queue->depth) {
+    FileReadRequest* request = queue->pending_head;
+    SLL_QUEUE_POP(queue->pending_head, queue->pending_tail, next);
+    if (queue->backend == FileReadQueueBackend_Threads) {
+      SLL_QUEUE_PUSH_BACK(queue->work_head, queue->work_tail, request, next);
+      CVSignal(&queue->work_cv);
+      queue->in_flight++;
+#ifdef CDEFAULT_IO_NATIVE_READ_QUEUE
+    } else if (CDEFAULT_IO_BACKEND_FN(FileReadQueueNativeIssue(&queue->native, request))) {
+      queue->in_flight++;
+#endif
+    } else {
+      SLL_QUEUE_PUSH_BACK(queue->ready_head, queue->ready_tail, request, next);
+    }
+  }
+  if (queue->backend == FileReadQueueBackend_Threads) { MutexUnlock(&queue->mutex); }
+#ifdef CDEFAULT_IO_NATIVE_READ_QUEUE
+  else { CDEFAULT_IO_BACKEND_FN(FileReadQueueNativeFlush(&queue->native)); }
+#endif
+}
+
+static U32 _FileReadQueueReap(FileReadQueue* queue, FileReadRequest** completed, U32 completed_cap, B32 wait) {
+  U32 completed_size = 0;
+  while (completed_size < completed_cap && queue->ready_head != NULL) {
+    completed[completed_size++] = queue->ready_head;
+    SLL_QUEUE_POP(queue->ready_head, queue->ready_tail, next);
+  }
+
+  if (completed_size < completed_cap && queue->in_flight > 0) {
+    B32 should_block = wait && completed_size == 0;
+    U32 reaped = 0;
+    if (queue->backend == FileReadQueueBackend_Threads) {
+      MutexLock(&queue->mutex);
+      while (should_block && queue->done_head == NULL) { CVWait(&queue->done_cv, &queue->mutex); }
+      while (completed_size + reaped < completed_cap && queue->done_head != NULL) {
+        completed[completed_size + reaped++] = queue->done_head;
+        SLL_QUEUE_POP(queue->done_head, queue->done_tail, next);
+      }
+      MutexUnlock(&queue->mutex);
+    } else {
+#ifdef CDEFAULT_IO_NATIVE_READ_QUEUE
+      // NOTE: the native backends may wake without a completion (e.g. on a transient failure), so retry the wait.
+      do {
+        reaped = CDEFAULT_IO_BACKEND_FN(FileReadQueueNativeReap(&queue->native, completed + completed_size, completed_cap - completed_size, should_block));
+      } while (should_block && reaped == 0);
+#endif
+    }
+    DEBUG_ASSERT(reaped <= queue->in_flight);
+    queue->in_flight -= reaped;
+    completed_size   += reaped;
+  }
+
+  queue->outstanding -= completed_size;
+  _FileReadQueueIssue(queue);
+  return completed_size;
+}
+
+// NOTE: Joins the first threads_size worker threads.
+static void _FileReadQueueStopThreads(FileReadQueue* queue, U32 threads_size) {
+  MutexLock(&queue->mutex);
+  queue->is_stopping = true;
+  CVBroadcast(&queue->work_cv);
+  MutexUnlock(&queue->mutex);
+  for (U32 i = 0; i < threads_size; i++) { ThreadJoin(&queue->threads[i]); }
+  CVDeinit(&queue->done_cv);
+  CVDeinit(&queue->work_cv);
+  MutexDeinit(&queue->mutex);
+}
+
+B32 FileReadQueueCreate(FileReadQueue** queue, U32 depth, FileReadQueueBackend backend) {
+  if (depth == 0 || depth > FILE_READ_QUEUE_MAX_DEPTH) {
+    LOG_ERROR("[IO] Invalid read queue depth %u, must be in [1, %u].", depth, FILE_READ_QUEUE_MAX_DEPTH);
+    return false;
+  }
+  Arena* arena = ArenaAllocate();
+  *queue = ARENA_PUSH_STRUCT(arena, FileReadQueue);
+  MEMORY_ZERO_STRUCT(*queue);
+  (*queue)->arena   = arena;
+  (*queue)->depth   = depth;
+  (*queue)->backend = backend;
+
+#ifdef CDEFAULT_IO_NATIVE_READ_QUEUE
+  if (backend == FileReadQueueBackend_Native && !CDEFAULT_IO_BACKEND_FN(FileReadQueueNativeInit(&(*queue)->native, depth))) {
+    LOG_DEBUG("[IO] Native async reads are unavailable, falling back to threads.");
+    (*queue)->backend = FileReadQueueBackend_Threads;
+  }
+#else
+  (*queue)->backend = FileReadQueueBackend_Threads;
+#endif
+  if ((*queue)->backend == FileReadQueueBackend_Threads) {
+    MutexInit(&(*queue)->mutex);
+    CVInit(&(*queue)->work_cv);
+    CVInit(&(*queue)->done_cv);
+    for (U32 i = 0; i < depth; i++) {
+      if (ThreadCreate(&(*queue)->threads[i], _FileReadQueueWorker, *queue)) { continue; }
+      LOG_ERROR("[IO] Failed to start read queue worker thread %u of %u.", i, depth);
+      _FileReadQueueStopThreads(*queue, i);
+      ArenaRelease(arena);
+      *queue = NULL;
+      return false;
+    }
+  }
+  return true;
+}
+
+void FileReadQueueDestroy(FileReadQueue* queue) {
+  FileReadRequest* completed[FILE_READ_QUEUE_MAX_DEPTH];
+  while (FileReadQueueWait(queue, completed, STATIC_ARRAY_SIZE(completed)) > 0) {}
+  if (queue->backend == FileReadQueueBackend_Threads) {
+    _FileReadQueueStopThreads(queue, queue->depth);
+#ifdef CDEFAULT_IO_NATIVE_READ_QUEUE
+  } else {
+    CDEFAULT_IO_BACKEND_FN(FileReadQueueNativeDeinit(&queue->native));
+#endif
+  }
+  ArenaRelease(queue->arena);
+}
+
+FileReadQueueBackend FileReadQueueGetBackend(FileReadQueue* queue) {
+  return queue->backend;
+}
+
+void FileReadQueueSubmit(FileReadQueue* queue, FileReadRequest* requests, U32 requests_size) {
+  for (U32 i = 0; i < requests_size; i++) {
+    FileReadRequest* request = &requests[i];
+    DEBUG_ASSERT(request->file != NULL);
+    request->success    = false;
+    request->bytes_read = 0;
+    SLL_QUEUE_PUSH_BACK(queue->pending_head, queue->pending_tail, request, next);
+  }
+  queue->outstanding += requests_size;
+  _FileReadQueueIssue(queue);
+}
+
+U32 FileReadQueuePoll(FileReadQueue* queue, FileReadRequest** completed, U32 completed_cap) {
+  return _FileReadQueueReap(queue, completed, completed_cap, false);
+}
+
+U32 FileReadQueueWait(FileReadQueue* queue, FileReadRequest** completed, U32 completed_cap) {
+  return _FileReadQueueReap(queue, completed, completed_cap, true);
+}
+
+U32 FileReadQueueOutstanding(FileReadQueue* queue) {
+  return queue->outstanding;
+}
+
+typedef CDEFAULT_IO_BACKEND_FN(FileWatcherNative) FileWatcherNative;
+
+typedef struct FileWatchRecord FileWatchRecord;
+struct FileWatchRecord {
+  String8 path;
+  FileWatchEventFlags flags;
+  U64 event_idx;
+  FileWatchRecord* next;
+  FileWatchRecord* hash_next;
+};
+
+struct FileWatcher {
+  Arena* arena;
+  Arena* batch_arena; // NOTE: Records pushed during a poll, cleared by the next one.
+  FileWatchRecord* records_head;
+  FileWatchRecord* records_tail;
+  U64 records_size;
+  FileWatcherNative native;
+};
+
+static void _FileWatcherPush(FileWatcher* watcher, String8 dir_path, String8 name, FileWatchEventFlags flags) {
+  FileWatchRecord* record = ARENA_PUSH_STRUCT(watcher->batch_arena, FileWatchRecord);
+  MEMORY_ZERO_STRUCT(record);
+  record->path  = (name.size > 0) ? Str8Format(watcher->batch_arena, "%S/%S", dir_path, name) : Str8Copy(watcher->batch_arena, dir_path);
+  record->flags = flags;
+  SLL_QUEUE_PUSH_BACK(watcher->records_head, watcher->records_tail, record, next);
+  watcher->records_size++;
+}
+
+B32 FileWatcherCreate(FileWatcher** watcher, String8 dir_path, B32 recursive) {
+  Arena* arena = ArenaAllocate();
+  *watcher = ARENA_PUSH_STRUCT(arena, FileWatcher);
+  MEMORY_ZERO_STRUCT(*watcher);
+  (*watcher)->arena       = arena;
+  (*watcher)->batch_arena = ArenaAllocate();
+
+  String8 root = Str8Copy(arena, Str8Trim(dir_path));
+  Str8ReplaceAllChar(&root, '\\', '/');
+  while (root.size > 1 && root.str[root.size - 1] == '/') { root.size--; }
+  if (root.size == 0) { root = Str8Lit("."); }
+  if (!CDEFAULT_IO_BACKEND_FN(FileWatcherNativeInit(&(*watcher)->native, arena, root, recursive))) {
+    ArenaRelease((*watcher)->batch_arena);
+    ArenaRelease(arena);
+    *watcher = NULL;
+    return false;
+  }
+  return true;
+}
+
+void FileWatcherDestroy(FileWatcher* watcher) {
+  CDEFAULT_IO_BACKEND_FN(FileWatcherNativeDeinit(&watcher->native));
+  ArenaRelease(watcher->batch_arena);
+  ArenaRelease(watcher->arena);
 }
 
-B32 FileHandleWrite(FileHandle* file, U8* buffer, U32 buffer_size) {
-  return CDEFAULT_IO_BACKEND_FN(FileHandleWrite(file, buffer, buffer_size));
+B32 FileWatcherPoll(FileWatcher* watcher, Arena* arena, FileWatchEvent** events, U64* events_size) {
+  *events = NULL;
+  *events_size = 0;
+  ArenaClear(watcher->batch_arena);
+  watcher->records_head = NULL;
+  watcher->records_tail = NULL;
+  watcher->records_size = 0;
+  B32 success = CDEFAULT_IO_BACKEND_FN(FileWatcherNativePoll(&watcher->native, watcher, watcher->batch_arena));
+  if (watcher->records_size == 0) { return success; }
+
+  // NOTE: coalesces records by path, keeping the order in which each path first changed.
+  U64 buckets_size = 16;
+  while (buckets_size < watcher->records_size * 2) { buckets_size <<= 1; }
+  FileWatchRecord** buckets = ARENA_PUSH_ARRAY(watcher->batch_arena, FileWatchRecord*, buckets_size);
+  MEMORY_ZERO_ARRAY(buckets, buckets_size);
+  FileWatchEvent* result = ARENA_PUSH_ARRAY(arena, FileWatchEvent, watcher->records_size);
+  U64 result_size = 0;
+  for (FileWatchRecord* record = watcher->records_head; record != NULL; record = record->next) {
+    FileWatchRecord** bucket = &buckets[Crc32c(record->path.str, record->path.size) & (buckets_size - 1)];
+    FileWatchRecord* match = *bucket;
+    while (match != NULL && !Str8Eq(match->path, record->path)) { match = match->hash_next; }
+    if (match != NULL) {
+      result[match->event_idx].flags |= record->flags;
+      continue;
+    }
+    record->event_idx = result_size++;
+    SLL_STACK_PUSH(*bucket, record, hash_next);
+    result[record->event_idx].path  = Str8Copy(arena, record->path);
+    result[record->event_idx].flags = record->flags;
+  }
+  *events = result;
+  *events_size = result_size;
+  return success;
 }
 
+typedef struct LogRecord LogRecord;
+struct LogRecord {
+  AtomicS64 sequence;
+  U32 size;
+  U8 data[LOG_ASYNC_RECORD_SIZE - sizeof(AtomicS64) - sizeof(U32)];
+};
+STATIC_ASSERT(LOG_ASYNC_RECORD_SIZE > 64, "LOG_ASYNC_RECORD_SIZE is too small to hold a log line.");
+
+#define LOG_ASYNC_BATCH_SIZE 256
+
+// NOTE: A bounded MPSC ring (D. Vyukov's sequenced slots). A slot is free for the producer claiming position pos when
+// its sequence == pos, and ready for the writer when its sequence == pos + 1. Producers claim positions with a CAS.
+typedef struct LogAsync LogAsync;
+struct LogAsync {
+  Arena* arena;
+  LogRecord* records;
+  U32 records_size;
+  LogAsyncPolicy policy;
+  Thread writer;
+  AtomicS64 enqueue_pos;
+  U8 _pad0[64];
+  AtomicS64 written_pos; // NOTE: All records before this have been written.
+  AtomicS64 dropped;
+  AtomicS32 waiters;
+  AtomicB32 writer_is_sleeping;
+  U8 _pad1[64];
+  S64 dequeue_pos; // NOTE: Only touched by the writer.
+  Mutex mutex;
+  CV work_cv;
+  CV written_cv;
+  B32 is_stopping;
+};
+
+#define LOG_ARENA_POOL_SIZE 8
+
 typedef struct LogConfig LogConfig;
 struct LogConfig {
-  Arena*      arena;
   FileHandle* handle;
   Mutex       mtx;
   B8          is_initialized;
+  B8          is_stdout;
+  B8          is_async;
+  LogAsync    async;
+  // NOTE: Records are formatted outside of mtx, each in an arena taken from this pool. Loggers only hold arenas_mtx
+  // to take / return one, and at most LOG_ARENA_POOL_SIZE idle arenas are kept.
+  Mutex       arenas_mtx;
+  Arena*      arenas[LOG_ARENA_POOL_SIZE];
+  U32         arenas_size;
 };
 static LogConfig _cdef_log_config;
 
+static THREAD_LOCAL B32 _cdef_log_is_writer_thread;
+
 static void LogInitCommon(LogConfig* c) {
   DEBUG_ASSERT(!c->is_initialized);
   MEMORY_ZERO_STRUCT(c);
-  c->arena = ArenaAllocate();
   MutexInit(&c->mtx);
+  MutexInit(&c->arenas_mtx);
+}
+
+static Arena* _LogArenaAcquire(LogConfig* c) {
+  Arena* arena = NULL;
+  MutexLock(&c->arenas_mtx);
+  if (c->arenas_size > 0) { arena = c->arenas[--c->arenas_size]; }
+  MutexUnlock(&c->arenas_mtx);
+  if (arena == NULL) { arena = ArenaAllocate(); }
+  return arena;
+}
+
+static void _LogArenaReturn(LogConfig* c, Arena* arena) {
+  ArenaClear(arena);
+  MutexLock(&c->arenas_mtx);
+  if (c->arenas_size < LOG_ARENA_POOL_SIZE) {
+    c->arenas[c->arenas_size++] = arena;
+    arena = NULL;
+  }
+  MutexUnlock(&c->arenas_mtx);
+  ArenaRelease(arena);
 }
 
 B32 LogInitStdOut() {
   LogConfig* c = &_cdef_log_config;
   LogInitCommon(c);
   if (!FileHandleOpenStdOut(&c->handle)) { return false; }
+  c->is_stdout = true;
   c->is_initialized = true;
   return true;
 }
@@ -806,14 +4747,194 @@ B32 LogInitFile(String8 file_path) {
   return true;
 }
 
+static void _LogAsyncWakeWriter(LogAsync* a) {
+  if (!AtomicB32Load(&a->writer_is_sleeping)) { return; }
+  MutexLock(&a->mutex);
+  CVSignal(&a->work_cv);
+  MutexUnlock(&a->mutex);
+}
+
+// NOTE: Blocks until the writer has written every record before pos.
+static void _LogAsyncWaitWritten(LogAsync* a, S64 pos) {
+  if (AtomicS64Load(&a->written_pos) >= pos) { return; }
+  AtomicS32FetchAdd(&a->waiters, 1);
+  _LogAsyncWakeWriter(a);
+  MutexLock(&a->mutex);
+  while (AtomicS64Load(&a->written_pos) < pos) { CVWait(&a->written_cv, &a->mutex); }
+  MutexUnlock(&a->mutex);
+  AtomicS32FetchSub(&a->waiters, 1);
+}
+
+static S32 _LogAsyncWriter(void* arg) {
+  LogConfig* c = (LogConfig*) arg;
+  LogAsync* a  = &c->async;
+  _cdef_log_is_writer_thread = true;
+  U64 mask = a->records_size - 1;
+  String8 batch[LOG_ASYNC_BATCH_SIZE];
+  while (true) {
+    U32 batch_size = 0;
+    for (; batch_size < LOG_ASYNC_BATCH_SIZE; batch_size++) {
+      S64 pos = a->dequeue_pos + batch_size;
+      LogRecord* record = &a->records[pos & mask];
+      if (AtomicS64Load(&record->sequence) != pos + 1) { break; }
+      batch[batch_size] = Str8(record->data, record->size);
+    }
+
+    if (batch_size > 0) {
+      MutexLock(&c->mtx);
+      CDEFAULT_IO_BACKEND_FN(FileHandleWriteGather(c->handle, batch, batch_size));
+      MutexUnlock(&c->mtx);
+      for (U32 i = 0; i < batch_size; i++) {
+        S64 pos = a->dequeue_pos + i;
+        AtomicS64Store(&a->records[pos & mask].sequence, pos + a->records_size);
+      }
+      a->dequeue_pos += batch_size;
+      AtomicS64Store(&a->written_pos, a->dequeue_pos);
+      if (AtomicS32Load(&a->waiters) > 0) {
+        MutexLock(&a->mutex);
+        CVBroadcast(&a->written_cv);
+        MutexUnlock(&a->mutex);
+      }
+      continue;
+    }
+
+    LogRecord* next = &a->records[a->dequeue_pos & mask];
+    MutexLock(&a->mutex);
+    AtomicB32Store(&a->writer_is_sleeping, true);
+    while (!a->is_stopping && AtomicS64Load(&next->sequence) != a->dequeue_pos + 1) { CVWait(&a->work_cv, &a->mutex); }
+    AtomicB32Store(&a->writer_is_sleeping, false);
+    B32 should_stop = a->is_stopping && AtomicS64Load(&next->sequence) != a->dequeue_pos + 1;
+    MutexUnlock(&a->mutex);
+    if (should_stop) { break; }
+  }
+  return 0;
+}
+
+// NOTE: Returns false if the record must be written synchronously instead.
+static B32 _LogAsyncPush(LogAsync* a, String8 line) {
+  if (line.size > sizeof(a->records[0].data)) { return false; }
+  U64 mask = a->records_size - 1;
+  S64 pos  = AtomicS64Load(&a->enqueue_pos);
+  while (true) {
+    LogRecord* record = &a->records[pos & mask];
+    S64 diff = AtomicS64Load(&record->sequence) - pos;
+    if (diff == 0) {
+      if (AtomicS64CompareExchange(&a->enqueue_pos, &pos, pos + 1)) {
+        MEMORY_COPY_SIZE(record->data, line.str, line.size);
+        record->size = line.size;
+        AtomicS64Store(&record->sequence, pos + 1);
+        _LogAsyncWakeWriter(a);
+        return true;
+      }
+    } else if (diff < 0) {
+      if (a->policy == LogAsyncPolicy_Drop) {
+        AtomicS64FetchAdd(&a->dropped, 1);
+        return true;
+      }
+      _LogAsyncWaitWritten(a, pos - a->records_size + 1);
+      pos = AtomicS64Load(&a->enqueue_pos);
+    } else {
+      pos = AtomicS64Load(&a->enqueue_pos);
+    }
+  }
+}
+
+static void _LogAsyncStop(LogConfig* c) {
+  LogAsync* a = &c->async;
+  LogFlush();
+  MutexLock(&a->mutex);
+  a->is_stopping = true;
+  CVSignal(&a->work_cv);
+  MutexUnlock(&a->mutex);
+  ThreadJoin(&a->writer);
+  CVDeinit(&a->written_cv);
+  CVDeinit(&a->work_cv);
+  MutexDeinit(&a->mutex);
+  ArenaRelease(a->arena);
+  c->is_async = false;
+}
+
+static void _LogAtExit(void) {
+  LogConfig* c = &_cdef_log_config;
+  if (c->is_initialized && c->is_async) { _LogAsyncStop(c); }
+}
+
+B32 LogEnableAsync(U32 ring_size, LogAsyncPolicy policy) {
+  LogConfig* c = &_cdef_log_config;
+  DEBUG_ASSERT(c->is_initialized && !c->is_async);
+  if (ring_size == 0 || (ring_size & (ring_size - 1)) != 0) {
+    LOG_ERROR("[IO] Log ring size must be a power of 2, got %u.", ring_size);
+    return false;
+  }
+  LogAsync* a = &c->async;
+  MEMORY_ZERO_STRUCT(a);
+  U64 records_bytes = (U64) ring_size * sizeof(LogRecord);
+  a->arena = _ArenaAllocate(ALIGN_POW_2(records_bytes + KB(64), MB(1)), KB(64));
+  a->records = ARENA_PUSH_ARRAY(a->arena, LogRecord, ring_size);
+  a->records_size = ring_size;
+  a->policy = policy;
+  for (U32 i = 0; i < ring_size; i++) { AtomicS64Init(&a->records[i].sequence, i); }
+  AtomicS64Init(&a->enqueue_pos, 0);
+  AtomicS64Init(&a->written_pos, 0);
+  AtomicS64Init(&a->dropped, 0);
+  AtomicS32Init(&a->waiters, 0);
+  AtomicB32Init(&a->writer_is_sleeping, false);
+  MutexInit(&a->mutex);
+  CVInit(&a->work_cv);
+  CVInit(&a->written_cv);
+  if (!ThreadCreate(&a->writer, _LogAsyncWriter, c)) {
+    CVDeinit(&a->written_cv);
+    CVDeinit(&a->work_cv);
+    MutexDeinit(&a->mutex);
+    ArenaRelease(a->arena);
+    LOG_ERROR("[IO] Failed to start the async log writer thread.");
+    return false;
+  }
+
+  static B32 registered_at_exit = false;
+  if (!registered_at_exit) {
+    atexit(_LogAtExit);
+    registered_at_exit = true;
+  }
+  c->is_async = true;
+  return true;
+}
+
+void LogFlush() {
+  LogConfig* c = &_cdef_log_config;
+  if (!c->is_initialized || !c->is_async || _cdef_log_is_writer_thread) { return; }
+  _LogAsyncWaitWritten(&c->async, AtomicS64Load(&c->async.enqueue_pos));
+}
+
+U64 LogGetDroppedCount() {
+  LogConfig* c = &_cdef_log_config;
+  if (!c->is_async) { return 0; }
+  return AtomicS64Load(&c->async.dropped);
+}
+
+void LogDeinit() {
+  LogConfig* c = &_cdef_log_config;
+  DEBUG_ASSERT(c->is_initialized);
+  if (c->is_async) { _LogAsyncStop(c); }
+  // NOTE: the stdout handle is never closed, it's shared with the rest of the process.
+  if (!c->is_stdout) { FileHandleClose(c->handle); }
+  for (U32 i = 0; i < c->arenas_size; i++) { ArenaRelease(c->arenas[i]); }
+  c->arenas_size = 0;
+  MutexDeinit(&c->arenas_mtx);
+  MutexDeinit(&c->mtx);
+  c->is_initialized = false;
+}
+
 static void LogV(LogLevel level, String8 file, U32 loc, String8 fmt, va_list args) {
   LogConfig* c = &_cdef_log_config;
   DEBUG_ASSERT(c->is_initialized);
+  // NOTE: the async writer can't log its own failures, it would wait on itself.
+  if (_cdef_log_is_writer_thread) { return; }
 
   String8 file_name;
   if (!PathPop(file, NULL, &file_name)) { file_name = file; }
 
-  U64 arena_base = ArenaPos(c->arena);
+  Arena* arena = _LogArenaAcquire(c);
 
   // TODO: make highlighting optional.
   String8 level_text;
@@ -828,18 +4949,21 @@ static void LogV(LogLevel level, String8 file, U32 loc, String8 fmt, va_list arg
 
   String8 prefix = Str8Lit("");
   if (level != LogLevel_NoPrefix) {
-    prefix = Str8Format(c->arena, "[%S | %S:%d]: ", level_text, file_name, loc);
+    prefix = Str8Format(arena, "[%S | %S:%d]: ", level_text, file_name, loc);
   }
-  String8 message = Str8FormatV(c->arena, fmt, args);
-  String8 suffix  = Str8Lit("\n");
+  String8 message = Str8FormatV(arena, fmt, args);
+  String8 line    = Str8Format(arena, "%S%S\n", prefix, message);
 
-  MutexLock(&_cdef_log_config.mtx);
-  FileHandleWrite(c->handle, prefix.str, prefix.size);
-  FileHandleWrite(c->handle, message.str, message.size);
-  FileHandleWrite(c->handle, suffix.str, suffix.size);
-  MutexUnlock(&_cdef_log_config.mtx);
+  if (!c->is_async || !_LogAsyncPush(&c->async, line)) {
+    // NOTE: keep this thread's earlier records ahead of this one.
+    LogFlush();
+    MutexLock(&c->mtx);
+    FileHandleWrite(c->handle, line.str, line.size);
+    MutexUnlock(&c->mtx);
+  }
+  if (level == LogLevel_Error) { LogFlush(); }
 
-  ArenaPopTo(c->arena, arena_base);
+  _LogArenaReturn(c, arena);
 }
 
 void Log(LogLevel level, String8 file, U32 loc, String8 fmt, ...) {
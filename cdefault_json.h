@@ -3,6 +3,7 @@
 
 #include "cdefault_std.h"
 #include "cdefault_io.h"
+#include "cdefault_profile.h"
 
 // TODO: truncate string when logging / better error messages?
 // TODO: metaprogramming for struct -> json serialization / deserialization?
@@ -348,8 +349,12 @@ json_object_parse_end:
 }
 
 B32 JsonParse(Arena* arena, JsonObject* object, String8 json_str) {
+  CDEFAULT_PROFILE_START(JSON_PARSE);
+  PROFILE_ADD_BYTES(json_str.size);
   String8 json_str_copy = json_str;
-  return JsonObjectParse(arena, object, &json_str, &json_str_copy);
+  B32 success = JsonObjectParse(arena, object, &json_str, &json_str_copy);
+  CDEFAULT_PROFILE_END(JSON_PARSE);
+  return success;
 }
 
 B32 JsonParseFromFile(Arena* arena, JsonObject* object, String8 file_path) {
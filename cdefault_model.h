@@ -6,6 +6,7 @@
 #include "cdefault_image.h"
 #include "cdefault_json.h"
 #include "cdefault_io.h"
+#include "cdefault_profile.h"
 
 // NOTE: supports loading:
 // - OBJ
@@ -40,6 +41,8 @@ B32 ModelLoadFile(Arena* arena, Model* model, String8 file_path);
 B32 ModelLoad(Arena* arena, Model* model, U8* file_data, U32 file_data_size);
 B32 ModelCopy(Arena* arena, Model* dest, Model* src);
 B32 MeshCopy(Arena* arena, Mesh* dest, Mesh* src);
+B32 ModelPackAdd(PackWriter* writer, String8 name, Model* model);         // NOTE: Bakes the mesh arrays (and textures) into an asset pack, see cdefault_io.h.
+B32 ModelPackGet(Arena* arena, Pack* pack, String8 name, Model* model);   // NOTE: Only the Mesh structs are pushed on arena, the arrays point into the (read-only) pack.
 
 B32 ModelLoadObj(Arena* arena, Model* model, U8* file_data, U32 file_data_size);
 B32 ModelLoadGlb(Arena* arena, Model* model, U8* file_data, U32 file_data_size);
@@ -52,10 +55,15 @@ B32 ModelLoadGlb(Arena* arena, Model* model, U8* file_data, U32 file_data_size);
 #define MODEL_LOG_OUT_OF_CHARS() LOG_ERROR("[FONT] Ran out of characters in model file.")
 
 B32 ModelLoadObj(Arena* arena, Model* model, U8* file_data, U32 file_data_size) {
+  CDEFAULT_PROFILE_START(MODEL_LOAD_OBJ);
+  PROFILE_ADD_BYTES(file_data_size);
   MEMORY_ZERO_STRUCT(model);
   Arena* temp_arena = ArenaAllocate();
   String8 file_str = Str8(file_data, file_data_size);
-  String8List lines = Str8Split(temp_arena, file_str, '\n');
+  String8LineIter lines;
+  String8TokenIter line_parts;
+  String8 line, line_part;
+  Str8TokenIterInit(&line_parts, Str8Lit(""), STR8_WHITESPACE);
   U64 arena_pos = ArenaPos(arena);
   B32 success = false;
 
@@ -71,11 +79,12 @@ B32 ModelLoadObj(Arena* arena, Model* model, U8* file_data, U32 file_data_size)
   S32 obj_normals_size  = 0;
   S32 obj_uvs_size      = 0;
   U32 vertices_size_estimate = 0;
-  for (String8ListNode* line = lines.head; line != NULL; line = line->next) {
-    if      (Str8StartsWith(line->string, Str8Lit("v ")))  { obj_points_size++;           }
-    else if (Str8StartsWith(line->string, Str8Lit("vn "))) { obj_normals_size++;          }
-    else if (Str8StartsWith(line->string, Str8Lit("vt "))) { obj_uvs_size++;              }
-    else if (Str8StartsWith(line->string, Str8Lit("f ")))  { vertices_size_estimate += 3; }
+  Str8LineIterInit(&lines, file_str);
+  while (Str8LineIterNext(&lines, &line)) {
+    if      (Str8StartsWith(line, Str8Lit("v ")))  { obj_points_size++;           }
+    else if (Str8StartsWith(line, Str8Lit("vn "))) { obj_normals_size++;          }
+    else if (Str8StartsWith(line, Str8Lit("vt "))) { obj_uvs_size++;              }
+    else if (Str8StartsWith(line, Str8Lit("f ")))  { vertices_size_estimate += 3; }
   }
   if (obj_points_size == 0) { goto mesh_load_obj_end; }
 
@@ -86,36 +95,36 @@ B32 ModelLoadObj(Arena* arena, Model* model, U8* file_data, U32 file_data_size)
   S32 obj_points_idx  = 0;
   S32 obj_normals_idx = 0;
   S32 obj_uvs_idx     = 0;
-#define NEXT_F32(f, node) \
-    node = node->next;    \
-    if (node == NULL) {   \
-      LOG_ERROR("[MESH] OBJ file malformed; expected string where there was none. For line: %.*s", line->string.size, line->string.str); \
-      goto mesh_load_obj_end; \
-    }                     \
-    Str8ToF32(node->string, &f);
-  for (String8ListNode* line = lines.head; line != NULL; line = line->next) {
-    String8List line_parts = Str8Split(temp_arena, line->string, ' ');
-    String8ListNode* line_part = line_parts.head;
-    if (Str8Eq(line_part->string, Str8Lit("v"))) {
+#define NEXT_F32(f, tokens)                           \
+    if (!Str8TokenIterNext(&tokens, &line_part)) {    \
+      LOG_ERROR("[MESH] OBJ file malformed; expected string where there was none. For line: %.*s", line.size, line.str); \
+      goto mesh_load_obj_end;                         \
+    }                                                 \
+    Str8ToF32(line_part, &f);
+  Str8LineIterInit(&lines, file_str);
+  while (Str8LineIterNext(&lines, &line)) {
+    Str8TokenIterReset(&line_parts, line);
+    if (!Str8TokenIterNext(&line_parts, &line_part)) { continue; }
+    if (Str8Eq(line_part, Str8Lit("v"))) {
       V3 point;
-      NEXT_F32(point.x, line_part);
-      NEXT_F32(point.y, line_part);
-      NEXT_F32(point.z, line_part);
+      NEXT_F32(point.x, line_parts);
+      NEXT_F32(point.y, line_parts);
+      NEXT_F32(point.z, line_parts);
       obj_points[obj_points_idx++] = point;
 
-    } else if (Str8Eq(line_part->string, Str8Lit("vn"))) {
+    } else if (Str8Eq(line_part, Str8Lit("vn"))) {
       V3 normal;
-      NEXT_F32(normal.x, line_part);
-      NEXT_F32(normal.y, line_part);
-      NEXT_F32(normal.z, line_part);
+      NEXT_F32(normal.x, line_parts);
+      NEXT_F32(normal.y, line_parts);
+      NEXT_F32(normal.z, line_parts);
       obj_normals[obj_normals_idx++] = normal;
 
-    } else if (Str8Eq(line_part->string, Str8Lit("vt"))) {
+    } else if (Str8Eq(line_part, Str8Lit("vt"))) {
       V2 uv;
-      NEXT_F32(uv.u, line_part);
-      NEXT_F32(uv.v, line_part);
-      if (line_part->next != NULL) {
-        LOG_ERROR("[MESH] OBJ importer does not support 3-part texture coordinates. For line: %.*s", line->string.size, line->string.str);
+      NEXT_F32(uv.u, line_parts);
+      NEXT_F32(uv.v, line_parts);
+      if (Str8TokenIterNext(&line_parts, &line_part)) {
+        LOG_ERROR("[MESH] OBJ importer does not support 3-part texture coordinates. For line: %.*s", line.size, line.str);
         goto mesh_load_obj_end;
       }
       obj_uvs[obj_uvs_idx++] = uv;
@@ -129,30 +138,30 @@ B32 ModelLoadObj(Arena* arena, Model* model, U8* file_data, U32 file_data_size)
   mesh->points  = ARENA_PUSH_ARRAY(arena, V3, vertices_size_estimate);
   if (obj_normals_size > 0) { mesh->normals = ARENA_PUSH_ARRAY(arena, V3, vertices_size_estimate); }
   if (obj_uvs_size > 0)     { mesh->uvs = ARENA_PUSH_ARRAY(arena, V2, vertices_size_estimate);     }
-  for (String8ListNode* line = lines.head; line != NULL; line = line->next) {
-    if (!Str8StartsWith(line->string, Str8Lit("f "))) { continue; }
-    String8List line_parts = Str8Split(temp_arena, line->string, ' ');
+  Str8LineIterInit(&lines, file_str);
+  while (Str8LineIterNext(&lines, &line)) {
+    if (!Str8StartsWith(line, Str8Lit("f "))) { continue; }
+    Str8TokenIterReset(&line_parts, Str8Substring(line, 2, line.size));
     U32 face_vertices_size = 0;
-    for (String8ListNode* line_part = line_parts.head->next; line_part != NULL; line_part = line_part->next) {
-      String8List face_parts = Str8Split(temp_arena, line_part->string, '/');
-      DEBUG_ASSERT(face_parts.head != NULL);
+    while (Str8TokenIterNext(&line_parts, &line_part)) {
+      String8SplitIter face_parts;
+      String8 face_part;
+      Str8SplitIterInit(&face_parts, line_part, '/');
 
       // NOTE: parse face point vertex/uv/normal
       S32 point_idx  = -1;
       S32 uv_idx     = -1;
       S32 normal_idx = -1;
-      String8ListNode* face_part = face_parts.head;;
-      Str8ToS32(face_part->string, &point_idx);
+      DEBUG_ASSERT(Str8SplitIterNext(&face_parts, &face_part));
+      Str8ToS32(face_part, &point_idx);
       point_idx -= 1;
-      face_part = face_part->next;
-      if (face_part != NULL) {
-        if (face_part->string.size > 0) {
-          Str8ToS32(face_part->string, &uv_idx);
+      if (Str8SplitIterNext(&face_parts, &face_part)) {
+        if (face_part.size > 0) {
+          Str8ToS32(face_part, &uv_idx);
           uv_idx -= 1;
         }
-        face_part = face_part->next;
-        if (face_part != NULL) {
-          Str8ToS32(face_part->string, &normal_idx);
+        if (Str8SplitIterNext(&face_parts, &face_part)) {
+          Str8ToS32(face_part, &normal_idx);
           normal_idx -= 1;
         }
       }
@@ -185,7 +194,7 @@ B32 ModelLoadObj(Arena* arena, Model* model, U8* file_data, U32 file_data_size)
 
       // TODO: support this
       if (++face_vertices_size > 3) {
-        LOG_ERROR("[MESH] OBJ importer does not support defining more than 3 vertices per face face. For line: %.*s", line->string.size, line->string.str);
+        LOG_ERROR("[MESH] OBJ importer does not support defining more than 3 vertices per face face. For line: %.*s", line.size, line.str);
         goto mesh_load_obj_end;
       }
     }
@@ -217,6 +226,7 @@ B32 ModelLoadObj(Arena* arena, Model* model, U8* file_data, U32 file_data_size)
 mesh_load_obj_end:
   ArenaRelease(temp_arena);
   if (!success) { ArenaPopTo(arena, arena_pos); }
+  CDEFAULT_PROFILE_END(MODEL_LOAD_OBJ);
   return success;
 }
 
@@ -680,6 +690,8 @@ gltf_mesh_parse_exit:
 
 #define BIN_CATCH MODEL_LOG_OUT_OF_CHARS(); goto mesh_load_glb_exit;
 B32 ModelLoadGlb(Arena* arena, Model* model, U8* file_data, U32 file_data_size) {
+  CDEFAULT_PROFILE_START(MODEL_LOAD_GLB);
+  PROFILE_ADD_BYTES(file_data_size);
   MEMORY_ZERO_STRUCT(model);
   U64 arena_base = ArenaPos(arena);
   Arena* temp_arena = ArenaAllocate();
@@ -690,7 +702,7 @@ B32 ModelLoadGlb(Arena* arena, Model* model, U8* file_data, U32 file_data_size)
   // NOTE: header
   U32 magic_number, version;
   BIN_TRY(BinStreamPullU32LE(&s, &magic_number));
-  if (magic_number != 0x46546C67) { return false; }
+  if (magic_number != 0x46546C67) { goto mesh_load_glb_exit; }
   BIN_TRY(BinStreamPullU32LE(&s, &version));
   if (version != 2) {
     LOG_WARN("[MESH] For GLTF, only version 2 is supported, detected version: %d", version);
@@ -827,6 +839,7 @@ B32 ModelLoadGlb(Arena* arena, Model* model, U8* file_data, U32 file_data_size)
 mesh_load_glb_exit:
   ArenaRelease(temp_arena);
   if (!success) { ArenaPopTo(arena, arena_base); }
+  CDEFAULT_PROFILE_END(MODEL_LOAD_GLB);
   return success;
 }
 #undef BIN_CATCH
@@ -837,14 +850,18 @@ B32 ModelLoad(Arena* arena, Model* model, U8* file_data, U32 file_data_size) {
   return false;
 }
 
+// NOTE: the file is only needed while parsing, so map it rather than copying it into an arena.
 B32 ModelLoadFile(Arena* arena, Model* model, String8 file_path) {
   B32 success = false;
-  String8 file_data;
-  Arena* file_arena = ArenaAllocate();
-  if (!FileReadAll(file_arena, file_path, &file_data.str, &file_data.size)) { goto mesh_load_file_exit; }
-  success = ModelLoad(arena, model, file_data.str, file_data.size);
+  FileMap file_map;
+  if (!FileMapOpen(file_path, &file_map, FileMapHint_Sequential)) { return false; }
+  if (file_map.size > U32_MAX) {
+    LOG_ERROR("[MODEL] File is too large to load: %S", file_path);
+    goto mesh_load_file_exit;
+  }
+  success = ModelLoad(arena, model, file_map.data, file_map.size);
 mesh_load_file_exit:
-  ArenaRelease(file_arena);
+  DEBUG_ASSERT(FileMapClose(&file_map));
   return success;
 }
 
@@ -893,6 +910,133 @@ B32 MeshCopy(Arena* arena, Mesh* dest, Mesh* src) {
   return true;
 }
 
+// NOTE: a baked model is a ModelPackHeader, then per mesh a MeshPackHeader followed by its arrays, in the order of
+// MeshPackHeader's fields. Every section starts on a MODEL_PACK_ALIGNMENT boundary.
+#define MODEL_PACK_ALIGNMENT 16
+
+typedef struct ModelPackHeader ModelPackHeader;
+struct ModelPackHeader {
+  U32 meshes_size;
+  U32 _pad[3];
+};
+
+typedef struct MeshPackHeader MeshPackHeader;
+struct MeshPackHeader {
+  U32 vertices_size;
+  U32 indices_size;
+  U32 has_normals;
+  U32 has_uvs;
+  U32 has_texture;
+  U32 texture_format;
+  U32 texture_width;
+  U32 texture_height;
+};
+
+// NOTE: pack entries start PACK_DATA_ALIGNMENT aligned, so padding each section keeps the next one aligned too.
+static B32 ModelPackPut(PackWriter* writer, void* data, U64 data_size) {
+  static U8 zeros[MODEL_PACK_ALIGNMENT];
+  U64 pad = ALIGN_POW_2(data_size, MODEL_PACK_ALIGNMENT) - data_size;
+  return PackWriterAppend(writer, (U8*) data, data_size) && PackWriterAppend(writer, zeros, pad);
+}
+
+static B32 ModelPackWrite(PackWriter* writer, Model* model) {
+  ModelPackHeader model_header;
+  MEMORY_ZERO_STRUCT(&model_header);
+  for (Mesh* mesh = model->meshes; mesh != NULL; mesh = mesh->next) { model_header.meshes_size++; }
+  if (!ModelPackPut(writer, &model_header, sizeof(model_header))) { return false; }
+  for (Mesh* mesh = model->meshes; mesh != NULL; mesh = mesh->next) {
+    MeshPackHeader header;
+    MEMORY_ZERO_STRUCT(&header);
+    header.vertices_size  = mesh->vertices_size;
+    header.indices_size   = mesh->indices_size;
+    header.has_normals    = mesh->normals != NULL;
+    header.has_uvs        = mesh->uvs != NULL;
+    header.has_texture    = mesh->texture.data != NULL;
+    header.texture_format = mesh->texture.format;
+    header.texture_width  = header.has_texture ? mesh->texture.width : 0;
+    header.texture_height = header.has_texture ? mesh->texture.height : 0;
+    if (!ModelPackPut(writer, &header, sizeof(header))) { return false; }
+    if (!ModelPackPut(writer, mesh->points, sizeof(V3) * mesh->vertices_size)) { return false; }
+    if (header.has_normals && !ModelPackPut(writer, mesh->normals, sizeof(V3) * mesh->vertices_size)) { return false; }
+    if (header.has_uvs && !ModelPackPut(writer, mesh->uvs, sizeof(V2) * mesh->vertices_size)) { return false; }
+    if (!ModelPackPut(writer, mesh->indices, sizeof(U32) * mesh->indices_size)) { return false; }
+    if (header.has_texture &&
+        !ModelPackPut(writer, mesh->texture.data, (U64) header.texture_width * header.texture_height * ImageBytesPerPixel(mesh->texture.format))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+B32 ModelPackAdd(PackWriter* writer, String8 name, Model* model) {
+  for (Mesh* mesh = model->meshes; mesh != NULL; mesh = mesh->next) {
+    if (mesh->points == NULL || mesh->indices == NULL) {
+      LOG_ERROR("[MESH] ModelPackAdd failed; mesh vertices or indices are NULL.");
+      return false;
+    }
+  }
+  return PackWriterBegin(writer, name) && ModelPackWrite(writer, model) && PackWriterEnd(writer);
+}
+
+// NOTE: returns NULL if the section would run past the end of the entry.
+static void* ModelPackTake(U8* data, U64 data_size, U64* pos, U64 size) {
+  if (*pos > data_size || size > data_size - *pos) { return NULL; }
+  void* result = data + *pos;
+  *pos = ALIGN_POW_2(*pos + size, MODEL_PACK_ALIGNMENT);
+  return result;
+}
+
+B32 ModelPackGet(Arena* arena, Pack* pack, String8 name, Model* model) {
+  U8* data;
+  U64 data_size;
+  if (!PackGet(pack, name, &data, &data_size)) { return false; }
+  U64 arena_base = ArenaPos(arena);
+  B32 success    = false;
+  MEMORY_ZERO_STRUCT(model);
+
+  U64 pos = 0;
+  Mesh* meshes_tail = NULL;
+  ModelPackHeader* model_header = (ModelPackHeader*) ModelPackTake(data, data_size, &pos, sizeof(ModelPackHeader));
+  if (model_header == NULL) { goto model_pack_get_exit; }
+  for (U32 i = 0; i < model_header->meshes_size; i++) {
+    MeshPackHeader* header = (MeshPackHeader*) ModelPackTake(data, data_size, &pos, sizeof(MeshPackHeader));
+    if (header == NULL || (header->has_texture && header->texture_format > ImageFormat_R)) { goto model_pack_get_exit; }
+    Mesh* mesh = ARENA_PUSH_STRUCT(arena, Mesh);
+    MEMORY_ZERO_STRUCT(mesh);
+    mesh->vertices_size = header->vertices_size;
+    mesh->indices_size  = header->indices_size;
+    mesh->points = (V3*) ModelPackTake(data, data_size, &pos, sizeof(V3) * header->vertices_size);
+    if (mesh->points == NULL) { goto model_pack_get_exit; }
+    if (header->has_normals) {
+      mesh->normals = (V3*) ModelPackTake(data, data_size, &pos, sizeof(V3) * header->vertices_size);
+      if (mesh->normals == NULL) { goto model_pack_get_exit; }
+    }
+    if (header->has_uvs) {
+      mesh->uvs = (V2*) ModelPackTake(data, data_size, &pos, sizeof(V2) * header->vertices_size);
+      if (mesh->uvs == NULL) { goto model_pack_get_exit; }
+    }
+    mesh->indices = (U32*) ModelPackTake(data, data_size, &pos, sizeof(U32) * header->indices_size);
+    if (mesh->indices == NULL) { goto model_pack_get_exit; }
+    if (header->has_texture) {
+      mesh->texture.format = (ImageFormat) header->texture_format;
+      mesh->texture.width  = header->texture_width;
+      mesh->texture.height = header->texture_height;
+      mesh->texture.data   = (U8*) ModelPackTake(data, data_size, &pos, (U64) header->texture_width * header->texture_height * ImageBytesPerPixel(mesh->texture.format));
+      if (mesh->texture.data == NULL) { goto model_pack_get_exit; }
+    }
+    SLL_QUEUE_PUSH_BACK(model->meshes, meshes_tail, mesh, next);
+  }
+  success = true;
+
+model_pack_get_exit:
+  if (!success) {
+    LOG_ERROR("[MESH] Asset pack entry is not a baked model: %S", name);
+    ArenaPopTo(arena, arena_base);
+    MEMORY_ZERO_STRUCT(model);
+  }
+  return success;
+}
+
 #undef MODEL_LOG_OUT_OF_CHARS
 
 #endif // CDEFAULT_MODEL_IMPLEMENTATION
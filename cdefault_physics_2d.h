@@ -4,6 +4,7 @@
 #include "cdefault_geometry.h"
 #include "cdefault_math.h"
 #include "cdefault_std.h"
+#include "cdefault_profile.h"
 
 // TODO: feature parity w/ 3d physics
 
@@ -529,8 +530,11 @@ void Physics2ConfigRigidBodies(U32 iterations, F32 penetration_slop, F32 pos_cor
 }
 
 void Physics2Update(F32 dt_s) {
+  CDEFAULT_PROFILE_START(PHYSICS2_UPDATE);
   Physics2Context* c = &_cdef_phys_2d_context;
+  CDEFAULT_PROFILE_START(PHYSICS2_INTEGRATE);
   Physics2RigidBodyUpdate(dt_s);
+  CDEFAULT_PROFILE_END(PHYSICS2_INTEGRATE);
 
   for (U32 iteration = 0; iteration < c->iterations; iteration++) {
     for (Collider2Internal* a_internal = c->collider_head; a_internal->next != NULL; a_internal = a_internal->next) {
@@ -542,8 +546,14 @@ void Physics2Update(F32 dt_s) {
         // TODO: separate? acceleration structure? maybe just presort along one axis?
         // TODO: multithread?
         IntersectManifold2 manifold;
-        if (!Collider2IntersectBroad(a, b, &manifold)) { continue; }
-        if (!Collider2IntersectNarrow(a, b, &manifold)) { continue; }
+        CDEFAULT_PROFILE_START(PHYSICS2_BROAD);
+        B32 is_broad_intersecting = Collider2IntersectBroad(a, b, &manifold);
+        CDEFAULT_PROFILE_END(PHYSICS2_BROAD);
+        if (!is_broad_intersecting) { continue; }
+        CDEFAULT_PROFILE_START(PHYSICS2_NARROW);
+        B32 is_narrow_intersecting = Collider2IntersectNarrow(a, b, &manifold);
+        CDEFAULT_PROFILE_END(PHYSICS2_NARROW);
+        if (!is_narrow_intersecting) { continue; }
 
         Collision2 collision;
         collision.a = a;
@@ -568,11 +578,14 @@ void Physics2Update(F32 dt_s) {
       }
     }
 
+    CDEFAULT_PROFILE_START(PHYSICS2_RESOLVE);
     for (Physics2ResolverEntry* resolver = c->resolvers; resolver != NULL; resolver = resolver->next) {
       resolver->fn(resolver->collisions, resolver->collisions_size);
       resolver->collisions_size = 0;
     }
+    CDEFAULT_PROFILE_END(PHYSICS2_RESOLVE);
   }
+  CDEFAULT_PROFILE_END(PHYSICS2_UPDATE);
 }
 
 void Physics2SetGravity(V2 gravity) {
@@ -4,12 +4,51 @@
 #include "cdefault_std.h"
 
 // NOTE: Block profiling is enabled by #defining PROFILE.
+// Event tracing (a timeline of every block, see ProfileDumpChromeTrace) is additionally enabled by #defining PROFILE_TRACE.
+// Hardware performance counters (see ProfileCounter) are additionally enabled by #defining PROFILE_PMC.
+// Duration histograms (see ProfileHistogramTrack) are additionally enabled by #defining PROFILE_HISTOGRAM.
+// cdefault's own hot paths (see CDEFAULT_PROFILE_REGISTRY) are additionally instrumented by #defining CDEFAULT_PROFILE_INTERNAL.
 
 // NOTE: ProfileMetricType_Count is used to size static arrays, so add a dummy counter if the user hasn't defined a registry.
 #ifndef PROFILE_REGISTRY
 #define PROFILE_REGISTRY(PROFILE_METRIC) PROFILE_METRIC(DUMMY)
 #endif
 
+// NOTE: cdefault's own expensive routines are instrumented with library-owned metrics, which are only compiled in if
+// CDEFAULT_PROFILE_INTERNAL is #defined (along with PROFILE). They're appended after the user's registry and prefixed
+// with CDEFAULT_ so they can't collide with user metrics, and otherwise behave like any other metric, e.g.
+// ProfileGetAnchor(CDEFAULT_JSON_PARSE). Library code marks them with CDEFAULT_PROFILE_START / CDEFAULT_PROFILE_END.
+#if defined(PROFILE) && defined(CDEFAULT_PROFILE_INTERNAL)
+#  define CDEFAULT_PROFILE_REGISTRY(PROFILE_METRIC) \
+     PROFILE_METRIC(CDEFAULT_JSON_PARSE)              \
+     PROFILE_METRIC(CDEFAULT_IMAGE_LOAD_BMP)          \
+     PROFILE_METRIC(CDEFAULT_IMAGE_LOAD_PNG)          \
+     PROFILE_METRIC(CDEFAULT_FONT_ATLAS_BAKE_BITMAP)  \
+     PROFILE_METRIC(CDEFAULT_FONT_ATLAS_BAKE_SDF)     \
+     PROFILE_METRIC(CDEFAULT_MODEL_LOAD_OBJ)          \
+     PROFILE_METRIC(CDEFAULT_MODEL_LOAD_GLB)          \
+     PROFILE_METRIC(CDEFAULT_PHYSICS2_UPDATE)         \
+     PROFILE_METRIC(CDEFAULT_PHYSICS2_INTEGRATE)      \
+     PROFILE_METRIC(CDEFAULT_PHYSICS2_BROAD)          \
+     PROFILE_METRIC(CDEFAULT_PHYSICS2_NARROW)         \
+     PROFILE_METRIC(CDEFAULT_PHYSICS2_RESOLVE)        \
+     PROFILE_METRIC(CDEFAULT_GJK3)                    \
+     PROFILE_METRIC(CDEFAULT_EPA3)                    \
+     PROFILE_METRIC(CDEFAULT_UI_END)                  \
+     PROFILE_METRIC(CDEFAULT_UI_LAYOUT)               \
+     PROFILE_METRIC(CDEFAULT_DRAW_SHAPE_2D)           \
+     PROFILE_METRIC(CDEFAULT_DRAW_IMAGE)              \
+     PROFILE_METRIC(CDEFAULT_DRAW_GLYPH)              \
+     PROFILE_METRIC(CDEFAULT_DRAW_LINE_3D)            \
+     PROFILE_METRIC(CDEFAULT_DRAW_MODEL)
+#  define CDEFAULT_PROFILE_START(metric) _ProfileBlockStart(ProfileMetricType_CDEFAULT_##metric)
+#  define CDEFAULT_PROFILE_END(metric)   _ProfileBlockEnd(ProfileMetricType_CDEFAULT_##metric)
+#else
+#  define CDEFAULT_PROFILE_REGISTRY(PROFILE_METRIC)
+#  define CDEFAULT_PROFILE_START(metric)
+#  define CDEFAULT_PROFILE_END(metric)
+#endif
+
 // NOTE: The user is expected to register macros before #including this header the following way:
 // #define PROFILE_REGISTRY(PROFILE_METRIC) \
 //   PROFILE_METRIC(METRIC_1) \
@@ -19,6 +58,7 @@
 typedef enum ProfileMetricType ProfileMetricType;
 enum ProfileMetricType {
   PROFILE_REGISTRY(PROFILE_DEFINE_METRIC_ENUM)
+  CDEFAULT_PROFILE_REGISTRY(PROFILE_DEFINE_METRIC_ENUM)
   ProfileMetricType_Count,
 };
 
@@ -27,6 +67,7 @@ enum ProfileMetricType {
 #define PROFILE_DEFINE_METRIC_STR8(metric) Str8Static(#metric),
 static String8 ProfileMetricType_Names[ProfileMetricType_Count] = {
   PROFILE_REGISTRY(PROFILE_DEFINE_METRIC_STR8)
+  CDEFAULT_PROFILE_REGISTRY(PROFILE_DEFINE_METRIC_STR8)
 };
 
 // NOTE: Profiling is inherently stack-shaped. Therefore, when profiling a section, unless it
@@ -38,39 +79,205 @@ static String8 ProfileMetricType_Names[ProfileMetricType_Count] = {
 // elapsed_exclusive measures time that is unique *only* to that given metric / anchor --
 // A's elapsed_exclusive does not contain any of the times B is measured. elapsed_inclusive conversely
 // does include the overlap time. in the case of recursive calls, only the top-level time is maintained.
+// NOTE: With PROFILE_PMC, each thread opens a group of hardware counters the first time it profiles, and anchors
+// accumulate them like elapsed_inclusive. Only Linux (perf_event_open) is supported; counters are read with rdpmc
+// on x64 when the kernel allows it, otherwise with a single group read() per block boundary. If the counters can't be
+// opened (perf_event_paranoid, no PMU in a VM, other OSes, ...), profiling still works and the counters read as 0.
+// ProfileCountersAvailable reports whether the calling thread's counters are live.
+typedef enum ProfileCounter ProfileCounter;
+enum ProfileCounter {
+  ProfileCounter_Cycles,
+  ProfileCounter_Instructions,
+  ProfileCounter_L1dMisses,
+  ProfileCounter_LlcMisses,
+  ProfileCounter_BranchMisses,
+  ProfileCounter_Count,
+};
+
 typedef struct ProfileAnchor ProfileAnchor;
 struct ProfileAnchor {
   U64 num_hits;
   U64 elapsed_exclusive; // Does not include child-anchor times.
   U64 elapsed_inclusive; // Includes child-anchor times.
+  U64 processed_bytes;   // Bytes attributed to this anchor via PROFILE_START_BANDWIDTH / PROFILE_ADD_BYTES.
+  U64 counters[ProfileCounter_Count]; // Includes child-anchor counts.
 };
 
 // NOTE: Surround critical blocks with PROFILE_START / PROFILE_END to time them.
+// PROFILE_START_BANDWIDTH additionally attributes a number of processed bytes to the metric, so reports can show
+// throughput. PROFILE_ADD_BYTES attributes bytes to the calling thread's innermost open block (if any); cdefault's
+// loaders (e.g. FileReadAll, JsonParse, ImageLoadPng) use it to report the size of their input, so e.g. a block around
+// JsonParseFromFile counts the file's bytes twice -- once read, once parsed.
 #ifdef PROFILE
-#  define PROFILE_START(metric)  _ProfileBlockStart(ProfileMetricType_##metric)
-#  define PROFILE_END(metric)    _ProfileBlockEnd(ProfileMetricType_##metric)
+#  define PROFILE_START(metric)                  _ProfileBlockStart(ProfileMetricType_##metric)
+#  define PROFILE_START_BANDWIDTH(metric, bytes) _ProfileBlockStartBandwidth(ProfileMetricType_##metric, bytes)
+#  define PROFILE_END(metric)                    _ProfileBlockEnd(ProfileMetricType_##metric)
+#  define PROFILE_ADD_BYTES(bytes)               _ProfileAddBytes(bytes)
 #else
 #  define PROFILE_START(metric)
+#  define PROFILE_START_BANDWIDTH(metric, bytes)
 #  define PROFILE_END(metric)
+#  define PROFILE_ADD_BYTES(bytes)
+#endif
+
+// NOTE: Profiling is thread safe. Each thread records into its own anchor table, which is registered
+// the first time the thread starts a block (or calls ProfileThreadIndex). Tables outlive their threads,
+// so they can be inspected after a join. Once PROFILE_MAX_THREADS threads have registered, new threads
+// reuse the tables of exited threads and add to their anchors, so totals still cover every thread. If
+// none have exited, the new thread isn't profiled (and ProfileThreadIndex returns PROFILE_MAX_THREADS).
+// On windows, threads that first profile from inside a fiber never give up their table.
+//
+// ProfileGetAnchor / ProfileMerge sum each metric over all threads (so elapsed times are total CPU
+// time, not wall time). ProfileGetAnchorForThread returns a single thread's anchor. Reading other
+// threads' tables (and ProfileReset) should happen while those threads aren't profiling.
+#ifndef PROFILE_MAX_THREADS
+#  define PROFILE_MAX_THREADS 256
 #endif
 
+// NOTE: Anchor times are in cpu timer ticks (rdtsc). ProfileCpuTimerFrequency estimates the tick rate against the OS
+// timer once (~10ms, first done in ProfileReset) and caches it, which the functions below use to convert to seconds.
+U64 ProfileCpuTimerFrequency();
+F64 ProfileCyclesToSeconds(U64 cycles);
+F64 ProfileAnchorToSeconds(ProfileAnchor anchor); // NOTE: The anchor's inclusive time.
+
+// NOTE: A report is a snapshot of every metric with at least one hit (summed over all threads), sorted by descending
+// inclusive time. Percentages are relative to total_seconds, the sum of all exclusive times (i.e. the time spent in
+// profiled blocks). Print it with e.g. LOG_INFO("%S", ProfileReportToString(arena, &report)).
+typedef struct ProfileReportEntry ProfileReportEntry;
+struct ProfileReportEntry {
+  String8 name;
+  ProfileAnchor anchor;
+  F64 inclusive_seconds;
+  F64 exclusive_seconds;
+  F64 inclusive_percent;
+  F64 exclusive_percent;
+  F64 inclusive_seconds_per_hit;
+  F64 exclusive_seconds_per_hit;
+  F64 gb_per_second; // NOTE: processed_bytes over inclusive time, 0 if no bytes were attributed.
+  F64 instructions_per_cycle; // NOTE: 0 if hardware counters weren't available.
+};
+
+typedef struct ProfileReport ProfileReport;
+struct ProfileReport {
+  ProfileReportEntry* entries;
+  U32 entries_size;
+  F64 total_seconds;
+  U64 cpu_timer_frequency;
+};
+
+void    ProfileReportGet(Arena* arena, ProfileReport* report);
+String8 ProfileReportToString(Arena* arena, ProfileReport* report); // NOTE: A human readable table.
+String8 ProfileReportToCsv(Arena* arena, ProfileReport* report);    // NOTE: One header row, then one row per entry.
+String8 ProfileReportToJson(Arena* arena, ProfileReport* report);   // NOTE: { "total_seconds", "cpu_timer_frequency", "entries": [...] }
+
 void ProfileReset();
+B32  ProfileCountersAvailable();
 #define ProfileGetAnchor(metric) _ProfileGetAnchor(ProfileMetricType_##metric)
+#define ProfileGetAnchorForThread(metric, thread_idx) _ProfileGetAnchorForThread(ProfileMetricType_##metric, thread_idx)
+void ProfileMerge(ProfileAnchor* anchors); // NOTE: anchors must have room for ProfileMetricType_Count entries.
+U32  ProfileThreadCount();
+U32  ProfileThreadIndex(); // NOTE: The calling thread's index, for ProfileGetAnchorForThread.
+// NOTE: With PROFILE_TRACE, every block start / end is also recorded into a per-thread ring of PROFILE_TRACE_EVENTS
+// events (must be a power of 2). Recording is lock-free and never allocates; once a ring is full, the oldest events
+// are overwritten, so a trace holds the most recent PROFILE_TRACE_EVENTS / 2 blocks of each thread.
+//
+// ProfileDumpChromeTrace writes the retained events in the Trace Event JSON format, which can be loaded with
+// chrome://tracing or https://ui.perfetto.dev. Like ProfileReset, call it while no other thread is profiling.
+#ifndef PROFILE_TRACE_EVENTS
+#  define PROFILE_TRACE_EVENTS KB(64)
+#endif
+
+B32 ProfileDumpChromeTrace(String8 file_path);
+
+// NOTE: With PROFILE_HISTOGRAM, tracked metrics also record the distribution of their durations, so e.g. p99 frame
+// spikes are visible instead of being averaged away. Each thread records into its own log-linear (HDR style)
+// histogram per tracked metric: 2^PROFILE_HISTOGRAM_PRECISION_BITS linear sub-buckets per power of 2, so values are
+// kept to within 1 / 2^PROFILE_HISTOGRAM_PRECISION_BITS relative error (~3% by default) in a fixed ~15KB, and
+// recording is O(1). Histograms are allocated the first time a thread records into them.
+//
+// ProfileFrameBoundary marks the end of a frame on the calling thread. It records the frame's duration (see
+// ProfileGetFrameStats) and, for metrics tracked with ProfileHistogramMode_PerFrame, their total inclusive time in the
+// frame (a block is counted in the frame it ends in). Track metrics before profiling them. Stats are in seconds and
+// merged over all threads; like ProfileReset, read them while no other thread is profiling.
+#ifndef PROFILE_HISTOGRAM_PRECISION_BITS
+#  define PROFILE_HISTOGRAM_PRECISION_BITS 5
+#endif
+
+typedef enum ProfileHistogramMode ProfileHistogramMode;
+enum ProfileHistogramMode {
+  ProfileHistogramMode_None,
+  ProfileHistogramMode_PerHit,   // NOTE: Records every block's duration.
+  ProfileHistogramMode_PerFrame, // NOTE: Records the metric's time per frame.
+};
+
+typedef struct ProfileHistogramStats ProfileHistogramStats;
+struct ProfileHistogramStats {
+  U64 count;
+  F64 min;
+  F64 max;
+  F64 mean;
+  F64 stddev;
+  F64 p50;
+  F64 p90;
+  F64 p99;
+  F64 p999;
+};
+
+#define ProfileHistogramTrack(metric, mode) _ProfileHistogramTrack(ProfileMetricType_##metric, mode)
+#define ProfileGetHistogramStats(metric)    _ProfileGetHistogramStats(ProfileMetricType_##metric)
+void ProfileFrameBoundary();
+ProfileHistogramStats ProfileGetFrameStats();
+void _ProfileHistogramTrack(ProfileMetricType metric, ProfileHistogramMode mode);
+ProfileHistogramStats _ProfileGetHistogramStats(ProfileMetricType metric);
 ProfileAnchor _ProfileGetAnchor(ProfileMetricType metric);
+ProfileAnchor _ProfileGetAnchorForThread(ProfileMetricType metric, U32 thread_idx);
 volatile void _ProfileBlockStart(ProfileMetricType metric);
+volatile void _ProfileBlockStartBandwidth(ProfileMetricType metric, U64 bytes);
 volatile void _ProfileBlockEnd(ProfileMetricType metric);
+void _ProfileAddBytes(U64 bytes);
 
 #endif // CDEFAULT_PROFILE_H_
 
 #ifdef CDEFAULT_PROFILE_IMPLEMENTATION
 #undef CDEFAULT_PROFILE_IMPLEMENTATION
 
+#include "cdefault_io.h"
+#include "cdefault_math.h"
+
+#if defined(PROFILE_PMC) && defined(OS_LINUX)
+#  include <linux/perf_event.h>
+#endif
+
 typedef struct ProfileBlock ProfileBlock;
 struct ProfileBlock {
   U32 parent_index;
   ProfileMetricType metric;
   U64 start;
   U64 elapsed_inclusive_snapshot;
+#ifdef PROFILE_PMC
+  U64 counters_start[ProfileCounter_Count];
+  U64 counters_snapshot[ProfileCounter_Count];
+#endif
+};
+
+typedef struct ProfileEvent ProfileEvent;
+struct ProfileEvent {
+  U64 tsc;
+  U32 metric;
+  B32 is_end;
+};
+
+#define PROFILE_HISTOGRAM_SUB_BUCKETS (1 << PROFILE_HISTOGRAM_PRECISION_BITS)
+#define PROFILE_HISTOGRAM_BUCKETS     ((64 - PROFILE_HISTOGRAM_PRECISION_BITS + 1) * PROFILE_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct ProfileHistogram ProfileHistogram;
+struct ProfileHistogram {
+  U64 count;
+  U64 min;
+  U64 max;
+  F64 sum;
+  F64 sum_squares;
+  U64 buckets[PROFILE_HISTOGRAM_BUCKETS];
 };
 
 typedef struct ProfileContext ProfileContext;
@@ -78,41 +285,783 @@ struct ProfileContext {
   ProfileAnchor profile_zones[ProfileMetricType_Count];
   ProfileBlock profile_block_stack[128];
   U32 next_profile_block;
+#ifdef PROFILE_TRACE
+  U64 trace_events_size; // NOTE: Total events recorded, the ring holds the last PROFILE_TRACE_EVENTS of them.
+  ProfileEvent trace_events[PROFILE_TRACE_EVENTS];
+#endif
+#ifdef PROFILE_PMC
+  B32 pmc_is_open;
+#  if defined(OS_LINUX)
+  S32 pmc_fds[ProfileCounter_Count]; // NOTE: pmc_fds[0] is the group leader.
+  struct perf_event_mmap_page* pmc_pages[ProfileCounter_Count];
+  B32 pmc_use_rdpmc;
+#  endif
+#endif
+#ifdef PROFILE_HISTOGRAM
+  ProfileHistogram* histograms[ProfileMetricType_Count];
+  ProfileHistogram* frame_histogram;
+  U64 frame_start;
+  U64 frame_snapshots[ProfileMetricType_Count]; // NOTE: elapsed_inclusive as of the last frame boundary.
+#endif
+  AtomicB32 is_free; // NOTE: Set once the owning thread exits, so another thread may reuse the table.
 };
-static ProfileContext _profile_context;
+
+// NOTE: Contexts get their own pages, so threads never share cache lines.
+static THREAD_LOCAL ProfileContext* _profile_context;
+static THREAD_LOCAL B32 _profile_context_is_unavailable;
+static ProfileContext* _profile_contexts[PROFILE_MAX_THREADS];
+static AtomicS32 _profile_contexts_size;
+static AtomicB32 _profile_exit_hook_claimed;
+static AtomicB32 _profile_exit_hook_ready;
+#if defined(OS_WINDOWS)
+static DWORD _profile_exit_hook;
+#else
+static tss_t _profile_exit_hook;
+#endif
+static ProfileHistogramMode _profile_histogram_modes[ProfileMetricType_Count];
 
 static volatile inline U64 ReadCpuTimer() {
   return __rdtsc();
 }
 
+#if defined(OS_WINDOWS)
+
+static U64 _ProfileOsTimerFrequency() {
+  LARGE_INTEGER freq;
+  QueryPerformanceFrequency(&freq);
+  return freq.QuadPart;
+}
+
+static U64 _ProfileReadOsTimer() {
+  LARGE_INTEGER value;
+  QueryPerformanceCounter(&value);
+  return value.QuadPart;
+}
+
+#else
+
+static U64 _ProfileOsTimerFrequency() {
+  return 1000000000;
+}
+
+static U64 _ProfileReadOsTimer() {
+  struct timespec value;
+  clock_gettime(CLOCK_MONOTONIC, &value);
+  return (U64) value.tv_sec * 1000000000 + value.tv_nsec;
+}
+
+#endif
+
+// NOTE: The cpu timer's frequency isn't exposed reliably by the OS, so count ticks over a short OS timer window.
+U64 ProfileCpuTimerFrequency() {
+  static U64 cpu_freq = 0;
+  if (cpu_freq != 0) { return cpu_freq; }
+  U64 os_freq = _ProfileOsTimerFrequency();
+  U64 os_wait = os_freq / 100;
+  U64 cpu_start = ReadCpuTimer();
+  U64 os_start = _ProfileReadOsTimer();
+  U64 os_elapsed = 0;
+  while (os_elapsed < os_wait) { os_elapsed = _ProfileReadOsTimer() - os_start; }
+  U64 cpu_elapsed = ReadCpuTimer() - cpu_start;
+  cpu_freq = (U64) ((F64) os_freq * (F64) cpu_elapsed / (F64) os_elapsed);
+  return cpu_freq;
+}
+
+#ifdef PROFILE_PMC
+#if defined(OS_LINUX)
+
+static void _ProfileCountersOpen(ProfileContext* ctx) {
+  static const U64 configs[ProfileCounter_Count][2] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  };
+  ctx->pmc_is_open = false;
+  ctx->pmc_use_rdpmc = false;
+  for (U32 i = 0; i < ProfileCounter_Count; i++) { ctx->pmc_fds[i] = -1; ctx->pmc_pages[i] = NULL; }
+
+  for (U32 i = 0; i < ProfileCounter_Count; i++) {
+    struct perf_event_attr attr;
+    MEMORY_ZERO_STRUCT(&attr);
+    attr.size = sizeof(attr);
+    attr.type = (U32) configs[i][0];
+    attr.config = configs[i][1];
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    S32 group_fd = i == 0 ? -1 : ctx->pmc_fds[0];
+    ctx->pmc_fds[i] = (S32) syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+    // NOTE: without the leader there's nothing to read. other counters may be unsupported by the PMU, those read as 0.
+    if (ctx->pmc_fds[0] < 0) { return; }
+  }
+  ctx->pmc_is_open = true;
+
+#if defined(ARCH_X64)
+  // NOTE: rdpmc requires the kernel to expose every counter's index via its mmap'd page.
+  ctx->pmc_use_rdpmc = true;
+  for (U32 i = 0; i < ProfileCounter_Count; i++) {
+    if (ctx->pmc_fds[i] < 0) { continue; }
+    void* page = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, ctx->pmc_fds[i], 0);
+    if (page == MAP_FAILED) { ctx->pmc_use_rdpmc = false; continue; }
+    ctx->pmc_pages[i] = (struct perf_event_mmap_page*) page;
+    if (!ctx->pmc_pages[i]->cap_user_rdpmc) { ctx->pmc_use_rdpmc = false; }
+  }
+#endif
+}
+
+static void _ProfileCountersClose(ProfileContext* ctx) {
+  for (U32 i = 0; i < ProfileCounter_Count; i++) {
+    if (ctx->pmc_pages[i] != NULL) { munmap(ctx->pmc_pages[i], sysconf(_SC_PAGESIZE)); }
+    if (ctx->pmc_fds[i] >= 0) { close(ctx->pmc_fds[i]); }
+    ctx->pmc_pages[i] = NULL;
+    ctx->pmc_fds[i] = -1;
+  }
+  ctx->pmc_is_open = false;
+  ctx->pmc_use_rdpmc = false;
+}
+
+#if defined(ARCH_X64)
+static inline U64 _ProfileRdpmc(struct perf_event_mmap_page* page) {
+  U32 seq, index;
+  U64 count;
+  do {
+    seq = page->lock;
+    __asm__ volatile("" ::: "memory");
+    index = page->index;
+    count = page->offset;
+    if (index != 0) {
+      U32 lo, hi;
+      __asm__ volatile("rdpmc" : "=a"(lo), "=d"(hi) : "c"(index - 1));
+      S64 pmc = (S64) (((U64) hi << 32) | lo);
+      U32 shift = 64 - page->pmc_width;
+      count += (U64) ((pmc << shift) >> shift);
+    }
+    __asm__ volatile("" ::: "memory");
+  } while (page->lock != seq);
+  return count;
+}
+#endif
+
+static inline void _ProfileCountersRead(ProfileContext* ctx, U64* counters) {
+  if (!ctx->pmc_is_open) { return; }
+#if defined(ARCH_X64)
+  if (ctx->pmc_use_rdpmc) {
+    for (U32 i = 0; i < ProfileCounter_Count; i++) {
+      counters[i] = ctx->pmc_pages[i] != NULL ? _ProfileRdpmc(ctx->pmc_pages[i]) : 0;
+    }
+    return;
+  }
+#endif
+  // NOTE: group read format is { nr, values[nr] }, in the order the counters joined the group.
+  U64 values[1 + ProfileCounter_Count];
+  if (read(ctx->pmc_fds[0], values, sizeof(values)) <= 0) { return; }
+  U32 value_idx = 1;
+  for (U32 i = 0; i < ProfileCounter_Count; i++) {
+    counters[i] = (ctx->pmc_fds[i] >= 0 && value_idx <= values[0]) ? values[value_idx++] : 0;
+  }
+}
+
+#else
+
+static void _ProfileCountersOpen(ProfileContext* ctx) {
+  // TODO: hardware counters on other OSes.
+  ctx->pmc_is_open = false;
+}
+
+static void _ProfileCountersClose(ProfileContext* ctx) {
+  ctx->pmc_is_open = false;
+}
+
+static inline void _ProfileCountersRead(ProfileContext* UNUSED(ctx), U64* UNUSED(counters)) {}
+
+#endif
+#endif // PROFILE_PMC
+
+// NOTE: The table is kept as is, so it can still be inspected after a join, until another thread reuses it. The
+// counters only measure the owning thread though, so those are closed.
+static void _ProfileReleaseContext(ProfileContext* ctx) {
+#ifdef PROFILE_PMC
+  _ProfileCountersClose(ctx);
+#endif
+  ctx->next_profile_block = 0;
+#ifdef PROFILE_HISTOGRAM
+  ctx->frame_start = 0;
+#endif
+  AtomicB32Store(&ctx->is_free, true);
+}
+
+#if defined(OS_WINDOWS)
+
+static VOID NTAPI _ProfileThreadExit(PVOID data) {
+  if (data != NULL) { _ProfileReleaseContext((ProfileContext*) data); }
+}
+
+static B32 _ProfileExitHookCreate() {
+  _profile_exit_hook = FlsAlloc(_ProfileThreadExit);
+  return _profile_exit_hook != FLS_OUT_OF_INDEXES;
+}
+
+static void _ProfileExitHookSet(ProfileContext* ctx) {
+  // NOTE: FLS belongs to the running fiber, which may be deleted long before its thread exits.
+  if (!IsThreadAFiber()) { FlsSetValue(_profile_exit_hook, ctx); }
+}
+
+#else
+
+static void _ProfileThreadExit(void* data) {
+  _ProfileReleaseContext((ProfileContext*) data);
+}
+
+static B32 _ProfileExitHookCreate() {
+  return tss_create(&_profile_exit_hook, _ProfileThreadExit) == thrd_success;
+}
+
+static void _ProfileExitHookSet(ProfileContext* ctx) {
+  tss_set(_profile_exit_hook, ctx);
+}
+
+#endif
+
+// NOTE: Thread exits are detected with a TLS destructor (FLS callback on windows), created by the first thread to
+// register. Like the crc tables, any threads racing it spin until it's ready.
+static void _ProfileExitHookInit() {
+  if (AtomicB32Load(&_profile_exit_hook_ready)) { return; }
+  if (!AtomicB32Exchange(&_profile_exit_hook_claimed, true)) {
+    B32 is_created = _ProfileExitHookCreate();
+    ASSERT(is_created);
+    AtomicB32Store(&_profile_exit_hook_ready, true);
+    return;
+  }
+  while (!AtomicB32Load(&_profile_exit_hook_ready)) {}
+}
+
+static ProfileContext* _ProfileRegisterThread() {
+  if (_profile_context_is_unavailable) { return NULL; }
+  _ProfileExitHookInit();
+  ProfileContext* ctx = NULL;
+  S32 idx = PROFILE_MAX_THREADS;
+  if (AtomicS32Load(&_profile_contexts_size) < PROFILE_MAX_THREADS) { idx = AtomicS32FetchAdd(&_profile_contexts_size, 1); }
+  if (idx < PROFILE_MAX_THREADS) {
+    ctx = (ProfileContext*) MemoryReserve(sizeof(ProfileContext));
+    ASSERT(ctx != NULL);
+    B32 is_committed = MemoryCommit(ctx, sizeof(ProfileContext));
+    ASSERT(is_committed);
+  } else {
+    // NOTE: every slot is taken, so take over the table of a thread that has exited, if any.
+    for (U32 i = 0; i < PROFILE_MAX_THREADS && ctx == NULL; i++) {
+      B32 is_free = true;
+      if (_profile_contexts[i] != NULL && AtomicB32CompareExchange(&_profile_contexts[i]->is_free, &is_free, false)) {
+        ctx = _profile_contexts[i];
+      }
+    }
+    if (ctx == NULL) {
+      _profile_context_is_unavailable = true;
+      return NULL;
+    }
+  }
+#ifdef PROFILE_PMC
+  _ProfileCountersOpen(ctx);
+#endif
+  _ProfileExitHookSet(ctx);
+  if (idx < PROFILE_MAX_THREADS) { _profile_contexts[idx] = ctx; }
+  _profile_context = ctx;
+  return ctx;
+}
+
+// NOTE: NULL if the calling thread isn't profiled, see PROFILE_MAX_THREADS.
+static inline ProfileContext* _ProfileGetContext() {
+  ProfileContext* ctx = _profile_context;
+  if (UNLIKELY(ctx == NULL)) { ctx = _ProfileRegisterThread(); }
+  return ctx;
+}
+
+B32 ProfileCountersAvailable() {
+#ifdef PROFILE_PMC
+  ProfileContext* ctx = _ProfileGetContext();
+  return ctx != NULL && ctx->pmc_is_open;
+#else
+  return false;
+#endif
+}
+
+U32 ProfileThreadCount() {
+  return MIN((U32) AtomicS32Load(&_profile_contexts_size), PROFILE_MAX_THREADS);
+}
+
+U32 ProfileThreadIndex() {
+  ProfileContext* ctx = _ProfileGetContext();
+  if (ctx == NULL) { return PROFILE_MAX_THREADS; }
+  U32 thread_count = ProfileThreadCount();
+  for (U32 i = 0; i < thread_count; i++) {
+    if (_profile_contexts[i] == ctx) { return i; }
+  }
+  UNREACHABLE();
+  return 0;
+}
+
+ProfileAnchor _ProfileGetAnchorForThread(ProfileMetricType metric, U32 thread_idx) {
+  ProfileAnchor result;
+  MEMORY_ZERO_STRUCT(&result);
+  // NOTE: a thread's slot may briefly be NULL while it registers.
+  if (thread_idx < ProfileThreadCount() && _profile_contexts[thread_idx] != NULL) {
+    result = _profile_contexts[thread_idx]->profile_zones[metric];
+  }
+  return result;
+}
+
+void ProfileMerge(ProfileAnchor* anchors) {
+  MEMORY_ZERO_ARRAY(anchors, ProfileMetricType_Count);
+  U32 thread_count = ProfileThreadCount();
+  for (U32 i = 0; i < thread_count; i++) {
+    ProfileContext* ctx = _profile_contexts[i];
+    if (ctx == NULL) { continue; }
+    for (U32 metric = 0; metric < ProfileMetricType_Count; metric++) {
+      anchors[metric].num_hits          += ctx->profile_zones[metric].num_hits;
+      anchors[metric].elapsed_exclusive += ctx->profile_zones[metric].elapsed_exclusive;
+      anchors[metric].elapsed_inclusive += ctx->profile_zones[metric].elapsed_inclusive;
+      anchors[metric].processed_bytes   += ctx->profile_zones[metric].processed_bytes;
+      for (U32 i = 0; i < ProfileCounter_Count; i++) { anchors[metric].counters[i] += ctx->profile_zones[metric].counters[i]; }
+    }
+  }
+}
+
 ProfileAnchor _ProfileGetAnchor(ProfileMetricType metric) {
-  ProfileContext* ctx = &_profile_context;
-  return ctx->profile_zones[metric];
+  ProfileAnchor result;
+  MEMORY_ZERO_STRUCT(&result);
+  U32 thread_count = ProfileThreadCount();
+  for (U32 i = 0; i < thread_count; i++) {
+    ProfileAnchor anchor = _ProfileGetAnchorForThread(metric, i);
+    result.num_hits          += anchor.num_hits;
+    result.elapsed_exclusive += anchor.elapsed_exclusive;
+    result.elapsed_inclusive += anchor.elapsed_inclusive;
+    result.processed_bytes   += anchor.processed_bytes;
+    for (U32 j = 0; j < ProfileCounter_Count; j++) { result.counters[j] += anchor.counters[j]; }
+  }
+  return result;
+}
+
+F64 ProfileCyclesToSeconds(U64 cycles) {
+  return (F64) cycles / (F64) ProfileCpuTimerFrequency();
+}
+
+F64 ProfileAnchorToSeconds(ProfileAnchor anchor) {
+  return ProfileCyclesToSeconds(anchor.elapsed_inclusive);
+}
+
+static S32 _ProfileReportEntryCompare(void* a, void* b) {
+  U64 a_elapsed = ((ProfileReportEntry*) a)->anchor.elapsed_inclusive;
+  U64 b_elapsed = ((ProfileReportEntry*) b)->anchor.elapsed_inclusive;
+  return (b_elapsed > a_elapsed) - (b_elapsed < a_elapsed);
+}
+
+void ProfileReportGet(Arena* arena, ProfileReport* report) {
+  MEMORY_ZERO_STRUCT(report);
+  ProfileAnchor anchors[ProfileMetricType_Count];
+  ProfileMerge(anchors);
+  report->cpu_timer_frequency = ProfileCpuTimerFrequency();
+  report->entries = ARENA_PUSH_ARRAY(arena, ProfileReportEntry, ProfileMetricType_Count);
+  U64 total_cycles = 0;
+  for (U32 metric = 0; metric < ProfileMetricType_Count; metric++) {
+    total_cycles += anchors[metric].elapsed_exclusive;
+  }
+  report->total_seconds = ProfileCyclesToSeconds(total_cycles);
+
+  for (U32 metric = 0; metric < ProfileMetricType_Count; metric++) {
+    ProfileAnchor anchor = anchors[metric];
+    if (anchor.num_hits == 0) { continue; }
+    ProfileReportEntry* entry = &report->entries[report->entries_size++];
+    entry->name = ProfileMetricType_Names[metric];
+    entry->anchor = anchor;
+    entry->inclusive_seconds = ProfileCyclesToSeconds(anchor.elapsed_inclusive);
+    entry->exclusive_seconds = ProfileCyclesToSeconds(anchor.elapsed_exclusive);
+    entry->inclusive_percent = total_cycles > 0 ? 100.0 * anchor.elapsed_inclusive / total_cycles : 0;
+    entry->exclusive_percent = total_cycles > 0 ? 100.0 * anchor.elapsed_exclusive / total_cycles : 0;
+    entry->inclusive_seconds_per_hit = entry->inclusive_seconds / anchor.num_hits;
+    entry->exclusive_seconds_per_hit = entry->exclusive_seconds / anchor.num_hits;
+    entry->gb_per_second = entry->inclusive_seconds > 0 ? anchor.processed_bytes / (entry->inclusive_seconds * GB(1)) : 0;
+    entry->instructions_per_cycle = anchor.counters[ProfileCounter_Cycles] > 0 ?
+      (F64) anchor.counters[ProfileCounter_Instructions] / anchor.counters[ProfileCounter_Cycles] : 0;
+  }
+  _Sort(report->entries, report->entries_size, sizeof(ProfileReportEntry), _ProfileReportEntryCompare, ARENA_PUSH_STRUCT(arena, ProfileReportEntry));
+}
+
+String8 ProfileReportToString(Arena* arena, ProfileReport* report) {
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  Str8ListAppend(arena, &list, Str8Format(arena, "Total: %.3f ms (cpu timer: %.3f GHz)\n", report->total_seconds * 1000.0, report->cpu_timer_frequency / 1000000000.0));
+  // NOTE: hardware counter columns are only shown if they were collected.
+  B32 has_counters = false;
+  for (U32 i = 0; i < report->entries_size; i++) { has_counters |= report->entries[i].anchor.counters[ProfileCounter_Cycles] > 0; }
+  Str8ListAppend(arena, &list, Str8Format(arena, "%-24s %12s %14s %8s %14s %8s %16s %16s %12s %10s",
+                                          "metric", "hits", "inclusive ms", "%", "exclusive ms", "%", "inclusive us/hit", "exclusive us/hit", "MB", "GB/s"));
+  if (has_counters) {
+    Str8ListAppend(arena, &list, Str8Format(arena, " %6s %14s %14s %14s", "IPC", "L1D miss/hit", "LLC miss/hit", "br miss/hit"));
+  }
+  Str8ListAppend(arena, &list, Str8Lit("\n"));
+  for (U32 i = 0; i < report->entries_size; i++) {
+    ProfileReportEntry* entry = &report->entries[i];
+    Str8ListAppend(arena, &list, Str8Format(arena, "%-24S %12llu %14.3f %8.2f %14.3f %8.2f %16.3f %16.3f %12.3f %10.3f",
+                                            entry->name, entry->anchor.num_hits,
+                                            entry->inclusive_seconds * 1000.0, entry->inclusive_percent,
+                                            entry->exclusive_seconds * 1000.0, entry->exclusive_percent,
+                                            entry->inclusive_seconds_per_hit * 1000000.0, entry->exclusive_seconds_per_hit * 1000000.0,
+                                            (F64) entry->anchor.processed_bytes / MB(1), entry->gb_per_second));
+    if (has_counters) {
+      F64 hits = (F64) entry->anchor.num_hits;
+      Str8ListAppend(arena, &list, Str8Format(arena, " %6.2f %14.1f %14.1f %14.1f", entry->instructions_per_cycle,
+                                              entry->anchor.counters[ProfileCounter_L1dMisses] / hits,
+                                              entry->anchor.counters[ProfileCounter_LlcMisses] / hits,
+                                              entry->anchor.counters[ProfileCounter_BranchMisses] / hits));
+    }
+    Str8ListAppend(arena, &list, Str8Lit("\n"));
+  }
+  return Str8ListJoin(arena, &list);
+}
+
+String8 ProfileReportToCsv(Arena* arena, ProfileReport* report) {
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  Str8ListAppend(arena, &list, Str8Lit("metric,hits,inclusive_seconds,inclusive_percent,exclusive_seconds,exclusive_percent,"
+                                       "inclusive_seconds_per_hit,exclusive_seconds_per_hit,processed_bytes,gb_per_second,"
+                                       "cycles,instructions,l1d_misses,llc_misses,branch_misses,instructions_per_cycle\n"));
+  for (U32 i = 0; i < report->entries_size; i++) {
+    ProfileReportEntry* entry = &report->entries[i];
+    Str8ListAppend(arena, &list, Str8Format(arena, "%S,%llu,%.9f,%.4f,%.9f,%.4f,%.12f,%.12f,%llu,%.6f,%llu,%llu,%llu,%llu,%llu,%.4f\n",
+                                            entry->name, entry->anchor.num_hits,
+                                            entry->inclusive_seconds, entry->inclusive_percent,
+                                            entry->exclusive_seconds, entry->exclusive_percent,
+                                            entry->inclusive_seconds_per_hit, entry->exclusive_seconds_per_hit,
+                                            entry->anchor.processed_bytes, entry->gb_per_second,
+                                            entry->anchor.counters[ProfileCounter_Cycles], entry->anchor.counters[ProfileCounter_Instructions],
+                                            entry->anchor.counters[ProfileCounter_L1dMisses], entry->anchor.counters[ProfileCounter_LlcMisses],
+                                            entry->anchor.counters[ProfileCounter_BranchMisses], entry->instructions_per_cycle));
+  }
+  return Str8ListJoin(arena, &list);
+}
+
+String8 ProfileReportToJson(Arena* arena, ProfileReport* report) {
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  Str8ListAppend(arena, &list, Str8Format(arena, "{\"total_seconds\":%.9f,\"cpu_timer_frequency\":%llu,\"entries\":[",
+                                          report->total_seconds, report->cpu_timer_frequency));
+  for (U32 i = 0; i < report->entries_size; i++) {
+    ProfileReportEntry* entry = &report->entries[i];
+    Str8ListAppend(arena, &list, Str8Format(arena, "%S{\"metric\":\"%S\",\"hits\":%llu,"
+                                            "\"inclusive_seconds\":%.9f,\"inclusive_percent\":%.4f,"
+                                            "\"exclusive_seconds\":%.9f,\"exclusive_percent\":%.4f,"
+                                            "\"inclusive_seconds_per_hit\":%.12f,\"exclusive_seconds_per_hit\":%.12f,"
+                                            "\"processed_bytes\":%llu,\"gb_per_second\":%.6f,"
+                                            "\"cycles\":%llu,\"instructions\":%llu,\"l1d_misses\":%llu,\"llc_misses\":%llu,"
+                                            "\"branch_misses\":%llu,\"instructions_per_cycle\":%.4f}",
+                                            i == 0 ? Str8Lit("") : Str8Lit(","), entry->name, entry->anchor.num_hits,
+                                            entry->inclusive_seconds, entry->inclusive_percent,
+                                            entry->exclusive_seconds, entry->exclusive_percent,
+                                            entry->inclusive_seconds_per_hit, entry->exclusive_seconds_per_hit,
+                                            entry->anchor.processed_bytes, entry->gb_per_second,
+                                            entry->anchor.counters[ProfileCounter_Cycles], entry->anchor.counters[ProfileCounter_Instructions],
+                                            entry->anchor.counters[ProfileCounter_L1dMisses], entry->anchor.counters[ProfileCounter_LlcMisses],
+                                            entry->anchor.counters[ProfileCounter_BranchMisses], entry->instructions_per_cycle));
+  }
+  Str8ListAppend(arena, &list, Str8Lit("]}"));
+  return Str8ListJoin(arena, &list);
 }
 
 void ProfileReset() {
-  ProfileContext* ctx = &_profile_context;
-  DEBUG_ASSERT(ctx->next_profile_block == 0);
-  MEMORY_ZERO_STATIC_ARRAY(ctx->profile_zones);
+  DEBUG_ASSERT(_profile_context == NULL || _profile_context->next_profile_block == 0);
+  ProfileCpuTimerFrequency();
+  U32 thread_count = ProfileThreadCount();
+  for (U32 i = 0; i < thread_count; i++) {
+    ProfileContext* ctx = _profile_contexts[i];
+    if (ctx == NULL) { continue; }
+    MEMORY_ZERO_STATIC_ARRAY(ctx->profile_zones);
+#ifdef PROFILE_TRACE
+    ctx->trace_events_size = 0;
+#endif
+#ifdef PROFILE_HISTOGRAM
+    for (U32 metric = 0; metric < ProfileMetricType_Count; metric++) {
+      if (ctx->histograms[metric] != NULL) { MEMORY_ZERO_STRUCT(ctx->histograms[metric]); }
+    }
+    if (ctx->frame_histogram != NULL) { MEMORY_ZERO_STRUCT(ctx->frame_histogram); }
+    MEMORY_ZERO_STATIC_ARRAY(ctx->frame_snapshots);
+    ctx->frame_start = 0;
+#endif
+  }
+}
+
+#ifdef PROFILE_HISTOGRAM
+static inline U32 _ProfileLog2(U64 value) {
+  DEBUG_ASSERT(value != 0);
+#if defined(COMPILER_MSVC)
+  unsigned long result;
+  _BitScanReverse64(&result, value);
+  return (U32) result;
+#else
+  return 63 - (U32) __builtin_clzll(value);
+#endif
+}
+
+static inline U32 _ProfileHistogramIndex(U64 value) {
+  if (value < PROFILE_HISTOGRAM_SUB_BUCKETS) { return (U32) value; }
+  U32 shift = _ProfileLog2(value) - PROFILE_HISTOGRAM_PRECISION_BITS;
+  return (shift + 1) * PROFILE_HISTOGRAM_SUB_BUCKETS + (U32) (value >> shift) - PROFILE_HISTOGRAM_SUB_BUCKETS;
+}
+
+// NOTE: The middle of the index's range of values.
+static U64 _ProfileHistogramValue(U32 index) {
+  U32 bucket = index / PROFILE_HISTOGRAM_SUB_BUCKETS;
+  U32 sub_bucket = index % PROFILE_HISTOGRAM_SUB_BUCKETS;
+  if (bucket == 0) { return sub_bucket; }
+  U32 shift = bucket - 1;
+  return ((U64) (PROFILE_HISTOGRAM_SUB_BUCKETS + sub_bucket) << shift) + (((U64) 1 << shift) >> 1);
+}
+
+static inline void _ProfileHistogramRecord(ProfileHistogram** histogram_ptr, U64 value) {
+  if (UNLIKELY(*histogram_ptr == NULL)) {
+    ProfileHistogram* allocated = (ProfileHistogram*) MemoryReserve(sizeof(ProfileHistogram));
+    ASSERT(allocated != NULL);
+    B32 is_committed = MemoryCommit(allocated, sizeof(ProfileHistogram));
+    ASSERT(is_committed);
+    *histogram_ptr = allocated;
+  }
+  ProfileHistogram* histogram = *histogram_ptr;
+  histogram->buckets[_ProfileHistogramIndex(value)]++;
+  if (histogram->count == 0 || value < histogram->min) { histogram->min = value; }
+  histogram->max = MAX(histogram->max, value);
+  histogram->count++;
+  histogram->sum += (F64) value;
+  histogram->sum_squares += (F64) value * (F64) value;
+}
+
+static void _ProfileHistogramMerge(ProfileHistogram* dest, ProfileHistogram* src) {
+  if (src == NULL || src->count == 0) { return; }
+  if (dest->count == 0 || src->min < dest->min) { dest->min = src->min; }
+  dest->max = MAX(dest->max, src->max);
+  dest->count += src->count;
+  dest->sum += src->sum;
+  dest->sum_squares += src->sum_squares;
+  for (U32 i = 0; i < PROFILE_HISTOGRAM_BUCKETS; i++) { dest->buckets[i] += src->buckets[i]; }
+}
+
+static ProfileHistogramStats _ProfileHistogramGetStats(ProfileHistogram* histogram) {
+  ProfileHistogramStats stats;
+  MEMORY_ZERO_STRUCT(&stats);
+  if (histogram->count == 0) { return stats; }
+  F64 seconds_per_tick = 1.0 / (F64) ProfileCpuTimerFrequency();
+  F64 mean = histogram->sum / histogram->count;
+  F64 variance = MAX(histogram->sum_squares / histogram->count - mean * mean, 0.0);
+  stats.count  = histogram->count;
+  stats.min    = histogram->min * seconds_per_tick;
+  stats.max    = histogram->max * seconds_per_tick;
+  stats.mean   = mean * seconds_per_tick;
+  stats.stddev = F64Sqrt(variance) * seconds_per_tick;
+
+  F64 percentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+  F64* results[] = { &stats.p50, &stats.p90, &stats.p99, &stats.p999 };
+  U32 percentile_idx = 0;
+  U64 cumulative = 0;
+  for (U32 i = 0; i < PROFILE_HISTOGRAM_BUCKETS && percentile_idx < STATIC_ARRAY_SIZE(percentiles); i++) {
+    cumulative += histogram->buckets[i];
+    while (percentile_idx < STATIC_ARRAY_SIZE(percentiles) &&
+           cumulative >= MAX((U64) F64Ceil(percentiles[percentile_idx] * histogram->count), 1)) {
+      U64 value = CLAMP(histogram->min, _ProfileHistogramValue(i), histogram->max);
+      *results[percentile_idx++] = value * seconds_per_tick;
+    }
+  }
+  return stats;
+}
+#endif
+
+void _ProfileHistogramTrack(ProfileMetricType metric, ProfileHistogramMode mode) {
+  _profile_histogram_modes[metric] = mode;
+}
+
+#ifdef PROFILE_HISTOGRAM
+ProfileHistogramStats _ProfileGetHistogramStats(ProfileMetricType metric) {
+  ProfileHistogram merged;
+  MEMORY_ZERO_STRUCT(&merged);
+  U32 thread_count = ProfileThreadCount();
+  for (U32 i = 0; i < thread_count; i++) {
+    if (_profile_contexts[i] == NULL) { continue; }
+    _ProfileHistogramMerge(&merged, _profile_contexts[i]->histograms[metric]);
+  }
+  return _ProfileHistogramGetStats(&merged);
+}
+
+ProfileHistogramStats ProfileGetFrameStats() {
+  ProfileHistogram merged;
+  MEMORY_ZERO_STRUCT(&merged);
+  U32 thread_count = ProfileThreadCount();
+  for (U32 i = 0; i < thread_count; i++) {
+    if (_profile_contexts[i] == NULL) { continue; }
+    _ProfileHistogramMerge(&merged, _profile_contexts[i]->frame_histogram);
+  }
+  return _ProfileHistogramGetStats(&merged);
+}
+#else
+ProfileHistogramStats _ProfileGetHistogramStats(ProfileMetricType UNUSED(metric)) {
+  ProfileHistogramStats stats;
+  MEMORY_ZERO_STRUCT(&stats);
+  return stats;
+}
+
+ProfileHistogramStats ProfileGetFrameStats() {
+  ProfileHistogramStats stats;
+  MEMORY_ZERO_STRUCT(&stats);
+  return stats;
+}
+#endif
+
+void ProfileFrameBoundary() {
+#ifdef PROFILE_HISTOGRAM
+  U64 now = ReadCpuTimer();
+  ProfileContext* ctx = _ProfileGetContext();
+  if (ctx == NULL) { return; }
+  if (ctx->frame_start != 0) {
+    _ProfileHistogramRecord(&ctx->frame_histogram, now - ctx->frame_start);
+    for (U32 metric = 0; metric < ProfileMetricType_Count; metric++) {
+      if (_profile_histogram_modes[metric] != ProfileHistogramMode_PerFrame) { continue; }
+      _ProfileHistogramRecord(&ctx->histograms[metric], ctx->profile_zones[metric].elapsed_inclusive - ctx->frame_snapshots[metric]);
+    }
+  }
+  for (U32 metric = 0; metric < ProfileMetricType_Count; metric++) {
+    ctx->frame_snapshots[metric] = ctx->profile_zones[metric].elapsed_inclusive;
+  }
+  ctx->frame_start = now;
+#endif
+}
+
+#ifdef PROFILE_TRACE
+STATIC_ASSERT((PROFILE_TRACE_EVENTS & (PROFILE_TRACE_EVENTS - 1)) == 0, "PROFILE_TRACE_EVENTS must be a power of 2!");
+
+static inline void _ProfileTraceRecord(ProfileContext* ctx, ProfileMetricType metric, U64 tsc, B32 is_end) {
+  ProfileEvent* event = &ctx->trace_events[ctx->trace_events_size & (PROFILE_TRACE_EVENTS - 1)];
+  event->tsc = tsc;
+  event->metric = metric;
+  event->is_end = is_end;
+  ctx->trace_events_size++;
+}
+#endif
+
+// NOTE: Events are converted to complete ("X") events by matching starts and ends per thread. Blocks whose start was
+// overwritten in the ring, or that hadn't ended by the time of the dump, are dropped.
+B32 ProfileDumpChromeTrace(String8 file_path) {
+  B32 success = false;
+  FileHandle* handle;
+  if (!FileHandleOpen(&handle, file_path, FileMode_Write | FileMode_Create | FileMode_Truncate)) { return false; }
+  Arena* arena = ArenaAllocate();
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  String8 str;
+
+  U32 thread_count = ProfileThreadCount();
+  B32 is_first = true;
+  Str8ListAppend(arena, &list, Str8Lit("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"));
+  for (U32 i = 0; i < thread_count; i++) {
+    if (_profile_contexts[i] == NULL) { continue; }
+    str = Str8Format(arena, "%S{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+                     is_first ? Str8Lit("") : Str8Lit(",\n"), i, i);
+    Str8ListAppend(arena, &list, str);
+    is_first = false;
+  }
+
+#ifdef PROFILE_TRACE
+  U32 list_size = 0;
+  F64 us_per_tick = 1000000.0 / (F64) ProfileCpuTimerFrequency();
+  // NOTE: Timestamps are relative to the earliest retained event across all threads.
+  U64 tsc_min = U64_MAX;
+  for (U32 i = 0; i < thread_count; i++) {
+    ProfileContext* ctx = _profile_contexts[i];
+    if (ctx == NULL || ctx->trace_events_size == 0) { continue; }
+    U64 oldest = ctx->trace_events_size - MIN(ctx->trace_events_size, PROFILE_TRACE_EVENTS);
+    tsc_min = MIN(tsc_min, ctx->trace_events[oldest & (PROFILE_TRACE_EVENTS - 1)].tsc);
+  }
+
+  for (U32 i = 0; i < thread_count; i++) {
+    ProfileContext* ctx = _profile_contexts[i];
+    if (ctx == NULL) { continue; }
+    ProfileEvent* stack[STATIC_ARRAY_SIZE(ctx->profile_block_stack)];
+    U32 stack_size = 0;
+    U64 oldest = ctx->trace_events_size - MIN(ctx->trace_events_size, PROFILE_TRACE_EVENTS);
+    for (U64 j = oldest; j < ctx->trace_events_size; j++) {
+      ProfileEvent* event = &ctx->trace_events[j & (PROFILE_TRACE_EVENTS - 1)];
+      if (!event->is_end) {
+        DEBUG_ASSERT(stack_size < STATIC_ARRAY_SIZE(stack));
+        stack[stack_size++] = event;
+        continue;
+      }
+      // NOTE: an end without a start, the start was overwritten.
+      if (stack_size == 0 || stack[stack_size - 1]->metric != event->metric) { continue; }
+      ProfileEvent* start = stack[--stack_size];
+      str = Str8Format(arena, "%S{\"name\":\"%S\",\"cat\":\"cdefault\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                       is_first ? Str8Lit("") : Str8Lit(",\n"), ProfileMetricType_Names[start->metric], i,
+                       (F64) (start->tsc - tsc_min) * us_per_tick, (F64) (event->tsc - start->tsc) * us_per_tick);
+      Str8ListAppend(arena, &list, str);
+      list_size++;
+      is_first = false;
+
+      // NOTE: flush periodically so the arena stays small for large traces.
+      if (list_size >= 4096) {
+        str = Str8ListJoin(arena, &list);
+        if (!FileHandleWrite(handle, str.str, str.size)) { goto profile_dump_chrome_trace_exit; }
+        ArenaClear(arena);
+        MEMORY_ZERO_STRUCT(&list);
+        list_size = 0;
+      }
+    }
+  }
+#endif
+
+  Str8ListAppend(arena, &list, Str8Lit("\n]}\n"));
+  str = Str8ListJoin(arena, &list);
+  if (!FileHandleWrite(handle, str.str, str.size)) { goto profile_dump_chrome_trace_exit; }
+  success = true;
+profile_dump_chrome_trace_exit:
+  ArenaRelease(arena);
+  DEBUG_ASSERT(FileHandleClose(handle));
+  return success;
 }
 
 volatile void _ProfileBlockStart(ProfileMetricType metric) {
-  ProfileContext* ctx = &_profile_context;
+  ProfileContext* ctx = _ProfileGetContext();
+  if (ctx == NULL) { return; }
   ProfileAnchor* anchor = &ctx->profile_zones[metric];
   ProfileBlock* block = &ctx->profile_block_stack[ctx->next_profile_block];
   ctx->next_profile_block++;
   DEBUG_ASSERT(ctx->next_profile_block <= STATIC_ARRAY_SIZE(ctx->profile_block_stack));
-  MEMORY_ZERO_STRUCT(block);
   block->metric = metric;
   block->elapsed_inclusive_snapshot = anchor->elapsed_inclusive;
+#ifdef PROFILE_PMC
+  MEMORY_COPY_STATIC_ARRAY(block->counters_snapshot, anchor->counters);
+  _ProfileCountersRead(ctx, block->counters_start);
+#endif
 
   block->start = ReadCpuTimer();
+#ifdef PROFILE_TRACE
+  _ProfileTraceRecord(ctx, metric, block->start, false);
+#endif
+}
+
+volatile void _ProfileBlockStartBandwidth(ProfileMetricType metric, U64 bytes) {
+  ProfileContext* ctx = _ProfileGetContext();
+  if (ctx == NULL) { return; }
+  ctx->profile_zones[metric].processed_bytes += bytes;
+  _ProfileBlockStart(metric);
+}
+
+void _ProfileAddBytes(U64 bytes) {
+  ProfileContext* ctx = _ProfileGetContext();
+  if (ctx == NULL || ctx->next_profile_block == 0) { return; }
+  ProfileBlock* block = &ctx->profile_block_stack[ctx->next_profile_block - 1];
+  ctx->profile_zones[block->metric].processed_bytes += bytes;
 }
 
 volatile void _ProfileBlockEnd(ProfileMetricType metric) {
   U64 end = ReadCpuTimer();
 
-  ProfileContext* ctx = &_profile_context;
+  ProfileContext* ctx = _profile_context;
+  if (ctx == NULL) { return; }
   ProfileBlock* block = &ctx->profile_block_stack[ctx->next_profile_block - 1];
   DEBUG_ASSERT(block->metric == metric);
   ctx->next_profile_block -= 1;
@@ -124,6 +1073,20 @@ volatile void _ProfileBlockEnd(ProfileMetricType metric) {
   // we clobber the inclusive time for recursive calls -- the topmost layer wins.
   anchor->elapsed_inclusive = block->elapsed_inclusive_snapshot + elapsed;
   anchor->num_hits++;
+#ifdef PROFILE_PMC
+  U64 counters_end[ProfileCounter_Count];
+  MEMORY_COPY_STATIC_ARRAY(counters_end, block->counters_start);
+  _ProfileCountersRead(ctx, counters_end);
+  for (U32 i = 0; i < ProfileCounter_Count; i++) {
+    anchor->counters[i] = block->counters_snapshot[i] + (counters_end[i] - block->counters_start[i]);
+  }
+#endif
+#ifdef PROFILE_TRACE
+  _ProfileTraceRecord(ctx, metric, end, true);
+#endif
+#ifdef PROFILE_HISTOGRAM
+  if (_profile_histogram_modes[metric] == ProfileHistogramMode_PerHit) { _ProfileHistogramRecord(&ctx->histograms[metric], elapsed); }
+#endif
 
   if (ctx->next_profile_block > 0) {
     ProfileBlock* block_parent = &ctx->profile_block_stack[ctx->next_profile_block - 1];
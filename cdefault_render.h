@@ -7,6 +7,7 @@
 #include "cdefault_image.h"
 #include "cdefault_font.h"
 #include "cdefault_io.h"
+#include "cdefault_profile.h"
 
 // TODO:
 // move 2d camera
@@ -1194,6 +1195,7 @@ void DrawRoundedRectangleFrameV(V2 center, V2 size, F32 radius, F32 border, V3 c
 }
 
 void DrawRoundedRectangleRot(F32 center_x, F32 center_y, F32 width, F32 height, F32 radius, F32 angle_rad, F32 red, F32 green, F32 blue) {
+  CDEFAULT_PROFILE_START(DRAW_SHAPE_2D);
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
 
@@ -1214,6 +1216,7 @@ void DrawRoundedRectangleRot(F32 center_x, F32 center_y, F32 width, F32 height,
   g->glDrawArrays(GL_TRIANGLES, 0, 6);
   g->glBindVertexArray(0);
   g->glUseProgram(0);
+  CDEFAULT_PROFILE_END(DRAW_SHAPE_2D);
 }
 
 void DrawRoundedRectangleRotV(V2 center, V2 size, F32 radius, F32 angle, V3 color) {
@@ -1229,6 +1232,7 @@ void DrawRectangleFrameRotV(V2 center, V2 size, F32 border, F32 angle_rad,  V3 c
 }
 
 void DrawRoundedRectangleFrameRot(F32 center_x, F32 center_y, F32 width, F32 height, F32 radius, F32 border, F32 angle_rad, F32 red, F32 green, F32 blue) {
+  CDEFAULT_PROFILE_START(DRAW_SHAPE_2D);
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
 
@@ -1250,6 +1254,7 @@ void DrawRoundedRectangleFrameRot(F32 center_x, F32 center_y, F32 width, F32 hei
   g->glDrawArrays(GL_TRIANGLES, 0, 6);
   g->glBindVertexArray(0);
   g->glUseProgram(0);
+  CDEFAULT_PROFILE_END(DRAW_SHAPE_2D);
 }
 
 void DrawRoundedRectangleFrameRotV(V2 center, V2 size, F32 radius, F32 border, F32 angle_rad, V3 color) {
@@ -1273,6 +1278,7 @@ void DrawRingV(V2 center, F32 radius, F32 border, V3 color) {
 }
 
 void DrawTriangle(F32 x1, F32 y1, F32 x2, F32 y2, F32 x3, F32 y3, F32 red, F32 green, F32 blue) {
+  CDEFAULT_PROFILE_START(DRAW_SHAPE_2D);
   // TODO: i assume there's a better way to do this without resorting to compatibility mode?
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
@@ -1314,6 +1320,7 @@ void DrawTriangle(F32 x1, F32 y1, F32 x2, F32 y2, F32 x3, F32 y3, F32 red, F32 g
 
   g->glDeleteBuffers(1, &tri_vbo);
   g->glDeleteVertexArrays(1, &tri_vao);
+  CDEFAULT_PROFILE_END(DRAW_SHAPE_2D);
 }
 
 void DrawTriangleV(V2 p1, V2 p2, V2 p3, V3 color) {
@@ -1355,6 +1362,7 @@ void DrawSubImageV(U32 image_handle, V2 center, V2 size, V2 min_uv, V2 max_uv) {
 }
 
 void DrawSubImageRot(U32 image_handle, F32 center_x, F32 center_y, F32 width, F32 height, F32 angle_rad, F32 min_uv_x, F32 min_uv_y, F32 max_uv_x, F32 max_uv_y) {
+  CDEFAULT_PROFILE_START(DRAW_IMAGE);
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
 
@@ -1379,6 +1387,7 @@ void DrawSubImageRot(U32 image_handle, F32 center_x, F32 center_y, F32 width, F3
   g->glBindTexture(GL_TEXTURE_2D, 0);
   g->glBindVertexArray(0);
   g->glUseProgram(0);
+  CDEFAULT_PROFILE_END(DRAW_IMAGE);
 }
 
 void DrawSubImageRotV(U32 image_handle, V2 center, V2 size, F32 angle_rad, V2 min_uv, V2 max_uv) {
@@ -1386,6 +1395,7 @@ void DrawSubImageRotV(U32 image_handle, V2 center, V2 size, F32 angle_rad, V2 mi
 }
 
 void DrawFontBmpCharacter(U32 image_handle, F32 center_x, F32 center_y, F32 width, F32 height, F32 min_uv_x, F32 min_uv_y, F32 max_uv_x, F32 max_uv_y, F32 red, F32 green, F32 blue) {
+  CDEFAULT_PROFILE_START(DRAW_GLYPH);
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
 
@@ -1412,6 +1422,7 @@ void DrawFontBmpCharacter(U32 image_handle, F32 center_x, F32 center_y, F32 widt
   g->glBindTexture(GL_TEXTURE_2D, 0);
   g->glBindVertexArray(0);
   g->glUseProgram(0);
+  CDEFAULT_PROFILE_END(DRAW_GLYPH);
 }
 
 void DrawFontBmpCharacterV(U32 image_handle, V2 center, V2 size, V2 min_uv, V2 max_uv, V3 color) {
@@ -1419,6 +1430,7 @@ void DrawFontBmpCharacterV(U32 image_handle, V2 center, V2 size, V2 min_uv, V2 m
 }
 
 void DrawFontSdfCharacter(U32 image_handle, F32 center_x, F32 center_y, F32 width, F32 height, F32 min_uv_x, F32 min_uv_y, F32 max_uv_x, F32 max_uv_y, F32 threshold, F32 smoothing, F32 red, F32 green, F32 blue) {
+  CDEFAULT_PROFILE_START(DRAW_GLYPH);
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
 
@@ -1452,6 +1464,7 @@ void DrawFontSdfCharacter(U32 image_handle, F32 center_x, F32 center_y, F32 widt
   g->glBindTexture(GL_TEXTURE_2D, 0);
   g->glBindVertexArray(0);
   g->glUseProgram(0);
+  CDEFAULT_PROFILE_END(DRAW_GLYPH);
 }
 
 void DrawFontSdfCharacterV(U32 image_handle, V2 center, V2 size, V2 min_uv, V2 max_uv, F32 threshold, F32 smoothing, V3 color) {
@@ -1504,6 +1517,7 @@ void DrawLine3(F32 start_x, F32 start_y, F32 start_z, F32 end_x, F32 end_y, F32
 
 // TODO: add thickness? sdf w/ 3d rect, similar to 2d api. remove reliance on glLineWidth.
 void DrawLine3V(V3 start, V3 end, V3 color) {
+  CDEFAULT_PROFILE_START(DRAW_LINE_3D);
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
 
@@ -1534,6 +1548,7 @@ void DrawLine3V(V3 start, V3 end, V3 color) {
   g->glUseProgram(0);
   g->glDeleteVertexArrays(1, &line_vao);
   g->glDeleteBuffers(1, &line_vbo);
+  CDEFAULT_PROFILE_END(DRAW_LINE_3D);
 }
 
 void DrawSphere(F32 center_x, F32 center_y, F32 center_z, F32 rot_x, F32 rot_y, F32 rot_z, F32 rot_w, F32 radius, F32 red, F32 green, F32 blue) {
@@ -1644,6 +1659,7 @@ void DrawModelEx(U32 model_handle, F32 pos_x, F32 pos_y, F32 pos_z, F32 rot_x, F
 }
 
 void DrawModelExV(U32 model_handle, V3 pos, V4 rot, V3 scale, V3 color, F32 tex_color_ratio) {
+  CDEFAULT_PROFILE_START(DRAW_MODEL);
   Renderer* r = &_renderer;
   OpenGLAPI* g = &_ogl;
   RenderModel* model = RendererFindModel(model_handle);
@@ -1671,6 +1687,7 @@ void DrawModelExV(U32 model_handle, V3 pos, V4 rot, V3 scale, V3 color, F32 tex_
   g->glBindVertexArray(0);
   g->glBindTexture(GL_TEXTURE_2D, 0);
   g->glUseProgram(0);
+  CDEFAULT_PROFILE_END(DRAW_MODEL);
 }
 
 #if defined(OS_WINDOWS)
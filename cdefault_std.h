@@ -25,13 +25,26 @@
 #  error Unknown / unsupported compiler.
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#  define ARCH_X64 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define ARCH_ARM64 1
+#else
+#  error Unknown / unsupported architecture.
+#endif
+
 #if defined(OS_WINDOWS)
 
 #include <windows.h>
 
 #elif defined(OS_LINUX)
 
+#include <fcntl.h>
+#include <sched.h>
 #include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <threads.h>
 #include <time.h>
 #include <stdatomic.h>
@@ -43,6 +56,7 @@
 
 #include <mach/mach.h>
 #include <mach/mach_time.h>
+#include <pthread.h>
 #include <sys/mman.h>
 #include <threads.h>
 #include <stdatomic.h>
@@ -52,6 +66,24 @@
 
 #endif
 
+#if defined(ARCH_X64)
+#include <immintrin.h>
+#  if defined(COMPILER_MSVC)
+#include <intrin.h>
+#  else
+#include <cpuid.h>
+#  endif
+#elif defined(ARCH_ARM64)
+#include <arm_neon.h>
+#  if defined(OS_LINUX)
+#include <sys/auxv.h>
+#  endif
+#endif
+
+#if defined(CDEFAULT_FIBER_UCONTEXT) && !defined(OS_WINDOWS)
+#include <ucontext.h>
+#endif
+
 #include <assert.h>
 #include <stdint.h>
 #include <stddef.h>
@@ -116,6 +148,12 @@ typedef double   F64;
 #define F64_E     2.71828182845904523536028747135266249
 #define F64_SQRT2 1.41421356237309504880168872420969808
 
+typedef struct String8 String8;
+struct String8 {
+  U8* str;
+  U32 size;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Gen purpose macros
 ///////////////////////////////////////////////////////////////////////////////
@@ -128,6 +166,12 @@ typedef double   F64;
 #  define UNUSED(x) x
 #endif
 
+#if defined(COMPILER_MSVC)
+#  define THREAD_LOCAL __declspec(thread)
+#else
+#  define THREAD_LOCAL _Thread_local
+#endif
+
 #define STRINGIFY(x) #x
 #define GLUE(a, b) a ## b
 
@@ -530,6 +574,312 @@ void  ArenaClear(Arena* arena);
   b_size = a_size;                                                                \
   MEMORY_COPY_ARRAY(b_data, a_data, a_size)
 
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Heap
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: Typed 4-ary heap / priority queue. HEAP_DEFINE(name, type, compare) generates a
+// struct called name and its routines, prefixed with name. compare(a, b) takes items by
+// value, and is negative if a belongs closer to the top than b (so e.g. a - b gives a min
+// heap, b - a gives a max heap).
+//
+// Each pushed item is given a handle, which stays valid until the item is popped or removed.
+// Handles can be used to look up, update (e.g. decrease-key), or remove items in O(log n).
+//
+// E.g.
+#if 0
+typedef struct Face Face;
+struct Face { F32 distance; U32 idx; };
+#define FaceCompare(a, b) (((a).distance > (b).distance) - ((a).distance < (b).distance))
+HEAP_DEFINE(FaceHeap, Face, FaceCompare)
+
+Arena* arena = ArenaAllocate();
+FaceHeap heap;
+FaceHeapInit(&heap, arena);
+U32 handle = FaceHeapPush(&heap, face);
+face.distance = 0;
+FaceHeapUpdate(&heap, handle, face);
+Face closest = FaceHeapPop(&heap);
+#endif
+//
+// NOTE: like the dynamic array, growing reallocates from the arena. Prefer NameReserve
+// up front if the max size is known.
+
+#ifndef HEAP_INITIAL_CAPACITY
+#define HEAP_INITIAL_CAPACITY 16
+#endif
+
+#define HEAP_DEFINE(name, type, compare)                                                  \
+  typedef struct name name;                                                               \
+  struct name {                                                                           \
+    Arena* arena;                                                                         \
+    type* data;                                                                           \
+    U32*  handles;   /* NOTE: heap position -> handle. Positions >= size hold free handles. */ \
+    U32*  positions; /* NOTE: handle -> heap position. */                                 \
+    U32   size;                                                                           \
+    U32   capacity;                                                                       \
+  };                                                                                      \
+                                                                                          \
+  static inline void name##Init(name* heap, Arena* arena) {                               \
+    MEMORY_ZERO_STRUCT(heap);                                                             \
+    heap->arena = arena;                                                                  \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##Reserve(name* heap, U32 capacity) {                            \
+    if (capacity <= heap->capacity) { return; }                                           \
+    U32 new_capacity = MAX(heap->capacity, HEAP_INITIAL_CAPACITY);                        \
+    while (new_capacity < capacity) { new_capacity *= 2; }                                \
+    type* data     = ARENA_PUSH_ARRAY(heap->arena, type, new_capacity);                   \
+    U32* handles   = ARENA_PUSH_ARRAY(heap->arena, U32, new_capacity);                    \
+    U32* positions = ARENA_PUSH_ARRAY(heap->arena, U32, new_capacity);                    \
+    MEMORY_COPY_ARRAY(data, heap->data, heap->size);                                      \
+    MEMORY_COPY_ARRAY(handles, heap->handles, heap->capacity);                            \
+    MEMORY_COPY_ARRAY(positions, heap->positions, heap->capacity);                        \
+    for (U32 _i = heap->capacity; _i < new_capacity; _i++) {                              \
+      handles[_i]   = _i;                                                                 \
+      positions[_i] = _i;                                                                 \
+    }                                                                                     \
+    heap->data      = data;                                                               \
+    heap->handles   = handles;                                                            \
+    heap->positions = positions;                                                          \
+    heap->capacity  = new_capacity;                                                       \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##_Swap(name* heap, U32 a, U32 b) {                              \
+    SWAP(type, heap->data[a], heap->data[b]);                                             \
+    SWAP(U32, heap->handles[a], heap->handles[b]);                                        \
+    heap->positions[heap->handles[a]] = a;                                                \
+    heap->positions[heap->handles[b]] = b;                                                \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##_SiftUp(name* heap, U32 pos) {                                 \
+    while (pos > 0) {                                                                     \
+      U32 parent = (pos - 1) / 4;                                                         \
+      if (compare(heap->data[pos], heap->data[parent]) >= 0) { break; }                   \
+      name##_Swap(heap, pos, parent);                                                     \
+      pos = parent;                                                                       \
+    }                                                                                     \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##_SiftDown(name* heap, U32 pos) {                               \
+    while (true) {                                                                        \
+      U32 first_child = pos * 4 + 1;                                                      \
+      if (first_child >= heap->size) { break; }                                           \
+      U32 last_child = MIN(first_child + 4, heap->size);                                  \
+      U32 best = first_child;                                                             \
+      for (U32 _c = first_child + 1; _c < last_child; _c++) {                             \
+        if (compare(heap->data[_c], heap->data[best]) < 0) { best = _c; }                 \
+      }                                                                                   \
+      if (compare(heap->data[best], heap->data[pos]) >= 0) { break; }                     \
+      name##_Swap(heap, pos, best);                                                       \
+      pos = best;                                                                         \
+    }                                                                                     \
+  }                                                                                       \
+                                                                                          \
+  static inline U32 name##Push(name* heap, type item) {                                   \
+    name##Reserve(heap, heap->size + 1);                                                  \
+    U32 pos = heap->size++;                                                               \
+    U32 handle = heap->handles[pos];                                                      \
+    heap->data[pos] = item;                                                               \
+    name##_SiftUp(heap, pos);                                                             \
+    return handle;                                                                        \
+  }                                                                                       \
+                                                                                          \
+  static inline type* name##Peek(name* heap) {                                            \
+    DEBUG_ASSERT(heap->size > 0);                                                         \
+    return &heap->data[0];                                                                \
+  }                                                                                       \
+                                                                                          \
+  static inline U32 name##PeekHandle(name* heap) {                                        \
+    DEBUG_ASSERT(heap->size > 0);                                                         \
+    return heap->handles[0];                                                              \
+  }                                                                                       \
+                                                                                          \
+  static inline type* name##Get(name* heap, U32 handle) {                                 \
+    DEBUG_ASSERT(handle < heap->capacity && heap->positions[handle] < heap->size);        \
+    return &heap->data[heap->positions[handle]];                                          \
+  }                                                                                       \
+                                                                                          \
+  static inline type name##Remove(name* heap, U32 handle) {                               \
+    DEBUG_ASSERT(handle < heap->capacity && heap->positions[handle] < heap->size);        \
+    U32 pos = heap->positions[handle];                                                    \
+    type result = heap->data[pos];                                                        \
+    U32 last = --heap->size;                                                              \
+    if (pos != last) {                                                                    \
+      name##_Swap(heap, pos, last);                                                       \
+      name##_SiftDown(heap, pos);                                                         \
+      name##_SiftUp(heap, pos);                                                           \
+    }                                                                                     \
+    return result;                                                                        \
+  }                                                                                       \
+                                                                                          \
+  static inline type name##Pop(name* heap) {                                              \
+    DEBUG_ASSERT(heap->size > 0);                                                         \
+    return name##Remove(heap, heap->handles[0]);                                          \
+  }                                                                                       \
+                                                                                          \
+  /* NOTE: Changes the item at handle, e.g. decrease-key (or increase-key). */            \
+  static inline void name##Update(name* heap, U32 handle, type item) {                    \
+    DEBUG_ASSERT(handle < heap->capacity && heap->positions[handle] < heap->size);        \
+    U32 pos = heap->positions[handle];                                                    \
+    heap->data[pos] = item;                                                               \
+    name##_SiftUp(heap, pos);                                                             \
+    name##_SiftDown(heap, heap->positions[handle]);                                       \
+  }                                                                                       \
+                                                                                          \
+  /* NOTE: Replaces the contents of the heap with items in O(n). Handles are 0..count-1. */ \
+  static inline void name##Heapify(name* heap, type* items, U32 count) {                  \
+    name##Reserve(heap, count);                                                           \
+    for (U32 _i = 0; _i < heap->capacity; _i++) {                                         \
+      heap->handles[_i]   = _i;                                                           \
+      heap->positions[_i] = _i;                                                           \
+    }                                                                                     \
+    MEMORY_COPY_ARRAY(heap->data, items, count);                                          \
+    heap->size = count;                                                                   \
+    for (S64 _i = ((S64) count - 2) / 4; _i >= 0; _i--) { name##_SiftDown(heap, (U32) _i); } \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##Clear(name* heap) {                                            \
+    for (U32 _i = 0; _i < heap->capacity; _i++) {                                         \
+      heap->handles[_i]   = _i;                                                           \
+      heap->positions[_i] = _i;                                                           \
+    }                                                                                     \
+    heap->size = 0;                                                                       \
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Deque
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: Typed ring buffer deque with O(1) push / pop at both ends. DEQUE_DEFINE(name, type)
+// generates a struct called name and its routines, prefixed with name. Capacity is always a
+// power of two, so indices wrap with a mask.
+//
+// Items are stored contiguously but may wrap around the end of the buffer. NameSpans returns
+// the (at most) 2 contiguous runs making up the deque, in order, for bulk copies.
+//
+// E.g.
+#if 0
+DEQUE_DEFINE(U32Deque, U32)
+
+Arena* arena = ArenaAllocate();
+U32Deque queue;
+U32DequeInit(&queue, arena);
+U32DequePushBack(&queue, root);
+while (queue.size > 0) {
+  U32 node = U32DequePopFront(&queue);
+  for (...) { U32DequePushBack(&queue, child); }
+}
+#endif
+//
+// NOTE: like the dynamic array, growing reallocates from the arena (re-linearizing the
+// items so head is 0). Prefer NameReserve up front if the max size is known.
+
+#ifndef DEQUE_INITIAL_CAPACITY
+#define DEQUE_INITIAL_CAPACITY 16
+#endif
+
+#define DEQUE_DEFINE(name, type)                                                          \
+  typedef struct name name;                                                               \
+  struct name {                                                                           \
+    Arena* arena;                                                                         \
+    type* data;                                                                           \
+    U32   head;                                                                           \
+    U32   size;                                                                           \
+    U32   capacity;                                                                       \
+  };                                                                                      \
+                                                                                          \
+  static inline void name##Init(name* deque, Arena* arena) {                              \
+    MEMORY_ZERO_STRUCT(deque);                                                            \
+    deque->arena = arena;                                                                 \
+  }                                                                                       \
+                                                                                          \
+  /* NOTE: Returns the 2 contiguous runs of the deque, front to back. b may be empty. */  \
+  static inline void name##Spans(name* deque, type** a, U32* a_size, type** b, U32* b_size) { \
+    U32 first = MIN(deque->size, deque->capacity - deque->head);                          \
+    *a      = deque->data + deque->head;                                                  \
+    *a_size = first;                                                                      \
+    *b      = deque->data;                                                                \
+    *b_size = deque->size - first;                                                        \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##Reserve(name* deque, U32 capacity) {                           \
+    if (capacity <= deque->capacity) { return; }                                          \
+    U32 new_capacity = MAX(deque->capacity, DEQUE_INITIAL_CAPACITY);                      \
+    while (new_capacity < capacity) { new_capacity *= 2; }                                \
+    type* data = ARENA_PUSH_ARRAY(deque->arena, type, new_capacity);                      \
+    if (deque->size > 0) {                                                                \
+      type *a, *b;                                                                        \
+      U32 a_size, b_size;                                                                 \
+      name##Spans(deque, &a, &a_size, &b, &b_size);                                       \
+      MEMORY_COPY_ARRAY(data, a, a_size);                                                 \
+      MEMORY_COPY_ARRAY(data + a_size, b, b_size);                                        \
+    }                                                                                     \
+    deque->data     = data;                                                               \
+    deque->head     = 0;                                                                  \
+    deque->capacity = new_capacity;                                                       \
+  }                                                                                       \
+                                                                                          \
+  static inline type* name##Get(name* deque, U32 idx) {                                   \
+    DEBUG_ASSERT(idx < deque->size);                                                      \
+    return &deque->data[(deque->head + idx) & (deque->capacity - 1)];                     \
+  }                                                                                       \
+                                                                                          \
+  static inline type* name##Front(name* deque) { return name##Get(deque, 0); }            \
+  static inline type* name##Back(name* deque)  { return name##Get(deque, deque->size - 1); } \
+                                                                                          \
+  static inline void name##PushBack(name* deque, type item) {                             \
+    name##Reserve(deque, deque->size + 1);                                                \
+    deque->data[(deque->head + deque->size) & (deque->capacity - 1)] = item;              \
+    deque->size++;                                                                        \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##PushFront(name* deque, type item) {                            \
+    name##Reserve(deque, deque->size + 1);                                                \
+    deque->head = (deque->head - 1) & (deque->capacity - 1);                              \
+    deque->data[deque->head] = item;                                                      \
+    deque->size++;                                                                        \
+  }                                                                                       \
+                                                                                          \
+  static inline type name##PopBack(name* deque) {                                         \
+    DEBUG_ASSERT(deque->size > 0);                                                        \
+    deque->size--;                                                                        \
+    return deque->data[(deque->head + deque->size) & (deque->capacity - 1)];              \
+  }                                                                                       \
+                                                                                          \
+  static inline type name##PopFront(name* deque) {                                        \
+    DEBUG_ASSERT(deque->size > 0);                                                        \
+    type result = deque->data[deque->head];                                               \
+    deque->head = (deque->head + 1) & (deque->capacity - 1);                              \
+    deque->size--;                                                                        \
+    return result;                                                                        \
+  }                                                                                       \
+                                                                                          \
+  /* NOTE: Bulk versions of PushBack / PopFront, copying at most 2 contiguous runs. */    \
+  static inline void name##PushBackArray(name* deque, type* items, U32 count) {           \
+    name##Reserve(deque, deque->size + count);                                            \
+    U32 tail  = (deque->head + deque->size) & (deque->capacity - 1);                      \
+    U32 first = MIN(count, deque->capacity - tail);                                       \
+    MEMORY_COPY_ARRAY(deque->data + tail, items, first);                                  \
+    MEMORY_COPY_ARRAY(deque->data, items + first, count - first);                         \
+    deque->size += count;                                                                 \
+  }                                                                                       \
+                                                                                          \
+  static inline U32 name##PopFrontArray(name* deque, type* dest, U32 count) {             \
+    count = MIN(count, deque->size);                                                      \
+    U32 first = MIN(count, deque->capacity - deque->head);                                \
+    MEMORY_COPY_ARRAY(dest, deque->data + deque->head, first);                            \
+    MEMORY_COPY_ARRAY(dest + first, deque->data, count - first);                          \
+    if (count > 0) { deque->head = (deque->head + count) & (deque->capacity - 1); }       \
+    deque->size -= count;                                                                 \
+    return count;                                                                         \
+  }                                                                                       \
+                                                                                          \
+  static inline void name##Clear(name* deque) {                                           \
+    deque->head = 0;                                                                      \
+    deque->size = 0;                                                                      \
+  }
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Thread
 ///////////////////////////////////////////////////////////////////////////////
@@ -547,10 +897,26 @@ typedef cnd_t CV;
 typedef S32 ThreadStart_Fn(void*);
 typedef S32 LockWitness;
 
-void ThreadCreate(Thread* thread, ThreadStart_Fn* entry, void* arg);
+B32  ThreadCreate(Thread* thread, ThreadStart_Fn* entry, void* arg); // NOTE: Returns false if the OS fails to start the thread.
 void ThreadDetach(Thread* thread);
 S32  ThreadJoin(Thread* thread);
 
+// NOTE: These apply to the calling thread, e.g. call them at the start of a ThreadStart_Fn.
+// They return false if the OS rejects the request (e.g. RealTime without the needed privileges).
+typedef enum ThreadPriority ThreadPriority;
+enum ThreadPriority {
+  ThreadPriority_Low,
+  ThreadPriority_Normal,
+  ThreadPriority_High,
+  ThreadPriority_RealTime, // NOTE: e.g. for audio threads. SCHED_FIFO on linux.
+};
+
+// NOTE: cpus are logical core indices, see CpuTopology. On windows, all cpus must be in the
+// same processor group (i.e. in the same block of 64).
+B32  ThreadSetAffinity(U32* cpus, U32 cpus_size);
+B32  ThreadSetPriority(ThreadPriority priority);
+B32  ThreadSetName(String8 name); // NOTE: truncated to 15 chars on linux.
+
 void MutexInit(Mutex* mutex);
 void MutexDeinit(Mutex* mutex);
 LockWitness MutexLock(Mutex* mutex);
@@ -580,6 +946,63 @@ void NotifInit(Notif* notification);
 void NotifSignal(Notif* notification);
 void NotifWaitAndDeinit(Notif* notification);
 
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Fiber
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: Stackful, cooperatively scheduled fibers. FiberResume runs a fiber on the calling
+// thread until it calls FiberYield (or its entry returns), at which point FiberResume returns.
+// A suspended fiber may be resumed from any thread, so fibers can be multiplexed over a pool of
+// Threads (M:N) without paying for kernel context switches. A fiber must not be resumed by
+// more than one thread at a time.
+//
+// Context switches use hand written assembly on x64 / arm64, the native fiber API on windows,
+// or ucontext if CDEFAULT_FIBER_UCONTEXT is #defined. Stacks are mapped with an inaccessible
+// guard page below them, so overflowing a fiber's stack faults instead of corrupting memory.
+//
+// E.g.
+#if 0
+void Count(Fiber* fiber, void* arg) {
+  for (S32 i = 0; i < 3; i++) {
+    LOG_INFO("%d", i);
+    FiberYield(fiber);
+  }
+}
+
+Fiber fiber;
+FiberCreate(&fiber, Count, NULL, KB(64));
+while (!FiberIsDone(&fiber)) { FiberResume(&fiber); }
+FiberDestroy(&fiber);
+#endif
+
+typedef struct Fiber Fiber;
+typedef void Fiber_Fn(Fiber* fiber, void* arg);
+struct Fiber {
+  Fiber_Fn* entry;
+  void* arg;
+  B32 is_done;
+#if defined(OS_WINDOWS)
+  void* handle;
+  void* caller;
+#else
+  U8* stack; // NOTE: includes the guard page.
+  U64 stack_size;
+#  if defined(CDEFAULT_FIBER_UCONTEXT)
+  ucontext_t context;
+  ucontext_t caller_context;
+#  else
+  void* sp;
+  void* caller_sp;
+#  endif
+#endif
+};
+
+B32  FiberCreate(Fiber* fiber, Fiber_Fn* entry, void* arg, U64 stack_size);
+void FiberDestroy(Fiber* fiber);
+void FiberResume(Fiber* fiber);
+void FiberYield(Fiber* fiber);
+B32  FiberIsDone(Fiber* fiber);
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Atomic
 ///////////////////////////////////////////////////////////////////////////////
@@ -625,6 +1048,185 @@ B32  AtomicB32FetchOr(AtomicB32* a, B32 b);
 B32  AtomicB32FetchXor(AtomicB32* a, B32 b);
 B32  AtomicB32FetchAnd(AtomicB32* a, B32 b);
 
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Virtual memory ring buffer
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: Byte ring buffer whose pages are mapped twice, back to back, so data[i] and
+// data[i + capacity] alias the same memory. Any read or write window of up to capacity bytes
+// is therefore contiguous, and never has to be split at the wrap-around point.
+//
+// Safe for a single producer and a single consumer on different threads. The producer calls
+// VRingBufferWriteBegin, fills (up to) the returned number of bytes, then VRingBufferWriteCommit.
+// The consumer does the same with VRingBufferReadBegin / VRingBufferReadCommit.
+//
+// NOTE: capacity is rounded up to a power of 2, and at least the OS mapping granularity (page
+// size on linux, 64KB on windows). Windows requires 10 1803+ (for VirtualAlloc2 / MapViewOfFile3).
+typedef struct VRingBuffer VRingBuffer;
+struct VRingBuffer {
+  U8* data;
+  U64 capacity;
+#if defined(OS_WINDOWS)
+  HANDLE mapping;
+#endif
+  // NOTE: cursors increase monotonically, and are padded onto separate cache lines.
+  U8 pad_0[64];
+  AtomicS64 write_pos;
+  U8 pad_1[64];
+  AtomicS64 read_pos;
+};
+
+B32  VRingBufferInit(VRingBuffer* ring, U64 capacity);
+void VRingBufferDeinit(VRingBuffer* ring);
+U64  VRingBufferSize(VRingBuffer* ring);
+// NOTE: Producer side.
+U8*  VRingBufferWriteBegin(VRingBuffer* ring, U64* available);
+void VRingBufferWriteCommit(VRingBuffer* ring, U64 size);
+B32  VRingBufferWrite(VRingBuffer* ring, void* src, U64 size);
+// NOTE: Consumer side.
+U8*  VRingBufferReadBegin(VRingBuffer* ring, U64* available);
+void VRingBufferReadCommit(VRingBuffer* ring, U64 size);
+B32  VRingBufferRead(VRingBuffer* ring, void* dest, U64 size);
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: CPU features
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: Runtime CPU feature detection (cpuid / xgetbv on x64, hwcaps on arm64). Detection
+// happens lazily on first query.
+typedef enum CpuFeature CpuFeature;
+enum CpuFeature {
+  CpuFeature_SSE2     = BIT(0),
+  CpuFeature_SSE3     = BIT(1),
+  CpuFeature_SSSE3    = BIT(2),
+  CpuFeature_SSE41    = BIT(3),
+  CpuFeature_SSE42    = BIT(4),
+  CpuFeature_POPCNT   = BIT(5),
+  CpuFeature_AVX      = BIT(6),
+  CpuFeature_AVX2     = BIT(7),
+  CpuFeature_FMA      = BIT(8),
+  CpuFeature_F16C     = BIT(9),
+  CpuFeature_BMI1     = BIT(10),
+  CpuFeature_BMI2     = BIT(11),
+  CpuFeature_AVX512F  = BIT(12),
+  CpuFeature_AVX512BW = BIT(13),
+  CpuFeature_AVX512DQ = BIT(14),
+  CpuFeature_AVX512VL = BIT(15),
+  CpuFeature_AES      = BIT(16),
+  CpuFeature_PCLMUL   = BIT(17),
+  CpuFeature_NEON     = BIT(18),
+  CpuFeature_CRC32    = BIT(19), // NOTE: arm64 crc32 / crc32c instructions. x64's crc32c is part of SSE42.
+};
+
+// NOTE: ISA levels, used to pick kernel variants. On x64 these follow the psABI
+// microarchitecture levels. Each level implies all lower levels.
+typedef enum CpuIsaLevel CpuIsaLevel;
+enum CpuIsaLevel {
+  CpuIsaLevel_Scalar,
+  CpuIsaLevel_SSE2,   // NOTE: x86-64 baseline.
+  CpuIsaLevel_SSE42,  // NOTE: x86-64-v2: + SSE3, SSSE3, SSE41, SSE42, POPCNT.
+  CpuIsaLevel_AVX2,   // NOTE: x86-64-v3: + AVX, AVX2, FMA, F16C, BMI1, BMI2.
+  CpuIsaLevel_AVX512, // NOTE: x86-64-v4: + AVX512 F, BW, DQ, VL.
+  CpuIsaLevel_Count,
+  CpuIsaLevel_NEON = CpuIsaLevel_SSE2, // NOTE: arm64 baseline.
+};
+
+U32  CpuFeaturesGet(void);
+B32  CpuHasFeature(CpuFeature feature);
+CpuIsaLevel CpuIsaLevelGet(void);
+// NOTE: Testing hook; hides features / levels above level, e.g. so that every kernel variant
+// can be exercised on one machine. CpuIsaLevel_Count removes the limit. Bound dispatch tables
+// are rebound on their next use.
+void CpuIsaLevelForceMax(CpuIsaLevel level);
+
+// NOTE: Kernels compiled for a higher ISA level than the build's baseline need to be marked
+// with the corresponding target attribute (no-op on MSVC, which allows any intrinsic).
+// PCLMUL isn't part of any level, so kernels using it must also check CpuHasFeature.
+#if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
+#  define CPU_TARGET_SSE42        __attribute__((target("sse4.2,popcnt")))
+#  define CPU_TARGET_SSE42_PCLMUL __attribute__((target("sse4.2,popcnt,pclmul")))
+#  define CPU_TARGET_AVX2         __attribute__((target("avx2,fma,bmi,bmi2")))
+#  define CPU_TARGET_AVX512       __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+#else
+#  define CPU_TARGET_SSE42
+#  define CPU_TARGET_SSE42_PCLMUL
+#  define CPU_TARGET_AVX2
+#  define CPU_TARGET_AVX512
+#endif
+
+// NOTE: Dispatch tables hold one variant of a kernel per ISA level (NULL if not implemented).
+// CPU_DISPATCH binds the variant for the highest supported level on first use. Scalar variants
+// should always be provided.
+// E.g.
+#if 0
+typedef U64 Sum_Fn(U8* data, U64 size);
+static CpuDispatch sum_dispatch = {
+  .variants = {
+    [CpuIsaLevel_Scalar] = (CpuKernel_Fn*) SumScalar,
+    [CpuIsaLevel_SSE2]   = (CpuKernel_Fn*) SumSse2,
+    [CpuIsaLevel_AVX2]   = (CpuKernel_Fn*) SumAvx2,
+  },
+  .bound = 0,
+};
+U64 Sum(U8* data, U64 size) { return CPU_DISPATCH(&sum_dispatch, Sum_Fn)(data, size); }
+#endif
+typedef void CpuKernel_Fn(void);
+typedef struct CpuDispatch CpuDispatch;
+struct CpuDispatch {
+  CpuKernel_Fn* variants[CpuIsaLevel_Count];
+  // NOTE: the bound level in the low 8 bits, and the generation it was bound in above them. Packed so that both
+  // are published together, and tables may be dispatched from any thread.
+  AtomicS32 bound;
+};
+
+#define CPU_DISPATCH(dispatch, type) ((type*) CpuDispatchGet(dispatch))
+CpuKernel_Fn* CpuDispatchGet(CpuDispatch* dispatch);
+CpuKernel_Fn* CpuDispatchBind(CpuDispatch* dispatch);
+
+// NOTE: Core / cache / NUMA layout, read from /sys/devices/system on linux and
+// GetLogicalProcessorInformationEx on windows. Cache sizes are in bytes, 0 if unknown.
+typedef struct CpuTopology CpuTopology;
+struct CpuTopology {
+  U32 logical_cores;
+  U32 physical_cores;
+  U32 numa_nodes;
+  U32 cache_line_size;
+  U32 l1d_cache_size; // NOTE: Per core.
+  U32 l2_cache_size;
+  U32 l3_cache_size;
+  // NOTE: indexed by logical core, U32_MAX for offline cores. SMT siblings share a physical_core_id.
+  // On windows, logical core indices are 64 * processor group + index within the group.
+  U32* physical_core_ids; // NOTE: Dense, in [0, physical_cores).
+  U32* numa_node_ids;     // NOTE: Dense, in [0, numa_nodes).
+};
+
+B32 CpuTopologyGet(Arena* arena, CpuTopology* topology);
+// NOTE: Fills cpus with one logical core per physical core, returns the number written.
+// cpus must have room for topology->physical_cores entries.
+U32 CpuTopologyOnePerPhysicalCore(CpuTopology* topology, U32* cpus);
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Checksum
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: Crc32 is the reflected CRC-32 used by zlib / gzip / png, Crc32c the Castagnoli CRC used by e.g.
+// iSCSI / ext4, and Adler32 the zlib checksum. Kernels are picked per CpuIsaLevel: slice-by-16 tables
+// for scalar, PCLMULQDQ folding for Crc32 and the crc32 instruction for Crc32c at SSE42, and SIMD
+// accumulation for Adler32 at SSE2 / AVX2.
+//
+// The *Update variants continue a running checksum, so that checksums can be computed over streamed
+// data, e.g. Crc32Update(Crc32(a), b) == Crc32(a ++ b). Start from the *_INIT value.
+#define CRC32_INIT   0
+#define CRC32C_INIT  0
+#define ADLER32_INIT 1
+
+U32 Crc32(U8* data, U64 size);
+U32 Crc32Update(U32 crc, U8* data, U64 size);
+U32 Crc32c(U8* data, U64 size);
+U32 Crc32cUpdate(U32 crc, U8* data, U64 size);
+U32 Adler32(U8* data, U64 size);
+U32 Adler32Update(U32 adler, U8* data, U64 size);
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Time
 ///////////////////////////////////////////////////////////////////////////////
@@ -668,12 +1270,6 @@ F64  RandF64(RandomSeries* rand, F64 min, F64 max);
 // NOTE: String
 ///////////////////////////////////////////////////////////////////////////////
 
-typedef struct String8 String8;
-struct String8 {
-  U8* str;
-  U32 size;
-};
-
 typedef struct String8ListNode String8ListNode;
 struct String8ListNode {
   String8ListNode* next;
@@ -750,6 +1346,63 @@ String8List Str8Split(Arena* arena, String8 string, U8 c);
 
 S32 Str8Hash(String8 s);
 
+// NOTE: Allocation-free alternatives to Str8Split. Each yielded piece points into the source string.
+// E.g.
+#if 0
+String8SplitIter it;
+Str8SplitIterInit(&it, Str8Lit("a,b,,c"), ',');
+String8 piece;
+while (Str8SplitIterNext(&it, &piece)) { ... } --> "a", "b", "", "c"
+#endif
+//
+// - SplitIter yields every piece between single byte delimiters, including empty pieces (but not a trailing empty piece).
+// - LineIter yields each line with its \n or \r\n terminator removed, including empty lines.
+// - TokenIter yields runs of bytes not in the delimiter set, skipping empty tokens. E.g. for whitespace tokenization.
+//
+// Delimiter scans are vectorized (SSE2 / NEON) when the set is small enough to compare directly.
+
+#define STR8_WHITESPACE Str8Lit(" \t\r\n\f\v")
+
+typedef struct String8ByteSet String8ByteSet;
+struct String8ByteSet {
+  U64 bits[4];        // NOTE: Membership bitmap, used by the scalar path.
+  U8  needles[8][16]; // NOTE: Each member splatted across a vector, used by the vector path. Only populated if the set is small enough.
+  U32 needles_size;
+};
+
+typedef struct String8SplitIter String8SplitIter;
+struct String8SplitIter {
+  String8 string;
+  U32 pos;
+  U8 c;
+};
+
+typedef struct String8LineIter String8LineIter;
+struct String8LineIter {
+  String8 string;
+  U32 pos;
+};
+
+typedef struct String8TokenIter String8TokenIter;
+struct String8TokenIter {
+  String8 string;
+  U32 pos;
+  String8ByteSet delims;
+};
+
+void Str8ByteSetInit(String8ByteSet* set, String8 bytes);
+B32  Str8ByteSetHas(String8ByteSet* set, U8 c);
+S32  Str8FindChar(String8 string, U32 start_pos, U8 c);                      // NOTE: Returns -1 on failure.
+S32  Str8FindByteSet(String8 string, U32 start_pos, String8ByteSet* set);    // NOTE: Returns -1 on failure.
+
+void Str8SplitIterInit(String8SplitIter* it, String8 string, U8 c);
+B32  Str8SplitIterNext(String8SplitIter* it, String8* piece);
+void Str8LineIterInit(String8LineIter* it, String8 string);
+B32  Str8LineIterNext(String8LineIter* it, String8* line);
+void Str8TokenIterInit(String8TokenIter* it, String8 string, String8 delims);
+void Str8TokenIterReset(String8TokenIter* it, String8 string); // NOTE: Retargets the iterator, keeping its delimiter set. E.g. to tokenize many lines.
+B32  Str8TokenIterNext(String8TokenIter* it, String8* token);
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Sort
 ///////////////////////////////////////////////////////////////////////////////
@@ -1104,13 +1757,12 @@ void ArenaClear(Arena* arena) {
 // NOTE: Thread Implementation
 ///////////////////////////////////////////////////////////////////////////////
 
-void ThreadCreate(Thread* thread, ThreadStart_Fn* entry, void* arg) {
+B32 ThreadCreate(Thread* thread, ThreadStart_Fn* entry, void* arg) {
 #if defined(OS_WINDOWS)
   *thread = CreateThread(0, 0, (LPTHREAD_START_ROUTINE) entry, arg, 0, 0);
-  ASSERT(*thread != NULL);
+  return *thread != NULL;
 #else
-  S32 result = thrd_create(thread, entry, arg);
-  ASSERT(result == thrd_success);
+  return thrd_create(thread, entry, arg) == thrd_success;
 #endif
 }
 
@@ -1139,6 +1791,94 @@ S32 ThreadJoin(Thread* thread) {
 #endif
 }
 
+B32 ThreadSetAffinity(U32* UNUSED(cpus), U32 UNUSED(cpus_size)) {
+#if defined(OS_WINDOWS)
+  if (cpus_size == 0) { return false; }
+  GROUP_AFFINITY affinity;
+  MEMORY_ZERO_STRUCT(&affinity);
+  affinity.Group = (WORD) (cpus[0] / 64);
+  for (U32 i = 0; i < cpus_size; i++) {
+    if (cpus[i] / 64 != affinity.Group) { return false; }
+    affinity.Mask |= (KAFFINITY) 1 << (cpus[i] % 64);
+  }
+  return SetThreadGroupAffinity(GetCurrentThread(), &affinity, NULL) != 0;
+#elif defined(OS_LINUX)
+  // NOTE: raw syscall, since the cpu_set_t api requires _GNU_SOURCE.
+  U64 mask[16];
+  MEMORY_ZERO_STATIC_ARRAY(mask);
+  for (U32 i = 0; i < cpus_size; i++) {
+    if (cpus[i] >= sizeof(mask) * 8) { return false; }
+    mask[cpus[i] / 64] |= (U64) 1 << (cpus[i] % 64);
+  }
+  return syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask) == 0;
+#else
+  // NOTE: mac doesn't support thread affinity.
+  return false;
+#endif
+}
+
+B32 ThreadSetPriority(ThreadPriority UNUSED(priority)) {
+#if defined(OS_WINDOWS)
+  S32 win_priority = THREAD_PRIORITY_NORMAL;
+  switch (priority) {
+    case ThreadPriority_Low:      { win_priority = THREAD_PRIORITY_LOWEST;        } break;
+    case ThreadPriority_Normal:   { win_priority = THREAD_PRIORITY_NORMAL;        } break;
+    case ThreadPriority_High:     { win_priority = THREAD_PRIORITY_HIGHEST;       } break;
+    case ThreadPriority_RealTime: { win_priority = THREAD_PRIORITY_TIME_CRITICAL; } break;
+  }
+  return SetThreadPriority(GetCurrentThread(), win_priority) != 0;
+#elif defined(OS_LINUX)
+  // NOTE: on linux, sched_setscheduler(0) and the nice value both apply per-thread.
+  struct sched_param param;
+  MEMORY_ZERO_STRUCT(&param);
+  if (priority == ThreadPriority_RealTime) {
+    param.sched_priority = (sched_get_priority_min(SCHED_FIFO) + sched_get_priority_max(SCHED_FIFO)) / 2;
+    return sched_setscheduler(0, SCHED_FIFO, &param) == 0;
+  }
+  if (sched_setscheduler(0, SCHED_OTHER, &param) != 0) { return false; }
+  S32 nice = 0;
+  switch (priority) {
+    case ThreadPriority_Low:  { nice = 10;  } break;
+    case ThreadPriority_High: { nice = -10; } break;
+    default: break;
+  }
+  return setpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid), nice) == 0;
+#else
+  // TODO: mac support, e.g. via pthread_set_qos_class_self_np.
+  return false;
+#endif
+}
+
+B32 ThreadSetName(String8 name) {
+#if defined(OS_WINDOWS)
+  // NOTE: loaded dynamically since it's only available on windows 10 1607+.
+  typedef HRESULT SetThreadDescription_Fn(HANDLE, PCWSTR);
+  HMODULE kernel32 = GetModuleHandleA("kernel32.dll");
+  if (kernel32 == NULL) { return false; }
+  SetThreadDescription_Fn* set_thread_description = (SetThreadDescription_Fn*) GetProcAddress(kernel32, "SetThreadDescription");
+  if (set_thread_description == NULL) { return false; }
+  WCHAR wide_name[64];
+  U32 size = MIN(name.size, STATIC_ARRAY_SIZE(wide_name) - 1);
+  for (U32 i = 0; i < size; i++) { wide_name[i] = name.str[i]; }
+  wide_name[size] = 0;
+  return SUCCEEDED(set_thread_description(GetCurrentThread(), wide_name));
+#else
+  char c_name[64];
+#  if defined(OS_LINUX)
+  U32 size = MIN(name.size, 15);
+#  else
+  U32 size = MIN(name.size, STATIC_ARRAY_SIZE(c_name) - 1);
+#  endif
+  MEMORY_COPY_SIZE(c_name, name.str, size);
+  c_name[size] = 0;
+#  if defined(OS_LINUX)
+  return prctl(PR_SET_NAME, c_name, 0, 0, 0) == 0;
+#  else
+  return pthread_setname_np(c_name) == 0;
+#  endif
+#endif
+}
+
 void MutexInit(Mutex* mutex) {
 #if defined(OS_WINDOWS)
   InitializeCriticalSection(mutex);
@@ -1261,6 +2001,235 @@ void NotifWaitAndDeinit(Notif* notification) {
   SemDeinit(notification);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Fiber Implementation
+///////////////////////////////////////////////////////////////////////////////
+
+static void _FiberMain(Fiber* fiber) {
+  fiber->entry(fiber, fiber->arg);
+  fiber->is_done = true;
+  FiberYield(fiber);
+  UNREACHABLE();
+}
+
+B32 FiberIsDone(Fiber* fiber) {
+  return fiber->is_done;
+}
+
+#if defined(OS_WINDOWS)
+
+static VOID WINAPI _FiberMainWindows(LPVOID param) {
+  _FiberMain((Fiber*) param);
+}
+
+B32 FiberCreate(Fiber* fiber, Fiber_Fn* entry, void* arg, U64 stack_size) {
+  MEMORY_ZERO_STRUCT(fiber);
+  fiber->entry = entry;
+  fiber->arg = arg;
+  // NOTE: windows reserves the stack and its guard page itself.
+  fiber->handle = CreateFiber(stack_size, _FiberMainWindows, fiber);
+  return fiber->handle != NULL;
+}
+
+void FiberDestroy(Fiber* fiber) {
+  DeleteFiber(fiber->handle);
+}
+
+void FiberResume(Fiber* fiber) {
+  DEBUG_ASSERT(!fiber->is_done);
+  if (!IsThreadAFiber()) { ConvertThreadToFiber(NULL); }
+  fiber->caller = GetCurrentFiber();
+  SwitchToFiber(fiber->handle);
+}
+
+void FiberYield(Fiber* fiber) {
+  SwitchToFiber(fiber->caller);
+}
+
+#else
+
+static B32 _FiberAllocateStack(Fiber* fiber, U64 stack_size) {
+  U64 page_size = (U64) sysconf(_SC_PAGESIZE);
+  stack_size = ALIGN_POW_2(stack_size, page_size);
+  fiber->stack = (U8*) MemoryReserve(stack_size + page_size);
+  if (fiber->stack == NULL) { return false; }
+  // NOTE: the lowest page is left reserved but inaccessible, stacks grow down into it.
+  if (!MemoryCommit(fiber->stack + page_size, stack_size)) {
+    MemoryRelease(fiber->stack, stack_size + page_size);
+    return false;
+  }
+  fiber->stack_size = stack_size + page_size;
+  return true;
+}
+
+void FiberDestroy(Fiber* fiber) {
+  MemoryRelease(fiber->stack, fiber->stack_size);
+}
+
+#if defined(CDEFAULT_FIBER_UCONTEXT)
+
+// NOTE: makecontext only passes int arguments, so the fiber pointer is split in 2.
+static void _FiberMainUcontext(U32 lo, U32 hi) {
+  _FiberMain((Fiber*) (((U64) hi << 32) | (U64) lo));
+}
+
+B32 FiberCreate(Fiber* fiber, Fiber_Fn* entry, void* arg, U64 stack_size) {
+  MEMORY_ZERO_STRUCT(fiber);
+  fiber->entry = entry;
+  fiber->arg = arg;
+  if (!_FiberAllocateStack(fiber, stack_size)) { return false; }
+  U64 page_size = (U64) sysconf(_SC_PAGESIZE);
+  getcontext(&fiber->context);
+  fiber->context.uc_stack.ss_sp = fiber->stack + page_size;
+  fiber->context.uc_stack.ss_size = fiber->stack_size - page_size;
+  fiber->context.uc_link = NULL;
+  U64 fiber_ptr = (U64) fiber;
+  makecontext(&fiber->context, (void (*)(void)) _FiberMainUcontext, 2, (U32) fiber_ptr, (U32) (fiber_ptr >> 32));
+  return true;
+}
+
+void FiberResume(Fiber* fiber) {
+  DEBUG_ASSERT(!fiber->is_done);
+  swapcontext(&fiber->caller_context, &fiber->context);
+}
+
+void FiberYield(Fiber* fiber) {
+  swapcontext(&fiber->context, &fiber->caller_context);
+}
+
+#else
+
+// NOTE: _FiberSwitch pushes the callee-saved registers onto the current stack, stores the
+// stack pointer to *from_sp, then loads to_sp and pops the other context's registers.
+// New fibers start with a stack that "returns" into _FiberTrampoline, which calls _FiberMain
+// with the fiber (both stashed in callee-saved registers).
+void _FiberSwitch(void** from_sp, void* to_sp);
+void _FiberTrampoline(void);
+
+#if defined(OS_MAC)
+#  define FIBER_ASM_FN(name) ".globl _" #name "\n_" #name ":\n"
+#else
+#  define FIBER_ASM_FN(name) ".globl " #name "\n.type " #name ", @function\n" #name ":\n"
+#endif
+
+#if defined(ARCH_X64)
+
+// NOTE: sysv: rbx, rbp, r12-r15, and the mxcsr / x87 control words are callee-saved.
+__asm__(
+  ".text\n"
+  FIBER_ASM_FN(_FiberSwitch)
+  "  pushq %rbp\n"
+  "  pushq %rbx\n"
+  "  pushq %r12\n"
+  "  pushq %r13\n"
+  "  pushq %r14\n"
+  "  pushq %r15\n"
+  "  subq $8, %rsp\n"
+  "  stmxcsr (%rsp)\n"
+  "  fnstcw 4(%rsp)\n"
+  "  movq %rsp, (%rdi)\n"
+  "  movq %rsi, %rsp\n"
+  "  ldmxcsr (%rsp)\n"
+  "  fldcw 4(%rsp)\n"
+  "  addq $8, %rsp\n"
+  "  popq %r15\n"
+  "  popq %r14\n"
+  "  popq %r13\n"
+  "  popq %r12\n"
+  "  popq %rbx\n"
+  "  popq %rbp\n"
+  "  ret\n"
+  FIBER_ASM_FN(_FiberTrampoline)
+  "  movq %rbx, %rdi\n"
+  "  callq *%r12\n"
+  "  ud2\n"
+);
+
+static void* _FiberInitStack(Fiber* fiber, U8* top) {
+  // NOTE: mirrors _FiberSwitch's pushes. top is 16 byte aligned, so after the final ret the
+  // trampoline's call is correctly aligned.
+  U64* sp = (U64*) top - 8;
+  MEMORY_ZERO_ARRAY(sp, 8);
+  sp[0] = ((U64) 0x037F << 32) | 0x1F80; // NOTE: default x87 control word, mxcsr.
+  sp[4] = (U64) _FiberMain;              // r12
+  sp[5] = (U64) fiber;                   // rbx
+  sp[7] = (U64) _FiberTrampoline;        // return address
+  return sp;
+}
+
+#elif defined(ARCH_ARM64)
+
+// NOTE: aapcs64: x19-x28, fp, lr, and the low halves of v8-v15 are callee-saved.
+__asm__(
+  ".text\n"
+  ".p2align 2\n"
+  FIBER_ASM_FN(_FiberSwitch)
+  "  sub sp, sp, #176\n"
+  "  stp x19, x20, [sp, #0]\n"
+  "  stp x21, x22, [sp, #16]\n"
+  "  stp x23, x24, [sp, #32]\n"
+  "  stp x25, x26, [sp, #48]\n"
+  "  stp x27, x28, [sp, #64]\n"
+  "  stp x29, x30, [sp, #80]\n"
+  "  stp d8,  d9,  [sp, #96]\n"
+  "  stp d10, d11, [sp, #112]\n"
+  "  stp d12, d13, [sp, #128]\n"
+  "  stp d14, d15, [sp, #144]\n"
+  "  mov x2, sp\n"
+  "  str x2, [x0]\n"
+  "  mov sp, x1\n"
+  "  ldp x19, x20, [sp, #0]\n"
+  "  ldp x21, x22, [sp, #16]\n"
+  "  ldp x23, x24, [sp, #32]\n"
+  "  ldp x25, x26, [sp, #48]\n"
+  "  ldp x27, x28, [sp, #64]\n"
+  "  ldp x29, x30, [sp, #80]\n"
+  "  ldp d8,  d9,  [sp, #96]\n"
+  "  ldp d10, d11, [sp, #112]\n"
+  "  ldp d12, d13, [sp, #128]\n"
+  "  ldp d14, d15, [sp, #144]\n"
+  "  add sp, sp, #176\n"
+  "  ret\n"
+  FIBER_ASM_FN(_FiberTrampoline)
+  "  mov x0, x19\n"
+  "  blr x20\n"
+  "  brk #0\n"
+);
+
+static void* _FiberInitStack(Fiber* fiber, U8* top) {
+  // NOTE: mirrors _FiberSwitch's frame.
+  U64* sp = (U64*) (top - 176);
+  MEMORY_ZERO_SIZE(sp, 176);
+  sp[0]  = (U64) fiber;            // x19
+  sp[1]  = (U64) _FiberMain;       // x20
+  sp[11] = (U64) _FiberTrampoline; // x30 / lr
+  return sp;
+}
+
+#endif
+
+B32 FiberCreate(Fiber* fiber, Fiber_Fn* entry, void* arg, U64 stack_size) {
+  MEMORY_ZERO_STRUCT(fiber);
+  fiber->entry = entry;
+  fiber->arg = arg;
+  if (!_FiberAllocateStack(fiber, stack_size)) { return false; }
+  U8* top = (U8*) ((U64) (fiber->stack + fiber->stack_size) & ~(U64) 15);
+  fiber->sp = _FiberInitStack(fiber, top);
+  return true;
+}
+
+void FiberResume(Fiber* fiber) {
+  DEBUG_ASSERT(!fiber->is_done);
+  _FiberSwitch(&fiber->caller_sp, fiber->sp);
+}
+
+void FiberYield(Fiber* fiber) {
+  _FiberSwitch(&fiber->sp, fiber->caller_sp);
+}
+
+#endif // CDEFAULT_FIBER_UCONTEXT
+#endif // OS_WINDOWS
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Atomic Implementation
 ///////////////////////////////////////////////////////////////////////////////
@@ -1277,8 +2246,11 @@ S64 AtomicS64FetchOr(AtomicS64* a, S64 b) { return InterlockedOr64(a, b); }
 S64 AtomicS64FetchXor(AtomicS64* a, S64 b) { return InterlockedXor64(a, b); }
 S64 AtomicS64FetchAnd(AtomicS64* a, S64 b) { return InterlockedAnd64(a, b); }
 B8 AtomicS64CompareExchange(AtomicS64* a, S64* expected, S64 desired) {
-  S64 result = InterlockedCompareExchange64(a, *expected, desired);
-  return (result == *expected);
+  // NOTE: matches the C11 semantics, *expected is updated with the current value on failure.
+  S64 result = InterlockedCompareExchange64(a, desired, *expected);
+  if (result == *expected) { return true; }
+  *expected = result;
+  return false;
 }
 
 void AtomicS32Init(AtomicS32* a, S32 desired) { InterlockedExchange(a, desired); }
@@ -1291,8 +2263,10 @@ S32 AtomicS32FetchOr(AtomicS32* a, S32 b) { return InterlockedOr(a, b); }
 S32 AtomicS32FetchXor(AtomicS32* a, S32 b) { return InterlockedXor(a, b); }
 S32 AtomicS32FetchAnd(AtomicS32* a, S32 b) { return InterlockedAnd(a, b); }
 B8 AtomicS32CompareExchange(AtomicS32* a, S32* expected, S32 desired) {
-  S32 result = InterlockedCompareExchange(a, *expected, desired);
-  return (result == *expected);
+  S32 result = InterlockedCompareExchange(a, desired, *expected);
+  if (result == *expected) { return true; }
+  *expected = result;
+  return false;
 }
 
 void AtomicB32Init(AtomicB32* a, B32 desired) { InterlockedExchange(a, desired); }
@@ -1303,8 +2277,10 @@ B32 AtomicB32FetchOr(AtomicB32* a, B32 b) { return InterlockedOr(a, b); }
 B32 AtomicB32FetchXor(AtomicB32* a, B32 b) { return InterlockedXor(a, b); }
 B32 AtomicB32FetchAnd(AtomicB32* a, B32 b) { return InterlockedAnd(a, b); }
 B8 AtomicB32CompareExchange(AtomicB32* a, B32* expected, B32 desired) {
-  B32 result = InterlockedCompareExchange(a, *expected, desired);
-  return (result == *expected);
+  B32 result = InterlockedCompareExchange(a, desired, *expected);
+  if (result == *expected) { return true; }
+  *expected = result;
+  return false;
 }
 
 #else
@@ -1348,6 +2324,780 @@ B8 AtomicB32CompareExchange(AtomicB32* a, B32* expected, B32 desired) {
 
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Virtual memory ring buffer Implementation
+///////////////////////////////////////////////////////////////////////////////
+
+B32 VRingBufferInit(VRingBuffer* ring, U64 capacity) {
+  MEMORY_ZERO_STRUCT(ring);
+#if defined(OS_WINDOWS)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  U64 granularity = info.dwAllocationGranularity;
+#else
+  U64 granularity = (U64) sysconf(_SC_PAGESIZE);
+#endif
+  // NOTE: keep capacity a power of 2 so cursors can be masked.
+  U64 aligned_capacity = granularity;
+  while (aligned_capacity < capacity) { aligned_capacity *= 2; }
+  capacity = aligned_capacity;
+
+#if defined(OS_WINDOWS)
+  // NOTE: loaded dynamically so that users don't need to link onecore.lib.
+  typedef PVOID VirtualAlloc2_Fn(HANDLE, PVOID, SIZE_T, ULONG, ULONG, MEM_EXTENDED_PARAMETER*, ULONG);
+  typedef PVOID MapViewOfFile3_Fn(HANDLE, HANDLE, PVOID, ULONG64, SIZE_T, ULONG, ULONG, MEM_EXTENDED_PARAMETER*, ULONG);
+  HMODULE kernelbase = GetModuleHandleA("kernelbase.dll");
+  if (kernelbase == NULL) { return false; }
+  VirtualAlloc2_Fn* virtual_alloc_2 = (VirtualAlloc2_Fn*) GetProcAddress(kernelbase, "VirtualAlloc2");
+  MapViewOfFile3_Fn* map_view_of_file_3 = (MapViewOfFile3_Fn*) GetProcAddress(kernelbase, "MapViewOfFile3");
+  if (virtual_alloc_2 == NULL || map_view_of_file_3 == NULL) { return false; }
+
+  // NOTE: reserve a 2x placeholder, split it in 2, then replace each half with a view of the same mapping.
+  B32 success = false;
+  U8* placeholder = NULL;
+  U8* view_0 = NULL;
+  U8* view_1 = NULL;
+  HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                      (DWORD) (capacity >> 32), (DWORD) (capacity & 0xFFFFFFFF), NULL);
+  if (mapping == NULL) { goto vring_buffer_init_exit; }
+  placeholder = (U8*) virtual_alloc_2(NULL, NULL, 2 * capacity, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, NULL, 0);
+  if (placeholder == NULL) { goto vring_buffer_init_exit; }
+  if (!VirtualFree(placeholder, capacity, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER)) { goto vring_buffer_init_exit; }
+  view_0 = (U8*) map_view_of_file_3(mapping, NULL, placeholder, 0, capacity, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, NULL, 0);
+  if (view_0 == NULL) { goto vring_buffer_init_exit; }
+  view_1 = (U8*) map_view_of_file_3(mapping, NULL, placeholder + capacity, 0, capacity, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, NULL, 0);
+  if (view_1 == NULL) { goto vring_buffer_init_exit; }
+  ring->data     = view_0;
+  ring->capacity = capacity;
+  ring->mapping  = mapping;
+  success = true;
+
+vring_buffer_init_exit:
+  if (!success) {
+    if (view_1 != NULL) { UnmapViewOfFile(view_1); }
+    else if (placeholder != NULL) { VirtualFree(placeholder + capacity, 0, MEM_RELEASE); }
+    if (view_0 != NULL) { UnmapViewOfFile(view_0); }
+    else if (placeholder != NULL) { VirtualFree(placeholder, 0, MEM_RELEASE); }
+    if (mapping != NULL) { CloseHandle(mapping); }
+  }
+#elif defined(OS_LINUX)
+  // NOTE: reserve a 2x region, then map the same memfd over each half.
+  B32 success = false;
+  U8* base = MAP_FAILED;
+  S32 fd = (S32) syscall(SYS_memfd_create, "cdefault_vring_buffer", 0);
+  if (fd < 0) { goto vring_buffer_init_exit; }
+  if (ftruncate(fd, capacity) != 0) { goto vring_buffer_init_exit; }
+  base = (U8*) mmap(NULL, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) { goto vring_buffer_init_exit; }
+  if (mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != base) {
+    goto vring_buffer_init_exit;
+  }
+  if (mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != base + capacity) {
+    goto vring_buffer_init_exit;
+  }
+  ring->data     = base;
+  ring->capacity = capacity;
+  success = true;
+
+vring_buffer_init_exit:
+  if (!success && base != MAP_FAILED) { munmap(base, 2 * capacity); }
+  // NOTE: the mappings keep the memory alive.
+  if (fd >= 0) { close(fd); }
+#else
+  // TODO: mac support, e.g. via mach_vm_remap.
+  B32 success = false;
+#endif
+
+  AtomicS64Init(&ring->write_pos, 0);
+  AtomicS64Init(&ring->read_pos, 0);
+  return success;
+}
+
+void VRingBufferDeinit(VRingBuffer* ring) {
+  if (ring->data == NULL) { return; }
+#if defined(OS_WINDOWS)
+  UnmapViewOfFile(ring->data);
+  UnmapViewOfFile(ring->data + ring->capacity);
+  CloseHandle(ring->mapping);
+#elif defined(OS_LINUX)
+  munmap(ring->data, 2 * ring->capacity);
+#endif
+  ring->data = NULL;
+}
+
+U64 VRingBufferSize(VRingBuffer* ring) {
+  return AtomicS64Load(&ring->write_pos) - AtomicS64Load(&ring->read_pos);
+}
+
+U8* VRingBufferWriteBegin(VRingBuffer* ring, U64* available) {
+  S64 write_pos = AtomicS64Load(&ring->write_pos);
+  S64 read_pos  = AtomicS64Load(&ring->read_pos);
+  *available = ring->capacity - (U64) (write_pos - read_pos);
+  return ring->data + (write_pos & (ring->capacity - 1));
+}
+
+void VRingBufferWriteCommit(VRingBuffer* ring, U64 size) {
+  DEBUG_ASSERT(VRingBufferSize(ring) + size <= ring->capacity);
+  AtomicS64FetchAdd(&ring->write_pos, size);
+}
+
+B32 VRingBufferWrite(VRingBuffer* ring, void* src, U64 size) {
+  U64 available;
+  U8* dest = VRingBufferWriteBegin(ring, &available);
+  if (available < size) { return false; }
+  MEMORY_COPY_SIZE(dest, src, size);
+  VRingBufferWriteCommit(ring, size);
+  return true;
+}
+
+U8* VRingBufferReadBegin(VRingBuffer* ring, U64* available) {
+  S64 read_pos  = AtomicS64Load(&ring->read_pos);
+  S64 write_pos = AtomicS64Load(&ring->write_pos);
+  *available = (U64) (write_pos - read_pos);
+  return ring->data + (read_pos & (ring->capacity - 1));
+}
+
+void VRingBufferReadCommit(VRingBuffer* ring, U64 size) {
+  DEBUG_ASSERT(size <= VRingBufferSize(ring));
+  AtomicS64FetchAdd(&ring->read_pos, size);
+}
+
+B32 VRingBufferRead(VRingBuffer* ring, void* dest, U64 size) {
+  U64 available;
+  U8* src = VRingBufferReadBegin(ring, &available);
+  if (available < size) { return false; }
+  MEMORY_COPY_SIZE(dest, src, size);
+  VRingBufferReadCommit(ring, size);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: CPU features Implementation
+///////////////////////////////////////////////////////////////////////////////
+
+// NOTE: starts at 1 so that zero-initialized dispatch tables bind on first use.
+static AtomicS32 _cpu_dispatch_generation = 1;
+static AtomicS32 _cpu_isa_level_max = CpuIsaLevel_Count;
+static AtomicB32 _cpu_features_claimed;
+static AtomicB32 _cpu_features_ready;
+static U32 _cpu_features;
+static CpuIsaLevel _cpu_isa_level;
+
+#define CPU_DISPATCH_LEVEL_BITS      8
+#define CPU_DISPATCH_GENERATION_MASK (0xFFFFFFFF >> CPU_DISPATCH_LEVEL_BITS)
+
+#define CPU_FEATURES_SSE42  (CpuFeature_SSE3 | CpuFeature_SSSE3 | CpuFeature_SSE41 | CpuFeature_SSE42 | CpuFeature_POPCNT)
+#define CPU_FEATURES_AVX2   (CpuFeature_AVX | CpuFeature_AVX2 | CpuFeature_FMA | CpuFeature_F16C | CpuFeature_BMI1 | CpuFeature_BMI2)
+#define CPU_FEATURES_AVX512 (CpuFeature_AVX512F | CpuFeature_AVX512BW | CpuFeature_AVX512DQ | CpuFeature_AVX512VL)
+
+#if defined(ARCH_X64)
+static void _CpuId(U32 leaf, U32 subleaf, U32* regs) {
+#if defined(COMPILER_MSVC)
+  __cpuidex((int*) regs, leaf, subleaf);
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static U64 _CpuXgetbv(void) {
+#if defined(COMPILER_MSVC)
+  return _xgetbv(0);
+#else
+  U32 lo, hi;
+  __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return ((U64) hi << 32) | lo;
+#endif
+}
+#endif
+
+static void _CpuFeaturesDetect(void) {
+  U32 features = 0;
+#if defined(ARCH_X64)
+  U32 regs[4]; // NOTE: eax, ebx, ecx, edx
+  _CpuId(0, 0, regs);
+  U32 max_leaf = regs[0];
+  _CpuId(1, 0, regs);
+  U32 ecx_1 = regs[2];
+  U32 edx_1 = regs[3];
+  if (EXTRACT_BIT(edx_1, 26)) { features |= CpuFeature_SSE2;   }
+  if (EXTRACT_BIT(ecx_1, 0))  { features |= CpuFeature_SSE3;   }
+  if (EXTRACT_BIT(ecx_1, 1))  { features |= CpuFeature_PCLMUL; }
+  if (EXTRACT_BIT(ecx_1, 9))  { features |= CpuFeature_SSSE3;  }
+  if (EXTRACT_BIT(ecx_1, 19)) { features |= CpuFeature_SSE41;  }
+  if (EXTRACT_BIT(ecx_1, 20)) { features |= CpuFeature_SSE42;  }
+  if (EXTRACT_BIT(ecx_1, 23)) { features |= CpuFeature_POPCNT; }
+  if (EXTRACT_BIT(ecx_1, 25)) { features |= CpuFeature_AES;    }
+
+  // NOTE: AVX state (and AVX512 state) must also be enabled by the OS, per XCR0.
+  B32 os_avx = false;
+  B32 os_avx512 = false;
+  if (EXTRACT_BIT(ecx_1, 27)) {
+    U64 xcr0 = _CpuXgetbv();
+    os_avx = (xcr0 & 0x6) == 0x6;
+    os_avx512 = os_avx && (xcr0 & 0xe0) == 0xe0;
+  }
+  if (os_avx) {
+    if (EXTRACT_BIT(ecx_1, 28)) { features |= CpuFeature_AVX;  }
+    if (EXTRACT_BIT(ecx_1, 12)) { features |= CpuFeature_FMA;  }
+    if (EXTRACT_BIT(ecx_1, 29)) { features |= CpuFeature_F16C; }
+  }
+  if (max_leaf >= 7) {
+    _CpuId(7, 0, regs);
+    U32 ebx_7 = regs[1];
+    if (EXTRACT_BIT(ebx_7, 3)) { features |= CpuFeature_BMI1; }
+    if (EXTRACT_BIT(ebx_7, 8)) { features |= CpuFeature_BMI2; }
+    if (os_avx && EXTRACT_BIT(ebx_7, 5)) { features |= CpuFeature_AVX2; }
+    if (os_avx512) {
+      if (EXTRACT_BIT(ebx_7, 16)) { features |= CpuFeature_AVX512F;  }
+      if (EXTRACT_BIT(ebx_7, 17)) { features |= CpuFeature_AVX512DQ; }
+      if (EXTRACT_BIT(ebx_7, 30)) { features |= CpuFeature_AVX512BW; }
+      if (EXTRACT_BIT(ebx_7, 31)) { features |= CpuFeature_AVX512VL; }
+    }
+  }
+
+  CpuIsaLevel level = CpuIsaLevel_Scalar;
+  if (features & CpuFeature_SSE2) { level = CpuIsaLevel_SSE2; }
+  if (level == CpuIsaLevel_SSE2  && (features & CPU_FEATURES_SSE42)  == CPU_FEATURES_SSE42)  { level = CpuIsaLevel_SSE42;  }
+  if (level == CpuIsaLevel_SSE42 && (features & CPU_FEATURES_AVX2)   == CPU_FEATURES_AVX2)   { level = CpuIsaLevel_AVX2;   }
+  if (level == CpuIsaLevel_AVX2  && (features & CPU_FEATURES_AVX512) == CPU_FEATURES_AVX512) { level = CpuIsaLevel_AVX512; }
+
+#elif defined(ARCH_ARM64)
+  // NOTE: NEON is mandatory on arm64.
+  features |= CpuFeature_NEON;
+#  if defined(OS_LINUX)
+  U64 hwcap = getauxval(AT_HWCAP);
+  if (hwcap & BIT(3)) { features |= CpuFeature_AES;    } // NOTE: HWCAP_AES
+  if (hwcap & BIT(4)) { features |= CpuFeature_PCLMUL; } // NOTE: HWCAP_PMULL
+  if (hwcap & BIT(7)) { features |= CpuFeature_CRC32;  } // NOTE: HWCAP_CRC32
+#  elif defined(OS_WINDOWS)
+  if (IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE)) { features |= CpuFeature_AES | CpuFeature_PCLMUL; }
+  if (IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE))  { features |= CpuFeature_CRC32; }
+#  elif defined(OS_MAC)
+  // NOTE: all apple silicon supports these.
+  features |= CpuFeature_AES | CpuFeature_PCLMUL | CpuFeature_CRC32;
+#  endif
+  CpuIsaLevel level = CpuIsaLevel_NEON;
+#endif
+
+  _cpu_features = features;
+  _cpu_isa_level = level;
+}
+
+// NOTE: Same as the crc tables, the first caller detects and then publishes the features, others spin until ready.
+static void _CpuFeaturesInit(void) {
+  if (AtomicB32Load(&_cpu_features_ready)) { return; }
+  if (!AtomicB32Exchange(&_cpu_features_claimed, true)) {
+    _CpuFeaturesDetect();
+    AtomicB32Store(&_cpu_features_ready, true);
+    return;
+  }
+  while (!AtomicB32Load(&_cpu_features_ready)) {}
+}
+
+U32 CpuFeaturesGet(void) {
+  _CpuFeaturesInit();
+  U32 result = _cpu_features;
+  CpuIsaLevel level = CpuIsaLevelGet();
+  if (level < CpuIsaLevel_AVX512) { result &= ~CPU_FEATURES_AVX512; }
+  if (level < CpuIsaLevel_AVX2)   { result &= ~CPU_FEATURES_AVX2; }
+  if (level < CpuIsaLevel_SSE42)  { result &= ~CPU_FEATURES_SSE42; }
+  // NOTE: everything else is treated as baseline.
+  if (level < CpuIsaLevel_SSE2)   { result = 0; }
+  return result;
+}
+
+B32 CpuHasFeature(CpuFeature feature) {
+  return (CpuFeaturesGet() & feature) == (U32) feature;
+}
+
+CpuIsaLevel CpuIsaLevelGet(void) {
+  _CpuFeaturesInit();
+  return MIN(_cpu_isa_level, (CpuIsaLevel) AtomicS32Load(&_cpu_isa_level_max));
+}
+
+void CpuIsaLevelForceMax(CpuIsaLevel level) {
+  AtomicS32Store(&_cpu_isa_level_max, level);
+  AtomicS32FetchAdd(&_cpu_dispatch_generation, 1);
+}
+
+CpuKernel_Fn* CpuDispatchGet(CpuDispatch* dispatch) {
+  U32 bound = (U32) AtomicS32Load(&dispatch->bound);
+  U32 generation = (U32) AtomicS32Load(&_cpu_dispatch_generation) & CPU_DISPATCH_GENERATION_MASK;
+  if ((bound >> CPU_DISPATCH_LEVEL_BITS) != generation) { return CpuDispatchBind(dispatch); }
+  return dispatch->variants[bound & ((1 << CPU_DISPATCH_LEVEL_BITS) - 1)];
+}
+
+// NOTE: The generation is read before the level, so that racing CpuIsaLevelForceMax at worst binds the new level
+// under the old generation, which is rebound on next use.
+CpuKernel_Fn* CpuDispatchBind(CpuDispatch* dispatch) {
+  U32 generation = (U32) AtomicS32Load(&_cpu_dispatch_generation) & CPU_DISPATCH_GENERATION_MASK;
+  S32 level = CpuIsaLevelGet();
+  while (level > 0 && dispatch->variants[level] == NULL) { level--; }
+  DEBUG_ASSERT(dispatch->variants[level] != NULL);
+  AtomicS32Store(&dispatch->bound, (S32) ((generation << CPU_DISPATCH_LEVEL_BITS) | (U32) level));
+  return dispatch->variants[level];
+}
+
+#if defined(OS_LINUX)
+// NOTE: Builds e.g. "/sys/devices/system/cpu/cpu" + 3 + "/topology/core_id".
+static void _CpuSysPath(char* path, char* prefix, U32 index, char* suffix) {
+  while (*prefix) { *path++ = *prefix++; }
+  char digits[10];
+  U32 digits_size = 0;
+  do { digits[digits_size++] = '0' + (index % 10); index /= 10; } while (index > 0);
+  while (digits_size > 0) { *path++ = digits[--digits_size]; }
+  while (*suffix) { *path++ = *suffix++; }
+  *path = 0;
+}
+
+// NOTE: Reads a small sysfs file, null terminated.
+static B32 _CpuSysRead(char* path, char* buffer, U32 buffer_size) {
+  S32 fd = open(path, O_RDONLY);
+  if (fd < 0) { return false; }
+  S64 size = read(fd, buffer, buffer_size - 1);
+  close(fd);
+  if (size <= 0) { return false; }
+  buffer[size] = 0;
+  return true;
+}
+
+// NOTE: Parses e.g. "48" or "48K".
+static B32 _CpuSysReadU32(char* path, U32* result) {
+  char buffer[64];
+  if (!_CpuSysRead(path, buffer, sizeof(buffer))) { return false; }
+  char* c = buffer;
+  if (*c < '0' || *c > '9') { return false; }
+  U32 value = 0;
+  while (*c >= '0' && *c <= '9') { value = value * 10 + (*c++ - '0'); }
+  if (*c == 'K') { value *= KB(1); }
+  if (*c == 'M') { value *= MB(1); }
+  *result = value;
+  return true;
+}
+#endif
+
+B32 CpuTopologyGet(Arena* arena, CpuTopology* topology) {
+  MEMORY_ZERO_STRUCT(topology);
+#if defined(OS_WINDOWS)
+  WORD groups = GetActiveProcessorGroupCount();
+  topology->logical_cores = (groups == 1) ? GetActiveProcessorCount(0) : groups * 64;
+  topology->physical_core_ids = ARENA_PUSH_ARRAY(arena, U32, topology->logical_cores);
+  topology->numa_node_ids = ARENA_PUSH_ARRAY(arena, U32, topology->logical_cores);
+  MEMORY_SET_SIZE(topology->physical_core_ids, 0xff, sizeof(U32) * topology->logical_cores);
+  MEMORY_SET_SIZE(topology->numa_node_ids, 0xff, sizeof(U32) * topology->logical_cores);
+
+  B32 success = false;
+  U64 arena_pos = ArenaPos(arena);
+  DWORD info_size = 0;
+  GetLogicalProcessorInformationEx(RelationAll, NULL, &info_size);
+  if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) { goto cpu_topology_get_exit; }
+  U8* infos = ARENA_PUSH_ARRAY(arena, U8, info_size);
+  if (!GetLogicalProcessorInformationEx(RelationAll, (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*) infos, &info_size)) {
+    goto cpu_topology_get_exit;
+  }
+  for (U8* curr = infos; curr < infos + info_size;) {
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*) curr;
+    curr += info->Size;
+    GROUP_AFFINITY* masks = NULL;
+    U32 masks_size = 0;
+    U32* ids = NULL;
+    U32 id = 0;
+    switch (info->Relationship) {
+      case RelationProcessorCore: {
+        masks = info->Processor.GroupMask;
+        masks_size = info->Processor.GroupCount;
+        ids = topology->physical_core_ids;
+        id = topology->physical_cores++;
+      } break;
+      case RelationNumaNode: {
+        masks = &info->NumaNode.GroupMask;
+        masks_size = 1;
+        ids = topology->numa_node_ids;
+        id = topology->numa_nodes++;
+      } break;
+      case RelationCache: {
+        CACHE_RELATIONSHIP* cache = &info->Cache;
+        topology->cache_line_size = cache->LineSize;
+        if (cache->Level == 1 && cache->Type == CacheData) { topology->l1d_cache_size = cache->CacheSize; }
+        if (cache->Level == 2) { topology->l2_cache_size = cache->CacheSize; }
+        if (cache->Level == 3) { topology->l3_cache_size = cache->CacheSize; }
+      } break;
+      default: break;
+    }
+    for (U32 i = 0; i < masks_size; i++) {
+      for (U32 bit = 0; bit < 64; bit++) {
+        if (!(masks[i].Mask & ((KAFFINITY) 1 << bit))) { continue; }
+        U32 cpu = masks[i].Group * 64 + bit;
+        if (cpu < topology->logical_cores) { ids[cpu] = id; }
+      }
+    }
+  }
+  success = true;
+
+cpu_topology_get_exit:
+  ArenaPopTo(arena, arena_pos);
+  return success;
+
+#elif defined(OS_LINUX)
+  char path[128];
+  topology->logical_cores = (U32) sysconf(_SC_NPROCESSORS_CONF);
+  if (topology->logical_cores == 0) { return false; }
+  topology->physical_core_ids = ARENA_PUSH_ARRAY(arena, U32, topology->logical_cores);
+  topology->numa_node_ids = ARENA_PUSH_ARRAY(arena, U32, topology->logical_cores);
+  MEMORY_SET_SIZE(topology->physical_core_ids, 0xff, sizeof(U32) * topology->logical_cores);
+  MEMORY_SET_SIZE(topology->numa_node_ids, 0xff, sizeof(U32) * topology->logical_cores);
+
+  // NOTE: physical cores are unique (package, core id) pairs.
+  U64 arena_pos = ArenaPos(arena);
+  U64* core_keys = ARENA_PUSH_ARRAY(arena, U64, topology->logical_cores);
+  for (U32 cpu = 0; cpu < topology->logical_cores; cpu++) {
+    U32 package_id, core_id;
+    _CpuSysPath(path, "/sys/devices/system/cpu/cpu", cpu, "/topology/physical_package_id");
+    if (!_CpuSysReadU32(path, &package_id)) { continue; } // NOTE: offline.
+    _CpuSysPath(path, "/sys/devices/system/cpu/cpu", cpu, "/topology/core_id");
+    if (!_CpuSysReadU32(path, &core_id)) { continue; }
+    U64 key = ((U64) package_id << 32) | core_id;
+    U32 idx = 0;
+    while (idx < topology->physical_cores && core_keys[idx] != key) { idx++; }
+    if (idx == topology->physical_cores) { core_keys[topology->physical_cores++] = key; }
+    topology->physical_core_ids[cpu] = idx;
+  }
+  ArenaPopTo(arena, arena_pos);
+
+  // NOTE: node directories may be sparse, and each lists its cpus as e.g. "0-3,8-11".
+  for (U32 node = 0; node < 1024; node++) {
+    char cpu_list[1024];
+    _CpuSysPath(path, "/sys/devices/system/node/node", node, "/cpulist");
+    if (!_CpuSysRead(path, cpu_list, sizeof(cpu_list))) { continue; }
+    U32 node_idx = topology->numa_nodes++;
+    char* c = cpu_list;
+    while (*c >= '0' && *c <= '9') {
+      U32 first = 0, last;
+      while (*c >= '0' && *c <= '9') { first = first * 10 + (*c++ - '0'); }
+      last = first;
+      if (*c == '-') {
+        c++;
+        last = 0;
+        while (*c >= '0' && *c <= '9') { last = last * 10 + (*c++ - '0'); }
+      }
+      for (U32 cpu = first; cpu <= last && cpu < topology->logical_cores; cpu++) { topology->numa_node_ids[cpu] = node_idx; }
+      if (*c == ',') { c++; }
+    }
+  }
+  if (topology->numa_nodes == 0) {
+    topology->numa_nodes = 1;
+    for (U32 cpu = 0; cpu < topology->logical_cores; cpu++) {
+      if (topology->physical_core_ids[cpu] != U32_MAX) { topology->numa_node_ids[cpu] = 0; }
+    }
+  }
+
+  for (U32 index = 0; index < 8; index++) {
+    char type[32];
+    U32 level, size, line_size;
+    _CpuSysPath(path, "/sys/devices/system/cpu/cpu0/cache/index", index, "/level");
+    if (!_CpuSysReadU32(path, &level)) { break; }
+    _CpuSysPath(path, "/sys/devices/system/cpu/cpu0/cache/index", index, "/type");
+    if (!_CpuSysRead(path, type, sizeof(type))) { continue; }
+    _CpuSysPath(path, "/sys/devices/system/cpu/cpu0/cache/index", index, "/size");
+    if (!_CpuSysReadU32(path, &size)) { continue; }
+    _CpuSysPath(path, "/sys/devices/system/cpu/cpu0/cache/index", index, "/coherency_line_size");
+    if (_CpuSysReadU32(path, &line_size)) { topology->cache_line_size = line_size; }
+    if (level == 1 && type[0] == 'D') { topology->l1d_cache_size = size; }
+    if (level == 2) { topology->l2_cache_size = size; }
+    if (level == 3) { topology->l3_cache_size = size; }
+  }
+  return topology->physical_cores > 0;
+
+#else
+  // TODO: mac support, via sysctlbyname hw.* values.
+  return false;
+#endif
+}
+
+U32 CpuTopologyOnePerPhysicalCore(CpuTopology* topology, U32* cpus) {
+  U32 result = 0;
+  for (U32 cpu = 0; cpu < topology->logical_cores; cpu++) {
+    U32 core = topology->physical_core_ids[cpu];
+    if (core == U32_MAX) { continue; }
+    B32 is_seen = false;
+    for (U32 i = 0; i < result; i++) { is_seen |= (topology->physical_core_ids[cpus[i]] == core); }
+    if (!is_seen) { cpus[result++] = cpu; }
+  }
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTE: Checksum Implementation
+///////////////////////////////////////////////////////////////////////////////
+
+#define CRC32_POLY   0xEDB88320
+#define CRC32C_POLY  0x82F63B78
+#define ADLER32_MOD  65521
+// NOTE: The most bytes that can be summed before b may overflow U32.
+#define ADLER32_NMAX 5552
+
+typedef U32 _Checksum_Fn(U32 checksum, U8* data, U64 size);
+
+// NOTE: Slice-by-16 tables, table[k][i] is the crc of byte i followed by k zero bytes.
+static U32 _cdef_crc32_table[16][256];
+static U32 _cdef_crc32c_table[16][256];
+static AtomicB32 _cdef_crc_tables_claimed;
+static AtomicB32 _cdef_crc_tables_ready;
+
+static void _CrcTableInit(U32 table[16][256], U32 poly) {
+  for (U32 i = 0; i < 256; i++) {
+    U32 crc = i;
+    for (U32 j = 0; j < 8; j++) { crc = (crc >> 1) ^ ((crc & 1) ? poly : 0); }
+    table[0][i] = crc;
+  }
+  for (U32 i = 0; i < 256; i++) {
+    for (U32 k = 1; k < 16; k++) { table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF]; }
+  }
+}
+
+// NOTE: The first caller builds the tables and then publishes them. Building takes a few microseconds, so any
+// threads racing it just spin until they're ready, rather than reading half written tables.
+static void _CrcTablesInit(void) {
+  if (AtomicB32Load(&_cdef_crc_tables_ready)) { return; }
+  if (!AtomicB32Exchange(&_cdef_crc_tables_claimed, true)) {
+    _CrcTableInit(_cdef_crc32_table, CRC32_POLY);
+    _CrcTableInit(_cdef_crc32c_table, CRC32C_POLY);
+    AtomicB32Store(&_cdef_crc_tables_ready, true);
+    return;
+  }
+  while (!AtomicB32Load(&_cdef_crc_tables_ready)) {}
+}
+
+static U32 _CrcSlice16(U32 table[16][256], U32 crc, U8* data, U64 size) {
+  _CrcTablesInit();
+  crc = ~crc;
+  while (size >= 16) {
+    U32 a = BinRead32LE(data + 0) ^ crc;
+    U32 b = BinRead32LE(data + 4);
+    U32 c = BinRead32LE(data + 8);
+    U32 d = BinRead32LE(data + 12);
+    crc = table[15][a & 0xFF] ^ table[14][(a >> 8) & 0xFF] ^ table[13][(a >> 16) & 0xFF] ^ table[12][a >> 24] ^
+          table[11][b & 0xFF] ^ table[10][(b >> 8) & 0xFF] ^ table[9][(b >> 16) & 0xFF]  ^ table[8][b >> 24]  ^
+          table[7][c & 0xFF]  ^ table[6][(c >> 8) & 0xFF]  ^ table[5][(c >> 16) & 0xFF]  ^ table[4][c >> 24]  ^
+          table[3][d & 0xFF]  ^ table[2][(d >> 8) & 0xFF]  ^ table[1][(d >> 16) & 0xFF]  ^ table[0][d >> 24];
+    data += 16;
+    size -= 16;
+  }
+  for (U64 i = 0; i < size; i++) { crc = table[0][(crc ^ data[i]) & 0xFF] ^ (crc >> 8); }
+  return ~crc;
+}
+
+static U32 _Crc32Scalar(U32 crc, U8* data, U64 size)  { return _CrcSlice16(_cdef_crc32_table, crc, data, size); }
+static U32 _Crc32cScalar(U32 crc, U8* data, U64 size) { return _CrcSlice16(_cdef_crc32c_table, crc, data, size); }
+
+static U32 _Adler32Scalar(U32 adler, U8* data, U64 size) {
+  U32 a = adler & 0xFFFF;
+  U32 b = adler >> 16;
+  while (size > 0) {
+    U64 block = MIN(size, ADLER32_NMAX);
+    size -= block;
+    for (U64 i = 0; i < block; i++) {
+      a += data[i];
+      b += a;
+    }
+    data += block;
+    a %= ADLER32_MOD;
+    b %= ADLER32_MOD;
+  }
+  return (b << 16) | a;
+}
+
+#if defined(ARCH_X64)
+// NOTE: Folds 4 x 128 bits at a time with carry-less multiplies, then reduces to 32 bits with a
+// Barrett reduction. See Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ".
+// The constants are x^(k) mod P for the bit-reflected polynomial, as in zlib / chromium.
+CPU_TARGET_SSE42_PCLMUL static U32 _Crc32Sse42(U32 crc, U8* data, U64 size) {
+  if (size < 64 || !CpuHasFeature(CpuFeature_PCLMUL)) { return _Crc32Scalar(crc, data, size); }
+  __m128i k1k2 = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+  __m128i k3k4 = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+  __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163CD6124);
+  __m128i poly = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+  __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  __m128i x1 = _mm_loadu_si128((__m128i*) (data + 0));
+  __m128i x2 = _mm_loadu_si128((__m128i*) (data + 16));
+  __m128i x3 = _mm_loadu_si128((__m128i*) (data + 32));
+  __m128i x4 = _mm_loadu_si128((__m128i*) (data + 48));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((S32) ~crc));
+  data += 64;
+  size -= 64;
+  while (size >= 64) {
+    __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+    __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+    __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+    __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((__m128i*) (data + 0)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((__m128i*) (data + 16)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((__m128i*) (data + 32)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((__m128i*) (data + 48)));
+    data += 64;
+    size -= 64;
+  }
+
+  // NOTE: fold the 4 lanes into 1, then any remaining whole 16 byte blocks.
+  __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+  while (size >= 16) {
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), _mm_loadu_si128((__m128i*) data)), x5);
+    data += 16;
+    size -= 16;
+  }
+
+  // NOTE: fold 128 to 64 bits, then Barrett reduce 64 to 32 bits.
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), k5k0, 0x00), x2);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), poly, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  crc = ~(U32) _mm_extract_epi32(x1, 1);
+  return _Crc32Scalar(crc, data, size);
+}
+
+CPU_TARGET_SSE42 static U32 _Crc32cSse42(U32 crc, U8* data, U64 size) {
+  U64 c = ~crc;
+  for (; size >= 8; data += 8, size -= 8) { c = _mm_crc32_u64(c, BinRead64LE(data)); }
+  for (; size > 0; data++, size--)        { c = _mm_crc32_u8((U32) c, *data); }
+  return ~(U32) c;
+}
+
+// NOTE: Over a block of n bytes, a gains sum(data[i]) and b gains n * a + sum((n - i) * data[i]).
+// Per 16 byte chunk, sad sums the bytes into a, madd weights them by (16 - i) into b, and the
+// running a at the start of each chunk is accumulated separately and added to b as 16 * a.
+static U32 _Adler32Sse2(U32 adler, U8* data, U64 size) {
+  U32 a = adler & 0xFFFF;
+  U32 b = adler >> 16;
+  __m128i zero       = _mm_setzero_si128();
+  __m128i weights_lo = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+  __m128i weights_hi = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+  while (size >= 16) {
+    U64 block = MIN(size, ADLER32_NMAX) & ~15;
+    size -= block;
+    b += a * (U32) block;
+    __m128i va     = zero;
+    __m128i vb     = zero;
+    __m128i va_acc = zero;
+    for (U8* end = data + block; data < end; data += 16) {
+      __m128i bytes = _mm_loadu_si128((__m128i*) data);
+      va_acc = _mm_add_epi32(va_acc, va);
+      va     = _mm_add_epi32(va, _mm_sad_epu8(bytes, zero));
+      vb     = _mm_add_epi32(vb, _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), weights_lo));
+      vb     = _mm_add_epi32(vb, _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), weights_hi));
+    }
+    vb = _mm_add_epi32(vb, _mm_slli_epi32(va_acc, 4));
+    va = _mm_add_epi32(va, _mm_shuffle_epi32(va, _MM_SHUFFLE(1, 0, 3, 2)));
+    vb = _mm_add_epi32(vb, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+    vb = _mm_add_epi32(vb, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 3, 0, 1)));
+    a = (a + (U32) _mm_cvtsi128_si32(va)) % ADLER32_MOD;
+    b = (b + (U32) _mm_cvtsi128_si32(vb)) % ADLER32_MOD;
+  }
+  return _Adler32Scalar((b << 16) | a, data, size);
+}
+
+// NOTE: As the SSE2 variant, over 32 byte chunks, with maddubs applying the weights.
+CPU_TARGET_AVX2 static U32 _Adler32Avx2(U32 adler, U8* data, U64 size) {
+  U32 a = adler & 0xFFFF;
+  U32 b = adler >> 16;
+  __m256i zero    = _mm256_setzero_si256();
+  __m256i ones    = _mm256_set1_epi16(1);
+  __m256i weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+                                     16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  while (size >= 32) {
+    U64 block = MIN(size, ADLER32_NMAX) & ~31;
+    size -= block;
+    b += a * (U32) block;
+    __m256i va     = zero;
+    __m256i vb     = zero;
+    __m256i va_acc = zero;
+    for (U8* end = data + block; data < end; data += 32) {
+      __m256i bytes = _mm256_loadu_si256((__m256i*) data);
+      va_acc = _mm256_add_epi32(va_acc, va);
+      va     = _mm256_add_epi32(va, _mm256_sad_epu8(bytes, zero));
+      vb     = _mm256_add_epi32(vb, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+    }
+    vb = _mm256_add_epi32(vb, _mm256_slli_epi32(va_acc, 5));
+    __m128i va_128 = _mm_add_epi32(_mm256_castsi256_si128(va), _mm256_extracti128_si256(va, 1));
+    __m128i vb_128 = _mm_add_epi32(_mm256_castsi256_si128(vb), _mm256_extracti128_si256(vb, 1));
+    va_128 = _mm_add_epi32(va_128, _mm_shuffle_epi32(va_128, _MM_SHUFFLE(1, 0, 3, 2)));
+    vb_128 = _mm_add_epi32(vb_128, _mm_shuffle_epi32(vb_128, _MM_SHUFFLE(1, 0, 3, 2)));
+    vb_128 = _mm_add_epi32(vb_128, _mm_shuffle_epi32(vb_128, _MM_SHUFFLE(2, 3, 0, 1)));
+    a = (a + (U32) _mm_cvtsi128_si32(va_128)) % ADLER32_MOD;
+    b = (b + (U32) _mm_cvtsi128_si32(vb_128)) % ADLER32_MOD;
+  }
+  return _Adler32Scalar((b << 16) | a, data, size);
+}
+#endif
+
+static CpuDispatch _cdef_crc32_dispatch = {
+  .variants = {
+    [CpuIsaLevel_Scalar] = (CpuKernel_Fn*) _Crc32Scalar,
+#if defined(ARCH_X64)
+    [CpuIsaLevel_SSE42]  = (CpuKernel_Fn*) _Crc32Sse42,
+#endif
+  },
+  .bound = 0,
+};
+
+static CpuDispatch _cdef_crc32c_dispatch = {
+  .variants = {
+    [CpuIsaLevel_Scalar] = (CpuKernel_Fn*) _Crc32cScalar,
+#if defined(ARCH_X64)
+    [CpuIsaLevel_SSE42]  = (CpuKernel_Fn*) _Crc32cSse42,
+#endif
+  },
+  .bound = 0,
+};
+
+static CpuDispatch _cdef_adler32_dispatch = {
+  .variants = {
+    [CpuIsaLevel_Scalar] = (CpuKernel_Fn*) _Adler32Scalar,
+#if defined(ARCH_X64)
+    [CpuIsaLevel_SSE2]   = (CpuKernel_Fn*) _Adler32Sse2,
+    [CpuIsaLevel_AVX2]   = (CpuKernel_Fn*) _Adler32Avx2,
+#endif
+  },
+  .bound = 0,
+};
+
+U32 Crc32(U8* data, U64 size) {
+  return Crc32Update(CRC32_INIT, data, size);
+}
+
+U32 Crc32Update(U32 crc, U8* data, U64 size) {
+  return CPU_DISPATCH(&_cdef_crc32_dispatch, _Checksum_Fn)(crc, data, size);
+}
+
+U32 Crc32c(U8* data, U64 size) {
+  return Crc32cUpdate(CRC32C_INIT, data, size);
+}
+
+U32 Crc32cUpdate(U32 crc, U8* data, U64 size) {
+  return CPU_DISPATCH(&_cdef_crc32c_dispatch, _Checksum_Fn)(crc, data, size);
+}
+
+U32 Adler32(U8* data, U64 size) {
+  return Adler32Update(ADLER32_INIT, data, size);
+}
+
+U32 Adler32Update(U32 adler, U8* data, U64 size) {
+  return CPU_DISPATCH(&_cdef_adler32_dispatch, _Checksum_Fn)(adler, data, size);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Time Implementation
 ///////////////////////////////////////////////////////////////////////////////
@@ -2516,19 +4266,12 @@ String8 Str8ListJoin(Arena* arena, String8List* list) {
 }
 
 String8List Str8Split(Arena* arena, String8 string, U8 c) {
-  DEBUG_ASSERT(string.size >= 0);
   String8List list;
   MEMORY_ZERO_STRUCT(&list);
-  U8* substring_start = string.str;
-  for (U32 i = 0; i < string.size; ++i) {
-    if (string.str[i] == c) {
-      Str8ListAppend(arena, &list, Str8Range(substring_start, &string.str[i]));
-      substring_start = &string.str[++i];
-    }
-  }
-  if (substring_start < string.str + string.size) {
-    Str8ListAppend(arena, &list, Str8Range(substring_start, string.str + string.size));
-  }
+  String8SplitIter it;
+  Str8SplitIterInit(&it, string, c);
+  String8 piece;
+  while (Str8SplitIterNext(&it, &piece)) { Str8ListAppend(arena, &list, piece); }
   return list;
 }
 
@@ -2546,6 +4289,125 @@ S32 Str8Hash(String8 s) {
   return hash;
 }
 
+void Str8ByteSetInit(String8ByteSet* set, String8 bytes) {
+  MEMORY_ZERO_STRUCT(set);
+  for (U32 i = 0; i < bytes.size; i++) {
+    U8 c = bytes.str[i];
+    if (Str8ByteSetHas(set, c)) { continue; }
+    set->bits[c >> 6] |= ((U64) 1) << (c & 63);
+    if (set->needles_size < STATIC_ARRAY_SIZE(set->needles)) { MEMORY_SET_SIZE(set->needles[set->needles_size], c, 16); }
+    set->needles_size++;
+  }
+  // NOTE: too many members to compare directly, fall back to the bitmap.
+  if (set->needles_size > STATIC_ARRAY_SIZE(set->needles)) { set->needles_size = 0; }
+}
+
+B32 Str8ByteSetHas(String8ByteSet* set, U8 c) {
+  return (set->bits[c >> 6] >> (c & 63)) & 1;
+}
+
+S32 Str8FindChar(String8 string, U32 start_pos, U8 c) {
+  U32 i = start_pos;
+#if defined(ARCH_X64)
+  __m128i needle = _mm_set1_epi8((char) c);
+  for (; i + 16 <= string.size; i += 16) {
+    __m128i chunk = _mm_loadu_si128((__m128i*) (string.str + i));
+    S32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+    if (mask != 0) { return i + U32LsbPos(mask); }
+  }
+#elif defined(ARCH_ARM64)
+  uint8x16_t needle = vdupq_n_u8(c);
+  for (; i + 16 <= string.size; i += 16) {
+    uint8x16_t chunk = vld1q_u8(string.str + i);
+    if (vmaxvq_u8(vceqq_u8(chunk, needle)) != 0) { break; }
+  }
+#endif
+  for (; i < string.size; i++) {
+    if (string.str[i] == c) { return i; }
+  }
+  return -1;
+}
+
+S32 Str8FindByteSet(String8 string, U32 start_pos, String8ByteSet* set) {
+  U32 i = start_pos;
+  if (set->needles_size > 0) {
+#if defined(ARCH_X64)
+    for (; i + 16 <= string.size; i += 16) {
+      __m128i chunk = _mm_loadu_si128((__m128i*) (string.str + i));
+      __m128i hits  = _mm_cmpeq_epi8(chunk, _mm_loadu_si128((__m128i*) set->needles[0]));
+      for (U32 j = 1; j < set->needles_size; j++) {
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_loadu_si128((__m128i*) set->needles[j])));
+      }
+      S32 mask = _mm_movemask_epi8(hits);
+      if (mask != 0) { return i + U32LsbPos(mask); }
+    }
+#elif defined(ARCH_ARM64)
+    for (; i + 16 <= string.size; i += 16) {
+      uint8x16_t chunk = vld1q_u8(string.str + i);
+      uint8x16_t hits  = vceqq_u8(chunk, vld1q_u8(set->needles[0]));
+      for (U32 j = 1; j < set->needles_size; j++) { hits = vorrq_u8(hits, vceqq_u8(chunk, vld1q_u8(set->needles[j]))); }
+      if (vmaxvq_u8(hits) != 0) { break; }
+    }
+#endif
+  }
+  for (; i < string.size; i++) {
+    if (Str8ByteSetHas(set, string.str[i])) { return i; }
+  }
+  return -1;
+}
+
+void Str8SplitIterInit(String8SplitIter* it, String8 string, U8 c) {
+  it->string = string;
+  it->pos = 0;
+  it->c = c;
+}
+
+B32 Str8SplitIterNext(String8SplitIter* it, String8* piece) {
+  if (it->pos >= it->string.size) { return false; }
+  S32 end = Str8FindChar(it->string, it->pos, it->c);
+  if (end < 0) { end = it->string.size; }
+  *piece = Str8Substring(it->string, it->pos, end);
+  it->pos = end + 1;
+  return true;
+}
+
+void Str8LineIterInit(String8LineIter* it, String8 string) {
+  it->string = string;
+  it->pos = 0;
+}
+
+B32 Str8LineIterNext(String8LineIter* it, String8* line) {
+  if (it->pos >= it->string.size) { return false; }
+  S32 end = Str8FindChar(it->string, it->pos, '\n');
+  if (end < 0) { end = it->string.size; }
+  U32 line_end = end;
+  if (line_end > it->pos && it->string.str[line_end - 1] == '\r') { line_end--; }
+  *line = Str8Substring(it->string, it->pos, line_end);
+  it->pos = end + 1;
+  return true;
+}
+
+void Str8TokenIterInit(String8TokenIter* it, String8 string, String8 delims) {
+  Str8ByteSetInit(&it->delims, delims);
+  Str8TokenIterReset(it, string);
+}
+
+void Str8TokenIterReset(String8TokenIter* it, String8 string) {
+  it->string = string;
+  it->pos = 0;
+}
+
+B32 Str8TokenIterNext(String8TokenIter* it, String8* token) {
+  // NOTE: delimiter runs are typically short, so skip them with a scalar scan.
+  while (it->pos < it->string.size && Str8ByteSetHas(&it->delims, it->string.str[it->pos])) { it->pos++; }
+  if (it->pos >= it->string.size) { return false; }
+  S32 end = Str8FindByteSet(it->string, it->pos, &it->delims);
+  if (end < 0) { end = it->string.size; }
+  *token = Str8Substring(it->string, it->pos, end);
+  it->pos = end;
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // NOTE: Sort Implementation
 ///////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 #include "cdefault_std.h"
 #include "cdefault_math.h"
 #include "cdefault_io.h"
+#include "cdefault_profile.h"
 
 // TODO: for widget caching, use a hash map instead of referencing the old frame's tree
 // TODO: text wrapping
@@ -1039,6 +1040,7 @@ void UiBegin(F32 dt_s) {
 }
 
 UiDrawCommand* UiEnd() {
+  CDEFAULT_PROFILE_START(UI_END);
   UiContext* c = UiGetContext();
   DEBUG_ASSERT(c->current_widget == c->root);
 
@@ -1059,6 +1061,7 @@ UiDrawCommand* UiEnd() {
   UiDrawCommand* commands_tail = NULL;
   UiWidget* hot_root_widget    = NULL;
   UiWidget* deepest_scrollable = NULL;
+  CDEFAULT_PROFILE_START(UI_LAYOUT);
   for (U32 i = 0; i < windows_size; i++) {
     UiWidget* window = windows[i];
     window->priority = i; // NOTE: fix priority so in range (0, num windows)
@@ -1078,6 +1081,7 @@ UiDrawCommand* UiEnd() {
     if (current_hot_root_widget != NULL)    { hot_root_widget = current_hot_root_widget;       }
     if (current_deepest_scrollable != NULL) { deepest_scrollable = current_deepest_scrollable; }
   }
+  CDEFAULT_PROFILE_END(UI_LAYOUT);
 
   // NOTE: propagate hover tag
   if (c->deepest_hover_id != 0) {
@@ -1107,6 +1111,7 @@ UiDrawCommand* UiEnd() {
   c->root = NULL;
   c->current_widget = NULL;
 
+  CDEFAULT_PROFILE_END(UI_END);
   return commands_head;
 }
 
@@ -0,0 +1,144 @@
+#define BENCH_WARMUP_SECONDS 0.01
+#define BENCH_SAMPLE_SECONDS 0.001
+#define BENCH_SAMPLES        20
+#define BENCH_MAX_SECONDS    0.5
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define SUM_SIZE KB(4)
+
+static U32 sum_data[SUM_SIZE];
+static U32 bench_calls;
+
+BENCH(SumBench) {
+  bench_calls++;
+  bench->bytes_per_iteration = sizeof(sum_data);
+  while (BenchLoop(bench)) {
+    U32 sum = 0;
+    for (U32 i = 0; i < SUM_SIZE; i++) { sum += sum_data[i]; }
+    BENCH_DO_NOT_OPTIMIZE(sum);
+  }
+}
+
+BENCH(EmptyBench) {
+  while (BenchLoop(bench)) { BENCH_CLOBBER(); }
+}
+
+void StatsTest(void) {
+  F64 odd[] = { 5, 1, 3, 2, 4 };
+  BenchStats stats = BenchStatsCompute(odd, STATIC_ARRAY_SIZE(odd));
+  EXPECT_U32_EQ(stats.samples_size, 5);
+  EXPECT_F64_EQ(stats.min_ns, 1);
+  EXPECT_F64_EQ(stats.max_ns, 5);
+  EXPECT_F64_EQ(stats.mean_ns, 3);
+  EXPECT_F64_EQ(stats.median_ns, 3);
+  EXPECT_F64_EQ(stats.mad_ns, 1);
+  EXPECT_F64_EQ(stats.p90_ns, 5);
+  EXPECT_F64_EQ(stats.p99_ns, 5);
+
+  // NOTE: sub-ns differences must still sort correctly.
+  F64 even[] = { 0.4, 0.1, 100.0, 0.3, 0.2, 0.25 };
+  stats = BenchStatsCompute(even, STATIC_ARRAY_SIZE(even));
+  EXPECT_F64_APPROX_EQ(stats.min_ns, 0.1);
+  EXPECT_F64_APPROX_EQ(stats.median_ns, 0.275);
+  EXPECT_F64_APPROX_EQ(stats.p90_ns, 100.0);
+  EXPECT_TRUE(stats.mad_ns < 1.0); // NOTE: the outlier moves the mean, but not the median or MAD.
+  EXPECT_TRUE(stats.mean_ns > 10.0);
+
+  stats = BenchStatsCompute(NULL, 0);
+  EXPECT_U32_EQ(stats.samples_size, 0);
+}
+
+void PauseTest(void) {
+  Bench bench;
+  MEMORY_ZERO_STRUCT(&bench);
+  bench.iterations = 3;
+  U32 loops = 0;
+  while (BenchLoop(&bench)) {
+    loops++;
+    BenchPause(&bench);
+    SleepMs(5);
+    BenchResume(&bench);
+  }
+  EXPECT_U32_EQ(loops, 3);
+  EXPECT_TRUE(bench._elapsed < 5000000);
+}
+
+void RunTest(void) {
+  for (U32 i = 0; i < SUM_SIZE; i++) { sum_data[i] = i; }
+  RUN_BENCH(SumBench);
+  RUN_BENCH(EmptyBench);
+
+  BenchResult* sum = BenchGetResults();
+  EXPECT_PTR_NOT_NULL(sum);
+  EXPECT_STR8_EQ(sum->name, Str8Lit("SumBench"));
+  EXPECT_TRUE(sum->stats.iterations > 1);
+  EXPECT_TRUE(sum->stats.samples_size >= BENCH_MIN_SAMPLES && sum->stats.samples_size <= BENCH_SAMPLES);
+  EXPECT_TRUE(bench_calls > sum->stats.samples_size);
+  EXPECT_TRUE(sum->stats.min_ns > 0);
+  EXPECT_TRUE(sum->stats.min_ns <= sum->stats.median_ns);
+  EXPECT_TRUE(sum->stats.median_ns <= sum->stats.p90_ns);
+  EXPECT_TRUE(sum->stats.p90_ns <= sum->stats.p99_ns);
+  EXPECT_TRUE(sum->stats.p99_ns <= sum->stats.max_ns);
+  EXPECT_U64_EQ(sum->bytes_per_iteration, sizeof(sum_data));
+  EXPECT_TRUE(sum->stats.gb_per_second > 0);
+
+  BenchResult* empty = sum->next;
+  EXPECT_PTR_NOT_NULL(empty);
+  EXPECT_STR8_EQ(empty->name, Str8Lit("EmptyBench"));
+  EXPECT_TRUE(empty->stats.iterations > sum->stats.iterations);
+  EXPECT_F64_EQ(empty->stats.gb_per_second, 0);
+  EXPECT_PTR_NULL(empty->next);
+}
+
+void ReportTest(void) {
+  Arena* arena = ArenaAllocate();
+  String8 json_str = BenchReportToJson(arena);
+  JsonObject json;
+  JsonArray benchmarks;
+  EXPECT_TRUE(JsonParse(arena, &json, json_str));
+  EXPECT_TRUE(JsonObjectGetArray(json, Str8Lit("benchmarks"), &benchmarks));
+  JsonObject entry;
+  String8 name;
+  F32 median_ns;
+  EXPECT_PTR_NOT_NULL(benchmarks.head);
+  EXPECT_TRUE(JsonValueGetObject(&benchmarks.head->value, &entry));
+  EXPECT_TRUE(JsonObjectGetString(entry, Str8Lit("name"), &name));
+  EXPECT_STR8_EQ(name, Str8Lit("SumBench"));
+  EXPECT_TRUE(JsonObjectGetNumber(entry, Str8Lit("median_ns"), &median_ns));
+  EXPECT_TRUE(median_ns > 0);
+
+  String8 csv = BenchReportToCsv(arena);
+  String8List lines = Str8Split(arena, csv, '\n');
+  EXPECT_TRUE(Str8StartsWith(lines.head->string, Str8Lit("name,iterations,samples,median_ns")));
+  EXPECT_TRUE(Str8StartsWith(lines.head->next->string, Str8Lit("SumBench,")));
+  EXPECT_TRUE(Str8StartsWith(lines.head->next->next->string, Str8Lit("EmptyBench,")));
+  ArenaRelease(arena);
+}
+
+void BaselineTest(void) {
+  Arena* arena = ArenaAllocate();
+  BenchResult* sum = BenchGetResults();
+
+  // NOTE: baseline was 10x faster -> regression; 10x slower -> improvement; missing benchmarks are new.
+  String8 slower = Str8Format(arena, "{\"benchmarks\":[{\"name\":\"SumBench\",\"median_ns\":%.3f}]}", sum->stats.median_ns / 10.0);
+  String8 faster = Str8Format(arena, "{\"benchmarks\":[{\"name\":\"SumBench\",\"median_ns\":%.3f}]}", sum->stats.median_ns * 10.0);
+  EXPECT_U32_EQ(BenchCompareBaseline(slower, 0.05), 1);
+  EXPECT_U32_EQ(BenchCompareBaseline(faster, 0.05), 0);
+  EXPECT_U32_EQ(BenchCompareBaseline(BenchReportToJson(arena), 0.05), 0);
+  EXPECT_U32_EQ(BenchCompareBaseline(Str8Lit("{ not json"), 0.05), 0);
+  ArenaRelease(arena);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  RUN_TEST(StatsTest);
+  RUN_TEST(PauseTest);
+  RUN_TEST(RunTest);
+  RUN_TEST(ReportTest);
+  RUN_TEST(BaselineTest);
+  LogBenchReport();
+  LogTestReport();
+  return 0;
+}
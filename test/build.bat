@@ -17,4 +17,14 @@ REM cl %FLAGS% sort_test.c /Fobuild/sort_test.obj /Febin/sort_test.exe /link %LI
 REM cl %FLAGS% bin_stream_test.c /Fobuild/bin_stream_test.obj /Febin/bin_stream_test.exe /link %LIBS% && bin\bin_stream_test.exe
 REM cl %FLAGS% dynamic_array_test.c /Fobuild/dynamic_array_test.obj /Febin/dynamic_array_test.exe /link %LIBS% && bin\dynamic_array_test.exe
 REM cl %FLAGS% json_test.c /Fobuild/json_test.obj /Febin/json_test.exe /link %LIBS% && bin\json_test.exe
+REM cl %FLAGS% heap_test.c /Fobuild/heap_test.obj /Febin/heap_test.exe /link %LIBS% && bin\heap_test.exe
+REM cl %FLAGS% deque_test.c /Fobuild/deque_test.obj /Febin/deque_test.exe /link %LIBS% && bin\deque_test.exe
+REM cl %FLAGS% vring_buffer_test.c /Fobuild/vring_buffer_test.obj /Febin/vring_buffer_test.exe /link %LIBS% && bin\vring_buffer_test.exe
+REM cl %FLAGS% fiber_test.c /Fobuild/fiber_test.obj /Febin/fiber_test.exe /link %LIBS% && bin\fiber_test.exe
+REM cl %FLAGS% cpu_test.c /Fobuild/cpu_test.obj /Febin/cpu_test.exe /link %LIBS% && bin\cpu_test.exe
+REM cl %FLAGS% profile_test.c /Fobuild/profile_test.obj /Febin/profile_test.exe /link %LIBS% && bin\profile_test.exe
+REM cl %FLAGS% bench_test.c /Fobuild/bench_test.obj /Febin/bench_test.exe /link %LIBS% && bin\bench_test.exe
+REM cl %FLAGS% io_test.c /Fobuild/io_test.obj /Febin/io_test.exe /link %LIBS% && bin\io_test.exe
+REM cl %FLAGS% compress_test.c /Fobuild/compress_test.obj /Febin/compress_test.exe /link %LIBS% && bin\compress_test.exe
+REM cl %FLAGS% checksum_test.c /Fobuild/checksum_test.obj /Febin/checksum_test.exe /link %LIBS% && bin\checksum_test.exe
 cl %FLAGS% geometry_test.c /Fobuild/geometry_test.obj /Febin/geometry_test.exe /link %LIBS% && bin\geometry_test.exe
@@ -15,6 +15,16 @@ echo "Compiling..."
 # gcc matrix_test.c -o ./bin/matrix_test -lm
 # gcc time_test.c -o ./bin/time_test -lm
 # gcc sort_test.c -o ./bin/sort_test -lm
+# gcc heap_test.c -o ./bin/heap_test
+# gcc deque_test.c -o ./bin/deque_test
+# gcc vring_buffer_test.c -o ./bin/vring_buffer_test
+# gcc fiber_test.c -o ./bin/fiber_test
+# gcc cpu_test.c -o ./bin/cpu_test
+# gcc profile_test.c -o ./bin/profile_test
+# gcc bench_test.c -o ./bin/bench_test -lm
+# gcc io_test.c -o ./bin/io_test -lm
+# gcc compress_test.c -o ./bin/compress_test -lm
+# gcc checksum_test.c -o ./bin/checksum_test -lm
 
 echo "Testing:"
 # ./bin/dll_test
@@ -25,3 +35,13 @@ echo "Testing:"
 # ./bin/matrix_test
 # ./bin/time_test
 # ./bin/sort_test
+# ./bin/heap_test
+# ./bin/deque_test
+# ./bin/vring_buffer_test
+# ./bin/fiber_test
+# ./bin/cpu_test
+# ./bin/profile_test
+# ./bin/bench_test
+# ./bin/io_test
+# ./bin/compress_test
+# ./bin/checksum_test
@@ -0,0 +1,150 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+// NOTE: Bit at a time references, to check the table / SIMD kernels against.
+static U32 CrcReference(U32 poly, U32 crc, U8* data, U64 size) {
+  crc = ~crc;
+  for (U64 i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (U32 j = 0; j < 8; j++) { crc = (crc >> 1) ^ ((crc & 1) ? poly : 0); }
+  }
+  return ~crc;
+}
+
+static U32 Adler32Reference(U8* data, U64 size) {
+  U32 a = 1, b = 0;
+  for (U64 i = 0; i < size; i++) {
+    a = (a + data[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  return (b << 16) | a;
+}
+
+static U8* RandomBytes(Arena* arena, U32 size) {
+  U8* data = ARENA_PUSH_ARRAY(arena, U8, size);
+  RandSeed(NULL, 4321);
+  for (U32 i = 0; i < size; i++) { data[i] = (U8) RandU32(NULL, 0, 256); }
+  return data;
+}
+
+void KnownTest(void) {
+  U8* check = (U8*) "123456789";
+  CpuIsaLevel level = CpuIsaLevelGet();
+  for (S32 max = CpuIsaLevel_Scalar; max <= (S32) level; max++) {
+    CpuIsaLevelForceMax((CpuIsaLevel) max);
+    EXPECT_U32_EQ(Crc32(check, 9), 0xCBF43926);
+    EXPECT_U32_EQ(Crc32c(check, 9), 0xE3069283);
+    EXPECT_U32_EQ(Adler32((U8*) "Wikipedia", 9), 0x11E60398);
+    EXPECT_U32_EQ(Crc32(NULL, 0), 0);
+    EXPECT_U32_EQ(Crc32c(NULL, 0), 0);
+    EXPECT_U32_EQ(Adler32(NULL, 0), 1);
+  }
+  CpuIsaLevelForceMax(CpuIsaLevel_Count);
+}
+
+// NOTE: Sizes and offsets around each kernel's block sizes, and large enough to cross Adler32's reduction interval.
+void ReferenceTest(void) {
+  Arena* arena = ArenaAllocate();
+  U32 size = 20000;
+  U8* data = RandomBytes(arena, size);
+  U32 sizes[] = { 1, 7, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 255, 1000, 5552, 5553, 11104, 16383, 19990 };
+  CpuIsaLevel level = CpuIsaLevelGet();
+  for (S32 max = CpuIsaLevel_Scalar; max <= (S32) level; max++) {
+    CpuIsaLevelForceMax((CpuIsaLevel) max);
+    for (U32 i = 0; i < STATIC_ARRAY_SIZE(sizes); i++) {
+      for (U32 offset = 0; offset < 4; offset++) {
+        EXPECT_U32_EQ(Crc32(data + offset, sizes[i]), CrcReference(0xEDB88320, 0, data + offset, sizes[i]));
+        EXPECT_U32_EQ(Crc32c(data + offset, sizes[i]), CrcReference(0x82F63B78, 0, data + offset, sizes[i]));
+        EXPECT_U32_EQ(Adler32(data + offset, sizes[i]), Adler32Reference(data + offset, sizes[i]));
+      }
+    }
+  }
+  CpuIsaLevelForceMax(CpuIsaLevel_Count);
+  ArenaRelease(arena);
+}
+
+// NOTE: All 0xFF bytes maximize Adler32's sums, to check that the SIMD accumulators don't overflow.
+void AdlerOverflowTest(void) {
+  Arena* arena = ArenaAllocate();
+  U32 size = 100000;
+  U8* data = ARENA_PUSH_ARRAY(arena, U8, size);
+  MEMORY_SET_SIZE(data, 0xFF, size);
+  U32 expected = Adler32Reference(data, size);
+  CpuIsaLevel level = CpuIsaLevelGet();
+  for (S32 max = CpuIsaLevel_Scalar; max <= (S32) level; max++) {
+    CpuIsaLevelForceMax((CpuIsaLevel) max);
+    EXPECT_U32_EQ(Adler32(data, size), expected);
+  }
+  CpuIsaLevelForceMax(CpuIsaLevel_Count);
+  ArenaRelease(arena);
+}
+
+void StreamingTest(void) {
+  Arena* arena = ArenaAllocate();
+  U32 size = 10000;
+  U8* data = RandomBytes(arena, size);
+  U32 crc32  = Crc32(data, size);
+  U32 crc32c = Crc32c(data, size);
+  U32 adler  = Adler32(data, size);
+  U32 splits[] = { 0, 1, 13, 64, 100, 5552, 9999, 10000 };
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(splits); i++) {
+    U32 split = splits[i];
+    EXPECT_U32_EQ(Crc32Update(Crc32Update(CRC32_INIT, data, split), data + split, size - split), crc32);
+    EXPECT_U32_EQ(Crc32cUpdate(Crc32cUpdate(CRC32C_INIT, data, split), data + split, size - split), crc32c);
+    EXPECT_U32_EQ(Adler32Update(Adler32Update(ADLER32_INIT, data, split), data + split, size - split), adler);
+  }
+  // NOTE: many small updates.
+  U32 crc = CRC32_INIT;
+  for (U32 i = 0; i < size; i += 37) { crc = Crc32Update(crc, data + i, MIN(37, size - i)); }
+  EXPECT_U32_EQ(crc, crc32);
+  ArenaRelease(arena);
+}
+
+static U8* PngPushChunk(U8* at, char* type, U8* data, U32 data_size) {
+  BinWrite32BE(at, data_size);
+  MEMORY_COPY_SIZE(at + 4, type, 4);
+  MEMORY_COPY_SIZE(at + 8, data, data_size);
+  BinWrite32BE(at + 8 + data_size, Crc32(at + 4, 4 + data_size));
+  return at + 12 + data_size;
+}
+
+void PngCrcTest(void) {
+  Arena* arena = ArenaAllocate();
+  U8 pixels[2 * (1 + 2 * 4)] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 9, 10, 11, 12, 13, 14, 15, 16 };
+  U8* idat;
+  U64 idat_size;
+  EXPECT_TRUE(DeflateAll(arena, CompressFormat_Zlib, DeflateLevel_Default, pixels, sizeof(pixels), &idat, &idat_size));
+  U8 ihdr[13] = { 0, 0, 0, 2, 0, 0, 0, 2, 8, 6, 0, 0, 0 };
+
+  U8* png = ARENA_PUSH_ARRAY(arena, U8, 256);
+  U8* at = png;
+  BinWrite64BE(at, 0x89504E470D0A1A0A);
+  at = PngPushChunk(at + 8, "IHDR", ihdr, sizeof(ihdr));
+  at = PngPushChunk(at, "IDAT", idat, (U32) idat_size);
+  at = PngPushChunk(at, "IEND", NULL, 0);
+  U32 png_size = (U32) (at - png);
+
+  Image image;
+  EXPECT_TRUE(ImageLoadPng(arena, &image, ImageFormat_RGBA, png, png_size));
+  EXPECT_U32_EQ(image.width, 2);
+  EXPECT_U32_EQ(image.height, 2);
+
+  // NOTE: corrupt IHDR's height, then the IEND crc, which is otherwise never looked at.
+  png[8 + 8 + 7] ^= 1;
+  EXPECT_FALSE(ImageLoadPng(arena, &image, ImageFormat_RGBA, png, png_size));
+  png[8 + 8 + 7] ^= 1;
+  png[png_size - 1] ^= 1;
+  EXPECT_FALSE(ImageLoadPng(arena, &image, ImageFormat_RGBA, png, png_size));
+  ArenaRelease(arena);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  RUN_TEST(KnownTest);
+  RUN_TEST(ReferenceTest);
+  RUN_TEST(AdlerOverflowTest);
+  RUN_TEST(StreamingTest);
+  RUN_TEST(PngCrcTest);
+  LogTestReport();
+  return 0;
+}
@@ -0,0 +1,265 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+static CompressFormat formats[] = { CompressFormat_Raw, CompressFormat_Zlib, CompressFormat_Gzip };
+static DeflateLevel   levels[]  = { DeflateLevel_Fast, DeflateLevel_Default, DeflateLevel_Best };
+
+// NOTE: The lines of the known answer dynamic block below.
+static String8 KnownLines(Arena* arena) {
+  String8List list;
+  MEMORY_ZERO_STRUCT(&list);
+  for (U32 i = 0; i < 24; i++) { Str8ListAppend(arena, &list, Str8Format(arena, "line %u: the quick brown fox jumps over the lazy dog\n", i * i % 97)); }
+  return Str8ListJoin(arena, &list);
+}
+
+// NOTE: A mix of text, structured binary, noise and runs, large enough to slide the window a few times.
+static String8 Corpus(Arena* arena, U32 size) {
+  static char* words[] = { "the", "of", "compression", "window", "arena", "huffman", "a", "stream", "block", "match" };
+  U8* data = ARENA_PUSH_ARRAY(arena, U8, size);
+  RandSeed(NULL, 1234);
+  U32 i = 0;
+  while (i < size) {
+    U32 kind = RandU32(NULL, 0, 4);
+    U32 run  = MIN(RandU32(NULL, 1, 4096), size - i);
+    for (U32 j = 0; j < run; i++, j++) {
+      switch (kind) {
+        case 0: {
+          char* word = words[(i / 7) % STATIC_ARRAY_SIZE(words)];
+          data[i] = (U8) ((j % 8 == 7) ? ' ' : word[j % 8 % (U32) strlen(word)]);
+        } break;
+        case 1:  { data[i] = (U8) ((j % 16 < 4) ? (i / 16) : (j % 16)); } break;
+        case 2:  { data[i] = (U8) RandU32(NULL, 0, 256); } break;
+        default: { data[i] = 0; } break;
+      }
+    }
+  }
+  String8 result = { data, size };
+  return result;
+}
+
+static B32 RoundTrip(Arena* arena, CompressFormat format, DeflateLevel level, String8 data) {
+  U64 arena_pos = ArenaPos(arena);
+  U8* compressed;
+  U64 compressed_size;
+  U8* decompressed;
+  U64 decompressed_size;
+  B32 result = DeflateAll(arena, format, level, data.str, data.size, &compressed, &compressed_size) &&
+               InflateAll(arena, format, compressed, compressed_size, &decompressed, &decompressed_size) &&
+               decompressed_size == data.size &&
+               MEMORY_IS_EQUAL_SIZE(decompressed, data.str, data.size);
+  ArenaPopTo(arena, arena_pos);
+  return result;
+}
+
+void InflateKnownTest(void) {
+  Arena* arena = ArenaAllocate();
+  String8 hello = Str8Lit("hello hello hello hello, cdefault!\n");
+  U8* out;
+  U64 out_size;
+
+  U8 zlib[] = {
+    0x78, 0xDA, 0xCB, 0x48, 0xCD, 0xC9, 0xC9, 0x57, 0xC8, 0x40, 0x27, 0x75, 0x14, 0x92, 0x53, 0x52,
+    0xD3, 0x12, 0x4B, 0x73, 0x4A, 0x14, 0xB9, 0x00, 0xE8, 0xFA, 0x0C, 0x70,
+  };
+  EXPECT_TRUE(InflateAll(arena, CompressFormat_Zlib, zlib, sizeof(zlib), &out, &out_size));
+  EXPECT_STR8_EQ(Str8(out, (U32) out_size), hello);
+
+  // NOTE: with a file name in the header.
+  U8 gzip[] = {
+    0x1F, 0x8B, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x02, 0xFF, 0x68, 0x65, 0x6C, 0x6C, 0x6F, 0x2E,
+    0x74, 0x78, 0x74, 0x00, 0xCB, 0x48, 0xCD, 0xC9, 0xC9, 0x57, 0xC8, 0x40, 0x27, 0x75, 0x14, 0x92,
+    0x53, 0x52, 0xD3, 0x12, 0x4B, 0x73, 0x4A, 0x14, 0xB9, 0x00, 0xFC, 0x9D, 0xB4, 0x9B, 0x23, 0x00,
+    0x00, 0x00,
+  };
+  EXPECT_TRUE(InflateAll(arena, CompressFormat_Gzip, gzip, sizeof(gzip), &out, &out_size));
+  EXPECT_STR8_EQ(Str8(out, (U32) out_size), hello);
+
+  U8 stored[] = { 0x01, 0x06, 0x00, 0xF9, 0xFF, 0x73, 0x74, 0x6F, 0x72, 0x65, 0x64 };
+  EXPECT_TRUE(InflateAll(arena, CompressFormat_Raw, stored, sizeof(stored), &out, &out_size));
+  EXPECT_STR8_EQ(Str8(out, (U32) out_size), Str8Lit("stored"));
+
+  U8 dynamic[] = {
+    0x78, 0xDA, 0x9D, 0x93, 0xD1, 0x11, 0x82, 0x30, 0x10, 0x44, 0xFF, 0xAD, 0xE2, 0x4A, 0xD0, 0x24,
+    0x24, 0x86, 0x6E, 0x40, 0xA2, 0x80, 0x91, 0x00, 0x1A, 0x45, 0xAB, 0x67, 0xA0, 0x03, 0xDF, 0xF7,
+    0xCD, 0x9B, 0xDB, 0xDB, 0xDD, 0x8B, 0xDD, 0x10, 0xE4, 0x58, 0xCA, 0xAB, 0x0D, 0x32, 0xE5, 0xEE,
+    0x72, 0x97, 0x7A, 0x4E, 0x9F, 0x41, 0xAE, 0x69, 0x91, 0x3E, 0x3F, 0xC6, 0xA7, 0xA4, 0x77, 0x98,
+    0xF7, 0x71, 0xAC, 0x7E, 0x5F, 0x69, 0xD2, 0xED, 0x10, 0x37, 0xE6, 0x04, 0x18, 0x03, 0x18, 0x4F,
+    0xB4, 0x59, 0x00, 0xA9, 0x02, 0x40, 0x9A, 0x6C, 0x32, 0xE4, 0x26, 0x4B, 0xCC, 0x3B, 0x93, 0x94,
+    0x34, 0x31, 0x8F, 0xA8, 0x33, 0x0E, 0x40, 0x4E, 0x11, 0x79, 0xC4, 0x06, 0xE2, 0x9D, 0x25, 0x9B,
+    0x3C, 0x6A, 0x1E, 0x89, 0xC9, 0xA1, 0x4F, 0x27, 0x37, 0x15, 0x44, 0x9E, 0x47, 0xDF, 0xF4, 0x67,
+    0xF5, 0x56, 0xCC, 0xB7, 0xBC, 0x15,
+  };
+  EXPECT_TRUE(InflateAll(arena, CompressFormat_Zlib, dynamic, sizeof(dynamic), &out, &out_size));
+  EXPECT_STR8_EQ(Str8(out, (U32) out_size), KnownLines(arena));
+  ArenaRelease(arena);
+}
+
+void RoundTripTest(void) {
+  Arena* arena = _ArenaAllocate(MB(64), MB(1));
+  String8 corpus = Corpus(arena, MB(1));
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(formats); i++) {
+    for (U32 j = 0; j < STATIC_ARRAY_SIZE(levels); j++) {
+      EXPECT_TRUE(RoundTrip(arena, formats[i], levels[j], corpus));
+      EXPECT_TRUE(RoundTrip(arena, formats[i], levels[j], Str8Lit("")));
+      EXPECT_TRUE(RoundTrip(arena, formats[i], levels[j], Str8Lit("a")));
+      EXPECT_TRUE(RoundTrip(arena, formats[i], levels[j], Str8Substring(corpus, 0, 1000)));
+    }
+  }
+  ArenaRelease(arena);
+}
+
+void DeflateRatioTest(void) {
+  Arena* arena = _ArenaAllocate(MB(64), MB(1));
+  U8* out;
+  U64 out_size;
+
+  // NOTE: runs compress to a tiny fraction, noise is stored with only a few bytes of overhead per block.
+  String8 zeros = { ARENA_PUSH_ARRAY(arena, U8, MB(1)), MB(1) };
+  MEMORY_ZERO_SIZE(zeros.str, zeros.size);
+  EXPECT_TRUE(DeflateAll(arena, CompressFormat_Raw, DeflateLevel_Default, zeros.str, zeros.size, &out, &out_size));
+  EXPECT_TRUE(out_size < KB(2));
+
+  String8 noise = { ARENA_PUSH_ARRAY(arena, U8, MB(1)), MB(1) };
+  for (U32 i = 0; i < noise.size; i++) { noise.str[i] = (U8) RandU32(NULL, 0, 256); }
+  EXPECT_TRUE(DeflateAll(arena, CompressFormat_Raw, DeflateLevel_Best, noise.str, noise.size, &out, &out_size));
+  EXPECT_TRUE(out_size <= noise.size + noise.size / 1000);
+
+  String8 lines = KnownLines(arena);
+  EXPECT_TRUE(DeflateAll(arena, CompressFormat_Zlib, DeflateLevel_Best, lines.str, lines.size, &out, &out_size));
+  EXPECT_TRUE(out_size < lines.size / 4);
+
+  // NOTE: higher levels search harder, so shouldn't do worse on a larger input.
+  String8 corpus = Corpus(arena, KB(256));
+  U64 sizes[STATIC_ARRAY_SIZE(levels)];
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(levels); i++) {
+    EXPECT_TRUE(DeflateAll(arena, CompressFormat_Zlib, levels[i], corpus.str, corpus.size, &out, &sizes[i]));
+  }
+  EXPECT_TRUE(sizes[1] <= sizes[0]);
+  EXPECT_TRUE(sizes[2] <= sizes[1]);
+  ArenaRelease(arena);
+}
+
+// NOTE: feeds and drains a few bytes at a time, so every state has to suspend and resume.
+void StreamingTest(void) {
+  Arena* arena = _ArenaAllocate(MB(64), MB(1));
+  String8 corpus = Corpus(arena, KB(200));
+  U64 chunk_sizes[] = { 1, 7, 4096 };
+  for (U32 f = 0; f < STATIC_ARRAY_SIZE(formats); f++) {
+    for (U32 c = 0; c < STATIC_ARRAY_SIZE(chunk_sizes); c++) {
+      U64 chunk_size = chunk_sizes[c];
+      U8* compressed = ARENA_PUSH_ARRAY(arena, U8, corpus.size * 2);
+      U64 compressed_size = 0, in_pos = 0;
+      Deflate* deflate;
+      EXPECT_TRUE(DeflateCreate(&deflate, formats[f], DeflateLevel_Default));
+      CompressStatus status;
+      do {
+        U64 in_size = MIN(chunk_size, corpus.size - in_pos);
+        U64 in_read, out_written;
+        status = DeflateRun(deflate, corpus.str + in_pos, in_size, &in_read, compressed + compressed_size, chunk_size, &out_written, in_pos + in_size == corpus.size);
+        in_pos          += in_read;
+        compressed_size += out_written;
+      } while (status == CompressStatus_NeedsInput || status == CompressStatus_NeedsOutput);
+      EXPECT_TRUE(status == CompressStatus_Done);
+      EXPECT_U64_EQ(in_pos, corpus.size);
+      DeflateDestroy(deflate);
+
+      U8* decompressed = ARENA_PUSH_ARRAY(arena, U8, corpus.size);
+      U64 decompressed_size = 0;
+      in_pos = 0;
+      Inflate* inflate;
+      EXPECT_TRUE(InflateCreate(&inflate, formats[f]));
+      do {
+        U64 in_size  = MIN(chunk_size, compressed_size - in_pos);
+        U64 out_size = MIN(chunk_size, corpus.size - decompressed_size);
+        U64 in_read, out_written;
+        status = InflateRun(inflate, compressed + in_pos, in_size, &in_read, decompressed + decompressed_size, out_size, &out_written);
+        in_pos            += in_read;
+        decompressed_size += out_written;
+      } while ((status == CompressStatus_NeedsInput && in_pos < compressed_size) || status == CompressStatus_NeedsOutput);
+      EXPECT_TRUE(status == CompressStatus_Done);
+      EXPECT_U64_EQ(in_pos, compressed_size);
+      EXPECT_U64_EQ(decompressed_size, corpus.size);
+      EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(decompressed, corpus.str, corpus.size));
+      InflateDestroy(inflate);
+      ArenaClear(arena);
+      corpus = Corpus(arena, KB(200));
+    }
+  }
+  ArenaRelease(arena);
+}
+
+// NOTE: bytes after the end of a stream are not consumed, e.g. for concatenated members.
+void InflateTrailingDataTest(void) {
+  Arena* arena = ArenaAllocate();
+  String8 data = Str8Lit("trailing data trailing data");
+  U8* compressed;
+  U64 compressed_size;
+  EXPECT_TRUE(DeflateAll(arena, CompressFormat_Zlib, DeflateLevel_Default, data.str, data.size, &compressed, &compressed_size));
+  U8* padded = ARENA_PUSH_ARRAY(arena, U8, compressed_size + 16);
+  MEMORY_COPY_SIZE(padded, compressed, compressed_size);
+  MEMORY_SET_SIZE(padded + compressed_size, 0xAB, 16);
+
+  Inflate* inflate;
+  EXPECT_TRUE(InflateCreate(&inflate, CompressFormat_Zlib));
+  U8 out[64];
+  U64 in_read, out_written;
+  EXPECT_TRUE(InflateRun(inflate, padded, compressed_size + 16, &in_read, out, sizeof(out), &out_written) == CompressStatus_Done);
+  EXPECT_U64_EQ(in_read, compressed_size);
+  EXPECT_STR8_EQ(Str8(out, (U32) out_written), data);
+  InflateDestroy(inflate);
+  ArenaRelease(arena);
+}
+
+void InflateInvalidTest(void) {
+  Arena* arena = ArenaAllocate();
+  String8 data = KnownLines(arena);
+  U8* compressed;
+  U64 compressed_size;
+  U8* out;
+  U64 out_size;
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(formats); i++) {
+    EXPECT_TRUE(DeflateAll(arena, formats[i], DeflateLevel_Default, data.str, data.size, &compressed, &compressed_size));
+    EXPECT_FALSE(InflateAll(arena, formats[i], compressed, compressed_size - 5, &out, &out_size));
+    EXPECT_FALSE(InflateAll(arena, formats[i], compressed, 0, &out, &out_size));
+  }
+
+  // NOTE: checksums catch corruption the bitstream itself doesn't.
+  EXPECT_TRUE(DeflateAll(arena, CompressFormat_Zlib, DeflateLevel_Default, data.str, data.size, &compressed, &compressed_size));
+  compressed[compressed_size - 1] ^= 1;
+  EXPECT_FALSE(InflateAll(arena, CompressFormat_Zlib, compressed, compressed_size, &out, &out_size));
+  EXPECT_TRUE(DeflateAll(arena, CompressFormat_Gzip, DeflateLevel_Default, data.str, data.size, &compressed, &compressed_size));
+  compressed[compressed_size - 8] ^= 1;
+  EXPECT_FALSE(InflateAll(arena, CompressFormat_Gzip, compressed, compressed_size, &out, &out_size));
+
+  U8 bad_header[]      = { 0x78, 0x9D, 0x03, 0x00 };
+  U8 bad_block_type[]  = { 0x07 };
+  U8 bad_stored_len[]  = { 0x01, 0x06, 0x00, 0xF8, 0xFF, 0x73, 0x74, 0x6F, 0x72, 0x65, 0x64 };
+  U8 bad_dist[]        = { 0x4B, 0x04, 0x22, 0x00 }; // NOTE: fixed block, literal then a match reaching back 3 bytes.
+  EXPECT_FALSE(InflateAll(arena, CompressFormat_Zlib, bad_header, sizeof(bad_header), &out, &out_size));
+  EXPECT_FALSE(InflateAll(arena, CompressFormat_Raw, bad_block_type, sizeof(bad_block_type), &out, &out_size));
+  EXPECT_FALSE(InflateAll(arena, CompressFormat_Raw, bad_stored_len, sizeof(bad_stored_len), &out, &out_size));
+  EXPECT_FALSE(InflateAll(arena, CompressFormat_Raw, bad_dist, sizeof(bad_dist), &out, &out_size));
+  EXPECT_FALSE(InflateAll(arena, CompressFormat_Gzip, bad_header, sizeof(bad_header), &out, &out_size));
+
+  // NOTE: an errored stream stays errored.
+  Inflate* inflate;
+  EXPECT_TRUE(InflateCreate(&inflate, CompressFormat_Raw));
+  U8 buffer[16];
+  U64 in_read, out_written;
+  EXPECT_TRUE(InflateRun(inflate, bad_block_type, sizeof(bad_block_type), &in_read, buffer, sizeof(buffer), &out_written) == CompressStatus_Error);
+  EXPECT_TRUE(InflateRun(inflate, bad_block_type, sizeof(bad_block_type), &in_read, buffer, sizeof(buffer), &out_written) == CompressStatus_Error);
+  InflateDestroy(inflate);
+  ArenaRelease(arena);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  RUN_TEST(InflateKnownTest);
+  RUN_TEST(RoundTripTest);
+  RUN_TEST(DeflateRatioTest);
+  RUN_TEST(StreamingTest);
+  RUN_TEST(InflateTrailingDataTest);
+  RUN_TEST(InflateInvalidTest);
+  LogTestReport();
+  return 0;
+}
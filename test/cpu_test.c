@@ -0,0 +1,153 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+typedef U64 Sum_Fn(U8* data, U32 size);
+
+static U64 SumScalar(U8* data, U32 size) {
+  U64 result = 0;
+  for (U32 i = 0; i < size; i++) { result += data[i]; }
+  return result;
+}
+
+#if defined(ARCH_X64)
+static U64 SumSse2(U8* data, U32 size) {
+  __m128i acc = _mm_setzero_si128();
+  U32 i = 0;
+  for (; i + 16 <= size; i += 16) {
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128((__m128i*) (data + i)), _mm_setzero_si128()));
+  }
+  U64 result = (U64) _mm_cvtsi128_si64(acc) + (U64) _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+  return result + SumScalar(data + i, size - i);
+}
+
+CPU_TARGET_AVX2 static U64 SumAvx2(U8* data, U32 size) {
+  __m256i acc = _mm256_setzero_si256();
+  U32 i = 0;
+  for (; i + 32 <= size; i += 32) {
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256((__m256i*) (data + i)), _mm256_setzero_si256()));
+  }
+  U64 lanes[4];
+  _mm256_storeu_si256((__m256i*) lanes, acc);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumScalar(data + i, size - i);
+}
+#endif
+
+// NOTE: SSE42 is deliberately left empty, to check fallback to the next lowest variant.
+static CpuDispatch sum_dispatch = {
+  .variants = {
+    [CpuIsaLevel_Scalar] = (CpuKernel_Fn*) SumScalar,
+#if defined(ARCH_X64)
+    [CpuIsaLevel_SSE2]   = (CpuKernel_Fn*) SumSse2,
+    [CpuIsaLevel_AVX2]   = (CpuKernel_Fn*) SumAvx2,
+#endif
+  },
+  .bound = 0,
+};
+
+void DetectTest(void) {
+  CpuIsaLevel level = CpuIsaLevelGet();
+#if defined(ARCH_X64)
+  EXPECT_TRUE(CpuHasFeature(CpuFeature_SSE2));
+  EXPECT_TRUE(level >= CpuIsaLevel_SSE2);
+  EXPECT_FALSE(CpuHasFeature(CpuFeature_NEON));
+  if (level >= CpuIsaLevel_AVX2) { EXPECT_TRUE(CpuHasFeature(CpuFeature_AVX2 | CpuFeature_AVX | CpuFeature_SSE42)); }
+  if (CpuHasFeature(CpuFeature_AVX2)) { EXPECT_TRUE(CpuHasFeature(CpuFeature_AVX)); }
+#elif defined(ARCH_ARM64)
+  EXPECT_TRUE(CpuHasFeature(CpuFeature_NEON));
+  EXPECT_TRUE(level == CpuIsaLevel_NEON);
+#endif
+}
+
+void ForceMaxTest(void) {
+  CpuIsaLevel level = CpuIsaLevelGet();
+  U32 features = CpuFeaturesGet();
+
+  CpuIsaLevelForceMax(CpuIsaLevel_Scalar);
+  EXPECT_TRUE(CpuIsaLevelGet() == CpuIsaLevel_Scalar);
+  EXPECT_U32_EQ(CpuFeaturesGet(), 0);
+
+  CpuIsaLevelForceMax(CpuIsaLevel_SSE2);
+  EXPECT_TRUE(CpuIsaLevelGet() <= CpuIsaLevel_SSE2);
+  EXPECT_FALSE(CpuHasFeature(CpuFeature_SSE42));
+  EXPECT_FALSE(CpuHasFeature(CpuFeature_AVX2));
+
+  CpuIsaLevelForceMax(CpuIsaLevel_Count);
+  EXPECT_TRUE(CpuIsaLevelGet() == level);
+  EXPECT_U32_EQ(CpuFeaturesGet(), features);
+}
+
+void DispatchTest(void) {
+  U8 data[1000];
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(data); i++) { data[i] = (U8) (i * 31); }
+  U64 expected = SumScalar(data, STATIC_ARRAY_SIZE(data));
+
+  CpuIsaLevel level = CpuIsaLevelGet();
+  for (S32 max = CpuIsaLevel_Scalar; max <= (S32) level; max++) {
+    CpuIsaLevelForceMax((CpuIsaLevel) max);
+    Sum_Fn* sum = CPU_DISPATCH(&sum_dispatch, Sum_Fn);
+    EXPECT_U32_EQ(sum(data, STATIC_ARRAY_SIZE(data)), expected);
+    EXPECT_U32_EQ(sum(data, 7), SumScalar(data, 7));
+#if defined(ARCH_X64)
+    if (max == CpuIsaLevel_Scalar) { EXPECT_TRUE(sum == SumScalar); }
+    if (max == CpuIsaLevel_SSE2 || max == CpuIsaLevel_SSE42) { EXPECT_TRUE(sum == SumSse2); }
+    if (max >= CpuIsaLevel_AVX2) { EXPECT_TRUE(sum == SumAvx2); }
+#endif
+  }
+  CpuIsaLevelForceMax(CpuIsaLevel_Count);
+}
+
+void TopologyTest(void) {
+  Arena* arena = ArenaAllocate();
+  CpuTopology topology;
+  EXPECT_TRUE(CpuTopologyGet(arena, &topology));
+  EXPECT_TRUE(topology.logical_cores >= topology.physical_cores);
+  EXPECT_TRUE(topology.physical_cores >= 1);
+  EXPECT_TRUE(topology.numa_nodes >= 1);
+  EXPECT_TRUE(topology.cache_line_size == 0 || topology.cache_line_size >= 32);
+  for (U32 cpu = 0; cpu < topology.logical_cores; cpu++) {
+    if (topology.physical_core_ids[cpu] == U32_MAX) { continue; }
+    EXPECT_TRUE(topology.physical_core_ids[cpu] < topology.physical_cores);
+    EXPECT_TRUE(topology.numa_node_ids[cpu] < topology.numa_nodes);
+  }
+  U32* cpus = ARENA_PUSH_ARRAY(arena, U32, topology.physical_cores);
+  EXPECT_U32_EQ(CpuTopologyOnePerPhysicalCore(&topology, cpus), topology.physical_cores);
+  ArenaRelease(arena);
+}
+
+static S32 ThreadControlEntry(void* arg) {
+  CpuTopology* topology = (CpuTopology*) arg;
+  U32 cpu = 0;
+  while (topology->physical_core_ids[cpu] == U32_MAX) { cpu++; }
+  B32 success = true;
+  success &= ThreadSetAffinity(&cpu, 1);
+  // NOTE: lowering priority never needs privileges.
+  success &= ThreadSetPriority(ThreadPriority_Low);
+  success &= ThreadSetName(Str8Lit("cpu_test_worker_thread"));
+#if defined(OS_LINUX)
+  char name[16];
+  prctl(PR_GET_NAME, name, 0, 0, 0);
+  success &= MEMORY_IS_EQUAL_SIZE(name, "cpu_test_worker", 16);
+#endif
+  return success;
+}
+
+void ThreadControlTest(void) {
+  Arena* arena = ArenaAllocate();
+  CpuTopology topology;
+  EXPECT_TRUE(CpuTopologyGet(arena, &topology));
+  Thread thread;
+  ThreadCreate(&thread, ThreadControlEntry, &topology);
+  EXPECT_TRUE(ThreadJoin(&thread));
+  ArenaRelease(arena);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  RUN_TEST(DetectTest);
+  RUN_TEST(ForceMaxTest);
+  RUN_TEST(DispatchTest);
+  RUN_TEST(TopologyTest);
+  RUN_TEST(ThreadControlTest);
+  LogTestReport();
+  return 0;
+}
@@ -0,0 +1,107 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+DEQUE_DEFINE(U32Deque, U32)
+
+Arena* arena;
+
+void PushPopBackTest(void) {
+  U32Deque deque;
+  U32DequeInit(&deque, arena);
+  for (U32 i = 0; i < 100; i++) { U32DequePushBack(&deque, i); }
+  EXPECT_U32_EQ(deque.size, 100);
+  EXPECT_U32_EQ(*U32DequeFront(&deque), 0);
+  EXPECT_U32_EQ(*U32DequeBack(&deque), 99);
+  for (S32 i = 99; i >= 0; i--) { EXPECT_U32_EQ(U32DequePopBack(&deque), i); }
+  EXPECT_U32_EQ(deque.size, 0);
+}
+
+void PushPopFrontTest(void) {
+  U32Deque deque;
+  U32DequeInit(&deque, arena);
+  for (U32 i = 0; i < 100; i++) { U32DequePushFront(&deque, i); }
+  EXPECT_U32_EQ(*U32DequeFront(&deque), 99);
+  EXPECT_U32_EQ(*U32DequeBack(&deque), 0);
+  for (S32 i = 99; i >= 0; i--) { EXPECT_U32_EQ(U32DequePopFront(&deque), i); }
+  EXPECT_U32_EQ(deque.size, 0);
+}
+
+void QueueTest(void) {
+  U32Deque deque;
+  U32DequeInit(&deque, arena);
+  U32DequeReserve(&deque, 8);
+  EXPECT_U32_EQ(deque.capacity, 16);
+  // NOTE: cycle through the buffer several times without growing.
+  U32 next_push = 0, next_pop = 0;
+  for (U32 i = 0; i < 10; i++) { U32DequePushBack(&deque, next_push++); }
+  for (U32 i = 0; i < 100; i++) {
+    EXPECT_U32_EQ(U32DequePopFront(&deque), next_pop++);
+    U32DequePushBack(&deque, next_push++);
+  }
+  EXPECT_U32_EQ(deque.capacity, 16);
+  for (U32 i = 0; i < deque.size; i++) { EXPECT_U32_EQ(*U32DequeGet(&deque, i), next_pop + i); }
+}
+
+void GrowWrappedTest(void) {
+  U32Deque deque;
+  U32DequeInit(&deque, arena);
+  U32DequeReserve(&deque, 16);
+  for (U32 i = 0; i < 8; i++) { U32DequePushBack(&deque, i + 8); }
+  for (U32 i = 0; i < 8; i++) { U32DequePushFront(&deque, 7 - i); }
+  EXPECT_U32_EQ(deque.size, 16);
+  EXPECT_U32_EQ(deque.capacity, 16);
+  EXPECT_TRUE(deque.head != 0);
+  U32DequePushBack(&deque, 16);
+  EXPECT_U32_EQ(deque.capacity, 32);
+  EXPECT_U32_EQ(deque.head, 0);
+  for (U32 i = 0; i < deque.size; i++) { EXPECT_U32_EQ(*U32DequeGet(&deque, i), i); }
+}
+
+void SpansTest(void) {
+  U32Deque deque;
+  U32DequeInit(&deque, arena);
+  U32DequeReserve(&deque, 16);
+  for (U32 i = 0; i < 4; i++) { U32DequePushBack(&deque, i + 4); }
+  for (U32 i = 0; i < 4; i++) { U32DequePushFront(&deque, 3 - i); }
+  U32 *a, *b, a_size, b_size;
+  U32DequeSpans(&deque, &a, &a_size, &b, &b_size);
+  EXPECT_U32_EQ(a_size, 4);
+  EXPECT_U32_EQ(b_size, 4);
+  for (U32 i = 0; i < a_size; i++) { EXPECT_U32_EQ(a[i], i); }
+  for (U32 i = 0; i < b_size; i++) { EXPECT_U32_EQ(b[i], i + 4); }
+}
+
+void BulkTest(void) {
+  U32Deque deque;
+  U32DequeInit(&deque, arena);
+  U32DequeReserve(&deque, 16);
+  U32 items[12];
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(items); i++) { items[i] = i; }
+  U32DequePushBackArray(&deque, items, 10);
+  U32 dest[12];
+  EXPECT_U32_EQ(U32DequePopFrontArray(&deque, dest, 8), 8);
+  for (U32 i = 0; i < 8; i++) { EXPECT_U32_EQ(dest[i], i); }
+  // NOTE: this push wraps.
+  U32DequePushBackArray(&deque, items, 12);
+  EXPECT_U32_EQ(deque.size, 14);
+  EXPECT_U32_EQ(deque.capacity, 16);
+  EXPECT_U32_EQ(U32DequePopFrontArray(&deque, dest, 2), 2);
+  EXPECT_U32_EQ(dest[0], 8);
+  EXPECT_U32_EQ(dest[1], 9);
+  EXPECT_U32_EQ(U32DequePopFrontArray(&deque, dest, 100), 12);
+  for (U32 i = 0; i < 12; i++) { EXPECT_U32_EQ(dest[i], i); }
+  EXPECT_U32_EQ(deque.size, 0);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  arena = ArenaAllocate();
+  RUN_TEST(PushPopBackTest);
+  RUN_TEST(PushPopFrontTest);
+  RUN_TEST(QueueTest);
+  RUN_TEST(GrowWrappedTest);
+  RUN_TEST(SpansTest);
+  RUN_TEST(BulkTest);
+  LogTestReport();
+  return 0;
+}
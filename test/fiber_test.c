@@ -0,0 +1,163 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+static void Counter(Fiber* fiber, void* arg) {
+  S32* count = (S32*) arg;
+  for (S32 i = 0; i < 3; i++) {
+    *count += 1;
+    FiberYield(fiber);
+  }
+}
+
+void ResumeYieldTest(void) {
+  S32 count = 0;
+  Fiber fiber;
+  EXPECT_TRUE(FiberCreate(&fiber, Counter, &count, KB(64)));
+  EXPECT_S32_EQ(count, 0);
+  FiberResume(&fiber);
+  EXPECT_S32_EQ(count, 1);
+  FiberResume(&fiber);
+  EXPECT_S32_EQ(count, 2);
+  FiberResume(&fiber);
+  EXPECT_S32_EQ(count, 3);
+  EXPECT_FALSE(FiberIsDone(&fiber));
+  FiberResume(&fiber);
+  EXPECT_S32_EQ(count, 3);
+  EXPECT_TRUE(FiberIsDone(&fiber));
+  FiberDestroy(&fiber);
+}
+
+static void Interleave(Fiber* fiber, void* arg) {
+  U8* log = (U8*) arg;
+  U8 c = *log;
+  for (S32 i = 0; i < 3; i++) {
+    U32 len = 0;
+    while (log[len] != 0) { len++; }
+    log[len] = c;
+    FiberYield(fiber);
+  }
+}
+
+void InterleaveTest(void) {
+  U8 log_a[16] = { 'a' };
+  U8 log_b[16] = { 'b' };
+  Fiber a, b;
+  EXPECT_TRUE(FiberCreate(&a, Interleave, log_a, KB(64)));
+  EXPECT_TRUE(FiberCreate(&b, Interleave, log_b, KB(64)));
+  while (!FiberIsDone(&a) || !FiberIsDone(&b)) {
+    if (!FiberIsDone(&a)) { FiberResume(&a); }
+    if (!FiberIsDone(&b)) { FiberResume(&b); }
+  }
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(log_a, "aaaa", 5));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(log_b, "bbbb", 5));
+  FiberDestroy(&a);
+  FiberDestroy(&b);
+}
+
+// NOTE: callee-saved float registers must survive switches.
+static void FloatMath(Fiber* fiber, void* arg) {
+  F64* result = (F64*) arg;
+  F64 x = 1.5;
+  for (S32 i = 0; i < 10; i++) {
+    x = x * 1.25 + 0.5;
+    FiberYield(fiber);
+  }
+  *result = x;
+}
+
+void FloatTest(void) {
+  F64 result = 0;
+  F64 expected = 1.5;
+  for (S32 i = 0; i < 10; i++) { expected = expected * 1.25 + 0.5; }
+  Fiber fiber;
+  EXPECT_TRUE(FiberCreate(&fiber, FloatMath, &result, KB(64)));
+  F64 y = 3.0;
+  while (!FiberIsDone(&fiber)) {
+    FiberResume(&fiber);
+    y = y * 0.5 + 1.0;
+  }
+  EXPECT_TRUE(result == expected);
+  EXPECT_TRUE(y > 1.0 && y < 3.0);
+  FiberDestroy(&fiber);
+}
+
+static void Inner(Fiber* fiber, void* arg) {
+  *(S32*) arg += 10;
+  FiberYield(fiber);
+  *(S32*) arg += 10;
+}
+
+static void Outer(Fiber* fiber, void* arg) {
+  Fiber inner;
+  ASSERT(FiberCreate(&inner, Inner, arg, KB(64)));
+  while (!FiberIsDone(&inner)) {
+    FiberResume(&inner);
+    *(S32*) arg += 1;
+    FiberYield(fiber);
+  }
+  FiberDestroy(&inner);
+}
+
+void NestedTest(void) {
+  S32 value = 0;
+  Fiber outer;
+  EXPECT_TRUE(FiberCreate(&outer, Outer, &value, KB(64)));
+  while (!FiberIsDone(&outer)) { FiberResume(&outer); }
+  EXPECT_S32_EQ(value, 22);
+  FiberDestroy(&outer);
+}
+
+static S32 Recurse(S32 depth) {
+  volatile U8 buffer[256];
+  buffer[0] = (U8) depth;
+  if (depth == 0) { return buffer[0]; }
+  return Recurse(depth - 1) + 1 + buffer[0] * 0;
+}
+
+static void DeepStack(Fiber* fiber, void* arg) {
+  *(S32*) arg = Recurse(500);
+  FiberYield(fiber);
+}
+
+void DeepStackTest(void) {
+  S32 value = 0;
+  Fiber fiber;
+  EXPECT_TRUE(FiberCreate(&fiber, DeepStack, &value, KB(256)));
+  FiberResume(&fiber);
+  EXPECT_S32_EQ(value, 500);
+  FiberResume(&fiber);
+  EXPECT_TRUE(FiberIsDone(&fiber));
+  FiberDestroy(&fiber);
+}
+
+// NOTE: a suspended fiber can be picked up by a different thread.
+static S32 ResumeOnThread(void* arg) {
+  FiberResume((Fiber*) arg);
+  return 0;
+}
+
+void MigrateTest(void) {
+  S32 count = 0;
+  Fiber fiber;
+  EXPECT_TRUE(FiberCreate(&fiber, Counter, &count, KB(64)));
+  for (S32 i = 0; i < 4; i++) {
+    Thread thread;
+    ThreadCreate(&thread, ResumeOnThread, &fiber);
+    ThreadJoin(&thread);
+  }
+  EXPECT_S32_EQ(count, 3);
+  EXPECT_TRUE(FiberIsDone(&fiber));
+  FiberDestroy(&fiber);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  RUN_TEST(ResumeYieldTest);
+  RUN_TEST(InterleaveTest);
+  RUN_TEST(FloatTest);
+  RUN_TEST(NestedTest);
+  RUN_TEST(DeepStackTest);
+  RUN_TEST(MigrateTest);
+  LogTestReport();
+  return 0;
+}
@@ -0,0 +1,115 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define MinCompare(a, b) (((a) > (b)) - ((a) < (b)))
+#define MaxCompare(a, b) (((a) < (b)) - ((a) > (b)))
+HEAP_DEFINE(MinHeap, S32, MinCompare)
+HEAP_DEFINE(MaxHeap, S32, MaxCompare)
+
+Arena* arena;
+
+void PushPopTest(void) {
+  MinHeap heap;
+  MinHeapInit(&heap, arena);
+  S32 items[] = { 5, 3, 8, 1, 9, 2, 7, 4, 6, 0 };
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(items); i++) { MinHeapPush(&heap, items[i]); }
+  EXPECT_U32_EQ(heap.size, 10);
+  EXPECT_S32_EQ(*MinHeapPeek(&heap), 0);
+  for (S32 i = 0; i < 10; i++) { EXPECT_S32_EQ(MinHeapPop(&heap), i); }
+  EXPECT_U32_EQ(heap.size, 0);
+}
+
+void MaxHeapTest(void) {
+  MaxHeap heap;
+  MaxHeapInit(&heap, arena);
+  S32 items[] = { 5, 3, 8, 1, 9, 2, 7, 4, 6, 0 };
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(items); i++) { MaxHeapPush(&heap, items[i]); }
+  for (S32 i = 9; i >= 0; i--) { EXPECT_S32_EQ(MaxHeapPop(&heap), i); }
+}
+
+void GrowTest(void) {
+  MinHeap heap;
+  MinHeapInit(&heap, arena);
+  for (S32 i = 1000; i > 0; i--) { MinHeapPush(&heap, i); }
+  EXPECT_U32_EQ(heap.size, 1000);
+  EXPECT_TRUE(heap.capacity >= 1000);
+  for (S32 i = 1; i <= 1000; i++) { EXPECT_S32_EQ(MinHeapPop(&heap), i); }
+}
+
+void HandleTest(void) {
+  MinHeap heap;
+  MinHeapInit(&heap, arena);
+  U32 h10 = MinHeapPush(&heap, 10);
+  U32 h20 = MinHeapPush(&heap, 20);
+  U32 h30 = MinHeapPush(&heap, 30);
+  EXPECT_S32_EQ(*MinHeapGet(&heap, h10), 10);
+  EXPECT_S32_EQ(*MinHeapGet(&heap, h20), 20);
+  EXPECT_S32_EQ(*MinHeapGet(&heap, h30), 30);
+  EXPECT_U32_EQ(MinHeapPeekHandle(&heap), h10);
+
+  // NOTE: decrease-key.
+  MinHeapUpdate(&heap, h30, 5);
+  EXPECT_U32_EQ(MinHeapPeekHandle(&heap), h30);
+  EXPECT_S32_EQ(*MinHeapPeek(&heap), 5);
+
+  // NOTE: increase-key.
+  MinHeapUpdate(&heap, h30, 25);
+  EXPECT_U32_EQ(MinHeapPeekHandle(&heap), h10);
+
+  EXPECT_S32_EQ(MinHeapRemove(&heap, h20), 20);
+  EXPECT_U32_EQ(heap.size, 2);
+  EXPECT_S32_EQ(*MinHeapGet(&heap, h30), 25);
+
+  // NOTE: handles are recycled once freed.
+  U32 h40 = MinHeapPush(&heap, 40);
+  EXPECT_U32_EQ(h40, h20);
+  EXPECT_S32_EQ(MinHeapPop(&heap), 10);
+  EXPECT_S32_EQ(MinHeapPop(&heap), 25);
+  EXPECT_S32_EQ(MinHeapPop(&heap), 40);
+}
+
+void HeapifyTest(void) {
+  MinHeap heap;
+  MinHeapInit(&heap, arena);
+  S32 items[] = { 9, 4, 7, 1, 8, 2, 6, 3, 5, 0, 11, 10 };
+  MinHeapHeapify(&heap, items, STATIC_ARRAY_SIZE(items));
+  EXPECT_U32_EQ(heap.size, STATIC_ARRAY_SIZE(items));
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(items); i++) { EXPECT_S32_EQ(*MinHeapGet(&heap, i), items[i]); }
+  for (S32 i = 0; i < (S32) STATIC_ARRAY_SIZE(items); i++) { EXPECT_S32_EQ(MinHeapPop(&heap), i); }
+}
+
+void RandomTest(void) {
+  MinHeap heap;
+  MinHeapInit(&heap, arena);
+  RandSeed(NULL, 1234);
+  U32 handles[256];
+  S32 values[256];
+  for (U32 i = 0; i < 256; i++) {
+    values[i] = RandU32(NULL, 0, 10000);
+    handles[i] = MinHeapPush(&heap, values[i]);
+  }
+  for (U32 i = 0; i < 256; i += 3) {
+    values[i] = RandU32(NULL, 0, 10000);
+    MinHeapUpdate(&heap, handles[i], values[i]);
+  }
+  for (U32 i = 0; i < 256; i++) { EXPECT_S32_EQ(*MinHeapGet(&heap, handles[i]), values[i]); }
+  S32 prev = MinHeapPop(&heap);
+  while (heap.size > 0) {
+    S32 curr = MinHeapPop(&heap);
+    EXPECT_TRUE(prev <= curr);
+    prev = curr;
+  }
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  arena = ArenaAllocate();
+  RUN_TEST(PushPopTest);
+  RUN_TEST(MaxHeapTest);
+  RUN_TEST(GrowTest);
+  RUN_TEST(HandleTest);
+  RUN_TEST(HeapifyTest);
+  RUN_TEST(RandomTest);
+  LogTestReport();
+  return 0;
+}
@@ -0,0 +1,729 @@
+#define FILE_IO_CHUNK_SIZE KB(4) // NOTE: exercise chunking with small buffers.
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define TEST_FILE Str8Lit("./io_test.tmp")
+
+void FileMapTest(void) {
+  U8 data[KB(16) + 3];
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(data); i++) { data[i] = (U8) (i * 31); }
+  EXPECT_TRUE(FileDump(TEST_FILE, data, sizeof(data)));
+
+  FileMap map;
+  EXPECT_TRUE(FileMapOpen(TEST_FILE, &map, FileMapHint_None));
+  EXPECT_U64_EQ(map.size, sizeof(data));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(map.data, data, sizeof(data)));
+  EXPECT_TRUE(FileMapClose(&map));
+  EXPECT_PTR_NULL(map.data);
+
+  // NOTE: hints are advisory, so they never change what's read.
+  EXPECT_TRUE(FileMapOpen(TEST_FILE, &map, FileMapHint_Sequential | FileMapHint_WillNeed | FileMapHint_HugePages));
+  EXPECT_U64_EQ(map.size, sizeof(data));
+  EXPECT_U8_EQ(map.data[sizeof(data) - 1], data[sizeof(data) - 1]);
+
+  // NOTE: the mapping outlives other handles to the file.
+  FileMap other;
+  EXPECT_TRUE(FileMapOpen(TEST_FILE, &other, FileMapHint_None));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(map.data, other.data, sizeof(data)));
+  EXPECT_TRUE(FileMapClose(&other));
+  EXPECT_TRUE(FileMapClose(&map));
+}
+
+void FileMapEmptyTest(void) {
+  EXPECT_TRUE(FileDump(TEST_FILE, NULL, 0));
+  FileMap map;
+  EXPECT_TRUE(FileMapOpen(TEST_FILE, &map, FileMapHint_Sequential));
+  EXPECT_U64_EQ(map.size, 0);
+  EXPECT_PTR_NULL(map.data);
+  EXPECT_TRUE(FileMapClose(&map));
+
+  EXPECT_FALSE(FileMapOpen(Str8Lit("./does_not_exist.tmp"), &map, FileMapHint_None));
+  EXPECT_PTR_NULL(map.data);
+  EXPECT_U64_EQ(map.size, 0);
+}
+
+void ChunkedReadWriteTest(void) {
+  Arena* arena = ArenaAllocate();
+  U64 size = FILE_IO_CHUNK_SIZE * 3 + 17;
+  U8* data = ARENA_PUSH_ARRAY(arena, U8, size);
+  for (U64 i = 0; i < size; i++) { data[i] = (U8) (i * 7); }
+  EXPECT_TRUE(FileDump(TEST_FILE, data, size));
+
+  U8* read_data;
+  U64 read_size;
+  EXPECT_TRUE(FileReadAll64(arena, TEST_FILE, &read_data, &read_size));
+  EXPECT_U64_EQ(read_size, size);
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(read_data, data, size));
+
+  // NOTE: reads stop at EOF, even mid-chunk.
+  FileHandle* file;
+  U8* buffer = ARENA_PUSH_ARRAY(arena, U8, size * 2);
+  U64 bytes_read;
+  U32 bytes_read_32;
+  EXPECT_TRUE(FileHandleOpen(&file, TEST_FILE, FileMode_Read));
+  EXPECT_TRUE(FileHandleRead64(file, buffer, size * 2, &bytes_read));
+  EXPECT_U64_EQ(bytes_read, size);
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(buffer, data, size));
+  EXPECT_TRUE(FileHandleSeek(file, -(S64) FILE_IO_CHUNK_SIZE - 17, FileSeekPos_End));
+  EXPECT_TRUE(FileHandleRead(file, buffer, (U32) size, &bytes_read_32));
+  EXPECT_U32_EQ(bytes_read_32, FILE_IO_CHUNK_SIZE + 17);
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(buffer, data + FILE_IO_CHUNK_SIZE * 2, FILE_IO_CHUNK_SIZE + 17));
+  EXPECT_TRUE(FileHandleRead64(file, buffer, size, &bytes_read));
+  EXPECT_U64_EQ(bytes_read, 0);
+  EXPECT_TRUE(FileHandleClose(file));
+
+  EXPECT_TRUE(FileAppend(TEST_FILE, data, FILE_IO_CHUNK_SIZE + 1));
+  FileStats stats;
+  EXPECT_TRUE(FileStat(TEST_FILE, &stats));
+  EXPECT_U64_EQ(stats.size, size + FILE_IO_CHUNK_SIZE + 1);
+  ArenaRelease(arena);
+}
+
+// NOTE: everything past 4GB is a hole, so this only costs a few pages of disk on filesystems with sparse files.
+void LargeFileTest(void) {
+  U64 tail_pos = GB(6);
+  FileHandle* file;
+  EXPECT_TRUE(FileHandleOpen(&file, TEST_FILE, FileMode_Read | FileMode_Write | FileMode_Create | FileMode_Truncate));
+  EXPECT_TRUE(FileHandleWrite(file, (U8*) "head", 4));
+  EXPECT_TRUE(FileHandleSeek(file, tail_pos, FileSeekPos_Begin));
+  EXPECT_TRUE(FileHandleWrite(file, (U8*) "tail", 4));
+
+  FileStats stats;
+  EXPECT_TRUE(FileHandleStat(file, &stats));
+  EXPECT_U64_EQ(stats.size, tail_pos + 4);
+
+  U8 buffer[16];
+  U64 bytes_read;
+  EXPECT_TRUE(FileHandleSeek(file, -4, FileSeekPos_End));
+  EXPECT_TRUE(FileHandleRead64(file, buffer, sizeof(buffer), &bytes_read));
+  EXPECT_U64_EQ(bytes_read, 4);
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(buffer, "tail", 4));
+
+  // NOTE: seek relative to the current position across the 4GB boundary, into the hole.
+  EXPECT_TRUE(FileHandleSeek(file, -(S64) GB(3), FileSeekPos_Current));
+  EXPECT_TRUE(FileHandleRead64(file, buffer, sizeof(buffer), &bytes_read));
+  EXPECT_U64_EQ(bytes_read, sizeof(buffer));
+  for (U32 i = 0; i < sizeof(buffer); i++) { EXPECT_U8_EQ(buffer[i], 0); }
+
+  EXPECT_TRUE(FileHandleSeek(file, tail_pos - 8, FileSeekPos_Begin));
+  EXPECT_TRUE(FileHandleRead64(file, buffer, sizeof(buffer), &bytes_read));
+  EXPECT_U64_EQ(bytes_read, 12);
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(buffer + 8, "tail", 4));
+
+  EXPECT_TRUE(FileHandleSeek(file, 0, FileSeekPos_Begin));
+  EXPECT_TRUE(FileHandleRead64(file, buffer, 4, &bytes_read));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(buffer, "head", 4));
+  EXPECT_TRUE(FileHandleClose(file));
+
+  EXPECT_TRUE(FileStat(TEST_FILE, &stats));
+  EXPECT_U64_EQ(stats.size, tail_pos + 4);
+  FileMap map;
+  EXPECT_TRUE(FileMapOpen(TEST_FILE, &map, FileMapHint_None));
+  EXPECT_U64_EQ(map.size, tail_pos + 4);
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(map.data + tail_pos, "tail", 4));
+  EXPECT_TRUE(FileMapClose(&map));
+
+  // NOTE: too large for the U32 API.
+  Arena* arena = ArenaAllocate();
+  U8* data;
+  U32 data_size;
+  EXPECT_FALSE(FileReadAll(arena, TEST_FILE, &data, &data_size));
+  ArenaRelease(arena);
+  EXPECT_TRUE(FileDump(TEST_FILE, NULL, 0));
+}
+
+static void ReadQueueTestCommon(FileReadQueueBackend backend) {
+  Arena* arena = ArenaAllocate();
+  U32 size = KB(64) + 5;
+  U8* data = ARENA_PUSH_ARRAY(arena, U8, size);
+  for (U32 i = 0; i < size; i++) { data[i] = (U8) (i * 13); }
+  EXPECT_TRUE(FileDump(TEST_FILE, data, size));
+
+  FileHandle* file;
+  EXPECT_TRUE(FileHandleOpen(&file, TEST_FILE, FileMode_Read));
+  FileReadQueue* queue;
+  EXPECT_TRUE(FileReadQueueCreate(&queue, 4, backend));
+  LOG_INFO("Read queue backend: %d", FileReadQueueGetBackend(queue));
+  EXPECT_U32_EQ(FileReadQueuePoll(queue, NULL, 0), 0);
+
+  // NOTE: more requests than slots, the last two straddle / start past EOF.
+  U32 requests_size = 34;
+  FileReadRequest* requests = ARENA_PUSH_ARRAY(arena, FileReadRequest, requests_size);
+  for (U32 i = 0; i < requests_size; i++) {
+    MEMORY_ZERO_STRUCT(&requests[i]);
+    requests[i].file      = file;
+    requests[i].offset    = i * KB(2) + i;
+    requests[i].size      = KB(2);
+    requests[i].buffer    = ARENA_PUSH_ARRAY(arena, U8, requests[i].size);
+    requests[i].user_data = (void*) (U64) i;
+  }
+  FileReadQueueSubmit(queue, requests, requests_size);
+  EXPECT_U32_EQ(FileReadQueueOutstanding(queue), requests_size);
+
+  FileReadRequest* completed[3];
+  U32 completed_size;
+  U32 num_completed = 0;
+  while ((completed_size = FileReadQueueWait(queue, completed, STATIC_ARRAY_SIZE(completed))) > 0) {
+    EXPECT_TRUE(completed_size <= STATIC_ARRAY_SIZE(completed));
+    for (U32 i = 0; i < completed_size; i++) {
+      FileReadRequest* request = completed[i];
+      U32 index = (U32) (U64) request->user_data;
+      EXPECT_TRUE(request == &requests[index]);
+      EXPECT_TRUE(request->success);
+      U32 expected_size = (request->offset < size) ? MIN(request->size, size - request->offset) : 0;
+      EXPECT_U32_EQ(request->bytes_read, expected_size);
+      EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(request->buffer, data + request->offset, request->bytes_read));
+    }
+    num_completed += completed_size;
+  }
+  EXPECT_U32_EQ(num_completed, requests_size);
+  EXPECT_U32_EQ(FileReadQueueOutstanding(queue), 0);
+
+  // NOTE: poll until complete.
+  FileReadQueueSubmit(queue, requests, 2);
+  num_completed = 0;
+  while (FileReadQueueOutstanding(queue) > 0) {
+    num_completed += FileReadQueuePoll(queue, completed, STATIC_ARRAY_SIZE(completed));
+  }
+  EXPECT_U32_EQ(num_completed, 2);
+
+  // NOTE: destroy waits on outstanding reads.
+  FileReadQueueSubmit(queue, requests, requests_size);
+  FileReadQueueDestroy(queue);
+  for (U32 i = 0; i < requests_size; i++) { EXPECT_TRUE(requests[i].success); }
+
+  EXPECT_TRUE(FileHandleClose(file));
+  EXPECT_FALSE(FileReadQueueCreate(&queue, 0, backend));
+  EXPECT_FALSE(FileReadQueueCreate(&queue, FILE_READ_QUEUE_MAX_DEPTH + 1, backend));
+  ArenaRelease(arena);
+}
+
+void ReadQueueNativeTest(void) {
+  ReadQueueTestCommon(FileReadQueueBackend_Native);
+}
+
+void ReadQueueThreadsTest(void) {
+  ReadQueueTestCommon(FileReadQueueBackend_Threads);
+}
+
+static void FileStreamTestCommon(FileMode mode) {
+  Arena* arena = ArenaAllocate();
+  U32 lines_size = 5000;
+  FileWriter writer;
+  EXPECT_TRUE(FileWriterOpen(&writer, TEST_FILE, mode | FileMode_Create | FileMode_Truncate, KB(4)));
+  U64 total_size = 0;
+  for (U32 i = 0; i < lines_size; i++) {
+    U64 arena_pos = ArenaPos(arena);
+    String8 line = (i % 2 == 0) ? Str8Format(arena, "line,%u\n", i) : Str8Format(arena, "line,%u\r\n", i);
+    EXPECT_TRUE(FileWriterWriteStr8(&writer, line));
+    total_size += line.size;
+    ArenaPopTo(arena, arena_pos);
+  }
+  EXPECT_TRUE(FileWriterFlush(&writer));
+  // NOTE: a write larger than the buffer, followed by a final line without a newline.
+  U64 blob_size = KB(9) + 3;
+  U8* blob = ARENA_PUSH_ARRAY(arena, U8, blob_size);
+  for (U64 i = 0; i < blob_size; i++) { blob[i] = 'a' + (i % 26); }
+  EXPECT_TRUE(FileWriterWrite(&writer, blob, blob_size));
+  EXPECT_TRUE(FileWriterWriteStr8(&writer, Str8Lit("\nlast")));
+  total_size += blob_size + 5;
+  // NOTE: batches many small writes into few syscalls.
+  EXPECT_TRUE(writer.num_os_calls <= (total_size / KB(4)) + 3);
+  EXPECT_TRUE(FileWriterClose(&writer));
+
+  FileStats stats;
+  EXPECT_TRUE(FileStat(TEST_FILE, &stats));
+  EXPECT_U64_EQ(stats.size, total_size);
+
+  FileReader reader;
+  EXPECT_TRUE(FileReaderOpen(&reader, TEST_FILE, mode, KB(4)));
+  String8 line;
+  for (U32 i = 0; i < lines_size; i++) {
+    U64 arena_pos = ArenaPos(arena);
+    EXPECT_TRUE(FileReaderReadLine(&reader, arena, &line));
+    EXPECT_STR8_EQ(line, Str8Format(arena, "line,%u", i));
+    ArenaPopTo(arena, arena_pos);
+  }
+  U8* read_blob = ARENA_PUSH_ARRAY(arena, U8, blob_size);
+  EXPECT_TRUE(FileReaderReadExact(&reader, read_blob, blob_size));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(read_blob, blob, blob_size));
+  EXPECT_TRUE(FileReaderReadLine(&reader, arena, &line));
+  EXPECT_STR8_EQ(line, Str8Lit(""));
+  EXPECT_TRUE(FileReaderReadLine(&reader, arena, &line));
+  EXPECT_STR8_EQ(line, Str8Lit("last"));
+  EXPECT_FALSE(FileReaderReadLine(&reader, arena, &line));
+  EXPECT_FALSE(FileReaderReadExact(&reader, read_blob, 1));
+  EXPECT_TRUE(reader.num_os_calls <= (total_size / KB(4)) + 3);
+  EXPECT_TRUE(FileReaderClose(&reader));
+
+  EXPECT_FALSE(FileReaderOpen(&reader, TEST_FILE, mode, FILE_STREAM_MAX_BUFFER_SIZE + 1));
+  ArenaRelease(arena);
+}
+
+void FileStreamTest(void) {
+  FileStreamTestCommon(0);
+
+  // NOTE: reads larger than the buffer bypass it.
+  Arena* arena = ArenaAllocate();
+  U64 size = KB(64);
+  U8* data = ARENA_PUSH_ARRAY(arena, U8, size);
+  for (U64 i = 0; i < size; i++) { data[i] = (U8) (i * 3); }
+  EXPECT_TRUE(FileDump(TEST_FILE, data, size));
+  FileReader reader;
+  EXPECT_TRUE(FileReaderOpen(&reader, TEST_FILE, 0, KB(4)));
+  U8* read_data = ARENA_PUSH_ARRAY(arena, U8, size);
+  EXPECT_TRUE(FileReaderReadExact(&reader, read_data, 10));
+  EXPECT_TRUE(FileReaderReadExact(&reader, read_data + 10, size - 10));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(read_data, data, size));
+  EXPECT_U64_EQ(reader.num_os_calls, 2);
+  EXPECT_TRUE(FileReaderClose(&reader));
+  ArenaRelease(arena);
+}
+
+void FileStreamUnbufferedTest(void) {
+  FileStreamTestCommon(FileMode_Unbuffered);
+}
+
+void PackTest(void) {
+  Arena* arena = ArenaAllocate();
+  U32 entries_size = 100;
+  PackWriter writer;
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  for (U32 i = 0; i < entries_size; i++) {
+    String8 name = Str8Format(arena, "entry_%u", i);
+    U8* data = ARENA_PUSH_ARRAY(arena, U8, i * 7);
+    for (U32 j = 0; j < i * 7; j++) { data[j] = (U8) (i + j); }
+    EXPECT_TRUE(PackWriterAdd(&writer, name, data, i * 7, (i % 2 == 0) ? PackCompression_None : PackCompression_Deflate));
+  }
+  EXPECT_TRUE(PackWriterClose(&writer));
+
+  Pack pack;
+  EXPECT_TRUE(PackOpen(&pack, TEST_FILE, FileMapHint_None));
+  EXPECT_U32_EQ(pack.header->entries_size, entries_size);
+  for (U32 i = 0; i < entries_size; i++) {
+    String8 name = Str8Format(arena, "entry_%u", i);
+    PackEntry* entry = PackFind(&pack, name);
+    EXPECT_PTR_NOT_NULL(entry);
+    EXPECT_STR8_EQ(PackEntryName(&pack, entry), name);
+    EXPECT_TRUE(PackEntryVerify(&pack, entry));
+
+    EXPECT_U64_EQ((U64) PackEntryData(&pack, entry) % PACK_DATA_ALIGNMENT, 0);
+    U8* data;
+    U64 data_size;
+    if (entry->compression == PackCompression_None) {
+      EXPECT_TRUE(PackGet(&pack, name, &data, &data_size));
+      EXPECT_U64_EQ(data_size, i * 7);
+      for (U32 j = 0; j < i * 7; j++) { EXPECT_U8_EQ(data[j], (U8) (i + j)); }
+    } else {
+      // NOTE: compressed entries can't be read in place.
+      EXPECT_TRUE(entry->size < entry->raw_size);
+      EXPECT_FALSE(PackGet(&pack, name, &data, &data_size));
+    }
+
+    EXPECT_TRUE(PackRead(arena, &pack, name, &data, &data_size));
+    EXPECT_U64_EQ(data_size, i * 7);
+    for (U32 j = 0; j < i * 7; j++) { EXPECT_U8_EQ(data[j], (U8) (i + j)); }
+  }
+  EXPECT_PTR_NULL(PackFind(&pack, Str8Lit("entry_")));
+  EXPECT_PTR_NULL(PackFind(&pack, Str8Lit("entry_100")));
+  U8* data;
+  U64 data_size;
+  EXPECT_FALSE(PackGet(&pack, Str8Lit("missing"), &data, &data_size));
+  EXPECT_TRUE(PackClose(&pack));
+
+  // NOTE: an empty pack is still valid.
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  EXPECT_TRUE(PackWriterClose(&writer));
+  EXPECT_TRUE(PackOpen(&pack, TEST_FILE, FileMapHint_None));
+  EXPECT_U32_EQ(pack.header->entries_size, 0);
+  EXPECT_PTR_NULL(PackFind(&pack, Str8Lit("entry_0")));
+  EXPECT_TRUE(PackClose(&pack));
+  ArenaRelease(arena);
+}
+
+void PackStreamTest(void) {
+  U8 header[10];
+  U8 payload[1000];
+  for (U32 i = 0; i < sizeof(header); i++)  { header[i] = (U8) (i + 1); }
+  for (U32 i = 0; i < sizeof(payload); i++) { payload[i] = (U8) (i * 13); }
+  PackWriter writer;
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  EXPECT_TRUE(PackWriterBegin(&writer, Str8Lit("streamed")));
+  EXPECT_TRUE(PackWriterAppend(&writer, header, sizeof(header)));
+  EXPECT_TRUE(PackWriterAppend(&writer, payload, sizeof(payload)));
+  EXPECT_TRUE(PackWriterEnd(&writer));
+  EXPECT_TRUE(PackWriterAdd(&writer, Str8Lit("added"), payload, sizeof(payload), PackCompression_None));
+  EXPECT_TRUE(PackWriterBegin(&writer, Str8Lit("empty")));
+  EXPECT_TRUE(PackWriterEnd(&writer));
+  EXPECT_TRUE(PackWriterClose(&writer));
+
+  Pack pack;
+  EXPECT_TRUE(PackOpen(&pack, TEST_FILE, FileMapHint_None));
+  EXPECT_U32_EQ(pack.header->entries_size, 3);
+  PackEntry* entry = PackFind(&pack, Str8Lit("streamed"));
+  EXPECT_PTR_NOT_NULL(entry);
+  EXPECT_TRUE(PackEntryVerify(&pack, entry));
+  EXPECT_U64_EQ(entry->raw_size, sizeof(header) + sizeof(payload));
+  U8* data;
+  U64 data_size;
+  EXPECT_TRUE(PackGet(&pack, Str8Lit("streamed"), &data, &data_size));
+  EXPECT_U64_EQ(data_size, sizeof(header) + sizeof(payload));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(data, header, sizeof(header)));
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(data + sizeof(header), payload, sizeof(payload)));
+  // NOTE: entries added in one piece are checksummed the same way.
+  EXPECT_U64_EQ(PackFind(&pack, Str8Lit("added"))->checksum, Crc32c(payload, sizeof(payload)));
+  EXPECT_TRUE(PackGet(&pack, Str8Lit("empty"), &data, &data_size));
+  EXPECT_U64_EQ(data_size, 0);
+  EXPECT_TRUE(PackClose(&pack));
+}
+
+void PackInvalidTest(void) {
+  Arena* arena = ArenaAllocate();
+  U8 data[100];
+  MEMORY_SET_SIZE(data, 0xAB, sizeof(data));
+  PackWriter writer;
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  EXPECT_TRUE(PackWriterAdd(&writer, Str8Lit("a"), data, sizeof(data), PackCompression_None));
+  EXPECT_TRUE(PackWriterAdd(&writer, Str8Lit("a"), data, sizeof(data), PackCompression_None));
+  EXPECT_FALSE(PackWriterClose(&writer));
+
+  // NOTE: entries must be ended before the next one begins, and before the pack is closed.
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  EXPECT_TRUE(PackWriterBegin(&writer, Str8Lit("a")));
+  EXPECT_FALSE(PackWriterBegin(&writer, Str8Lit("b")));
+  EXPECT_FALSE(PackWriterClose(&writer));
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  EXPECT_TRUE(PackWriterBegin(&writer, Str8Lit("a")));
+  EXPECT_FALSE(PackWriterClose(&writer));
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  EXPECT_FALSE(PackWriterAppend(&writer, data, sizeof(data)));
+  EXPECT_FALSE(PackWriterClose(&writer));
+
+  // NOTE: packs that were never finished are rejected.
+  Pack pack;
+  EXPECT_FALSE(PackOpen(&pack, TEST_FILE, FileMapHint_None));
+  EXPECT_TRUE(FileDump(TEST_FILE, NULL, 0));
+  EXPECT_FALSE(PackOpen(&pack, TEST_FILE, FileMapHint_None));
+
+  EXPECT_TRUE(PackWriterOpen(&writer, TEST_FILE));
+  EXPECT_TRUE(PackWriterAdd(&writer, Str8Lit("a"), data, sizeof(data), PackCompression_None));
+  EXPECT_TRUE(PackWriterClose(&writer));
+  U8* file_data;
+  U32 file_data_size;
+  EXPECT_TRUE(FileReadAll(arena, TEST_FILE, &file_data, &file_data_size));
+
+  // NOTE: truncated.
+  EXPECT_TRUE(FileDump(TEST_FILE, file_data, file_data_size - 1));
+  EXPECT_FALSE(PackOpen(&pack, TEST_FILE, FileMapHint_None));
+
+  // NOTE: corrupted entry data is only caught by the checksum.
+  file_data[PACK_DATA_ALIGNMENT + 10] ^= 1;
+  EXPECT_TRUE(FileDump(TEST_FILE, file_data, file_data_size));
+  EXPECT_TRUE(PackOpen(&pack, TEST_FILE, FileMapHint_None));
+  EXPECT_FALSE(PackEntryVerify(&pack, PackFind(&pack, Str8Lit("a"))));
+  U64 read_size;
+  U8* read_data;
+  EXPECT_FALSE(PackRead(arena, &pack, Str8Lit("a"), &read_data, &read_size));
+  EXPECT_TRUE(PackGet(&pack, Str8Lit("a"), &read_data, &read_size));
+  EXPECT_TRUE(PackClose(&pack));
+  // NOTE: the last test to use TEST_FILE.
+  EXPECT_TRUE(FileDelete(TEST_FILE));
+  ArenaRelease(arena);
+}
+
+#define DIR_WALK_TEST_ROOT "./io_test_dir_walk.tmp"
+
+static String8 dir_walk_test_files[] = {
+  Str8Static("x.png"),
+  Str8Static("y.txt"),
+  Str8Static(".dotfile"),
+  Str8Static("a/z.PNG"),
+  Str8Static("a/b/w.json"),
+  Str8Static("a/b/c/v.png"),
+  Str8Static(".hidden/h.png"),
+};
+
+static DirEntry* DirWalkTestFind(DirEntry* entries, U64 entries_size, String8 path) {
+  for (U64 i = 0; i < entries_size; i++) {
+    if (Str8Eq(entries[i].path, path)) { return &entries[i]; }
+  }
+  return NULL;
+}
+
+static void DirWalkTestExpectCount(Arena* arena, DirWalkFlags flags, DirWalkFilter_Fn* filter, void* filter_data, U64 expected_size) {
+  DirEntry* entries;
+  U64 entries_size;
+  EXPECT_TRUE(DirWalk(arena, Str8Lit(DIR_WALK_TEST_ROOT), flags, filter, filter_data, &entries, &entries_size));
+  EXPECT_U64_EQ(entries_size, expected_size);
+}
+
+void DirWalkTest(void) {
+  Arena* arena = ArenaAllocate();
+  EXPECT_TRUE(DirCreate(Str8Lit(DIR_WALK_TEST_ROOT "/a/b/c")));
+  EXPECT_TRUE(DirCreate(Str8Lit(DIR_WALK_TEST_ROOT "/.hidden/")));
+  EXPECT_TRUE(DirCreate(Str8Lit(DIR_WALK_TEST_ROOT "/a"))); // NOTE: already exists.
+  U8 data[64];
+  MEMORY_SET_SIZE(data, 'x', sizeof(data));
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(dir_walk_test_files); i++) {
+    EXPECT_TRUE(FileDump(Str8Format(arena, DIR_WALK_TEST_ROOT "/%S", dir_walk_test_files[i]), data, i + 1));
+  }
+
+  DirWalkTestExpectCount(arena, DirWalkFlags_None, NULL, NULL, 3);
+  DirWalkTestExpectCount(arena, DirWalkFlags_IncludeDirs, NULL, NULL, 5);
+  DirWalkTestExpectCount(arena, DirWalkFlags_Recursive, NULL, NULL, 7);
+  DirWalkTestExpectCount(arena, DirWalkFlags_Recursive | DirWalkFlags_IncludeDirs, NULL, NULL, 11);
+  DirWalkTestExpectCount(arena, DirWalkFlags_Recursive | DirWalkFlags_SkipHidden, NULL, NULL, 5);
+
+  String8List extensions;
+  MEMORY_ZERO_STRUCT(&extensions);
+  Str8ListAppend(arena, &extensions, Str8Lit(".png"));
+  DirWalkTestExpectCount(arena, DirWalkFlags_Recursive, DirWalkFilterExtensions, &extensions, 4);
+  Str8ListAppend(arena, &extensions, Str8Lit(".txt"));
+  DirWalkTestExpectCount(arena, DirWalkFlags_Recursive, DirWalkFilterExtensions, &extensions, 5);
+
+  String8 pattern = Str8Lit("?.js*");
+  DirEntry* entries;
+  U64 entries_size;
+  EXPECT_TRUE(DirWalk(arena, Str8Lit(DIR_WALK_TEST_ROOT "/"), DirWalkFlags_Recursive | DirWalkFlags_Stat, DirWalkFilterGlob, &pattern, &entries, &entries_size));
+  EXPECT_U64_EQ(entries_size, 1);
+  EXPECT_STR8_EQ(entries[0].path, Str8Lit(DIR_WALK_TEST_ROOT "/a/b/w.json"));
+  EXPECT_STR8_EQ(entries[0].name, Str8Lit("w.json"));
+  EXPECT_U32_EQ(entries[0].depth, 2);
+  EXPECT_TRUE(entries[0].type == DirEntryType_File);
+  EXPECT_U64_EQ(entries[0].size, 5);
+  EXPECT_TRUE(entries[0].last_write_time > 0);
+
+  // NOTE: the parallel walk finds the same entries, in any order.
+  DirWalkFlags flags = DirWalkFlags_Recursive | DirWalkFlags_IncludeDirs | DirWalkFlags_Stat;
+  DirEntry* serial;
+  U64 serial_size;
+  EXPECT_TRUE(DirWalk(arena, Str8Lit(DIR_WALK_TEST_ROOT), flags, NULL, NULL, &serial, &serial_size));
+  EXPECT_TRUE(DirWalk(arena, Str8Lit(DIR_WALK_TEST_ROOT), flags | DirWalkFlags_Parallel, NULL, NULL, &entries, &entries_size));
+  EXPECT_U64_EQ(entries_size, serial_size);
+  for (U64 i = 0; i < serial_size; i++) {
+    DirEntry* entry = DirWalkTestFind(entries, entries_size, serial[i].path);
+    EXPECT_PTR_NOT_NULL(entry);
+    if (entry == NULL) { continue; }
+    EXPECT_TRUE(entry->type == serial[i].type);
+    EXPECT_U64_EQ(entry->size, serial[i].size);
+  }
+  DirEntry* dir = DirWalkTestFind(serial, serial_size, Str8Lit(DIR_WALK_TEST_ROOT "/a/b"));
+  EXPECT_PTR_NOT_NULL(dir);
+  if (dir != NULL) { EXPECT_TRUE(dir->type == DirEntryType_Dir); }
+
+  EXPECT_FALSE(DirWalk(arena, Str8Lit("./does_not_exist.tmp"), DirWalkFlags_Recursive, NULL, NULL, &entries, &entries_size));
+  EXPECT_U64_EQ(entries_size, 0);
+
+  for (U32 i = 0; i < STATIC_ARRAY_SIZE(dir_walk_test_files); i++) {
+    EXPECT_TRUE(FileDelete(Str8Format(arena, DIR_WALK_TEST_ROOT "/%S", dir_walk_test_files[i])));
+  }
+  EXPECT_TRUE(DirDelete(Str8Lit(DIR_WALK_TEST_ROOT "/a/b/c")));
+  EXPECT_TRUE(DirDelete(Str8Lit(DIR_WALK_TEST_ROOT "/a/b")));
+  EXPECT_TRUE(DirDelete(Str8Lit(DIR_WALK_TEST_ROOT "/a")));
+  EXPECT_TRUE(DirDelete(Str8Lit(DIR_WALK_TEST_ROOT "/.hidden")));
+  EXPECT_TRUE(DirDelete(Str8Lit(DIR_WALK_TEST_ROOT)));
+  ArenaRelease(arena);
+}
+
+#define FILE_WATCH_TEST_ROOT "./io_test_file_watch.tmp"
+
+// NOTE: changes may be reported asynchronously (e.g. on windows), so polls until all of flags were seen on path, and
+// writes the flags seen to seen. Also checks that each batch has coalesced events per path, and never includes unexpected.
+static void FileWatchTestWait(FileWatcher* watcher, String8 path, FileWatchEventFlags flags, String8 unexpected, FileWatchEventFlags* seen) {
+  Arena* arena = ArenaAllocate();
+  B32 is_polled    = true;
+  B32 is_coalesced = true;
+  B32 is_expected  = true;
+  *seen = 0;
+  for (U32 i = 0; i < 200 && (*seen & flags) != flags; i++) {
+    FileWatchEvent* events;
+    U64 events_size;
+    if (!FileWatcherPoll(watcher, arena, &events, &events_size)) {
+      is_polled = false;
+      break;
+    }
+    for (U64 j = 0; j < events_size; j++) {
+      for (U64 k = j + 1; k < events_size; k++) { is_coalesced = is_coalesced && !Str8Eq(events[j].path, events[k].path); }
+      is_expected = is_expected && !Str8Eq(events[j].path, unexpected);
+      if (Str8Eq(events[j].path, path)) { *seen |= events[j].flags; }
+    }
+    if ((*seen & flags) != flags) { SleepMs(10); }
+    ArenaClear(arena);
+  }
+  ArenaRelease(arena);
+  EXPECT_TRUE(is_polled);
+  EXPECT_TRUE(is_coalesced);
+  EXPECT_TRUE(is_expected);
+}
+
+void FileWatcherTest(void) {
+  U8 data[] = "watched";
+  EXPECT_TRUE(DirCreate(Str8Lit(FILE_WATCH_TEST_ROOT "/sub")));
+  FileWatcher* watcher;
+  EXPECT_TRUE(FileWatcherCreate(&watcher, Str8Lit(FILE_WATCH_TEST_ROOT "/"), true));
+  FileWatcher* shallow;
+  EXPECT_TRUE(FileWatcherCreate(&shallow, Str8Lit(FILE_WATCH_TEST_ROOT), false));
+
+  // NOTE: nothing changed yet.
+  Arena* arena = ArenaAllocate();
+  FileWatchEvent* events;
+  U64 events_size;
+  EXPECT_TRUE(FileWatcherPoll(watcher, arena, &events, &events_size));
+  EXPECT_U64_EQ(events_size, 0);
+
+  EXPECT_TRUE(FileDump(Str8Lit(FILE_WATCH_TEST_ROOT "/a.txt"), data, sizeof(data)));
+  EXPECT_TRUE(FileAppend(Str8Lit(FILE_WATCH_TEST_ROOT "/a.txt"), data, sizeof(data)));
+  FileWatchEventFlags seen;
+  FileWatchTestWait(watcher, Str8Lit(FILE_WATCH_TEST_ROOT "/a.txt"), FileWatchEventFlags_Created | FileWatchEventFlags_Modified, Str8Lit(""), &seen);
+  EXPECT_TRUE(seen == (FileWatchEventFlags_Created | FileWatchEventFlags_Modified));
+
+  EXPECT_TRUE(FileDump(Str8Lit(FILE_WATCH_TEST_ROOT "/sub/b.json"), data, sizeof(data)));
+  FileWatchTestWait(watcher, Str8Lit(FILE_WATCH_TEST_ROOT "/sub/b.json"), FileWatchEventFlags_Created, Str8Lit(""), &seen);
+  EXPECT_TRUE(seen & FileWatchEventFlags_Created);
+
+  // NOTE: directories created after the watch started are watched too.
+  EXPECT_TRUE(DirCreate(Str8Lit(FILE_WATCH_TEST_ROOT "/new/deeper")));
+  EXPECT_TRUE(FileDump(Str8Lit(FILE_WATCH_TEST_ROOT "/new/deeper/c.glsl"), data, sizeof(data)));
+  FileWatchTestWait(watcher, Str8Lit(FILE_WATCH_TEST_ROOT "/new/deeper/c.glsl"), FileWatchEventFlags_Created, Str8Lit(""), &seen);
+  EXPECT_TRUE(seen & FileWatchEventFlags_Created);
+  EXPECT_TRUE(FileAppend(Str8Lit(FILE_WATCH_TEST_ROOT "/new/deeper/c.glsl"), data, sizeof(data)));
+  FileWatchTestWait(watcher, Str8Lit(FILE_WATCH_TEST_ROOT "/new/deeper/c.glsl"), FileWatchEventFlags_Modified, Str8Lit(""), &seen);
+  EXPECT_TRUE(seen & FileWatchEventFlags_Modified);
+
+  EXPECT_TRUE(FileDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/a.txt")));
+  FileWatchTestWait(watcher, Str8Lit(FILE_WATCH_TEST_ROOT "/a.txt"), FileWatchEventFlags_Deleted, Str8Lit(""), &seen);
+  EXPECT_TRUE(seen == FileWatchEventFlags_Deleted);
+
+  // NOTE: the non-recursive watcher saw a.txt, but nothing in sub.
+  FileWatchTestWait(shallow, Str8Lit(FILE_WATCH_TEST_ROOT "/a.txt"), FileWatchEventFlags_Created | FileWatchEventFlags_Deleted, Str8Lit(FILE_WATCH_TEST_ROOT "/sub/b.json"), &seen);
+  EXPECT_TRUE(seen & FileWatchEventFlags_Deleted);
+
+  EXPECT_TRUE(FileDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/sub/b.json")));
+  EXPECT_TRUE(FileDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/new/deeper/c.glsl")));
+  EXPECT_FALSE(FileDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/a.txt")));
+  FileWatcherDestroy(shallow);
+  FileWatcherDestroy(watcher);
+
+  // NOTE: only empty directories can be deleted.
+  EXPECT_FALSE(DirDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/new")));
+  EXPECT_TRUE(DirDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/new/deeper")));
+  EXPECT_TRUE(DirDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/new")));
+  EXPECT_TRUE(DirDelete(Str8Lit(FILE_WATCH_TEST_ROOT "/sub")));
+  EXPECT_TRUE(DirDelete(Str8Lit(FILE_WATCH_TEST_ROOT)));
+  EXPECT_FALSE(DirDelete(Str8Lit(FILE_WATCH_TEST_ROOT)));
+
+  EXPECT_FALSE(FileWatcherCreate(&watcher, Str8Lit("./does_not_exist.tmp"), true));
+  ArenaRelease(arena);
+}
+
+void PathMatchGlobTest(void) {
+  EXPECT_TRUE(PathMatchGlob(Str8Lit("a.png"), Str8Lit("*.png")));
+  EXPECT_TRUE(PathMatchGlob(Str8Lit(".png"), Str8Lit("*.png")));
+  EXPECT_FALSE(PathMatchGlob(Str8Lit("a.png.txt"), Str8Lit("*.png")));
+  EXPECT_TRUE(PathMatchGlob(Str8Lit("tex_01_albedo.png"), Str8Lit("tex_??_*")));
+  EXPECT_FALSE(PathMatchGlob(Str8Lit("tex_1_albedo.png"), Str8Lit("tex_??_*")));
+  EXPECT_TRUE(PathMatchGlob(Str8Lit("aaab"), Str8Lit("*a*b")));
+  EXPECT_TRUE(PathMatchGlob(Str8Lit(""), Str8Lit("*")));
+  EXPECT_FALSE(PathMatchGlob(Str8Lit(""), Str8Lit("?")));
+  EXPECT_TRUE(PathMatchGlob(Str8Lit("abc"), Str8Lit("abc")));
+  EXPECT_FALSE(PathMatchGlob(Str8Lit("abc"), Str8Lit("ab")));
+}
+
+#define LOG_TEST_FILE Str8Lit("./io_test_log.tmp")
+#define LOG_TEST_THREADS 4
+#define LOG_TEST_MESSAGES 2000
+
+static S32 LogTestThread(void* arg) {
+  U32 id = (U32) (U64) arg;
+  for (U32 i = 0; i < LOG_TEST_MESSAGES; i++) { LOG_INFO("thread %u message %u", id, i); }
+  return 0;
+}
+
+// NOTE: logging is redirected to a file for the duration, so checks are deferred until stdout is restored.
+void LogAsyncTest(void) {
+  Arena* arena = ArenaAllocate();
+  LogDeinit();
+  B32 init_file = LogInitFile(LOG_TEST_FILE);
+  B32 enable_async = LogEnableAsync(64, LogAsyncPolicy_Block);
+  Thread threads[LOG_TEST_THREADS];
+  for (U32 i = 0; i < LOG_TEST_THREADS; i++) { ThreadCreate(&threads[i], LogTestThread, (void*) (U64) i); }
+  for (U32 i = 0; i < LOG_TEST_THREADS; i++) { ThreadJoin(&threads[i]); }
+  // NOTE: too long for a ring slot, written synchronously.
+  U8 long_message[LOG_ASYNC_RECORD_SIZE * 2];
+  MEMORY_SET_SIZE(long_message, 'x', sizeof(long_message));
+  LOG_NO_PREFIX("%S", Str8(long_message, sizeof(long_message)));
+  LogDeinit();
+  EXPECT_TRUE(LogInitStdOut());
+  EXPECT_TRUE(init_file);
+  EXPECT_TRUE(enable_async);
+
+  // NOTE: all records are written, and each thread's records stay in order.
+  String8 data;
+  EXPECT_TRUE(FileReadAll(arena, LOG_TEST_FILE, &data.str, &data.size));
+  U32 next_message[LOG_TEST_THREADS] = {0};
+  U32 lines_size = 0;
+  String8LineIter it;
+  String8 line;
+  for (Str8LineIterInit(&it, data); Str8LineIterNext(&it, &line);) {
+    lines_size++;
+    if (line.size == sizeof(long_message)) { continue; }
+    S32 thread_pos = Str8Find(line, 0, Str8Lit("thread "));
+    EXPECT_TRUE(thread_pos >= 0);
+    U32 id = line.str[thread_pos + 7] - '0';
+    EXPECT_TRUE(id < LOG_TEST_THREADS);
+    EXPECT_TRUE(Str8EndsWith(line, Str8Format(arena, "thread %u message %u", id, next_message[id])));
+    next_message[id]++;
+  }
+  EXPECT_U32_EQ(lines_size, LOG_TEST_THREADS * LOG_TEST_MESSAGES + 1);
+  for (U32 i = 0; i < LOG_TEST_THREADS; i++) { EXPECT_U32_EQ(next_message[i], LOG_TEST_MESSAGES); }
+  EXPECT_TRUE(FileDelete(LOG_TEST_FILE));
+  ArenaRelease(arena);
+}
+
+void LogAsyncDropTest(void) {
+  Arena* arena = ArenaAllocate();
+  LogDeinit();
+  B32 init_file = LogInitFile(LOG_TEST_FILE);
+  B32 enable_async = LogEnableAsync(4, LogAsyncPolicy_Drop);
+  LogTestThread(NULL);
+  LogFlush();
+  U64 dropped = LogGetDroppedCount();
+  LogDeinit();
+  EXPECT_TRUE(LogInitStdOut());
+  EXPECT_TRUE(init_file);
+  EXPECT_TRUE(enable_async);
+  EXPECT_FALSE(LogEnableAsync(3, LogAsyncPolicy_Drop));
+
+  String8 data;
+  EXPECT_TRUE(FileReadAll(arena, LOG_TEST_FILE, &data.str, &data.size));
+  U32 lines_size = 0;
+  String8LineIter it;
+  String8 line;
+  for (Str8LineIterInit(&it, data); Str8LineIterNext(&it, &line);) { lines_size++; }
+  EXPECT_U64_EQ(lines_size + dropped, LOG_TEST_MESSAGES);
+  EXPECT_TRUE(FileDelete(LOG_TEST_FILE));
+  ArenaRelease(arena);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  RUN_TEST(FileMapTest);
+  RUN_TEST(FileMapEmptyTest);
+  RUN_TEST(ChunkedReadWriteTest);
+  RUN_TEST(LargeFileTest);
+  RUN_TEST(ReadQueueNativeTest);
+  RUN_TEST(ReadQueueThreadsTest);
+  RUN_TEST(FileStreamTest);
+  RUN_TEST(FileStreamUnbufferedTest);
+  RUN_TEST(PackTest);
+  RUN_TEST(PackStreamTest);
+  RUN_TEST(PackInvalidTest);
+  RUN_TEST(DirWalkTest);
+  RUN_TEST(PathMatchGlobTest);
+  RUN_TEST(FileWatcherTest);
+  RUN_TEST(LogAsyncTest);
+  RUN_TEST(LogAsyncDropTest);
+  LogTestReport();
+  return 0;
+}
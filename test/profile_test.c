@@ -0,0 +1,406 @@
+#define PROFILE
+#define PROFILE_TRACE
+#define PROFILE_TRACE_EVENTS 1024
+#define PROFILE_PMC
+#define PROFILE_HISTOGRAM
+#define PROFILE_MAX_THREADS 16
+#define CDEFAULT_PROFILE_INTERNAL
+#define PROFILE_REGISTRY(PROFILE_METRIC) \
+  PROFILE_METRIC(OUTER)                  \
+  PROFILE_METRIC(INNER)                  \
+  PROFILE_METRIC(LEAF)                   \
+  PROFILE_METRIC(RECURSE)
+
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+#define STRESS_THREADS    8
+#define STRESS_ITERATIONS 100000
+#define RECYCLE_THREADS   (PROFILE_MAX_THREADS * 2)
+
+static volatile U64 sink;
+
+static void Recurse(U32 depth) {
+  PROFILE_START(RECURSE);
+  sink++;
+  if (depth > 0) { Recurse(depth - 1); }
+  PROFILE_END(RECURSE);
+}
+
+static void Nested(U32 iterations) {
+  for (U32 i = 0; i < iterations; i++) {
+    PROFILE_START(OUTER);
+    sink++;
+    PROFILE_START(INNER);
+    sink++;
+    PROFILE_START(LEAF);
+    sink++;
+    PROFILE_END(LEAF);
+    PROFILE_START(LEAF);
+    sink++;
+    PROFILE_END(LEAF);
+    PROFILE_END(INNER);
+    Recurse(3);
+    PROFILE_END(OUTER);
+  }
+}
+
+void SingleThreadTest(void) {
+  ProfileReset();
+  Nested(10);
+  ProfileAnchor outer = ProfileGetAnchor(OUTER);
+  ProfileAnchor inner = ProfileGetAnchor(INNER);
+  ProfileAnchor leaf = ProfileGetAnchor(LEAF);
+  ProfileAnchor recurse = ProfileGetAnchor(RECURSE);
+  EXPECT_U32_EQ(outer.num_hits, 10);
+  EXPECT_U32_EQ(inner.num_hits, 10);
+  EXPECT_U32_EQ(leaf.num_hits, 20);
+  EXPECT_U32_EQ(recurse.num_hits, 40);
+  EXPECT_TRUE(outer.elapsed_inclusive >= inner.elapsed_inclusive + recurse.elapsed_inclusive);
+  EXPECT_TRUE(inner.elapsed_inclusive >= leaf.elapsed_inclusive);
+  // NOTE: exclusive times partition the root's inclusive time.
+  EXPECT_TRUE(outer.elapsed_exclusive + inner.elapsed_exclusive + leaf.elapsed_exclusive + recurse.elapsed_exclusive ==
+              outer.elapsed_inclusive);
+
+  U32 thread_idx = ProfileThreadIndex();
+  EXPECT_TRUE(thread_idx < ProfileThreadCount());
+  EXPECT_U32_EQ(ProfileGetAnchorForThread(LEAF, thread_idx).num_hits, 20);
+
+  ProfileReset();
+  EXPECT_U32_EQ(ProfileGetAnchor(OUTER).num_hits, 0);
+  EXPECT_U32_EQ(ProfileGetAnchorForThread(OUTER, thread_idx).num_hits, 0);
+}
+
+typedef struct StressWorker StressWorker;
+struct StressWorker {
+  Thread thread;
+  U32 thread_idx;
+};
+
+static S32 StressEntry(void* arg) {
+  StressWorker* worker = (StressWorker*) arg;
+  worker->thread_idx = ProfileThreadIndex();
+  Nested(STRESS_ITERATIONS);
+  return 0;
+}
+
+void StressTest(void) {
+  ProfileReset();
+  StressWorker workers[STRESS_THREADS];
+  for (U32 i = 0; i < STRESS_THREADS; i++) { ThreadCreate(&workers[i].thread, StressEntry, &workers[i]); }
+  for (U32 i = 0; i < STRESS_THREADS; i++) { ThreadJoin(&workers[i].thread); }
+
+  ProfileAnchor merged[ProfileMetricType_Count];
+  ProfileMerge(merged);
+  EXPECT_U32_EQ(merged[ProfileMetricType_OUTER].num_hits, STRESS_THREADS * STRESS_ITERATIONS);
+  EXPECT_U32_EQ(merged[ProfileMetricType_INNER].num_hits, STRESS_THREADS * STRESS_ITERATIONS);
+  EXPECT_U32_EQ(merged[ProfileMetricType_LEAF].num_hits, STRESS_THREADS * STRESS_ITERATIONS * 2);
+  EXPECT_U32_EQ(merged[ProfileMetricType_RECURSE].num_hits, STRESS_THREADS * STRESS_ITERATIONS * 4);
+  EXPECT_U32_EQ(ProfileGetAnchor(LEAF).num_hits, STRESS_THREADS * STRESS_ITERATIONS * 2);
+
+  U64 exclusive_sum = 0;
+  U64 inclusive_sum = 0;
+  for (U32 i = 0; i < STRESS_THREADS; i++) {
+    U32 idx = workers[i].thread_idx;
+    ProfileAnchor outer   = ProfileGetAnchorForThread(OUTER, idx);
+    ProfileAnchor inner   = ProfileGetAnchorForThread(INNER, idx);
+    ProfileAnchor leaf    = ProfileGetAnchorForThread(LEAF, idx);
+    ProfileAnchor recurse = ProfileGetAnchorForThread(RECURSE, idx);
+    EXPECT_U32_EQ(outer.num_hits, STRESS_ITERATIONS);
+    EXPECT_U32_EQ(leaf.num_hits, STRESS_ITERATIONS * 2);
+    EXPECT_TRUE(outer.elapsed_exclusive + inner.elapsed_exclusive + leaf.elapsed_exclusive + recurse.elapsed_exclusive ==
+                outer.elapsed_inclusive);
+    exclusive_sum += outer.elapsed_exclusive + inner.elapsed_exclusive + leaf.elapsed_exclusive + recurse.elapsed_exclusive;
+    inclusive_sum += outer.elapsed_inclusive;
+  }
+  EXPECT_TRUE(exclusive_sum == inclusive_sum);
+  EXPECT_TRUE(merged[ProfileMetricType_OUTER].elapsed_inclusive == inclusive_sum);
+}
+
+// NOTE: Counts the complete events in the trace, optionally only those named metric_name.
+static void TraceCountEvents(JsonArray events, String8 metric_name, U32* count, U32* thread_names) {
+  *count        = 0;
+  *thread_names = 0;
+  for (JsonArrayNode* node = events.head; node != NULL; node = node->next) {
+    JsonObject event;
+    String8 phase, name;
+    F32 ts, dur;
+    EXPECT_TRUE(JsonValueGetObject(&node->value, &event));
+    EXPECT_TRUE(JsonObjectGetString(event, Str8Lit("ph"), &phase));
+    if (Str8Eq(phase, Str8Lit("M"))) { *thread_names += 1; continue; }
+    EXPECT_STR8_EQ(phase, Str8Lit("X"));
+    EXPECT_TRUE(JsonObjectGetString(event, Str8Lit("name"), &name));
+    EXPECT_TRUE(JsonObjectGetNumber(event, Str8Lit("ts"), &ts));
+    EXPECT_TRUE(JsonObjectGetNumber(event, Str8Lit("dur"), &dur));
+    EXPECT_TRUE(ts >= 0 && dur >= 0);
+    if (metric_name.size == 0 || Str8Eq(name, metric_name)) { *count += 1; }
+  }
+}
+
+void ChromeTraceTest(void) {
+  Arena* arena = ArenaAllocate();
+  String8 path = Str8Lit("profile_trace_test.json");
+  ProfileReset();
+  Nested(10);
+
+  String8 trace;
+  JsonObject json;
+  JsonArray events;
+  U32 count, thread_names;
+  EXPECT_TRUE(ProfileDumpChromeTrace(path));
+  EXPECT_TRUE(FileReadAll(arena, path, &trace.str, &trace.size));
+  EXPECT_TRUE(JsonParse(arena, &json, trace));
+  EXPECT_TRUE(JsonObjectGetArray(json, Str8Lit("traceEvents"), &events));
+  TraceCountEvents(events, Str8Lit("OUTER"), &count, &thread_names);
+  EXPECT_U32_EQ(count, 10);
+  TraceCountEvents(events, Str8Lit("LEAF"), &count, &thread_names);
+  EXPECT_U32_EQ(count, 20);
+  TraceCountEvents(events, Str8Lit("RECURSE"), &count, &thread_names);
+  EXPECT_U32_EQ(count, 40);
+  EXPECT_U32_EQ(thread_names, ProfileThreadCount());
+
+  // NOTE: once the ring wraps, only the most recent (whole) blocks are kept.
+  ProfileReset();
+  Nested(1000);
+  ArenaClear(arena);
+  EXPECT_TRUE(ProfileDumpChromeTrace(path));
+  EXPECT_TRUE(FileReadAll(arena, path, &trace.str, &trace.size));
+  EXPECT_TRUE(JsonParse(arena, &json, trace));
+  EXPECT_TRUE(JsonObjectGetArray(json, Str8Lit("traceEvents"), &events));
+  TraceCountEvents(events, Str8Lit(""), &count, &thread_names);
+  EXPECT_TRUE(count > 0 && count <= PROFILE_TRACE_EVENTS / 2);
+  ArenaRelease(arena);
+}
+
+void ReportTest(void) {
+  Arena* arena = ArenaAllocate();
+  ProfileReset();
+  EXPECT_TRUE(ProfileCpuTimerFrequency() > 0);
+  EXPECT_F64_EQ(ProfileCyclesToSeconds(ProfileCpuTimerFrequency()), 1.0);
+  Nested(100);
+  EXPECT_F64_EQ(ProfileAnchorToSeconds(ProfileGetAnchor(OUTER)), ProfileCyclesToSeconds(ProfileGetAnchor(OUTER).elapsed_inclusive));
+
+  ProfileReport report;
+  ProfileReportGet(arena, &report);
+  EXPECT_U32_EQ(report.entries_size, 4);
+  EXPECT_STR8_EQ(report.entries[0].name, Str8Lit("OUTER"));
+  EXPECT_U32_EQ(report.entries[0].anchor.num_hits, 100);
+  EXPECT_TRUE(report.entries[0].inclusive_percent > 99.99 && report.entries[0].inclusive_percent < 100.01);
+  F64 exclusive_percent = 0;
+  for (U32 i = 0; i < report.entries_size; i++) {
+    ProfileReportEntry* entry = &report.entries[i];
+    if (i > 0) { EXPECT_TRUE(entry->anchor.elapsed_inclusive <= report.entries[i - 1].anchor.elapsed_inclusive); }
+    EXPECT_TRUE(entry->inclusive_seconds >= entry->exclusive_seconds);
+    EXPECT_F64_APPROX_EQ(entry->inclusive_seconds_per_hit * entry->anchor.num_hits, entry->inclusive_seconds);
+    exclusive_percent += entry->exclusive_percent;
+  }
+  EXPECT_TRUE(exclusive_percent > 99.99 && exclusive_percent < 100.01);
+  EXPECT_TRUE(ProfileReportToString(arena, &report).size > 0);
+
+  String8 csv = ProfileReportToCsv(arena, &report);
+  String8List csv_lines = Str8Split(arena, csv, '\n');
+  String8 csv_line;
+  U32 csv_lines_size = 0;
+  for (String8ListNode* node = csv_lines.head; node != NULL; node = node->next) {
+    if (node->string.size > 0) { csv_lines_size++; csv_line = node->string; }
+  }
+  EXPECT_U32_EQ(csv_lines_size, report.entries_size + 1);
+  EXPECT_TRUE(Str8StartsWith(csv_line, report.entries[report.entries_size - 1].name));
+
+  JsonObject json;
+  JsonArray entries;
+  F32 total_seconds;
+  String8 metric;
+  EXPECT_TRUE(JsonParse(arena, &json, ProfileReportToJson(arena, &report)));
+  EXPECT_TRUE(JsonObjectGetNumber(json, Str8Lit("total_seconds"), &total_seconds));
+  EXPECT_TRUE(JsonObjectGetArray(json, Str8Lit("entries"), &entries));
+  JsonObject first;
+  EXPECT_TRUE(JsonValueGetObject(&entries.head->value, &first));
+  EXPECT_TRUE(JsonObjectGetString(first, Str8Lit("metric"), &metric));
+  EXPECT_STR8_EQ(metric, Str8Lit("OUTER"));
+  ArenaRelease(arena);
+}
+
+void BandwidthTest(void) {
+  Arena* arena = ArenaAllocate();
+  ProfileReset();
+  PROFILE_ADD_BYTES(7); // NOTE: no open block, dropped.
+  for (U32 i = 0; i < 10; i++) {
+    PROFILE_START_BANDWIDTH(OUTER, 1000);
+    PROFILE_START(INNER);
+    PROFILE_ADD_BYTES(10);
+    PROFILE_START(LEAF);
+    PROFILE_END(LEAF);
+    PROFILE_END(INNER);
+    PROFILE_END(OUTER);
+  }
+  EXPECT_U32_EQ(ProfileGetAnchor(OUTER).processed_bytes, 10000);
+  EXPECT_U32_EQ(ProfileGetAnchor(INNER).processed_bytes, 100);
+  EXPECT_U32_EQ(ProfileGetAnchor(LEAF).processed_bytes, 0);
+
+  // NOTE: library loaders attribute their input to the innermost block, which is their own zone when enabled.
+  String8 json_str = Str8Lit("{ \"a\": 1, \"b\": [ true, false ] }");
+  JsonObject json;
+  PROFILE_START(RECURSE);
+  EXPECT_TRUE(JsonParse(arena, &json, json_str));
+  PROFILE_END(RECURSE);
+  EXPECT_U32_EQ(ProfileGetAnchor(CDEFAULT_JSON_PARSE).processed_bytes, json_str.size);
+  EXPECT_U32_EQ(ProfileGetAnchor(RECURSE).processed_bytes, 0);
+
+  ProfileReport report;
+  ProfileReportGet(arena, &report);
+  for (U32 i = 0; i < report.entries_size; i++) {
+    ProfileReportEntry* entry = &report.entries[i];
+    EXPECT_TRUE((entry->gb_per_second > 0) == (entry->anchor.processed_bytes > 0));
+  }
+  ProfileReset();
+  EXPECT_U32_EQ(ProfileGetAnchor(OUTER).processed_bytes, 0);
+  ArenaRelease(arena);
+}
+
+void CountersTest(void) {
+  Arena* arena = ArenaAllocate();
+  ProfileReset();
+  // NOTE: a loop with a known lower bound on retired instructions (at least a load, add, store, and branch per iteration).
+  U32 iterations = 1000000;
+  PROFILE_START(OUTER);
+  for (U32 i = 0; i < iterations; i++) { sink += i; }
+  PROFILE_END(OUTER);
+
+  ProfileAnchor outer = ProfileGetAnchor(OUTER);
+  ProfileReport report;
+  ProfileReportGet(arena, &report);
+  if (ProfileCountersAvailable()) {
+    EXPECT_TRUE(outer.counters[ProfileCounter_Instructions] >= (U64) iterations * 4);
+    EXPECT_TRUE(outer.counters[ProfileCounter_Cycles] > 0);
+    EXPECT_TRUE(report.entries[0].instructions_per_cycle > 0);
+  } else {
+    LOG_INFO("Hardware counters are unavailable, checking that they read as 0.");
+    for (U32 i = 0; i < ProfileCounter_Count; i++) { EXPECT_U32_EQ(outer.counters[i], 0); }
+    EXPECT_F64_EQ(report.entries[0].instructions_per_cycle, 0);
+  }
+  // NOTE: profiling itself must still work either way.
+  EXPECT_U32_EQ(outer.num_hits, 1);
+  EXPECT_TRUE(outer.elapsed_inclusive > 0);
+  ArenaRelease(arena);
+}
+
+void LibraryZonesTest(void) {
+  Arena* arena = ArenaAllocate();
+  ProfileReset();
+  EXPECT_U32_EQ(ProfileMetricType_OUTER, 0);
+  EXPECT_TRUE(ProfileMetricType_CDEFAULT_JSON_PARSE > ProfileMetricType_RECURSE);
+  EXPECT_STR8_EQ(ProfileMetricType_Names[ProfileMetricType_CDEFAULT_JSON_PARSE], Str8Lit("CDEFAULT_JSON_PARSE"));
+
+  String8 json_str = Str8Lit("{ \"a\": { \"b\": [ 1, 2, 3 ] } }");
+  JsonObject json;
+  PROFILE_START(OUTER);
+  for (U32 i = 0; i < 3; i++) { EXPECT_TRUE(JsonParse(arena, &json, json_str)); }
+  EXPECT_FALSE(JsonParse(arena, &json, Str8Lit("{ \"a\": ")));
+  PROFILE_END(OUTER);
+  ProfileAnchor outer = ProfileGetAnchor(OUTER);
+  ProfileAnchor parse = ProfileGetAnchor(CDEFAULT_JSON_PARSE);
+  EXPECT_U32_EQ(outer.num_hits, 1);
+  EXPECT_U32_EQ(parse.num_hits, 4);
+  EXPECT_TRUE(parse.elapsed_inclusive <= outer.elapsed_inclusive);
+  EXPECT_TRUE(outer.elapsed_exclusive <= outer.elapsed_inclusive - parse.elapsed_inclusive);
+
+  // NOTE: failed loads still close their zone.
+  Image image;
+  U8 not_png[16] = {0};
+  EXPECT_FALSE(ImageLoadPng(arena, &image, ImageFormat_RGBA, not_png, sizeof(not_png)));
+  EXPECT_U32_EQ(ProfileGetAnchor(CDEFAULT_IMAGE_LOAD_PNG).num_hits, 1);
+  PROFILE_START(LEAF);
+  PROFILE_END(LEAF);
+  EXPECT_U32_EQ(ProfileGetAnchor(LEAF).num_hits, 1);
+  EXPECT_U32_EQ(ProfileGetAnchor(CDEFAULT_IMAGE_LOAD_PNG).elapsed_exclusive, ProfileGetAnchor(CDEFAULT_IMAGE_LOAD_PNG).elapsed_inclusive);
+
+  ProfileReset();
+  EXPECT_U32_EQ(ProfileGetAnchor(CDEFAULT_JSON_PARSE).num_hits, 0);
+  ArenaRelease(arena);
+}
+
+static void Spin(U64 cycles) {
+  U64 start = __rdtsc();
+  while (__rdtsc() - start < cycles) {}
+}
+
+void HistogramTest(void) {
+  ProfileReset();
+  EXPECT_U32_EQ(ProfileGetHistogramStats(LEAF).count, 0);
+
+  // NOTE: 998 short hits and 2 long ones; the spikes only show up in max and p99.9.
+  F64 short_seconds = ProfileCyclesToSeconds(20000);
+  F64 long_seconds = ProfileCyclesToSeconds(2000000);
+  ProfileHistogramTrack(LEAF, ProfileHistogramMode_PerHit);
+  for (U32 i = 0; i < 1000; i++) {
+    PROFILE_START(LEAF);
+    Spin(i == 500 || i == 700 ? 2000000 : 20000);
+    PROFILE_END(LEAF);
+  }
+  ProfileHistogramStats stats = ProfileGetHistogramStats(LEAF);
+  EXPECT_U32_EQ(stats.count, 1000);
+  EXPECT_TRUE(stats.min >= short_seconds * 0.96);
+  EXPECT_TRUE(stats.p50 >= short_seconds * 0.96 && stats.p50 < short_seconds * 1.5);
+  EXPECT_TRUE(stats.p90 >= stats.p50 && stats.p99 >= stats.p90 && stats.p999 >= stats.p99);
+  EXPECT_TRUE(stats.p99 < short_seconds * 2);
+  EXPECT_TRUE(stats.p999 >= long_seconds * 0.96);
+  EXPECT_TRUE(stats.max >= long_seconds && stats.max >= stats.p999);
+  EXPECT_TRUE(stats.mean > stats.p50 && stats.stddev > 0);
+  EXPECT_U32_EQ(ProfileGetHistogramStats(OUTER).count, 0);
+
+  // NOTE: per frame, INNER is hit twice.
+  ProfileReset();
+  ProfileHistogramTrack(LEAF, ProfileHistogramMode_None);
+  ProfileHistogramTrack(INNER, ProfileHistogramMode_PerFrame);
+  ProfileFrameBoundary();
+  for (U32 i = 0; i < 10; i++) {
+    for (U32 j = 0; j < 2; j++) {
+      PROFILE_START(INNER);
+      Spin(20000);
+      PROFILE_END(INNER);
+    }
+    ProfileFrameBoundary();
+  }
+  ProfileHistogramStats frame_stats = ProfileGetFrameStats();
+  ProfileHistogramStats inner_stats = ProfileGetHistogramStats(INNER);
+  EXPECT_U32_EQ(frame_stats.count, 10);
+  EXPECT_U32_EQ(inner_stats.count, 10);
+  EXPECT_TRUE(inner_stats.min >= short_seconds * 2 * 0.96);
+  EXPECT_TRUE(frame_stats.min >= inner_stats.min);
+  EXPECT_U32_EQ(ProfileGetHistogramStats(LEAF).count, 0);
+  ProfileHistogramTrack(INNER, ProfileHistogramMode_None);
+}
+
+static S32 RecycleEntry(void* UNUSED(arg)) {
+  Nested(1);
+  return 0;
+}
+
+// NOTE: threads past PROFILE_MAX_THREADS reuse the tables of exited threads, so every thread is still counted.
+void RecycleTest(void) {
+  ProfileReset();
+  for (U32 i = 0; i < RECYCLE_THREADS; i++) {
+    Thread thread;
+    EXPECT_TRUE(ThreadCreate(&thread, RecycleEntry, NULL));
+    ThreadJoin(&thread);
+  }
+  EXPECT_U32_EQ(ProfileThreadCount(), PROFILE_MAX_THREADS);
+  EXPECT_U32_EQ(ProfileGetAnchor(OUTER).num_hits, RECYCLE_THREADS);
+  EXPECT_U32_EQ(ProfileGetAnchor(LEAF).num_hits, RECYCLE_THREADS * 2);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  RUN_TEST(SingleThreadTest);
+  RUN_TEST(StressTest);
+  RUN_TEST(ChromeTraceTest);
+  RUN_TEST(ReportTest);
+  RUN_TEST(BandwidthTest);
+  RUN_TEST(CountersTest);
+  RUN_TEST(HistogramTest);
+  RUN_TEST(LibraryZonesTest);
+  RUN_TEST(RecycleTest);
+  LogTestReport();
+  return 0;
+}
@@ -333,6 +333,76 @@ void Str8SplitTest(void) {
   EXPECT_STR8_EQ(test->string, expected);
 }
 
+void Str8FindByteSetTest(void) {
+  String8ByteSet set;
+  Str8ByteSetInit(&set, Str8Lit(",;"));
+  EXPECT_TRUE(Str8ByteSetHas(&set, ','));
+  EXPECT_FALSE(Str8ByteSetHas(&set, 'a'));
+
+  // NOTE: long enough to exercise the vector path.
+  String8 string = Str8Lit("abcdefghijklmnopqrstuvwxyz;abcdefghijklmnopqrstuvwxyz,");
+  EXPECT_S32_EQ(Str8FindByteSet(string, 0, &set), 26);
+  EXPECT_S32_EQ(Str8FindByteSet(string, 27, &set), 53);
+  EXPECT_S32_EQ(Str8FindByteSet(Str8Lit("abcdefghijklmnopqrstuvwxyz"), 0, &set), -1);
+  EXPECT_S32_EQ(Str8FindChar(string, 0, ','), 53);
+  EXPECT_S32_EQ(Str8FindChar(string, 0, 'z'), 25);
+  EXPECT_S32_EQ(Str8FindChar(string, 26, 'z'), 52);
+  EXPECT_S32_EQ(Str8FindChar(string, 0, '!'), -1);
+
+  // NOTE: large sets fall back to the bitmap.
+  Str8ByteSetInit(&set, Str8Lit("0123456789"));
+  EXPECT_U32_EQ(set.needles_size, 0);
+  EXPECT_S32_EQ(Str8FindByteSet(Str8Lit("abcdefghijklmnopqrstuvwxyz7"), 0, &set), 26);
+}
+
+void Str8SplitIterTest(void) {
+  String8 expected[] = { Str8Lit("a"), Str8Lit("b"), Str8Lit(""), Str8Lit("cde") };
+  String8SplitIter it;
+  Str8SplitIterInit(&it, Str8Lit("a,b,,cde,"), ',');
+  String8 piece;
+  U32 i = 0;
+  while (Str8SplitIterNext(&it, &piece)) {
+    EXPECT_TRUE(i < STATIC_ARRAY_SIZE(expected));
+    EXPECT_STR8_EQ(piece, expected[i]);
+    i++;
+  }
+  EXPECT_U32_EQ(i, STATIC_ARRAY_SIZE(expected));
+
+  Str8SplitIterInit(&it, Str8Lit(""), ',');
+  EXPECT_FALSE(Str8SplitIterNext(&it, &piece));
+}
+
+void Str8LineIterTest(void) {
+  String8 expected[] = { Str8Lit("first"), Str8Lit(""), Str8Lit("third"), Str8Lit("fourth") };
+  String8LineIter it;
+  Str8LineIterInit(&it, Str8Lit("first\r\n\nthird\r\nfourth"));
+  String8 line;
+  U32 i = 0;
+  while (Str8LineIterNext(&it, &line)) {
+    EXPECT_TRUE(i < STATIC_ARRAY_SIZE(expected));
+    EXPECT_STR8_EQ(line, expected[i]);
+    i++;
+  }
+  EXPECT_U32_EQ(i, STATIC_ARRAY_SIZE(expected));
+}
+
+void Str8TokenIterTest(void) {
+  String8 expected[] = { Str8Lit("f"), Str8Lit("1/2/3"), Str8Lit("4/5/6"), Str8Lit("7/8/9") };
+  String8TokenIter it;
+  Str8TokenIterInit(&it, Str8Lit("  f \t1/2/3   4/5/6\t7/8/9 \r\n"), STR8_WHITESPACE);
+  String8 token;
+  U32 i = 0;
+  while (Str8TokenIterNext(&it, &token)) {
+    EXPECT_TRUE(i < STATIC_ARRAY_SIZE(expected));
+    EXPECT_STR8_EQ(token, expected[i]);
+    i++;
+  }
+  EXPECT_U32_EQ(i, STATIC_ARRAY_SIZE(expected));
+
+  Str8TokenIterInit(&it, Str8Lit(" \t "), STR8_WHITESPACE);
+  EXPECT_FALSE(Str8TokenIterNext(&it, &token));
+}
+
 int main(void) {
   DEBUG_ASSERT(LogInitStdOut());
   RUN_TEST(CharTest);
@@ -362,6 +432,10 @@ int main(void) {
   RUN_TEST(Str8FormatTest);
   RUN_TEST(Str8ListBuildTest);
   RUN_TEST(Str8SplitTest);
+  RUN_TEST(Str8FindByteSetTest);
+  RUN_TEST(Str8SplitIterTest);
+  RUN_TEST(Str8LineIterTest);
+  RUN_TEST(Str8TokenIterTest);
   LogTestReport();
   return 0;
 }
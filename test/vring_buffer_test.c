@@ -0,0 +1,107 @@
+#define CDEFAULT_IMPLEMENTATION
+#include "../cdefault.h"
+
+Arena* arena;
+
+void InitTest(void) {
+  VRingBuffer ring;
+  EXPECT_TRUE(VRingBufferInit(&ring, 1000));
+  EXPECT_TRUE(ring.capacity >= 1000);
+  EXPECT_U32_EQ(ring.capacity & (ring.capacity - 1), 0);
+  EXPECT_U32_EQ(VRingBufferSize(&ring), 0);
+  VRingBufferDeinit(&ring);
+}
+
+void AliasTest(void) {
+  VRingBuffer ring;
+  EXPECT_TRUE(VRingBufferInit(&ring, KB(64)));
+  ring.data[0] = 17;
+  EXPECT_U32_EQ(ring.data[ring.capacity], 17);
+  ring.data[2 * ring.capacity - 1] = 42;
+  EXPECT_U32_EQ(ring.data[ring.capacity - 1], 42);
+  VRingBufferDeinit(&ring);
+}
+
+void WrapTest(void) {
+  VRingBuffer ring;
+  EXPECT_TRUE(VRingBufferInit(&ring, KB(64)));
+  U64 capacity = ring.capacity;
+  U8* scratch = ARENA_PUSH_ARRAY(arena, U8, capacity);
+  U8* result  = ARENA_PUSH_ARRAY(arena, U8, capacity);
+
+  // NOTE: move the cursors near the end of the buffer.
+  EXPECT_TRUE(VRingBufferWrite(&ring, scratch, capacity - 10));
+  EXPECT_TRUE(VRingBufferRead(&ring, result, capacity - 10));
+
+  // NOTE: this write straddles the end, but is still contiguous.
+  for (U64 i = 0; i < capacity; i++) { scratch[i] = (U8) (i * 7); }
+  U64 available;
+  U8* dest = VRingBufferWriteBegin(&ring, &available);
+  EXPECT_U32_EQ(available, capacity);
+  MEMORY_COPY_SIZE(dest, scratch, 100);
+  VRingBufferWriteCommit(&ring, 100);
+  EXPECT_U32_EQ(VRingBufferSize(&ring), 100);
+  EXPECT_U32_EQ(ring.data[5], (U8) (15 * 7));
+
+  U8* src = VRingBufferReadBegin(&ring, &available);
+  EXPECT_U32_EQ(available, 100);
+  EXPECT_TRUE(MEMORY_IS_EQUAL_SIZE(src, scratch, 100));
+  VRingBufferReadCommit(&ring, 100);
+
+  ArenaClear(arena);
+  VRingBufferDeinit(&ring);
+}
+
+void FullEmptyTest(void) {
+  VRingBuffer ring;
+  EXPECT_TRUE(VRingBufferInit(&ring, KB(64)));
+  U8* scratch = ARENA_PUSH_ARRAY(arena, U8, ring.capacity + 1);
+  EXPECT_FALSE(VRingBufferRead(&ring, scratch, 1));
+  EXPECT_FALSE(VRingBufferWrite(&ring, scratch, ring.capacity + 1));
+  EXPECT_TRUE(VRingBufferWrite(&ring, scratch, ring.capacity));
+  EXPECT_FALSE(VRingBufferWrite(&ring, scratch, 1));
+  EXPECT_TRUE(VRingBufferRead(&ring, scratch, ring.capacity));
+  EXPECT_U32_EQ(VRingBufferSize(&ring), 0);
+  ArenaClear(arena);
+  VRingBufferDeinit(&ring);
+}
+
+#define SPSC_COUNT 1000000
+static S32 SpscProducer(void* arg) {
+  VRingBuffer* ring = (VRingBuffer*) arg;
+  for (U32 i = 0; i < SPSC_COUNT;) {
+    if (VRingBufferWrite(ring, &i, sizeof(i))) { i++; }
+  }
+  return 0;
+}
+
+void SpscTest(void) {
+  VRingBuffer ring;
+  EXPECT_TRUE(VRingBufferInit(&ring, KB(4)));
+  Thread producer;
+  ThreadCreate(&producer, SpscProducer, &ring);
+  B32 in_order = true;
+  for (U32 i = 0; i < SPSC_COUNT;) {
+    U32 value;
+    if (VRingBufferRead(&ring, &value, sizeof(value))) {
+      in_order &= (value == i);
+      i++;
+    }
+  }
+  ThreadJoin(&producer);
+  EXPECT_TRUE(in_order);
+  EXPECT_U32_EQ(VRingBufferSize(&ring), 0);
+  VRingBufferDeinit(&ring);
+}
+
+int main(void) {
+  DEBUG_ASSERT(LogInitStdOut());
+  arena = ArenaAllocate();
+  RUN_TEST(InitTest);
+  RUN_TEST(AliasTest);
+  RUN_TEST(WrapTest);
+  RUN_TEST(FullEmptyTest);
+  RUN_TEST(SpscTest);
+  LogTestReport();
+  return 0;
+}